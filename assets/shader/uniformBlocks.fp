@@ -0,0 +1,17 @@
+#version 330
+out vec4 out_color;
+
+smooth in vec3 normal;
+
+// Filled from the "Uniform Buffer" of the node's Material.
+layout(std140) uniform Material {
+  vec3 diffuse;
+  float shininess;
+};
+
+void main(void)
+{
+  // very basic lighting from the viewer's direction
+  float lighting = max(normalize(normal).z, 0.0);
+  out_color = vec4(diffuse * lighting, 1.0);
+}
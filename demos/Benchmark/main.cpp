@@ -0,0 +1,625 @@
+/*
+ Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark of the CPU hot paths of KoRE on a procedurally generated scene.
+// Usage: Benchmark [--nodes N] [--meshes M] [--materials K] [--depth D]
+//                  [--frames F] [--out results.json]
+//                  [--capture frame.kcap]
+// Run from the repository root, so the shaders in ./assets are found.
+
+#include <GL/glew.h>
+#include <GL/glfw.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "KoRE/GLerror.h"
+#include "KoRE/Log.h"
+#include "KoRE/IDManager.h"
+#include "KoRE/ShaderProgram.h"
+#include "KoRE/Mesh.h"
+#include "KoRE/Texture.h"
+#include "KoRE/FrameBuffer.h"
+#include "KoRE/SceneNode.h"
+#include "KoRE/SceneManager.h"
+#include "KoRE/ResourceManager.h"
+#include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
+#include "KoRE/Components/Camera.h"
+#include "KoRE/Components/Material.h"
+#include "KoRE/Components/MaterialComponent.h"
+#include "KoRE/Components/MeshComponent.h"
+#include "KoRE/Loader/MeshLoader.h"
+#include "KoRE/Loader/TextureLoader.h"
+#include "KoRE/Loader/lodepng.h"
+#include "KoRE/Operations/RenderMesh.h"
+#include "KoRE/Operations/BindOperations/BindAttribute.h"
+#include "KoRE/Operations/BindOperations/BindUniform.h"
+#include "KoRE/Operations/BindOperations/BindUniformBlock.h"
+#include "KoRE/Passes/FrameBufferStage.h"
+#include "KoRE/Passes/ShaderProgramPass.h"
+#include "KoRE/Passes/NodePass.h"
+
+typedef std::chrono::steady_clock BenchClock;
+
+struct SBenchmarkConfig {
+  SBenchmarkConfig()
+    : numNodes(10000),
+      numMeshes(16),
+      numMaterials(8),
+      depth(6),
+      numFrames(300),
+      numWarmupFrames(20),
+      outFile("benchmark_results.json"),
+      captureFile("") {
+  }
+
+  uint numNodes;
+  uint numMeshes;
+  uint numMaterials;
+  uint depth;
+  uint numFrames;
+  uint numWarmupFrames;
+  std::string outFile;
+  std::string captureFile;  // Captures the last warmup frame if set
+};
+
+/// Samples of one benchmarked function in milliseconds.
+struct SBenchmarkResult {
+  std::string name;
+  std::vector<double> samplesMS;
+};
+
+// A deque, so references returned by getResult() stay valid when more
+// results are added.
+std::deque<SBenchmarkResult> g_results;
+
+SBenchmarkResult& getResult(const std::string& name) {
+  for (uint i = 0; i < g_results.size(); ++i) {
+    if (g_results[i].name == name) {
+      return g_results[i];
+    }
+  }
+  g_results.push_back(SBenchmarkResult());
+  g_results.back().name = name;
+  return g_results.back();
+}
+
+inline double elapsedMS(const BenchClock::time_point& start) {
+  const std::chrono::duration<double, std::milli> diff =
+    BenchClock::now() - start;
+  return diff.count();
+}
+
+/// Simple deterministic random numbers, so every run builds the same scene.
+uint g_randomState = 12345;
+float randomFloat(float min, float max) {
+  g_randomState = g_randomState * 1664525u + 1013904223u;
+  return min + (max - min) * static_cast<float>(g_randomState >> 8)
+                           / static_cast<float>(1 << 24);
+}
+
+/// Generates a UV-sphere in the Wavefront OBJ format.
+std::string genSphereOBJ(const uint rings, const uint segments) {
+  std::ostringstream obj;
+  for (uint r = 0; r <= rings; ++r) {
+    const float theta = glm::pi<float>() * static_cast<float>(r) / rings;
+    for (uint s = 0; s <= segments; ++s) {
+      const float phi = 2.0f * glm::pi<float>() * static_cast<float>(s)
+                        / segments;
+      const glm::vec3 n(glm::sin(theta) * glm::cos(phi),
+                        glm::cos(theta),
+                        glm::sin(theta) * glm::sin(phi));
+      obj << "v " << n.x << " " << n.y << " " << n.z << "\n";
+      obj << "vn " << n.x << " " << n.y << " " << n.z << "\n";
+      obj << "vt " << static_cast<float>(s) / segments << " "
+          << static_cast<float>(r) / rings << "\n";
+    }
+  }
+
+  for (uint r = 0; r < rings; ++r) {
+    for (uint s = 0; s < segments; ++s) {
+      // OBJ-indices are 1-based
+      const uint i0 = r * (segments + 1) + s + 1;
+      const uint i1 = i0 + segments + 1;
+      obj << "f " << i0 << "/" << i0 << "/" << i0 << " "
+          << i1 << "/" << i1 << "/" << i1 << " "
+          << i1 + 1 << "/" << i1 + 1 << "/" << i1 + 1 << "\n";
+      obj << "f " << i0 << "/" << i0 << "/" << i0 << " "
+          << i1 + 1 << "/" << i1 + 1 << "/" << i1 + 1 << " "
+          << i0 + 1 << "/" << i0 + 1 << "/" << i0 + 1 << "\n";
+    }
+  }
+  return obj.str();
+}
+
+std::vector<kore::Mesh*> genMeshes(const SBenchmarkConfig& config) {
+  std::vector<kore::Mesh*> meshes;
+  kore::IDManager* idMgr = kore::IDManager::getInstance();
+  SBenchmarkResult& loadResult = getResult("MeshLoader::loadMesh");
+
+  for (uint i = 0; i < config.numMeshes; ++i) {
+    // Vary the tesselation, so the meshes have different sizes.
+    const uint rings = 8 + (i % 8) * 4;
+    const std::string obj = genSphereOBJ(rings, rings * 2);
+
+    Assimp::Importer importer;
+    const aiScene* scene =
+      importer.ReadFileFromMemory(obj.c_str(), obj.size(),
+                                  aiProcess_JoinIdenticalVertices
+                                  | aiProcess_Triangulate
+                                  | aiProcess_CalcTangentSpace, "obj");
+    if (scene == NULL || !scene->HasMeshes()) {
+      kore::Log::getInstance()->write("[ERROR] Benchmark: Could not "
+                                      "generate mesh %u: %s\n", i,
+                                      importer.GetErrorString());
+      continue;
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    kore::Mesh* mesh = kore::MeshLoader::getInstance()->loadMesh(scene, 0);
+    loadResult.samplesMS.push_back(elapsedMS(start));
+
+    std::ostringstream name;
+    name << "BenchmarkSphere" << i;
+    mesh->setName(name.str());
+    idMgr->registerURL(mesh->getID(), idMgr->genURL(name.str(), "benchmark",
+                                                    i));
+    kore::ResourceManager::getInstance()->addMesh(mesh);
+    meshes.push_back(mesh);
+  }
+  return meshes;
+}
+
+std::vector<kore::Texture*> genTextures(const SBenchmarkConfig& config) {
+  std::vector<kore::Texture*> textures;
+  SBenchmarkResult& loadResult = getResult("TextureLoader::loadTexture");
+
+  for (uint i = 0; i < config.numMaterials; ++i) {
+    // Checkerboard with a different size and color per material.
+    const uint size = 64u << (i % 4);
+    std::vector<unsigned char> image(size * size * 4);
+    for (uint y = 0; y < size; ++y) {
+      for (uint x = 0; x < size; ++x) {
+        const bool white = ((x / 8) + (y / 8)) % 2 == 0;
+        unsigned char* pixel = &image[(y * size + x) * 4];
+        pixel[0] = white ? 255 : static_cast<unsigned char>(i * 31);
+        pixel[1] = white ? 255 : static_cast<unsigned char>(i * 67);
+        pixel[2] = white ? 255 : static_cast<unsigned char>(i * 101);
+        pixel[3] = 255;
+      }
+    }
+
+    std::ostringstream path;
+    path << "benchmark_texture_" << i << ".png";
+    std::vector<unsigned char> png;
+    lodepng::encode(png, image, size, size);
+    lodepng::save_file(png, path.str());
+
+    BenchClock::time_point start = BenchClock::now();
+    kore::Texture* texture =
+      kore::TextureLoader::getInstance()->loadTexture(path.str());
+    loadResult.samplesMS.push_back(elapsedMS(start));
+
+    remove(path.str().c_str());
+    if (texture != NULL) {
+      textures.push_back(texture);
+    }
+  }
+  return textures;
+}
+
+std::vector<kore::Material*> genMaterials(const SBenchmarkConfig& config) {
+  std::vector<kore::Material*> materials;
+  for (uint i = 0; i < config.numMaterials; ++i) {
+    kore::Material* material = new kore::Material;
+    material->addValue("diffuse", GL_FLOAT_VEC3,
+                       new glm::vec3(randomFloat(0.0f, 1.0f),
+                                     randomFloat(0.0f, 1.0f),
+                                     randomFloat(0.0f, 1.0f)));
+    material->addValue("shininess", GL_FLOAT,
+                       new float(randomFloat(1.0f, 64.0f)));
+    kore::ResourceManager::getInstance()->addMaterial(material);
+    materials.push_back(material);
+  }
+  return materials;
+}
+
+/// Builds a tree of numNodes nodes with the requested depth below the root.
+/// Every node has a mesh and a material.
+std::vector<kore::SceneNode*>
+  genSceneNodes(const SBenchmarkConfig& config,
+                const std::vector<kore::Mesh*>& meshes,
+                const std::vector<kore::Material*>& materials) {
+  std::vector<kore::SceneNode*> nodes;
+  kore::IDManager* idMgr = kore::IDManager::getInstance();
+  kore::SceneNode* root = kore::SceneManager::getInstance()->getRootNode();
+
+  // Branching factor that fills the requested depth with numNodes nodes.
+  const uint depth = std::max(1u, config.depth);
+  const uint branching = std::max(2u, static_cast<uint>(glm::ceil(
+    glm::pow(static_cast<float>(config.numNodes), 1.0f / depth))));
+
+  for (uint i = 0; i < config.numNodes; ++i) {
+    kore::SceneNode* node = new kore::SceneNode;
+    std::ostringstream name;
+    name << "BenchmarkNode" << i;
+    node->setName(name.str());
+    idMgr->registerURL(node->getID(), idMgr->genURL(name.str(), "benchmark",
+                                                    i));
+
+    kore::SceneNode* parent = i < branching ? root : nodes[i / branching - 1];
+    parent->addChild(node);
+
+    // Children are placed relative to their parents.
+    const float spread = i < branching ? 100.0f : 10.0f;
+    node->translate(glm::vec3(randomFloat(-spread, spread),
+                              randomFloat(-spread, spread),
+                              randomFloat(-spread, spread)));
+
+    if (!meshes.empty()) {
+      kore::MeshComponent* meshComponent = new kore::MeshComponent;
+      meshComponent->setMesh(meshes[i % meshes.size()]);
+      node->addComponent(meshComponent);
+    }
+
+    if (!materials.empty()) {
+      kore::MaterialComponent* materialComponent =
+        new kore::MaterialComponent;
+      materialComponent->setMaterial(materials[i % materials.size()]);
+      node->addComponent(materialComponent);
+    }
+    nodes.push_back(node);
+  }
+  return nodes;
+}
+
+void setUpRendering(const std::vector<kore::SceneNode*>& nodes,
+                    kore::Camera* camera,
+                    kore::ShaderProgram* shader) {
+  std::vector<GLenum> drawBufs;
+  drawBufs.push_back(GL_COLOR_ATTACHMENT0);
+  kore::FrameBufferStage* backBufferStage = new kore::FrameBufferStage;
+  backBufferStage->setActiveAttachments(drawBufs);
+  backBufferStage->setFrameBuffer(kore::FrameBuffer::BACKBUFFER);
+
+  kore::ShaderProgramPass* programPass = new kore::ShaderProgramPass;
+  programPass->setShaderProgram(shader);
+  programPass->setCullingCamera(camera);
+
+  for (uint i = 0; i < nodes.size(); ++i) {
+    kore::SceneNode* node = nodes[i];
+    kore::MeshComponent* meshComponent =
+      static_cast<kore::MeshComponent*>(node->getComponent(
+                                        kore::COMPONENT_MESH));
+    if (meshComponent == NULL) {
+      continue;
+    }
+
+    kore::NodePass* nodePass = new kore::NodePass(node);
+    nodePass->addOperation(new kore::BindAttribute(
+      meshComponent->getShaderData("v_position"),
+      shader->getAttribute("v_position")));
+    nodePass->addOperation(new kore::BindAttribute(
+      meshComponent->getShaderData("v_normal"),
+      shader->getAttribute("v_normal")));
+    // The per-object matrices change every frame and are streamed, the
+    // material block is only rebuilt when a value of the material changes.
+    nodePass->addOperation(new kore::BindUniformBlock(
+      node->getTransform()->getShaderData("Uniform Buffer"),
+      shader->getUniformBlock("Transform"), true));
+    const kore::SceneNodeComponent* materialComponent =
+      node->getComponent(kore::COMPONENT_MATERIAL);
+    if (materialComponent != NULL) {
+      nodePass->addOperation(new kore::BindUniformBlock(
+        materialComponent->getShaderData("Uniform Buffer"),
+        shader->getUniformBlock("Material")));
+    }
+    nodePass->addOperation(new kore::BindUniform(
+      camera->getShaderData("view Matrix"), shader->getUniform("view")));
+    nodePass->addOperation(new kore::BindUniform(
+      camera->getShaderData("projection Matrix"),
+      shader->getUniform("projection")));
+
+    kore::RenderMesh* renderOp = new kore::RenderMesh();
+    renderOp->connect(meshComponent);
+    nodePass->addOperation(renderOp);
+
+    programPass->addNodePass(nodePass);
+  }
+
+  backBufferStage->addProgramPass(programPass);
+  kore::RenderManager::getInstance()->addFramebufferStage(backBufferStage);
+}
+
+void benchmarkIDManager(const std::vector<kore::SceneNode*>& nodes) {
+  kore::IDManager* idMgr = kore::IDManager::getInstance();
+  SBenchmarkResult& urlResult = getResult("IDManager::getURL");
+  SBenchmarkResult& idResult = getResult("IDManager::getID");
+
+  // Lookups are timed in batches, single lookups are below the clock
+  // resolution.
+  const uint batchSize = 64;
+  const uint numLookups = std::min(static_cast<uint>(nodes.size()), 4096u);
+  std::vector<std::string> urls(numLookups);
+  uint64 checksum = 0;
+
+  for (uint batch = 0; batch < numLookups; batch += batchSize) {
+    const uint end = std::min(batch + batchSize, numLookups);
+    BenchClock::time_point start = BenchClock::now();
+    for (uint i = batch; i < end; ++i) {
+      urls[i] = idMgr->getURL(nodes[i]->getID());
+    }
+    urlResult.samplesMS.push_back(elapsedMS(start) / (end - batch));
+  }
+
+  for (uint batch = 0; batch < numLookups; batch += batchSize) {
+    const uint end = std::min(batch + batchSize, numLookups);
+    BenchClock::time_point start = BenchClock::now();
+    for (uint i = batch; i < end; ++i) {
+      checksum += idMgr->getID(urls[i]);
+    }
+    idResult.samplesMS.push_back(elapsedMS(start) / (end - batch));
+  }
+
+  if (checksum == 0) {
+    kore::Log::getInstance()->write("[WARNING] Benchmark: IDManager "
+                                    "lookups failed\n");
+  }
+}
+
+void benchmarkFrames(const SBenchmarkConfig& config,
+                     const std::vector<kore::SceneNode*>& nodes) {
+  kore::SceneManager* sceneMgr = kore::SceneManager::getInstance();
+  kore::RenderManager* renderMgr = kore::RenderManager::getInstance();
+  const kore::FrameTimer& frameTimer = renderMgr->getFrameTimer();
+  kore::SFrameTimeStats sectionStats;
+
+  SBenchmarkResult& updateResult = getResult("SceneManager::update");
+  SBenchmarkResult& renderResult = getResult("RenderManager::renderFrame");
+  // Sections of renderFrame(), taken from the frame timer of the
+  // RenderManager.
+  SBenchmarkResult& optimizeResult = getResult("RenderManager::optimize");
+  SBenchmarkResult& executeResult = getResult("RenderManager::execute");
+
+  // Every frame, a tenth of the nodes is moved to exercise the transform
+  // and bounds updates.
+  const uint numMoved = std::max(1u, static_cast<uint>(nodes.size()) / 10);
+  uint movedOffset = 0;
+
+  for (uint frame = 0; frame < config.numWarmupFrames + config.numFrames;
+       ++frame) {
+    const bool record = frame >= config.numWarmupFrames;
+    // The last warmup frame is captured, so the capture doesn't distort
+    // the measurements.
+    if (frame + 1 == config.numWarmupFrames && !config.captureFile.empty()) {
+      kore::FrameCapture::getInstance()->requestCapture(config.captureFile);
+    }
+
+    for (uint i = 0; i < numMoved && !nodes.empty(); ++i) {
+      nodes[(movedOffset + i) % nodes.size()]->rotate(
+        1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    movedOffset += numMoved;
+
+    BenchClock::time_point start = BenchClock::now();
+    sceneMgr->update();
+    if (record) updateResult.samplesMS.push_back(elapsedMS(start));
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    start = BenchClock::now();
+    renderMgr->renderFrame();
+    if (record) {
+      renderResult.samplesMS.push_back(elapsedMS(start));
+      if (frameTimer.getSectionStats("RenderManager::optimize",
+                                     sectionStats)) {
+        optimizeResult.samplesMS.push_back(sectionStats.lastMS);
+      }
+      if (frameTimer.getSectionStats("RenderManager::execute",
+                                     sectionStats)) {
+        executeResult.samplesMS.push_back(sectionStats.lastMS);
+      }
+    }
+
+    // Keep the GPU from queueing up frames, so the CPU timings of the next
+    // frame aren't distorted by a full command queue.
+    glFinish();
+    glfwSwapBuffers();
+  }
+}
+
+void writeResults(const SBenchmarkConfig& config) {
+  FILE* pfile = fopen(config.outFile.c_str(), "w");
+  if (pfile == NULL) {
+    kore::Log::getInstance()->write("[ERROR] Benchmark: Could not write "
+                                    "'%s'\n", config.outFile.c_str());
+    return;
+  }
+
+  time_t rawtime;
+  time(&rawtime);
+  char timeBuf[64];
+  strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%dT%H:%M:%S", localtime(&rawtime));
+
+  fprintf(pfile, "{\n");
+  fprintf(pfile, "  \"timestamp\": \"%s\",\n", timeBuf);
+  fprintf(pfile, "  \"renderer\": \"%s\",\n",
+          reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  fprintf(pfile, "  \"glVersion\": \"%s\",\n",
+          reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+  fprintf(pfile, "  \"config\": {\"nodes\": %u, \"meshes\": %u, "
+          "\"materials\": %u, \"depth\": %u, \"frames\": %u},\n",
+          config.numNodes, config.numMeshes, config.numMaterials,
+          config.depth, config.numFrames);
+
+  const kore::GPUMemoryTracker& gpuMemory =
+    kore::ResourceManager::getInstance()->getGPUMemoryTracker();
+  fprintf(pfile, "  \"gpuMemoryPeakBytes\": {");
+  for (uint i = 0; i <= kore::GPUMEM_TOTAL; ++i) {
+    const kore::EGPUMemoryType type = static_cast<kore::EGPUMemoryType>(i);
+    fprintf(pfile, "\"%s\": %llu%s", kore::GPUMemoryTracker::getTypeName(type),
+            static_cast<unsigned long long>(gpuMemory.getPeakUsage(type)),
+            i < kore::GPUMEM_TOTAL ? ", " : "},\n");
+  }
+  fprintf(pfile, "  \"results\": [\n");
+
+  printf("%-30s %10s %10s %10s %10s %10s\n", "benchmark [ms]",
+         "min", "mean", "median", "p95", "max");
+  for (uint i = 0; i < g_results.size(); ++i) {
+    std::vector<double> samples = g_results[i].samplesMS;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (uint j = 0; j < samples.size(); ++j) {
+      sum += samples[j];
+    }
+
+    const uint n = static_cast<uint>(samples.size());
+    const double minMS = n > 0 ? samples.front() : 0.0;
+    const double maxMS = n > 0 ? samples.back() : 0.0;
+    const double meanMS = n > 0 ? sum / n : 0.0;
+    const double medianMS = n > 0 ? samples[(n - 1) / 2] : 0.0;
+    const double p95MS = n > 0 ? samples[((n - 1) * 95) / 100] : 0.0;
+
+    fprintf(pfile, "    {\"name\": \"%s\", \"unit\": \"ms\", "
+            "\"samples\": %u, \"min\": %.6f, \"mean\": %.6f, "
+            "\"median\": %.6f, \"p95\": %.6f, \"max\": %.6f}%s\n",
+            g_results[i].name.c_str(), n, minMS, meanMS, medianMS, p95MS,
+            maxMS, i + 1 < g_results.size() ? "," : "");
+    printf("%-30s %10.4f %10.4f %10.4f %10.4f %10.4f\n",
+           g_results[i].name.c_str(), minMS, meanMS, medianMS, p95MS, maxMS);
+  }
+
+  fprintf(pfile, "  ]\n}\n");
+  fclose(pfile);
+  printf("Results written to %s\n", config.outFile.c_str());
+}
+
+bool parseArguments(int argc, char** argv, SBenchmarkConfig& config) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      printf("Missing value for %s\n", arg.c_str());
+      return false;
+    }
+
+    const char* value = argv[++i];
+    if (arg == "--nodes") {
+      config.numNodes = static_cast<uint>(atoi(value));
+    } else if (arg == "--meshes") {
+      config.numMeshes = static_cast<uint>(atoi(value));
+    } else if (arg == "--materials") {
+      config.numMaterials = static_cast<uint>(atoi(value));
+    } else if (arg == "--depth") {
+      config.depth = static_cast<uint>(atoi(value));
+    } else if (arg == "--frames") {
+      config.numFrames = static_cast<uint>(atoi(value));
+    } else if (arg == "--out") {
+      config.outFile = value;
+    } else if (arg == "--capture") {
+      config.captureFile = value;
+    } else {
+      printf("Unknown argument %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  SBenchmarkConfig config;
+  if (!parseArguments(argc, argv, config)) {
+    printf("Usage: Benchmark [--nodes N] [--meshes M] [--materials K] "
+           "[--depth D] [--frames F] [--out results.json] "
+           "[--capture frame.kcap]\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (!glfwInit()) {
+    kore::Log::getInstance()->write("[ERROR] could not load window manager\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (!glfwOpenWindow(256, 256, 8, 8, 8, 8, 24, 8, GLFW_WINDOW)) {
+    kore::Log::getInstance()->write("[ERROR] could not open render window\n");
+    glfwTerminate();
+    exit(EXIT_FAILURE);
+  }
+  glfwSetWindowTitle("KoRE Benchmark");
+  glfwSwapInterval(0);
+
+  glewExperimental = GL_TRUE;
+  if (glewInit()) {
+    kore::Log::getInstance()->write("[ERROR] could not open initialize "
+                                    "extension manager\n");
+    glfwTerminate();
+    exit(EXIT_FAILURE);
+  }
+
+  kore::RenderManager::getInstance()
+    ->setScreenResolution(glm::ivec2(256, 256));
+  kore::RenderManager::getInstance()
+    ->setViewport(glm::ivec4(0, 0, 256, 256));
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_CULL_FACE);
+
+  kore::ShaderProgram* shader = new kore::ShaderProgram;
+  shader->loadShader("./assets/shader/uniformBlocks.vp", GL_VERTEX_SHADER);
+  shader->loadShader("./assets/shader/uniformBlocks.fp", GL_FRAGMENT_SHADER);
+  shader->init();
+  shader->setName("benchmark shader");
+
+  std::vector<kore::Mesh*> meshes = genMeshes(config);
+  std::vector<kore::Texture*> textures = genTextures(config);
+  std::vector<kore::Material*> materials = genMaterials(config);
+  std::vector<kore::SceneNode*> nodes =
+    genSceneNodes(config, meshes, materials);
+
+  // The camera looks at the scene from outside, so part of it is culled.
+  kore::SceneNode* cameraNode = new kore::SceneNode;
+  cameraNode->setName("BenchmarkCamera");
+  kore::Camera* camera = new kore::Camera;
+  camera->setProjectionPersp(60.0f, 1.0f, 0.1f, 1000.0f);
+  cameraNode->addComponent(camera);
+  kore::SceneManager::getInstance()->addCamera(camera);
+  kore::SceneManager::getInstance()->getRootNode()->addChild(cameraNode);
+  cameraNode->translate(glm::vec3(0.0f, 0.0f, 150.0f));
+
+  setUpRendering(nodes, camera, shader);
+
+  benchmarkIDManager(nodes);
+  benchmarkFrames(config, nodes);
+  writeResults(config);
+
+  glfwTerminate();
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HeadlessContext.h"
+
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <string.h>
+
+#include "KoRE/Log.h"
+
+namespace {
+  EGLDisplay g_display = EGL_NO_DISPLAY;
+  EGLContext g_context = EGL_NO_CONTEXT;
+
+  bool createContext(const int major, const int minor) {
+    // Prefer Mesa's surfaceless platform, which needs neither an X server
+    // nor a render node.
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY,
+                                                  EGL_EXTENSIONS);
+    if (clientExtensions != NULL
+        && strstr(clientExtensions,
+                  "EGL_MESA_platform_surfaceless") != NULL) {
+      PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+          eglGetProcAddress("eglGetPlatformDisplayEXT"));
+      if (getPlatformDisplay != NULL) {
+        g_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                       EGL_DEFAULT_DISPLAY, NULL);
+      }
+    }
+    if (g_display == EGL_NO_DISPLAY) {
+      g_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint eglMajor = 0;
+    EGLint eglMinor = 0;
+    if (g_display == EGL_NO_DISPLAY
+        || !eglInitialize(g_display, &eglMajor, &eglMinor)
+        || !eglBindAPI(EGL_OPENGL_API)) {
+      return false;
+    }
+
+    const EGLint configAttribs[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_NONE
+    };
+    EGLConfig eglConfig;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(g_display, configAttribs, &eglConfig, 1,
+                         &numConfigs)
+        || numConfigs == 0) {
+      return false;
+    }
+
+    const EGLint contextAttribs[] = {
+      EGL_CONTEXT_MAJOR_VERSION_KHR, major,
+      EGL_CONTEXT_MINOR_VERSION_KHR, minor,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,
+      EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+      EGL_NONE
+    };
+    g_context = eglCreateContext(g_display, eglConfig, EGL_NO_CONTEXT,
+                                 contextAttribs);
+    if (g_context == EGL_NO_CONTEXT) {
+      return false;
+    }
+
+    return eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                          g_context) == EGL_TRUE;
+  }
+}
+
+bool createHeadlessContext(const int major, const int minor) {
+  if (!createContext(major, minor)) {
+    kore::Log::getInstance()->write("[ERROR] could not create an offscreen "
+                                    "GL %i.%i context\n", major, minor);
+    destroyHeadlessContext();
+    return false;
+  }
+
+  // GLEW builds for GLX report a missing X display after loading the GL
+  // entry points, which is expected without a window system.
+  glewExperimental = GL_TRUE;
+  const GLenum glewError = glewInit();
+  if (glewError != GLEW_OK
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+      && glewError != GLEW_ERROR_NO_GLX_DISPLAY
+#endif
+      ) {
+    kore::Log::getInstance()->write("[ERROR] could not open initialize "
+                                    "extension manager\n");
+    destroyHeadlessContext();
+    return false;
+  }
+  // A core context reports GL_INVALID_ENUM from glewInit.
+  glGetError();
+  return true;
+}
+
+void destroyHeadlessContext(void) {
+  if (g_display != EGL_NO_DISPLAY) {
+    eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    if (g_context != EGL_NO_CONTEXT) {
+      eglDestroyContext(g_display, g_context);
+      g_context = EGL_NO_CONTEXT;
+    }
+    eglTerminate(g_display);
+    g_display = EGL_NO_DISPLAY;
+  }
+}
@@ -0,0 +1,35 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_DEMOS_COMMON_HEADLESSCONTEXT_H_
+#define KORE_DEMOS_COMMON_HEADLESSCONTEXT_H_
+
+// Offscreen GL context for the demos that run without a window, e.g. on
+// build servers with Mesa's llvmpipe. The context is created through EGL on
+// Mesa's surfaceless platform and has no default framebuffer, so everything
+// has to be rendered into FBOs.
+
+/// Creates a core profile context of the given version, makes it current
+/// and initializes GLEW. Returns false if any of these steps fails.
+bool createHeadlessContext(const int major, const int minor);
+
+/// Releases and destroys the context created by createHeadlessContext().
+void destroyHeadlessContext(void);
+
+#endif  // KORE_DEMOS_COMMON_HEADLESSCONTEXT_H_
@@ -0,0 +1,349 @@
+/*
+ Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Renders a scene without a window into an offscreen framebuffer, writes
+// the final image as PNG and prints frame-time statistics. Meant for
+// automated performance and regression runs on machines without a GPU,
+// e.g. with Mesa's llvmpipe.
+// Usage: Headless [--scene file.dae] [--texture file.png] [--width W]
+//                 [--height H] [--frames F] [--out image.png]
+// Run from the repository root, so the shaders in ./assets are found.
+// The context is created through EGL on Mesa's surfaceless platform.
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../Common/HeadlessContext.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/Log.h"
+#include "KoRE/ShaderProgram.h"
+#include "KoRE/Texture.h"
+#include "KoRE/FrameBuffer.h"
+#include "KoRE/FrameTimer.h"
+#include "KoRE/SceneNode.h"
+#include "KoRE/SceneManager.h"
+#include "KoRE/ResourceManager.h"
+#include "KoRE/RenderManager.h"
+#include "KoRE/Components/Camera.h"
+#include "KoRE/Components/LightComponent.h"
+#include "KoRE/Components/MeshComponent.h"
+#include "KoRE/Components/TexturesComponent.h"
+#include "KoRE/Loader/lodepng.h"
+#include "KoRE/Operations/ClearOp.h"
+#include "KoRE/Operations/RenderMesh.h"
+#include "KoRE/Operations/BindOperations/BindAttribute.h"
+#include "KoRE/Operations/BindOperations/BindUniform.h"
+#include "KoRE/Operations/BindOperations/BindTexture.h"
+#include "KoRE/Passes/FrameBufferStage.h"
+#include "KoRE/Passes/ShaderProgramPass.h"
+#include "KoRE/Passes/NodePass.h"
+
+struct SHeadlessConfig {
+  SHeadlessConfig()
+    : sceneFile("./assets/meshes/TestEnv.dae"),
+      textureFile("./assets/textures/Crate.png"),
+      outFile("headless.png"),
+      width(800),
+      height(600),
+      numFrames(100),
+      numWarmupFrames(10) {
+  }
+
+  std::string sceneFile;
+  std::string textureFile;
+  std::string outFile;
+  uint width;
+  uint height;
+  uint numFrames;
+  uint numWarmupFrames;
+};
+
+bool parseArguments(int argc, char** argv, SHeadlessConfig& config) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      printf("Missing value for %s\n", arg.c_str());
+      return false;
+    }
+
+    const char* value = argv[++i];
+    if (arg == "--scene") {
+      config.sceneFile = value;
+    } else if (arg == "--texture") {
+      config.textureFile = value;
+    } else if (arg == "--width") {
+      config.width = static_cast<uint>(atoi(value));
+    } else if (arg == "--height") {
+      config.height = static_cast<uint>(atoi(value));
+    } else if (arg == "--frames") {
+      config.numFrames = static_cast<uint>(atoi(value));
+    } else if (arg == "--out") {
+      config.outFile = value;
+    } else {
+      printf("Unknown argument %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return config.width > 0 && config.height > 0;
+}
+
+kore::FrameBuffer* createRenderTarget(const SHeadlessConfig& config) {
+  kore::FrameBuffer* target = new kore::FrameBuffer("HeadlessTarget");
+
+  kore::STextureProperties colorProps;
+  colorProps.width = config.width;
+  colorProps.height = config.height;
+  colorProps.targetType = GL_TEXTURE_2D;
+  colorProps.format = GL_RGBA;
+  colorProps.internalFormat = GL_RGBA8;
+  colorProps.pixelType = GL_UNSIGNED_BYTE;
+  target->addTextureAttachment(colorProps, "HeadlessColor",
+                               GL_COLOR_ATTACHMENT0);
+
+  kore::STextureProperties depthProps = colorProps;
+  depthProps.format = GL_DEPTH_COMPONENT;
+  depthProps.internalFormat = GL_DEPTH_COMPONENT24;
+  depthProps.pixelType = GL_FLOAT;
+  target->addTextureAttachment(depthProps, "HeadlessDepth",
+                               GL_DEPTH_ATTACHMENT);
+
+  if (!target->checkFBOcompleteness()) {
+    KORE_SAFE_DELETE(target);
+    return NULL;
+  }
+  kore::ResourceManager::getInstance()->addFramebuffer(target);
+  return target;
+}
+
+void setUpRendering(kore::FrameBuffer* target, kore::Camera* camera,
+                    kore::LightComponent* light, kore::Texture* texture,
+                    kore::ShaderProgram* shader) {
+  std::vector<kore::SceneNode*> renderNodes;
+  kore::SceneManager::getInstance()->
+    getSceneNodesByComponent(kore::COMPONENT_MESH, renderNodes);
+
+  std::vector<GLenum> drawBufs;
+  drawBufs.push_back(GL_COLOR_ATTACHMENT0);
+  kore::FrameBufferStage* stage = new kore::FrameBufferStage;
+  stage->setFrameBuffer(target);
+  stage->setActiveAttachments(drawBufs);
+  stage->addStartupOperation(
+    new kore::ClearOp(true, true, false, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)));
+
+  kore::ShaderProgramPass* programPass = new kore::ShaderProgramPass;
+  programPass->setShaderProgram(shader);
+
+  for (uint i = 0; i < renderNodes.size(); ++i) {
+    kore::SceneNode* node = renderNodes[i];
+    kore::MeshComponent* meshComponent =
+      static_cast<kore::MeshComponent*>(node->getComponent(
+                                        kore::COMPONENT_MESH));
+
+    kore::TexturesComponent* texComponent = new kore::TexturesComponent;
+    texComponent->addTexture(texture);
+    node->addComponent(texComponent);
+
+    kore::NodePass* nodePass = new kore::NodePass(node);
+    nodePass->addOperation(new kore::BindAttribute(
+      meshComponent->getShaderData("v_position"),
+      shader->getAttribute("v_position")));
+    nodePass->addOperation(new kore::BindAttribute(
+      meshComponent->getShaderData("v_normal"),
+      shader->getAttribute("v_normal")));
+    nodePass->addOperation(new kore::BindAttribute(
+      meshComponent->getShaderData("v_uv0"),
+      shader->getAttribute("v_uv0")));
+    nodePass->addOperation(new kore::BindUniform(
+      node->getTransform()->getShaderData("model Matrix"),
+      shader->getUniform("model")));
+    nodePass->addOperation(new kore::BindUniform(
+      camera->getShaderData("view Matrix"), shader->getUniform("view")));
+    nodePass->addOperation(new kore::BindUniform(
+      camera->getShaderData("projection Matrix"),
+      shader->getUniform("projection")));
+    if (light != NULL) {
+      nodePass->addOperation(new kore::BindUniform(
+        light->getShaderData("position"),
+        shader->getUniform("pointlightPos")));
+    }
+    nodePass->addOperation(new kore::BindTexture(
+      texComponent->getShaderData(texture->getName()),
+      shader->getUniform("tex")));
+
+    kore::RenderMesh* renderOp = new kore::RenderMesh();
+    renderOp->connect(meshComponent);
+    nodePass->addOperation(renderOp);
+
+    programPass->addNodePass(nodePass);
+  }
+
+  stage->addProgramPass(programPass);
+  kore::RenderManager::getInstance()->addFramebufferStage(stage);
+}
+
+bool writeImage(const SHeadlessConfig& config, kore::FrameBuffer* target) {
+  std::vector<unsigned char> pixels(config.width * config.height * 4);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, target->getHandle());
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, config.width, config.height, GL_RGBA, GL_UNSIGNED_BYTE,
+               &pixels[0]);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+  // GL rows start at the bottom, PNG rows at the top.
+  const uint rowSize = config.width * 4;
+  std::vector<unsigned char> flipped(pixels.size());
+  for (uint y = 0; y < config.height; ++y) {
+    memcpy(&flipped[y * rowSize],
+           &pixels[(config.height - 1 - y) * rowSize], rowSize);
+  }
+
+  const unsigned error = lodepng::encode(config.outFile, flipped,
+                                         config.width, config.height);
+  if (error != 0) {
+    kore::Log::getInstance()->write("[ERROR] Headless: Could not write '%s': "
+                                    "%s\n", config.outFile.c_str(),
+                                    lodepng_error_text(error));
+    return false;
+  }
+  return true;
+}
+
+void printStats(const char* name, const kore::SFrameTimeStats& stats) {
+  printf("%-30s %8.3f %8.3f %8.3f %8.3f %8.3f\n", name, stats.minMS,
+         stats.avgMS, stats.p50MS, stats.p95MS, stats.maxMS);
+}
+
+int main(int argc, char** argv) {
+  SHeadlessConfig config;
+  if (!parseArguments(argc, argv, config)) {
+    printf("Usage: Headless [--scene file.dae] [--texture file.png] "
+           "[--width W] [--height H] [--frames F] [--out image.png]\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (!createHeadlessContext(3, 3)) {
+    exit(EXIT_FAILURE);
+  }
+
+#if KORE_GL_ERROR_CHECKS
+  kore::GLerror::installDebugCallback();
+  kore::GLerror::setDebugAnnotationsEnabled(true);
+#endif
+
+  kore::Log::getInstance()
+    ->write("Render Device: %s\n",
+            reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  kore::Log::getInstance()
+    ->write("OpenGL version: %s\n",
+            reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+  kore::RenderManager* renderMgr = kore::RenderManager::getInstance();
+  renderMgr->setScreenResolution(glm::ivec2(config.width, config.height));
+  renderMgr->setViewport(glm::ivec4(0, 0, config.width, config.height));
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_CULL_FACE);
+  glCullFace(GL_BACK);
+
+  kore::FrameBuffer* target = createRenderTarget(config);
+  if (target == NULL) {
+    kore::Log::getInstance()->write("[ERROR] Headless: Could not create the "
+                                    "render target\n");
+    destroyHeadlessContext();
+    exit(EXIT_FAILURE);
+  }
+
+  kore::ShaderProgram* shader = new kore::ShaderProgram;
+  shader->loadShader("./assets/shader/normalColor.vp", GL_VERTEX_SHADER);
+  shader->loadShader("./assets/shader/normalColor.fp", GL_FRAGMENT_SHADER);
+  shader->init();
+  shader->setName("headless shader");
+
+  kore::ResourceManager::getInstance()->loadScene(config.sceneFile);
+  kore::Texture* texture =
+    kore::ResourceManager::getInstance()->loadTexture(config.textureFile);
+
+  kore::SceneManager* sceneMgr = kore::SceneManager::getInstance();
+  kore::SceneNode* cameraNode =
+    sceneMgr->getSceneNodeByComponent(kore::COMPONENT_CAMERA);
+  if (cameraNode == NULL || texture == NULL) {
+    kore::Log::getInstance()->write("[ERROR] Headless: The scene needs a "
+                                    "camera and the texture has to load\n");
+    destroyHeadlessContext();
+    exit(EXIT_FAILURE);
+  }
+  kore::Camera* camera = static_cast<kore::Camera*>(
+    cameraNode->getComponent(kore::COMPONENT_CAMERA));
+  camera->setAspectRatio(static_cast<float>(config.width) /
+                         static_cast<float>(config.height));
+
+  kore::SceneNode* lightNode =
+    sceneMgr->getSceneNodeByComponent(kore::COMPONENT_LIGHT);
+  kore::LightComponent* light = lightNode == NULL ? NULL :
+    static_cast<kore::LightComponent*>(
+      lightNode->getComponent(kore::COMPONENT_LIGHT));
+
+  setUpRendering(target, camera, light, texture, shader);
+
+  kore::FrameTimer frameTimer;
+  for (uint frame = 0; frame < config.numWarmupFrames + config.numFrames;
+       ++frame) {
+    if (frame == config.numWarmupFrames) {
+      frameTimer.reset();
+      renderMgr->getFrameTimer().reset();
+    }
+
+    sceneMgr->update();
+    renderMgr->renderFrame();
+
+    // Without a swap chain nothing paces the frames, so wait for the GPU
+    // to measure whole frames.
+    glFinish();
+    frameTimer.endFrame();
+  }
+
+  const bool imageWritten = writeImage(config, target);
+
+  printf("%u frames at %ux%u on %s\n", config.numFrames, config.width,
+         config.height,
+         reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  printf("%-30s %8s %8s %8s %8s %8s\n", "[ms]", "min", "mean", "median",
+         "p95", "max");
+  kore::SFrameTimeStats stats;
+  frameTimer.getFrameStats(stats);
+  printStats("frame", stats);
+
+  std::vector<std::string> sections;
+  renderMgr->getFrameTimer().getSectionNames(sections);
+  for (uint i = 0; i < sections.size(); ++i) {
+    renderMgr->getFrameTimer().getSectionStats(sections[i], stats);
+    printStats(sections[i].c_str(), stats);
+  }
+
+  kore::Log::getInstance()->flush();
+  destroyHeadlessContext();
+  exit(imageWritten ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -51,6 +51,7 @@
 #include "Kore/Passes/ShaderProgramPass.h"
 #include "KoRE/Passes/NodePass.h"
 #include "KoRE/Events.h"
+#include "KoRE/FrameCapture.h"
 #include "Kore/Operations/OperationFactory.h"
 #include "iostream"
 
@@ -287,6 +288,12 @@ int main(void) {
             reinterpret_cast<const char*>(
             glewGetString(GLEW_VERSION)));
 
+#if KORE_GL_ERROR_CHECKS
+  // Report GL errors through KHR_debug instead of glGetError in every op
+  kore::GLerror::installDebugCallback();
+  kore::GLerror::setDebugAnnotationsEnabled(true);
+#endif
+
   // enable culling and depthtest
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_CULL_FACE);
@@ -408,6 +415,12 @@ int main(void) {
   //////////////////////////////////////////////////////////////////////////
   //*/
     
+  // Video memory per resource type and scene, and the largest assets.
+  resourceManager->getGPUMemoryTracker().logReport();
+
+  bool captureKeyDown = false;
+  bool annotationKeyDown = false;
+
   // Main loop
   while (running) {
     time = the_timer.timeSinceLastCall();
@@ -447,6 +460,19 @@ int main(void) {
     oldMouseX = mouseX;
     oldMouseY = mouseY;
 
+    // F12 captures the next frame for the Replay tool.
+    if (glfwGetKey(GLFW_KEY_F12) == GLFW_PRESS && !captureKeyDown) {
+      kore::FrameCapture::getInstance()->requestCapture("frame.kcap");
+    }
+    captureKeyDown = glfwGetKey(GLFW_KEY_F12) == GLFW_PRESS;
+
+    // F11 toggles debug labels and groups for graphics debuggers.
+    if (glfwGetKey(GLFW_KEY_F11) == GLFW_PRESS && !annotationKeyDown) {
+      kore::GLerror::setDebugAnnotationsEnabled(
+        !kore::GLerror::areDebugAnnotationsEnabled());
+    }
+    annotationKeyDown = glfwGetKey(GLFW_KEY_F11) == GLFW_PRESS;
+
     if (rotationNode) {
       rotationNode->rotate(90.0f * static_cast<float>(time), glm::vec3(0.0f, 0.0f, 1.0f));
     }
@@ -0,0 +1,213 @@
+/*
+ Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Replays frames captured with kore::FrameCapture and reports their timings.
+// Several captures, e.g. of the same scene with different optimizers, are
+// replayed one after another for comparison.
+// Usage: Replay [--frames F] [--width W] [--height H] a.kcap [b.kcap ...]
+// Runs without a window in an offscreen context, like the Headless demo.
+// Commands that target the window render into an offscreen framebuffer of
+// the given size. Set LIBGL_ALWAYS_SOFTWARE=1 to replay on Mesa's software
+// rasterizer.
+
+#include <GL/glew.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "../Common/HeadlessContext.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/Log.h"
+#include "KoRE/FrameReplay.h"
+#include "KoRE/FrameTimer.h"
+
+struct SReplayConfig {
+  SReplayConfig()
+    : numFrames(500),
+      numWarmupFrames(20),
+      width(800),
+      height(600) {
+  }
+
+  uint numFrames;
+  uint numWarmupFrames;
+  int width;
+  int height;
+  std::vector<std::string> captureFiles;
+};
+
+bool parseArguments(int argc, char** argv, SReplayConfig& config) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 2, "--") != 0) {
+      config.captureFiles.push_back(arg);
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      printf("Missing value for %s\n", arg.c_str());
+      return false;
+    }
+
+    const char* value = argv[++i];
+    if (arg == "--frames") {
+      config.numFrames = static_cast<uint>(atoi(value));
+    } else if (arg == "--width") {
+      config.width = atoi(value);
+    } else if (arg == "--height") {
+      config.height = atoi(value);
+    } else {
+      printf("Unknown argument %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return !config.captureFiles.empty();
+}
+
+/// Stand-in for the window's framebuffer, which a surfaceless context
+/// doesn't have.
+struct SOffscreenTarget {
+  SOffscreenTarget(void)
+    : fbo(0),
+      color(0),
+      depthStencil(0) {
+  }
+
+  GLuint fbo;
+  GLuint color;
+  GLuint depthStencil;
+};
+
+bool createOffscreenTarget(const SReplayConfig& config,
+                           SOffscreenTarget& target) {
+  glGenRenderbuffers(1, &target.color);
+  glBindRenderbuffer(GL_RENDERBUFFER, target.color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config.width,
+                        config.height);
+  glGenRenderbuffers(1, &target.depthStencil);
+  glBindRenderbuffer(GL_RENDERBUFFER, target.depthStencil);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, config.width,
+                        config.height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &target.fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, target.color);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, target.depthStencil);
+  const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER)
+                        == GL_FRAMEBUFFER_COMPLETE;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  return complete;
+}
+
+void destroyOffscreenTarget(SOffscreenTarget& target) {
+  glDeleteFramebuffers(1, &target.fbo);
+  glDeleteRenderbuffers(1, &target.color);
+  glDeleteRenderbuffers(1, &target.depthStencil);
+  target = SOffscreenTarget();
+}
+
+/// Replays one capture and prints the CPU submission time and the frame
+/// time including the GPU work.
+void replayCapture(const SReplayConfig& config, const std::string& file,
+                   const SOffscreenTarget& target) {
+  kore::FrameReplay replay;
+  replay.setDefaultFramebuffer(target.fbo);
+  if (!replay.load(file)) {
+    return;
+  }
+
+  kore::FrameTimer timer;
+  const uint submitSection = timer.getSectionID("submit");
+
+  for (uint frame = 0; frame < config.numWarmupFrames + config.numFrames;
+       ++frame) {
+    if (frame == config.numWarmupFrames) {
+      timer.reset();
+    }
+
+    timer.beginSection(submitSection);
+    replay.execute();
+    timer.endSection(submitSection);
+
+    // Wait for the GPU, so the frame time covers the whole frame.
+    glFinish();
+    timer.endFrame();
+  }
+
+  kore::SFrameTimeStats frameStats;
+  kore::SFrameTimeStats submitStats;
+  timer.getFrameStats(frameStats);
+  timer.getSectionStats("submit", submitStats);
+
+  printf("%s: %u commands, %u draw calls, %u skipped\n", file.c_str(),
+         replay.getNumCommands(), replay.getNumDrawCalls(),
+         replay.getNumSkipped());
+  printf("  %-8s avg %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f ms\n", "submit",
+         submitStats.avgMS, submitStats.p50MS, submitStats.p95MS,
+         submitStats.maxMS);
+  printf("  %-8s avg %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f ms\n", "frame",
+         frameStats.avgMS, frameStats.p50MS, frameStats.p95MS,
+         frameStats.maxMS);
+
+  replay.destroy();
+}
+
+int main(int argc, char** argv) {
+  SReplayConfig config;
+  if (!parseArguments(argc, argv, config)) {
+    printf("Usage: Replay [--frames F] [--width W] [--height H] "
+           "a.kcap [b.kcap ...]\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Captures may contain compute dispatches, which need GL 4.3.
+  if (!createHeadlessContext(4, 3)) {
+    exit(EXIT_FAILURE);
+  }
+
+#if KORE_GL_ERROR_CHECKS
+  kore::GLerror::installDebugCallback();
+#endif
+
+  printf("Renderer: %s\n",
+         reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  SOffscreenTarget target;
+  if (!createOffscreenTarget(config, target)) {
+    kore::Log::getInstance()->write("[ERROR] Replay: Could not create the "
+                                    "offscreen framebuffer\n");
+    destroyOffscreenTarget(target);
+    destroyHeadlessContext();
+    exit(EXIT_FAILURE);
+  }
+
+  for (uint i = 0; i < config.captureFiles.size(); ++i) {
+    replayCapture(config, config.captureFiles[i], target);
+  }
+
+  destroyOffscreenTarget(target);
+  kore::Log::getInstance()->flush();
+  destroyHeadlessContext();
+  exit(EXIT_SUCCESS);
+}
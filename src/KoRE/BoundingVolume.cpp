@@ -0,0 +1,218 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KORE_BOUNDS_SSE
+#endif
+#include "KoRE/BoundingVolume.h"
+
+kore::SAABB kore::SAABB::transform(const glm::mat4& mat) const {
+  if (isEmpty()) {
+    return SAABB();
+  }
+
+  // Transform center and extents (Arvo). The extents are transformed by
+  // the absolute values of the 3x3 part.
+  const glm::vec3 center = getCenter();
+  const glm::vec3 extents = getExtents();
+  const glm::vec3 newCenter = glm::vec3(mat * glm::vec4(center, 1.0f));
+  glm::vec3 newExtents(0.0f);
+  for (int col = 0; col < 3; ++col) {
+    newExtents += glm::abs(glm::vec3(mat[col])) * extents[col];
+  }
+  return SAABB(newCenter - newExtents, newCenter + newExtents);
+}
+
+bool kore::SAABB::intersects(const glm::vec3& center,
+                             const float radius) const {
+  if (isEmpty()) {
+    return false;
+  }
+  const glm::vec3 closest = glm::clamp(center, min, max);
+  const glm::vec3 diff = closest - center;
+  return glm::dot(diff, diff) <= radius * radius;
+}
+
+bool kore::SAABB::intersectsRay(const glm::vec3& origin,
+                                const glm::vec3& invDir,
+                                const float maxDist,
+                                float& outDist) const {
+  if (isEmpty()) {
+    return false;
+  }
+  const glm::vec3 t0 = (min - origin) * invDir;
+  const glm::vec3 t1 = (max - origin) * invDir;
+  const glm::vec3 tNear = glm::min(t0, t1);
+  const glm::vec3 tFar = glm::max(t0, t1);
+  const float tEnter = glm::max(glm::max(tNear.x, tNear.y),
+                                glm::max(tNear.z, 0.0f));
+  const float tExit = glm::min(glm::min(tFar.x, tFar.y),
+                               glm::min(tFar.z, maxDist));
+  outDist = tEnter;
+  return tEnter <= tExit;
+}
+
+void kore::SFrustum::setFromMatrix(const glm::mat4& viewProj) {
+  // Rows of the column-major matrix.
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; ++i) {
+    rows[i] = glm::vec4(viewProj[0][i], viewProj[1][i],
+                        viewProj[2][i], viewProj[3][i]);
+  }
+
+  planes[0] = rows[3] + rows[0];  // left
+  planes[1] = rows[3] - rows[0];  // right
+  planes[2] = rows[3] + rows[1];  // bottom
+  planes[3] = rows[3] - rows[1];  // top
+  planes[4] = rows[3] + rows[2];  // near
+  planes[5] = rows[3] - rows[2];  // far
+
+  for (int i = 0; i < 6; ++i) {
+    const float len = glm::length(glm::vec3(planes[i]));
+    if (len > 0.0f) {
+      planes[i] /= len;
+    }
+  }
+}
+
+bool kore::SFrustum::intersects(const SAABB& aabb) const {
+  if (aabb.isEmpty()) {
+    return false;
+  }
+
+  const glm::vec3 center = aabb.getCenter();
+  const glm::vec3 extents = aabb.getExtents();
+  for (int i = 0; i < 6; ++i) {
+    const glm::vec3 normal(planes[i]);
+    const float dist = glm::dot(normal, center) + planes[i].w;
+    const float radius = glm::dot(glm::abs(normal), extents);
+    if (dist < -radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+kore::SFrustum::EClassification
+  kore::SFrustum::classify(const SAABB& aabb) const {
+  if (aabb.isEmpty()) {
+    return OUTSIDE;
+  }
+
+  const glm::vec3 center = aabb.getCenter();
+  const glm::vec3 extents = aabb.getExtents();
+  EClassification result = INSIDE;
+  for (int i = 0; i < 6; ++i) {
+    const glm::vec3 normal(planes[i]);
+    const float dist = glm::dot(normal, center) + planes[i].w;
+    const float radius = glm::dot(glm::abs(normal), extents);
+    if (dist < -radius) {
+      return OUTSIDE;
+    }
+    if (dist < radius) {
+      result = INTERSECTING;
+    }
+  }
+  return result;
+}
+
+bool kore::SFrustum::intersects(const SBoundingSphere& sphere) const {
+  if (sphere.isEmpty()) {
+    return false;
+  }
+
+  for (int i = 0; i < 6; ++i) {
+    const float dist = glm::dot(glm::vec3(planes[i]), sphere.center)
+                       + planes[i].w;
+    if (dist < -sphere.radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+kore::SAABB kore::BoundingVolumeUtil::computeAABB(const float* positions,
+                                                  const uint numPositions,
+                                                  const uint stride) {
+  SAABB aabb;
+  if (!positions || numPositions == 0) {
+    return aabb;
+  }
+
+  uint i = 0;
+#ifdef KORE_BOUNDS_SSE
+  // Reduce four positions per iteration. Each position is loaded as
+  // (x, y, z, x'), the fourth lane is ignored.
+  if (stride >= 3 && numPositions > 4) {
+    __m128 minV = _mm_set1_ps(FLT_MAX);
+    __m128 maxV = _mm_set1_ps(-FLT_MAX);
+    // The last position is handled by the scalar loop, so the 4-float load
+    // never reads past the end of the array.
+    const uint numSIMD = (numPositions - 1) & ~3u;
+    for (; i < numSIMD; i += 4) {
+      const float* p = positions + i * stride;
+      const __m128 p0 = _mm_loadu_ps(p);
+      const __m128 p1 = _mm_loadu_ps(p + stride);
+      const __m128 p2 = _mm_loadu_ps(p + 2 * stride);
+      const __m128 p3 = _mm_loadu_ps(p + 3 * stride);
+      minV = _mm_min_ps(minV, _mm_min_ps(_mm_min_ps(p0, p1),
+                                         _mm_min_ps(p2, p3)));
+      maxV = _mm_max_ps(maxV, _mm_max_ps(_mm_max_ps(p0, p1),
+                                         _mm_max_ps(p2, p3)));
+    }
+    float minF[4], maxF[4];
+    _mm_storeu_ps(minF, minV);
+    _mm_storeu_ps(maxF, maxV);
+    aabb.min = glm::vec3(minF[0], minF[1], minF[2]);
+    aabb.max = glm::vec3(maxF[0], maxF[1], maxF[2]);
+  }
+#endif
+
+  for (; i < numPositions; ++i) {
+    const float* p = positions + i * stride;
+    aabb.extend(glm::vec3(p[0], p[1], p[2]));
+  }
+  return aabb;
+}
+
+kore::SBoundingSphere
+  kore::BoundingVolumeUtil::computeSphere(const float* positions,
+                                          const uint numPositions,
+                                          const SAABB& aabb,
+                                          const uint stride) {
+  SBoundingSphere sphere;
+  if (!positions || numPositions == 0 || aabb.isEmpty()) {
+    return sphere;
+  }
+
+  sphere.center = aabb.getCenter();
+  float maxDistSq = 0.0f;
+  for (uint i = 0; i < numPositions; ++i) {
+    const float* p = positions + i * stride;
+    const glm::vec3 diff = glm::vec3(p[0], p[1], p[2]) - sphere.center;
+    const float distSq = glm::dot(diff, diff);
+    if (distSq > maxDistSq) {
+      maxDistSq = distSq;
+    }
+  }
+  sphere.radius = glm::sqrt(maxDistSq);
+  return sphere;
+}
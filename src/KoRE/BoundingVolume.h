@@ -0,0 +1,157 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_BOUNDINGVOLUME_H_
+#define KORE_SRC_KORE_BOUNDINGVOLUME_H_
+
+#include <cfloat>
+#include <glm/glm.hpp>
+#include "KoRE/Common.h"
+
+namespace kore {
+  /*! \brief An axis-aligned bounding box. A box with min > max is empty. */
+  struct SAABB {
+    SAABB(void)
+      : min(FLT_MAX),
+        max(-FLT_MAX) {
+    }
+
+    SAABB(const glm::vec3& minimum, const glm::vec3& maximum)
+      : min(minimum),
+        max(maximum) {
+    }
+
+    inline bool isEmpty() const {
+      return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    inline glm::vec3 getCenter() const {return (min + max) * 0.5f;}
+    inline glm::vec3 getExtents() const {return (max - min) * 0.5f;}
+
+    inline void extend(const glm::vec3& point) {
+      min = glm::min(min, point);
+      max = glm::max(max, point);
+    }
+
+    inline void extend(const SAABB& other) {
+      min = glm::min(min, other.min);
+      max = glm::max(max, other.max);
+    }
+
+    inline float getSurfaceArea() const {
+      if (isEmpty()) {
+        return 0.0f;
+      }
+      const glm::vec3 d = max - min;
+      return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    inline bool intersects(const SAABB& other) const {
+      return min.x <= other.max.x && max.x >= other.min.x
+          && min.y <= other.max.y && max.y >= other.min.y
+          && min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    inline bool operator==(const SAABB& other) const {
+      return min == other.min && max == other.max;
+    }
+
+    inline bool operator!=(const SAABB& other) const {
+      return !(*this == other);
+    }
+
+    /*! \brief Returns true if the sphere overlaps the box. */
+    bool intersects(const glm::vec3& center, const float radius) const;
+
+    /*! \brief Slab test of a ray against the box.
+    *   \param origin The origin of the ray.
+    *   \param invDir The component-wise inverse of the ray direction.
+    *   \param maxDist The maximum distance along the ray.
+    *   \param outDist Receives the distance of the entry point.
+    *   \return True if the ray hits the box within [0, maxDist]. */
+    bool intersectsRay(const glm::vec3& origin, const glm::vec3& invDir,
+                       const float maxDist, float& outDist) const;
+
+    /*! \brief Returns the box enclosing this box after transformation. */
+    SAABB transform(const glm::mat4& mat) const;
+
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+
+  /*! \brief A bounding sphere. A negative radius marks an empty sphere. */
+  struct SBoundingSphere {
+    SBoundingSphere(void)
+      : center(0.0f),
+        radius(-1.0f) {
+    }
+
+    inline bool isEmpty() const {return radius < 0.0f;}
+
+    glm::vec3 center;
+    float radius;
+  };
+
+  /*! \brief Six world-space planes (n, d) of a view frustum, in the order
+  *          left, right, bottom, top, near, far. A point p is inside a
+  *          plane if dot(n, p) + d >= 0. The normals are normalized.
+  */
+  struct SFrustum {
+    /*! \brief Extracts the planes from a (view-)projection matrix. */
+    void setFromMatrix(const glm::mat4& viewProj);
+
+    enum EClassification {
+      OUTSIDE,
+      INTERSECTING,
+      INSIDE
+    };
+
+    /*! \brief Returns false if the box is completely outside of one plane.*/
+    bool intersects(const SAABB& aabb) const;
+
+    /*! \brief Classifies a box as outside, partly inside or completely
+    *          inside of the frustum. */
+    EClassification classify(const SAABB& aabb) const;
+
+    /*! \brief Returns false if the sphere is completely outside of one
+    *          plane. */
+    bool intersects(const SBoundingSphere& sphere) const;
+
+    glm::vec4 planes[6];
+  };
+
+  class BoundingVolumeUtil {
+  public:
+    /*! \brief Computes the bounding box of a list of positions.
+    *   \param positions Pointer to the x-coordinate of the first position.
+    *   \param numPositions The number of positions.
+    *   \param stride The number of floats between two positions. */
+    static SAABB computeAABB(const float* positions,
+                             const uint numPositions,
+                             const uint stride = 3);
+
+    /*! \brief Computes a bounding sphere around the center of a box that
+    *          encloses all positions. */
+    static SBoundingSphere computeSphere(const float* positions,
+                                         const uint numPositions,
+                                         const SAABB& aabb,
+                                         const uint stride = 3);
+  };
+};
+#endif  // KORE_SRC_KORE_BOUNDINGVOLUME_H_
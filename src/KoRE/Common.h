@@ -55,6 +55,15 @@ typedef double float64;
 // maximum number of FBO's that KoRE can handle
 #define KORE_MAX_FRAMEBUFFER_COUNT 64
 
+// maximum number of uniform buffer binding points tracked by KoRE
+#define KORE_MAX_UNIFORM_BUFFER_BINDINGS 96
+
+// maximum number of shader storage buffer binding points tracked by KoRE
+#define KORE_MAX_SHADER_STORAGE_BUFFER_BINDINGS 16
+
+// default number of bytes per frame in the streaming uniform ring-buffer
+#define KORE_UNIFORM_STREAM_FRAME_SIZE (1024 * 1024)
+
 // Use this to indicate an invalid GL-handle of type GLuint
 
 #define KORE_GLUINT_HANDLE_INVALID 0xFFFFFFFF
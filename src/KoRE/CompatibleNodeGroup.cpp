@@ -38,10 +38,10 @@ void kore::CompatibleNodeGroup::addSceneNode(SceneNode* node) {
   // check if node isn't already in group
   for (uint i = 0; i < _nodes.size(); i++) {
     if(node->getID() == _nodes[i]->getID()) {
-      kore::Log::getInstance()
-        ->write("[WARNING] Node '%s' already exists in Group '%s'\n",
-                node->getName().c_str(),
-                _name.c_str());
+      KORE_LOG_WARNING(LOG_CATEGORY_SCENE,
+                       "Node '%s' already exists in Group '%s'\n",
+                       node->getName().c_str(),
+                       _name.c_str());
       return;
     }
   }
@@ -61,10 +61,10 @@ void kore::CompatibleNodeGroup::removeSceneNode(const SceneNode* node) {
     it++;
   }
   // log if node was not in group
-  kore::Log::getInstance()
-    ->write("[WARNING] Node '%s' does not exist in Group '%s'\n",
-    node->getName().c_str(),
-    _name.c_str());
+  KORE_LOG_WARNING(LOG_CATEGORY_SCENE,
+                   "Node '%s' does not exist in Group '%s'\n",
+                   node->getName().c_str(),
+                   _name.c_str());
 }
 
 bool kore::CompatibleNodeGroup::isCompatible(kore::EComponentType type) const {
@@ -126,6 +126,7 @@ kore::Camera::Camera()
   _shaderData.push_back(tmp);
 
   _type = COMPONENT_CAMERA;
+  _observesTransform = true;
 }
 
 kore::Camera::~Camera() {
@@ -139,7 +140,7 @@ isCompatibleWith(const SceneNodeComponent& otherComponent) const {
 void kore::Camera::transformChanged(const Transform* newTransform) {
   SceneNodeComponent::transformChanged(newTransform);
 
-  _matView = glm::inverse(newTransform->getGlobal());
+  _matView = newTransform->getGlobalInverse();
   _matViewInverse = newTransform->getGlobal();
   paramsChanged();
 }
@@ -382,6 +383,12 @@ void kore::Camera::updateFrustumPlanes() {
     }
 }
 
+kore::SFrustum kore::Camera::getFrustumWS() const {
+  SFrustum frustum;
+  frustum.setFromMatrix(_matViewProj);
+  return frustum;
+}
+
 bool kore::Camera::
     isVisible(const glm::vec3& rSphereCenterWS, const float fRadius) const {
     glm::vec4 bSphereVS =  _matView * glm::vec4(rSphereCenterWS, 1.0f);
@@ -28,6 +28,7 @@
 #include "KoRE/Common.h"
 #include "KoRE/Components/SceneNodeComponent.h"
 #include "KoRE/DataTypes.h"
+#include "KoRE/BoundingVolume.h"
 
 namespace kore {
 class Camera : public SceneNodeComponent {
@@ -86,6 +87,9 @@ class Camera : public SceneNodeComponent {
      bool isVisible(const glm::vec3& rSphereCenterWS,
                     const float fRadius) const;
 
+     /// Returns the world-space frustum planes of the camera
+     SFrustum getFrustumWS() const;
+
      void setProjectionMat(const glm::mat4& projMat);
 
      void setProjectionPersp(float yFov_deg, float fWidth,
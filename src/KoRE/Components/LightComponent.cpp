@@ -12,6 +12,7 @@ kore::LightComponent::LightComponent()
     _positionWS(0.0f, 0.0f, 0.0f),
     _directionWS(0.0f, 0.0f, 0.0f) {
   _type = COMPONENT_LIGHT;
+  _observesTransform = true;
   init();
 }
 
@@ -19,7 +19,15 @@
 
 #include "KoRE/Components/Material.h"
 using namespace kore;
-kore::Material::Material() : _name("UNNAMED"), kore::BaseResource() {
+kore::Material::Material()
+  : _name("UNNAMED"),
+    _uniformBuffer(&_values),
+    kore::BaseResource() {
+  _uniformBufferData.type = GL_UNIFORM_BUFFER;
+  _uniformBufferData.name = "Uniform Buffer";
+  _uniformBufferData.size = 1;
+  _uniformBufferData.data = &_uniformBuffer;
+  _uniformBufferData.component = NULL;
 }
 
 kore::Material::~Material() {
@@ -33,6 +41,7 @@ void kore::Material::addValue(ShaderData* shaderData) {
   if (!containsDataPointer(shaderData->data)) {
     // Store a copy of the shaderData.
     _values.push_back(*shaderData);
+    _uniformBuffer.invalidate();
     _eventDataAdded.raiseEvent(&_values[_values.size() - 1]);
   }
 }
@@ -54,32 +63,13 @@ void kore::Material::
     addValue(&shaderData);
 }
 
-template <typename ValueT>
-void kore::Material::setValue(const std::string& name,
-                              const GLuint dataType,
-                              const ValueT& value) {
-    ShaderData* shaderData = getValue(name);
-
-    if (shaderData == NULL) {
-      return;
-    }
-
-    if (shaderData->type != dataType) {
-      Log::getInstance()->
-        write("[ERROR] Material::setvalue(): datatypes don't match"
-              "for parameter %s", name.c_str());
-      return;
-    }
-
-    (*static_cast<ValueT*>(shaderData->data)) = value;
-}
-
 void kore::Material::removeValue(ShaderData* shaderData) {
   uint idx = getShaderDataIdxForValue(shaderData->data);
 
   if (idx != KORE_UINT_INVALID) {
     KORE_SAFE_DELETE(_values[idx].data);
     _values.erase(_values.begin() + idx);
+    _uniformBuffer.invalidate();
   }
 
   _eventDataRemoved.raiseEvent(shaderData);
@@ -25,6 +25,7 @@
 #include "KoRE/ShaderData.h"
 #include "KoRE/Events.h"
 #include "KoRE/BaseResource.h"
+#include "KoRE/UniformBuffer.h"
 
 namespace kore {
   /*! This class stores generic heap-pointers to material-values so that many
@@ -54,7 +55,10 @@ namespace kore {
                   const GLuint dataType,
                   void* value);
 
-       /*! \brief Sets the value of a material-parameter.
+       /*! \brief Sets the value of a material-parameter. The uniform buffer
+               of this material is only rebuilt if the value changed.
+               Values modified directly through their data-pointer require
+               a call to getUniformBuffer()->invalidate().
         \param name The name of the parameter (e.g. "diffuse reflectivity").
         \param value A pointer to the memory with the new value. */
     template<typename ValueT>
@@ -75,11 +79,19 @@ namespace kore {
                name. */
     bool hasValue(const std::string& name);
 
+    /*! \brief Returns the ShaderData referencing the uniform buffer of this
+               material. Bind it to a uniform block with BindUniformBlock. */
+    inline const ShaderData* getUniformBufferData() const
+                                                  {return &_uniformBufferData;}
+    inline UniformBuffer* getUniformBuffer() {return &_uniformBuffer;}
+
     Delegate1Param<ShaderData*>& getAddEvent() {return _eventDataAdded;}
     Delegate1Param<ShaderData*>& getRemoveEvent() {return _eventDataRemoved;}
   private:
     std::string _name; // Note: the sceneLoader will assign a unique name.
     std::vector<ShaderData> _values;
+    UniformBuffer _uniformBuffer;
+    ShaderData _uniformBufferData;
     Delegate1Param<ShaderData*> _eventDataAdded;
     Delegate1Param<ShaderData*> _eventDataRemoved;
 
@@ -88,6 +100,32 @@ namespace kore {
     bool containsDataPointer(const void* data);
     ShaderData* getValue(const std::string& name);
   };
+
+  template <typename ValueT>
+  void Material::setValue(const std::string& name,
+                          const GLuint dataType,
+                          const ValueT& value) {
+    ShaderData* shaderData = getValue(name);
+
+    if (shaderData == NULL) {
+      return;
+    }
+
+    if (shaderData->type != dataType) {
+      KORE_LOG_ERROR(LOG_CATEGORY_SCENE,
+                     "Material::setvalue(): datatypes don't match"
+                     "for parameter %s", name.c_str());
+      return;
+    }
+
+    ValueT* pValue = static_cast<ValueT*>(shaderData->data);
+    if (*pValue == value) {
+      return;
+    }
+
+    (*pValue) = value;
+    _uniformBuffer.invalidate();
+  }
 }
 
 #endif  // KORE_SRC_KORE_COMPONENTS_MATERIAL_H_
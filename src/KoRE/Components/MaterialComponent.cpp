@@ -39,6 +39,7 @@ void kore::MaterialComponent::setMaterial(Material* material) {
   }
 
   _shaderData.clear();
+  shaderDataChanged();
 
   // And attatch the new material...
   _material = material;
@@ -54,6 +55,9 @@ void kore::MaterialComponent::setMaterial(Material* material) {
   for (uint i = 0; i < vMaterialData.size(); ++i) {
     insertShaderData(&vMaterialData[i]);
   }
+
+  // And the uniform buffer holding all values.
+  insertShaderData(_material->getUniformBufferData());
 }
 
 
@@ -66,15 +70,6 @@ void kore::MaterialComponent::
     }
 }
 
-template <typename ValueT>
-void kore::MaterialComponent::setValue(const std::string& name,
-                              const GLuint dataType,
-                              const ValueT& value) {
-  if (_material) {
-    _material->setValue(name, dataType, value);
-  }
-}
-
 void kore::MaterialComponent::onMaterialDataAdded(ShaderData* data) {
   insertShaderData(data);
 }
@@ -95,6 +90,7 @@ void kore::MaterialComponent::onMaterialDataDeleted(ShaderData* data) {
   if (iPos >= 0) {
     // And now delete it in the own list...
     _shaderData.erase(_shaderData.begin() + iPos);
+    shaderDataChanged();
   }
 }
 
@@ -102,4 +98,5 @@ void kore::MaterialComponent::insertShaderData(const ShaderData* data) {
   _shaderData.push_back(*data); // Just append a copy of this shaderData.
   // But we have to set the component-field of the new shaderdata to "this"
   _shaderData[_shaderData.size() - 1].component = this;
+  shaderDataChanged();
 }
@@ -48,7 +48,11 @@ namespace kore {
     template<typename ValueT>
     void setValue(const std::string& name,
                   const GLuint dataType,
-                  const ValueT& value);
+                  const ValueT& value) {
+      if (_material) {
+        _material->setValue(name, dataType, value);
+      }
+    }
 
     const Material* getMaterial() const {return _material;}
 
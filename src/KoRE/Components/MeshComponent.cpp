@@ -21,13 +21,15 @@
 #include <vector>
 
 #include "KoRE/Components/MeshComponent.h"
+#include "KoRE/SceneNode.h"
 #include "KoRE/ResourceManager.h"
 #include "KoRE/DataTypes.h"
 #include "KoRE/Log.h"
 
 
 kore::MeshComponent::MeshComponent(void) 
-   : SceneNodeComponent() {
+   : _mesh(NULL),
+     SceneNodeComponent() {
   _type = COMPONENT_MESH;
 }
 
@@ -75,6 +77,12 @@ void kore::MeshComponent::setMesh(Mesh* mesh) {
     data.component = this;
     _shaderData.push_back(data);
   }
+  shaderDataChanged();
+
+  // The bounds of the node depend on the mesh.
+  if (_sceneNode) {
+    _sceneNode->setDirty(true);
+  }
 }
 
 void kore::MeshComponent::destroyAttributes() {
@@ -83,4 +91,5 @@ void kore::MeshComponent::destroyAttributes() {
   }
 
   _shaderData.clear();
+  shaderDataChanged();
 }
@@ -24,6 +24,8 @@
 kore::SceneNodeComponent::SceneNodeComponent()
   : _sceneNode(NULL),
     _type(COMPONENT_UNKNOWN),
+    _observesTransform(false),
+    _shaderDataDirty(true),
     kore::BaseResource() {
 }
 
@@ -42,15 +44,49 @@ void
 kore::SceneNodeComponent::transformChanged(const Transform* newTransform) {
 }
 
+void
+kore::SceneNodeComponent::resolveShaderData(const ShaderData* data) const {
+}
+
 const kore::ShaderData* kore::SceneNodeComponent::
   getShaderData(const std::string& name) const {
-    for (uint i = 0; i < _shaderData.size(); ++i) {
-      if(_shaderData[i].name == name ) {
-        return &_shaderData[i];
-      }
+    // Building the lookup interns the names, so the id is looked up after.
+    if (_shaderDataDirty) {
+      buildShaderDataLookup();
     }
-    Log::getInstance()->write("[ERROR] ShaderData %s not found in Component \n", 
-        name.c_str());
+    return findShaderData(StringTable::getInstance()->find(name), name);
+}
+
+const kore::ShaderData* kore::SceneNodeComponent::
+  getShaderData(const StringID nameID) const {
+    if (_shaderDataDirty) {
+      buildShaderDataLookup();
+    }
+    return findShaderData(nameID,
+                          StringTable::getInstance()->getString(nameID));
+}
+
+const kore::ShaderData* kore::SceneNodeComponent::
+  findShaderData(const StringID nameID, const std::string& name) const {
+    auto it = _shaderDataLookup.find(nameID);
+    if (it != _shaderDataLookup.end()) {
+      return &_shaderData[it->second];
+    }
+
+    KORE_LOG_ERROR(LOG_CATEGORY_SCENE,
+                   "ShaderData %s not found in Component \n",
+                   name.c_str());
 
     return NULL;
 }
+
+void kore::SceneNodeComponent::buildShaderDataLookup() const {
+  StringTable* strTable = StringTable::getInstance();
+  _shaderDataLookup.clear();
+  // insert() keeps the first entry of a name, like a linear search would.
+  for (uint i = 0; i < _shaderData.size(); ++i) {
+    _shaderDataLookup.insert(
+      std::make_pair(strTable->intern(_shaderData[i].name), i));
+  }
+  _shaderDataDirty = false;
+}
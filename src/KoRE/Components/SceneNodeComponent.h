@@ -20,10 +20,12 @@
 #ifndef CORE_INCLUDE_CORE_SCENENODECOMPONENT_H_
 #define CORE_INCLUDE_CORE_SCENENODECOMPONENT_H_
 
+#include <unordered_map>
 #include "KoRE/Common.h"
 #include "KoRE/ShaderData.h"
 #include "KoRE/Operations/Operation.h"
 #include "KoRE/BaseResource.h"
+#include "KoRE/StringTable.h"
 
 namespace kore {
   enum EComponentType {
@@ -47,8 +49,16 @@ namespace kore {
     virtual void attachTo(SceneNode* node);
     virtual void transformChanged(const Transform* newTransform);
 
+    /*! \brief True for components that override transformChanged(). The
+    *          TransformHierarchy only notifies these. */
+    inline bool observesTransform() const {return _observesTransform;}
+
+    /*! \brief Computes the value of deferred ShaderData on demand. */
+    virtual void resolveShaderData(const ShaderData* data) const;
+
     const EComponentType getType(void) const;
     const ShaderData* getShaderData(const std::string& name) const;
+    const ShaderData* getShaderData(const StringID nameID) const;
 
     inline const std::vector<ShaderData>&
     getShaderData() const {return _shaderData;};
@@ -59,7 +69,21 @@ namespace kore {
     std::string name;
     SceneNode* _sceneNode;
     EComponentType _type;
+    bool _observesTransform;
     std::vector<ShaderData> _shaderData;
+
+    /*! \brief Has to be called by derived components after _shaderData
+    *          was modified outside of their constructor. */
+    inline void shaderDataChanged() {_shaderDataDirty = true;}
+
+  private:
+    const ShaderData* findShaderData(const StringID nameID,
+                                     const std::string& name) const;
+    void buildShaderDataLookup() const;
+
+    // Index into _shaderData, rebuilt on the first lookup after a change.
+    mutable std::unordered_map<StringID, uint> _shaderDataLookup;
+    mutable bool _shaderDataDirty;
   };
 };
 #endif  // CORE_INCLUDE_CORE_SCENENODECOMPONENT_H_
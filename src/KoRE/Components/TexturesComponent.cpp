@@ -33,6 +33,7 @@ void kore::
   shaderdata.data = texInfo;
   shaderdata.component = this;
   _shaderData.push_back(shaderdata);
+  shaderDataChanged();
 
   _vTextures.push_back(tex);
   // Tex unit is defined by shader
@@ -1,10 +1,40 @@
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include "KoRE/Components/Transform.h"
 
+namespace {
+  const float kRigidEpsilon = 1e-5f;
+
+  inline bool isAffine(const glm::mat4& mat) {
+    return mat[0][3] == 0.0f && mat[1][3] == 0.0f
+        && mat[2][3] == 0.0f && mat[3][3] == 1.0f;
+  }
+
+  // True, if the columns are orthonormal (rotation without scale/shear).
+  inline bool isOrthonormal(const glm::mat3& mat) {
+    const glm::mat3 prod = glm::transpose(mat) * mat;
+    for (int col = 0; col < 3; ++col) {
+      for (int row = 0; row < 3; ++row) {
+        const float expected = col == row ? 1.0f : 0.0f;
+        if (glm::abs(prod[col][row] - expected) > kRigidEpsilon) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
 kore::Transform::Transform(void) : _global(glm::mat4(1.0f)),
                                    _local(glm::mat4(1.0f)),
                                    _normalWS(1.0f),
                                    _globalI(1.0f),
+                                   _localValid(true),
+                                   _globalIValid(true),
+                                   _normalWSValid(true),
                                    kore::SceneNodeComponent() {
+  _uniformBuffer.setValues(&_shaderData);
+
   ShaderData input = ShaderData();
   input.type = GL_FLOAT_MAT4;
   input.name = "model Matrix";
@@ -17,6 +47,7 @@ kore::Transform::Transform(void) : _global(glm::mat4(1.0f)),
   input.name = "inverse model Matrix";
   input.data = glm::value_ptr(_globalI);
   input.component = this;
+  input.deferred = true;
   _shaderData.push_back(input);
 
   input = ShaderData();
@@ -24,6 +55,7 @@ kore::Transform::Transform(void) : _global(glm::mat4(1.0f)),
   input.name = "object Matrix";
   input.data = glm::value_ptr(_local);
   input.component = this;
+  input.deferred = true;
   _shaderData.push_back(input);
 
   input = ShaderData();
@@ -31,6 +63,14 @@ kore::Transform::Transform(void) : _global(glm::mat4(1.0f)),
   input.name = "normal Matrix";
   input.data = glm::value_ptr(_normalWS);
   input.component = this;
+  input.deferred = true;
+  _shaderData.push_back(input);
+
+  input = ShaderData();
+  input.type = GL_UNIFORM_BUFFER;
+  input.name = "Uniform Buffer";
+  input.data = &_uniformBuffer;
+  input.component = this;
   _shaderData.push_back(input);
 
   _type = COMPONENT_TRANSFORM;
@@ -41,10 +81,120 @@ kore::Transform::~Transform() {
 
 void kore::Transform::setGlobal(const glm::mat4& global) {
   _global = global;
-  _normalWS = glm::mat3(glm::inverseTranspose(global));
-  _globalI = glm::inverse(_global);
+  _globalIValid = false;
+  _normalWSValid = false;
+  _uniformBuffer.invalidate();
+}
+
+const glm::mat4& kore::Transform::getGlobalInverse() const {
+  if (!_globalIValid) {
+    _globalI = inverse(_global);
+    _globalIValid = true;
+  }
+  return _globalI;
+}
+
+const glm::mat3& kore::Transform::getNormalWS() const {
+  if (!_normalWSValid) {
+    if (isAffine(_global)) {
+      // The normal matrix is the transposed inverse of the 3x3 part.
+      const glm::mat3 rotScale(_global);
+      if (isOrthonormal(rotScale)) {
+        _normalWS = rotScale;
+      } else {
+        _normalWS = glm::transpose(glm::mat3(getGlobalInverse()));
+      }
+    } else {
+      _normalWS = glm::mat3(glm::inverseTranspose(_global));
+    }
+    _normalWSValid = true;
+  }
+  return _normalWS;
+}
+
+void kore::Transform::resolveShaderData(const ShaderData* data) const {
+  if (data->data == glm::value_ptr(_local)) {
+    getLocal();
+  } else if (data->data == glm::value_ptr(_globalI)) {
+    getGlobalInverse();
+  } else if (data->data == glm::value_ptr(_normalWS)) {
+    getNormalWS();
+  }
+}
+
+glm::mat4 kore::Transform::inverse(const glm::mat4& mat) {
+  if (!isAffine(mat)) {
+    return glm::inverse(mat);
+  }
+
+  const glm::mat3 rotScale(mat);
+  const glm::mat3 rotScaleI = isOrthonormal(rotScale)
+                              ? glm::transpose(rotScale)
+                              : glm::inverse(rotScale);
+  const glm::vec3 translation(mat[3]);
+
+  glm::mat4 result(rotScaleI);
+  result[3] = glm::vec4(-(rotScaleI * translation), 1.0f);
+  return result;
 }
 
 void kore::Transform::setLocal(const glm::mat4& local) {
   _local = local;
+  _localValid = true;
+
+  _trs.translation = glm::vec3(local[3]);
+  glm::mat3 rotScale(local);
+  _trs.scale = glm::vec3(glm::length(rotScale[0]),
+                         glm::length(rotScale[1]),
+                         glm::length(rotScale[2]));
+  if (glm::determinant(rotScale) < 0.0f) {
+    _trs.scale.x = -_trs.scale.x;
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (_trs.scale[i] != 0.0f) {
+      rotScale[i] /= _trs.scale[i];
+    }
+  }
+  _trs.rotation = glm::normalize(glm::quat_cast(rotScale));
+
+  _uniformBuffer.invalidate();
+}
+
+void kore::Transform::setLocal(const STransformTRS& trs) {
+  _trs = trs;
+  localChanged();
+}
+
+void kore::Transform::setTranslation(const glm::vec3& translation) {
+  _trs.translation = translation;
+  localChanged();
+}
+
+void kore::Transform::setRotation(const glm::quat& rotation) {
+  _trs.rotation = rotation;
+  localChanged();
+}
+
+void kore::Transform::setScale(const glm::vec3& scale) {
+  _trs.scale = scale;
+  localChanged();
+}
+
+void kore::Transform::localChanged(void) {
+  _localValid = false;
+  _uniformBuffer.invalidate();
+}
+
+const glm::mat4& kore::Transform::getLocal() const {
+  if (!_localValid) {
+    // local = translate * rotate * scale, composed without multiplying
+    // full matrices.
+    const glm::mat3 rot = glm::mat3_cast(_trs.rotation);
+    _local[0] = glm::vec4(rot[0] * _trs.scale.x, 0.0f);
+    _local[1] = glm::vec4(rot[1] * _trs.scale.y, 0.0f);
+    _local[2] = glm::vec4(rot[2] * _trs.scale.z, 0.0f);
+    _local[3] = glm::vec4(_trs.translation, 1.0f);
+    _localValid = true;
+  }
+  return _local;
 }
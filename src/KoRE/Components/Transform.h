@@ -21,28 +21,85 @@
 #define CORE_INCLUDE_CORE_TRANSFORM_H_
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include "KoRE/Components/SceneNodeComponent.h"
 #include "KoRE/DataTypes.h"
+#include "KoRE/UniformBuffer.h"
 
 namespace kore {
+  /*! \brief A local transformation split into translation, rotation and
+  *          scale. */
+  struct STransformTRS {
+    STransformTRS(void)
+      : translation(0.0f),
+        rotation(1.0f, 0.0f, 0.0f, 0.0f),
+        scale(1.0f) {
+    }
+
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+  };
+
+  /*! \brief The transformation of a SceneNode.
+  *   The local transformation is stored as translation, rotation and scale.
+  *   The local matrix is composed from these only when it is read after a
+  *   change.
+  */
   class Transform : public SceneNodeComponent{
   public:
     Transform(void);
     virtual ~Transform(void);
 
     void setGlobal(const glm::mat4& global);
+
+    /*! \brief Sets the local matrix. The matrix is decomposed into
+    *          translation, rotation and scale. Shear is only preserved
+    *          until one of these is modified. */
     void setLocal(const glm::mat4& local);
 
+    void setLocal(const STransformTRS& trs);
+    void setTranslation(const glm::vec3& translation);
+    void setRotation(const glm::quat& rotation);
+    void setScale(const glm::vec3& scale);
+
+    inline const glm::vec3& getTranslation() const {return _trs.translation;}
+    inline const glm::quat& getRotation() const {return _trs.rotation;}
+    inline const glm::vec3& getScale() const {return _trs.scale;}
+    inline const STransformTRS& getTRS() const {return _trs;}
+
+    virtual void resolveShaderData(const ShaderData* data) const;
+
     inline const glm::mat4& getGlobal() const {return _global;}
-    inline const glm::mat4& getGlobalInverse() const {return _globalI;}
-    inline const glm::mat4& getLocal() const {return _local;}
-    inline const glm::mat3& getNormalWS() const {return _normalWS;}
+
+    /*! \brief Returns the local matrix. It is composed from translation,
+    *          rotation and scale on the first call after a change. */
+    const glm::mat4& getLocal() const;
+
+    /*! \brief Returns the inverse of the global matrix. It is computed on
+    *          the first call after the global matrix has changed. */
+    const glm::mat4& getGlobalInverse() const;
+
+    /*! \brief Returns the world-space normal matrix. It is computed on the
+    *          first call after the global matrix has changed. */
+    const glm::mat3& getNormalWS() const;
+
+    /*! \brief Inverts a matrix. Affine matrices are inverted via their 3x3
+    *          part, rigid-body matrices by transposing the rotation. */
+    static glm::mat4 inverse(const glm::mat4& mat);
 
   private:
-    glm::mat4 _globalI;
+    void localChanged(void);
+
+    mutable glm::mat4 _globalI;
     glm::mat4 _global;
-    glm::mat4 _local;
-    glm::mat3 _normalWS;
+    mutable glm::mat4 _local;
+    mutable glm::mat3 _normalWS;
+    STransformTRS _trs;
+    mutable bool _localValid;
+    mutable bool _globalIValid;
+    mutable bool _normalWSValid;
+    UniformBuffer _uniformBuffer;
   };
 }
 #endif  // CORE_INCLUDE_CORE_TRANSFORM_H_
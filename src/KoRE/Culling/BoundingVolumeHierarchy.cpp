@@ -0,0 +1,489 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <vector>
+#include "KoRE/Culling/BoundingVolumeHierarchy.h"
+
+namespace {
+  const uint kNumBins = 16;
+  const uint kMinLeafSize = 2;   // always a leaf below this
+  const uint kMaxLeafSize = 8;   // never a leaf above this
+  const float kTraversalCost = 1.0f;
+
+  // True for primitives left of the split plane.
+  struct SBinPredicate {
+    SBinPredicate(const std::vector<kore::SAABB>& bounds,
+                  const int axis, const float minCentroid,
+                  const float scale, const uint splitBin)
+      : _bounds(bounds), _axis(axis), _min(minCentroid),
+        _scale(scale), _splitBin(splitBin) {
+    }
+
+    bool operator()(const uint prim) const {
+      const float c = _bounds[prim].getCenter()[_axis];
+      uint bin = static_cast<uint>((c - _min) * _scale);
+      if (bin >= kNumBins) {
+        bin = kNumBins - 1;
+      }
+      return bin <= _splitBin;
+    }
+
+    const std::vector<kore::SAABB>& _bounds;
+    int _axis;
+    float _min;
+    float _scale;
+    uint _splitBin;
+  };
+
+  struct SCentroidLess {
+    SCentroidLess(const std::vector<kore::SAABB>& bounds, const int axis)
+      : _bounds(bounds), _axis(axis) {
+    }
+
+    bool operator()(const uint a, const uint b) const {
+      return _bounds[a].getCenter()[_axis] < _bounds[b].getCenter()[_axis];
+    }
+
+    const std::vector<kore::SAABB>& _bounds;
+    int _axis;
+  };
+}
+
+kore::BoundingVolumeHierarchy::BoundingVolumeHierarchy(void)
+  : _checkInterval(30),
+    _commitsSinceCheck(0),
+    _maxCostGrowth(1.5f),
+    _buildCost(0.0f),
+    _needsRebuild(false) {
+}
+
+kore::BoundingVolumeHierarchy::~BoundingVolumeHierarchy(void) {
+}
+
+void kore::BoundingVolumeHierarchy::clear(void) {
+  _nodes.clear();
+  _primOrder.clear();
+  _primBounds.clear();
+  _primIDs.clear();
+  _primLeaf.clear();
+  _idToPrim.clear();
+  _dirtyLeaves.clear();
+  _leafDirty.clear();
+  _commitsSinceCheck = 0;
+  _buildCost = 0.0f;
+  _needsRebuild = false;
+}
+
+void kore::BoundingVolumeHierarchy::build(const SAABB* bounds,
+                                          const uint* ids,
+                                          const uint count) {
+  clear();
+
+  uint maxID = 0;
+  for (uint i = 0; i < count; ++i) {
+    if (!bounds[i].isEmpty()) {
+      _primBounds.push_back(bounds[i]);
+      _primIDs.push_back(ids[i]);
+      maxID = std::max(maxID, ids[i]);
+    }
+  }
+
+  const uint numPrims = static_cast<uint>(_primIDs.size());
+  if (numPrims == 0) {
+    return;
+  }
+
+  _idToPrim.assign(maxID + 1, KORE_UINT_INVALID);
+  _primOrder.resize(numPrims);
+  for (uint i = 0; i < numPrims; ++i) {
+    _idToPrim[_primIDs[i]] = i;
+    _primOrder[i] = i;
+  }
+  _primLeaf.resize(numPrims);
+  _nodes.reserve(2 * numPrims);
+
+  buildRecursive(KORE_UINT_INVALID, 0, numPrims);
+  _leafDirty.assign(_nodes.size(), 0);
+  _buildCost = computeSAHCost();
+}
+
+uint kore::BoundingVolumeHierarchy::buildRecursive(const uint parent,
+                                                   const uint first,
+                                                   const uint count) {
+  const uint nodeIdx = static_cast<uint>(_nodes.size());
+  _nodes.push_back(SNode());
+
+  SAABB bounds;
+  SAABB centroids;
+  for (uint i = first; i < first + count; ++i) {
+    const SAABB& primBounds = _primBounds[_primOrder[i]];
+    bounds.extend(primBounds);
+    centroids.extend(primBounds.getCenter());
+  }
+
+  SNode node;
+  node.bounds = bounds;
+  node.parent = parent;
+  node.left = KORE_UINT_INVALID;
+  node.right = KORE_UINT_INVALID;
+  node.first = first;
+  node.count = count;
+
+  // Split along the axis with the largest centroid extent.
+  const glm::vec3 extent = centroids.max - centroids.min;
+  int axis = 0;
+  if (extent.y > extent[axis]) axis = 1;
+  if (extent.z > extent[axis]) axis = 2;
+
+  uint mid = first;
+  bool makeLeaf = count <= kMinLeafSize;
+
+  if (!makeLeaf && extent[axis] > 0.0f) {
+    // Binned SAH: sort the centroids into bins and evaluate the split
+    // planes between the bins.
+    SAABB binBounds[kNumBins];
+    uint binCount[kNumBins] = {0};
+    const float scale = static_cast<float>(kNumBins) / extent[axis];
+    for (uint i = first; i < first + count; ++i) {
+      const SAABB& primBounds = _primBounds[_primOrder[i]];
+      uint bin = static_cast<uint>(
+        (primBounds.getCenter()[axis] - centroids.min[axis]) * scale);
+      if (bin >= kNumBins) {
+        bin = kNumBins - 1;
+      }
+      binBounds[bin].extend(primBounds);
+      ++binCount[bin];
+    }
+
+    float rightArea[kNumBins];
+    uint rightCount[kNumBins];
+    SAABB accum;
+    uint accumCount = 0;
+    for (uint b = kNumBins - 1; b > 0; --b) {
+      accum.extend(binBounds[b]);
+      accumCount += binCount[b];
+      rightArea[b] = accum.getSurfaceArea();
+      rightCount[b] = accumCount;
+    }
+
+    float bestCost = FLT_MAX;
+    uint bestSplit = 0;
+    accum = SAABB();
+    accumCount = 0;
+    for (uint b = 0; b < kNumBins - 1; ++b) {
+      accum.extend(binBounds[b]);
+      accumCount += binCount[b];
+      if (accumCount == 0 || rightCount[b + 1] == 0) {
+        continue;
+      }
+      const float cost = accum.getSurfaceArea() * accumCount
+                         + rightArea[b + 1] * rightCount[b + 1];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestSplit = b;
+      }
+    }
+
+    const float area = bounds.getSurfaceArea();
+    const float splitCost = area > 0.0f ? kTraversalCost + bestCost / area
+                                        : FLT_MAX;
+    if (count <= kMaxLeafSize && splitCost >= static_cast<float>(count)) {
+      makeLeaf = true;
+    } else if (bestCost < FLT_MAX) {
+      std::vector<uint>::iterator split =
+        std::partition(_primOrder.begin() + first,
+                       _primOrder.begin() + first + count,
+                       SBinPredicate(_primBounds, axis, centroids.min[axis],
+                                     scale, bestSplit));
+      mid = static_cast<uint>(split - _primOrder.begin());
+    }
+  } else if (!makeLeaf && count <= kMaxLeafSize) {
+    // All centroids coincide, splitting doesn't help.
+    makeLeaf = true;
+  }
+
+  if (!makeLeaf && (mid == first || mid == first + count)) {
+    // No useful SAH split. Fall back to the median.
+    mid = first + count / 2;
+    std::nth_element(_primOrder.begin() + first,
+                     _primOrder.begin() + mid,
+                     _primOrder.begin() + first + count,
+                     SCentroidLess(_primBounds, axis));
+  }
+
+  if (makeLeaf) {
+    for (uint i = first; i < first + count; ++i) {
+      _primLeaf[_primOrder[i]] = nodeIdx;
+    }
+    _nodes[nodeIdx] = node;
+    return nodeIdx;
+  }
+
+  node.count = 0;
+  node.left = buildRecursive(nodeIdx, first, mid - first);
+  node.right = buildRecursive(nodeIdx, mid, first + count - mid);
+  _nodes[nodeIdx] = node;
+  return nodeIdx;
+}
+
+void kore::BoundingVolumeHierarchy::refit(const uint id,
+                                          const SAABB& bounds) {
+  const uint prim = id < _idToPrim.size() ? _idToPrim[id]
+                                          : KORE_UINT_INVALID;
+  if (prim == KORE_UINT_INVALID) {
+    // A new primitive can only be added by a rebuild.
+    if (!bounds.isEmpty()) {
+      _needsRebuild = true;
+    }
+    return;
+  }
+
+  // Empty boxes don't contribute to the unions and need no special care.
+  _primBounds[prim] = bounds;
+  const uint leaf = _primLeaf[prim];
+  if (!_leafDirty[leaf]) {
+    _leafDirty[leaf] = 1;
+    _dirtyLeaves.push_back(leaf);
+  }
+}
+
+void kore::BoundingVolumeHierarchy::commit(void) {
+  for (uint i = 0; i < _dirtyLeaves.size(); ++i) {
+    _leafDirty[_dirtyLeaves[i]] = 0;
+    refitLeaf(_dirtyLeaves[i]);
+  }
+  const bool changed = !_dirtyLeaves.empty();
+  _dirtyLeaves.clear();
+
+  if (!changed || ++_commitsSinceCheck < _checkInterval) {
+    return;
+  }
+  _commitsSinceCheck = 0;
+
+  if (computeSAHCost() > _buildCost * _maxCostGrowth) {
+    const std::vector<SAABB> bounds(_primBounds);
+    const std::vector<uint> ids(_primIDs);
+    const bool needsRebuild = _needsRebuild;
+    build(&bounds[0], &ids[0], static_cast<uint>(ids.size()));
+    _needsRebuild = needsRebuild;
+  }
+}
+
+void kore::BoundingVolumeHierarchy::refitLeaf(const uint nodeIdx) {
+  SNode& leaf = _nodes[nodeIdx];
+  SAABB bounds;
+  for (uint i = leaf.first; i < leaf.first + leaf.count; ++i) {
+    bounds.extend(_primBounds[_primOrder[i]]);
+  }
+  if (bounds == leaf.bounds) {
+    return;
+  }
+  leaf.bounds = bounds;
+
+  // Walk up until a box doesn't change anymore.
+  uint parent = leaf.parent;
+  while (parent != KORE_UINT_INVALID) {
+    SNode& node = _nodes[parent];
+    SAABB merged = _nodes[node.left].bounds;
+    merged.extend(_nodes[node.right].bounds);
+    if (merged == node.bounds) {
+      break;
+    }
+    node.bounds = merged;
+    parent = node.parent;
+  }
+}
+
+void kore::BoundingVolumeHierarchy::
+  setRebuildPolicy(const uint checkInterval, const float maxCostGrowth) {
+  _checkInterval = checkInterval > 0 ? checkInterval : 1;
+  _maxCostGrowth = maxCostGrowth;
+}
+
+float kore::BoundingVolumeHierarchy::computeSAHCost(void) const {
+  if (_nodes.empty()) {
+    return 0.0f;
+  }
+
+  const float rootArea = _nodes[0].bounds.getSurfaceArea();
+  if (rootArea <= 0.0f) {
+    return 0.0f;
+  }
+
+  float cost = 0.0f;
+  for (uint i = 0; i < _nodes.size(); ++i) {
+    const SNode& node = _nodes[i];
+    const float area = node.bounds.getSurfaceArea();
+    cost += node.count > 0 ? area * node.count : area * kTraversalCost;
+  }
+  return cost / rootArea;
+}
+
+void kore::BoundingVolumeHierarchy::
+  collectSubtree(const uint nodeIdx, std::vector<uint>& outIDs) const {
+  // All leaves of a subtree form one contiguous range of _primOrder.
+  uint firstLeaf = nodeIdx;
+  while (_nodes[firstLeaf].count == 0) {
+    firstLeaf = _nodes[firstLeaf].left;
+  }
+  uint lastLeaf = nodeIdx;
+  while (_nodes[lastLeaf].count == 0) {
+    lastLeaf = _nodes[lastLeaf].right;
+  }
+
+  const uint end = _nodes[lastLeaf].first + _nodes[lastLeaf].count;
+  for (uint i = _nodes[firstLeaf].first; i < end; ++i) {
+    if (!_primBounds[_primOrder[i]].isEmpty()) {
+      outIDs.push_back(_primIDs[_primOrder[i]]);
+    }
+  }
+}
+
+void kore::BoundingVolumeHierarchy::
+  queryFrustum(const SFrustum& frustum, std::vector<uint>& outIDs) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  std::vector<uint> stack;
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const uint nodeIdx = stack.back();
+    stack.pop_back();
+    const SNode& node = _nodes[nodeIdx];
+
+    const SFrustum::EClassification classification =
+      frustum.classify(node.bounds);
+    if (classification == SFrustum::OUTSIDE) {
+      continue;
+    }
+
+    if (classification == SFrustum::INSIDE) {
+      collectSubtree(nodeIdx, outIDs);
+    } else if (node.count > 0) {
+      // Test the primitives of partly visible leaves in one batch.
+      _leafBounds.resize(node.count);
+      _leafVisible.resize(node.count);
+      for (uint i = 0; i < node.count; ++i) {
+        _leafBounds[i] = &_primBounds[_primOrder[node.first + i]];
+      }
+      _culler.cull(frustum, &_leafBounds[0], node.count, &_leafVisible[0]);
+      for (uint i = 0; i < node.count; ++i) {
+        if (_leafVisible[i]) {
+          outIDs.push_back(_primIDs[_primOrder[node.first + i]]);
+        }
+      }
+    } else {
+      stack.push_back(node.right);
+      stack.push_back(node.left);
+    }
+  }
+}
+
+void kore::BoundingVolumeHierarchy::
+  querySphere(const glm::vec3& center, const float radius,
+              std::vector<uint>& outIDs) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  std::vector<uint> stack;
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const SNode& node = _nodes[stack.back()];
+    stack.pop_back();
+    if (!node.bounds.intersects(center, radius)) {
+      continue;
+    }
+
+    if (node.count > 0) {
+      for (uint i = node.first; i < node.first + node.count; ++i) {
+        if (_primBounds[_primOrder[i]].intersects(center, radius)) {
+          outIDs.push_back(_primIDs[_primOrder[i]]);
+        }
+      }
+    } else {
+      stack.push_back(node.right);
+      stack.push_back(node.left);
+    }
+  }
+}
+
+void kore::BoundingVolumeHierarchy::
+  queryAABB(const SAABB& aabb, std::vector<uint>& outIDs) const {
+  if (_nodes.empty() || aabb.isEmpty()) {
+    return;
+  }
+
+  std::vector<uint> stack;
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const SNode& node = _nodes[stack.back()];
+    stack.pop_back();
+    if (node.bounds.isEmpty() || !node.bounds.intersects(aabb)) {
+      continue;
+    }
+
+    if (node.count > 0) {
+      for (uint i = node.first; i < node.first + node.count; ++i) {
+        const SAABB& primBounds = _primBounds[_primOrder[i]];
+        if (!primBounds.isEmpty() && primBounds.intersects(aabb)) {
+          outIDs.push_back(_primIDs[_primOrder[i]]);
+        }
+      }
+    } else {
+      stack.push_back(node.right);
+      stack.push_back(node.left);
+    }
+  }
+}
+
+void kore::BoundingVolumeHierarchy::
+  queryRay(const glm::vec3& origin, const glm::vec3& direction,
+           const float maxDist, std::vector<uint>& outIDs) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  // Division by zero yields +-inf, which the slab test handles.
+  const glm::vec3 invDir = 1.0f / direction;
+  float dist;
+  std::vector<uint> stack;
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const SNode& node = _nodes[stack.back()];
+    stack.pop_back();
+    if (!node.bounds.intersectsRay(origin, invDir, maxDist, dist)) {
+      continue;
+    }
+
+    if (node.count > 0) {
+      for (uint i = node.first; i < node.first + node.count; ++i) {
+        if (_primBounds[_primOrder[i]].intersectsRay(origin, invDir,
+                                                     maxDist, dist)) {
+          outIDs.push_back(_primIDs[_primOrder[i]]);
+        }
+      }
+    } else {
+      stack.push_back(node.right);
+      stack.push_back(node.left);
+    }
+  }
+}
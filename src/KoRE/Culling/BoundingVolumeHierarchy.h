@@ -0,0 +1,124 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_CULLING_BOUNDINGVOLUMEHIERARCHY_H_
+#define KORE_SRC_KORE_CULLING_BOUNDINGVOLUMEHIERARCHY_H_
+
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/BoundingVolume.h"
+#include "KoRE/Culling/FrustumCuller.h"
+
+namespace kore {
+  /*! \brief A dynamic bounding volume hierarchy over boxes identified by
+  *          uint-ids.
+  *   The tree is built top-down with a binned surface area heuristic (SAH).
+  *   Moving primitives are handled by refitting the boxes of their leaves
+  *   and ancestors. Refitting lets the tree degrade, so its SAH cost is
+  *   checked periodically and the tree is rebuilt once it has grown too
+  *   much compared to the cost after the last build.
+  */
+  class BoundingVolumeHierarchy {
+  public:
+    BoundingVolumeHierarchy(void);
+    ~BoundingVolumeHierarchy(void);
+
+    /*! \brief Builds the tree from scratch.
+    *   \param bounds The boxes of the primitives. Empty boxes are skipped.
+    *   \param ids The ids of the primitives, returned by the queries.
+    *   \param count The number of primitives. */
+    void build(const SAABB* bounds, const uint* ids, const uint count);
+
+    void clear(void);
+
+    /*! \brief Changes the box of a primitive. The tree is updated with the
+    *          next call of commit(). */
+    void refit(const uint id, const SAABB& bounds);
+
+    /*! \brief Refits all ancestors of changed primitives. Every few commits
+    *          the SAH cost is checked and the tree is rebuilt if needed. */
+    void commit(void);
+
+    /*! \brief Returns true if a primitive with a non-empty box changed into
+    *          an empty box or vice versa. The tree has to be rebuilt then. */
+    inline bool needsRebuild() const {return _needsRebuild;}
+
+    /*! \brief Sets after how many commits the SAH cost is checked and by
+    *          which factor it may grow before the tree is rebuilt. */
+    void setRebuildPolicy(const uint checkInterval, const float maxCostGrowth);
+
+    /*! \brief Computes the SAH cost of the current tree. */
+    float computeSAHCost(void) const;
+
+    void queryFrustum(const SFrustum& frustum,
+                      std::vector<uint>& outIDs) const;
+    void querySphere(const glm::vec3& center, const float radius,
+                     std::vector<uint>& outIDs) const;
+    void queryAABB(const SAABB& aabb, std::vector<uint>& outIDs) const;
+
+    /*! \brief Returns the ids of all primitives whose box is hit by the ray
+    *          within maxDist. The direction does not need to be
+    *          normalized, distances are measured in multiples of it. */
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction,
+                  const float maxDist, std::vector<uint>& outIDs) const;
+
+    inline uint getNumPrimitives() const
+      {return static_cast<uint>(_primIDs.size());}
+    inline uint getNumNodes() const {return static_cast<uint>(_nodes.size());}
+    inline const SAABB& getBounds() const
+      {return _nodes.empty() ? _emptyBounds : _nodes[0].bounds;}
+
+  private:
+    struct SNode {
+      SAABB bounds;
+      uint parent;
+      uint left;    // inner nodes: children
+      uint right;
+      uint first;   // leaves: range in _primOrder
+      uint count;   // 0 for inner nodes
+    };
+
+    uint buildRecursive(const uint parent, const uint first,
+                        const uint count);
+    void refitLeaf(const uint nodeIdx);
+    void collectSubtree(const uint nodeIdx, std::vector<uint>& outIDs) const;
+
+    std::vector<SNode> _nodes;
+    std::vector<uint> _primOrder;  // leaf order || primitive index
+    std::vector<SAABB> _primBounds;
+    std::vector<uint> _primIDs;
+    std::vector<uint> _primLeaf;  // primitive index || leaf node
+    std::vector<uint> _idToPrim;  // id || primitive index
+    std::vector<uint> _dirtyLeaves;
+    std::vector<unsigned char> _leafDirty;
+
+    uint _checkInterval;
+    uint _commitsSinceCheck;
+    float _maxCostGrowth;
+    float _buildCost;
+    bool _needsRebuild;
+    SAABB _emptyBounds;
+
+    // Scratch memory for the leaf tests of frustum queries.
+    mutable FrustumCuller _culler;
+    mutable std::vector<const SAABB*> _leafBounds;
+    mutable std::vector<unsigned char> _leafVisible;
+  };
+};
+#endif  // KORE_SRC_KORE_CULLING_BOUNDINGVOLUMEHIERARCHY_H_
@@ -0,0 +1,161 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KORE_CULLING_SSE
+#endif
+#include "KoRE/Culling/FrustumCuller.h"
+
+kore::FrustumCuller::FrustumCuller(void) {
+}
+
+kore::FrustumCuller::~FrustumCuller(void) {
+}
+
+uint kore::FrustumCuller::cull(const SFrustum& frustum,
+                               const SAABB* const* boxes,
+                               const uint count,
+                               unsigned char* outVisible) {
+  uint numVisible = 0;
+  SBatch batch;
+  for (uint first = 0; first < count; first += BATCH_SIZE) {
+    const uint batchCount = count - first < BATCH_SIZE ? count - first
+                                                       : BATCH_SIZE;
+    for (uint i = 0; i < BATCH_SIZE; ++i) {
+      const SAABB* box = i < batchCount ? boxes[first + i] : NULL;
+      batch.valid[i] = box != NULL && !box->isEmpty();
+      if (batch.valid[i]) {
+        const glm::vec3 center = box->getCenter();
+        const glm::vec3 extents = box->getExtents();
+        batch.cx[i] = center.x;
+        batch.cy[i] = center.y;
+        batch.cz[i] = center.z;
+        batch.ex[i] = extents.x;
+        batch.ey[i] = extents.y;
+        batch.ez[i] = extents.z;
+      } else {
+        batch.cx[i] = batch.cy[i] = batch.cz[i] = 0.0f;
+        batch.ex[i] = batch.ey[i] = batch.ez[i] = 0.0f;
+      }
+    }
+    numVisible += testBatch(frustum, batch, false, batchCount,
+                            outVisible + first);
+  }
+  return numVisible;
+}
+
+uint kore::FrustumCuller::cull(const SFrustum& frustum,
+                               const SBoundingSphere* spheres,
+                               const uint count,
+                               unsigned char* outVisible) {
+  uint numVisible = 0;
+  SBatch batch;
+  for (uint first = 0; first < count; first += BATCH_SIZE) {
+    const uint batchCount = count - first < BATCH_SIZE ? count - first
+                                                       : BATCH_SIZE;
+    for (uint i = 0; i < BATCH_SIZE; ++i) {
+      const SBoundingSphere* sphere = i < batchCount ? &spheres[first + i]
+                                                     : NULL;
+      batch.valid[i] = sphere != NULL && !sphere->isEmpty();
+      if (batch.valid[i]) {
+        batch.cx[i] = sphere->center.x;
+        batch.cy[i] = sphere->center.y;
+        batch.cz[i] = sphere->center.z;
+        batch.ex[i] = sphere->radius;
+      } else {
+        batch.cx[i] = batch.cy[i] = batch.cz[i] = 0.0f;
+        batch.ex[i] = 0.0f;
+      }
+      batch.ey[i] = batch.ez[i] = 0.0f;
+    }
+    numVisible += testBatch(frustum, batch, true, batchCount,
+                            outVisible + first);
+  }
+  return numVisible;
+}
+
+uint kore::FrustumCuller::testBatch(const SFrustum& frustum,
+                                    const SBatch& batch,
+                                    const bool spheres,
+                                    const uint count,
+                                    unsigned char* outVisible) {
+  // Bit i is set if volume i is outside of at least one plane.
+  uint outsideMask = 0;
+
+#ifdef KORE_CULLING_SSE
+  for (uint half = 0; half < BATCH_SIZE; half += 4) {
+    const __m128 cx = _mm_loadu_ps(batch.cx + half);
+    const __m128 cy = _mm_loadu_ps(batch.cy + half);
+    const __m128 cz = _mm_loadu_ps(batch.cz + half);
+    const __m128 ex = _mm_loadu_ps(batch.ex + half);
+    const __m128 ey = _mm_loadu_ps(batch.ey + half);
+    const __m128 ez = _mm_loadu_ps(batch.ez + half);
+
+    __m128 outside = _mm_setzero_ps();
+    for (int p = 0; p < 6; ++p) {
+      const glm::vec4& plane = frustum.planes[p];
+      const __m128 dist =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)),
+                              _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                   _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)),
+                              _mm_set1_ps(plane.w)));
+      __m128 radius;
+      if (spheres) {
+        radius = ex;
+      } else {
+        radius =
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(glm::abs(plane.x))),
+                                _mm_mul_ps(ey, _mm_set1_ps(glm::abs(plane.y)))),
+                     _mm_mul_ps(ez, _mm_set1_ps(glm::abs(plane.z))));
+      }
+      // outside if dist < -radius  <=>  dist + radius < 0
+      outside = _mm_or_ps(outside,
+                          _mm_cmplt_ps(_mm_add_ps(dist, radius),
+                                       _mm_setzero_ps()));
+    }
+    outsideMask |= static_cast<uint>(_mm_movemask_ps(outside)) << half;
+  }
+#else
+  for (uint i = 0; i < BATCH_SIZE; ++i) {
+    for (int p = 0; p < 6; ++p) {
+      const glm::vec4& plane = frustum.planes[p];
+      const float dist = batch.cx[i] * plane.x + batch.cy[i] * plane.y
+                         + batch.cz[i] * plane.z + plane.w;
+      const float radius = spheres ? batch.ex[i]
+                           : batch.ex[i] * glm::abs(plane.x)
+                             + batch.ey[i] * glm::abs(plane.y)
+                             + batch.ez[i] * glm::abs(plane.z);
+      if (dist + radius < 0.0f) {
+        outsideMask |= 1u << i;
+        break;
+      }
+    }
+  }
+#endif
+
+  uint numVisible = 0;
+  for (uint i = 0; i < count; ++i) {
+    const bool visible = batch.valid[i] && (outsideMask & (1u << i)) == 0;
+    outVisible[i] = visible ? 1 : 0;
+    numVisible += visible ? 1 : 0;
+  }
+  return numVisible;
+}
@@ -0,0 +1,86 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_CULLING_FRUSTUMCULLER_H_
+#define KORE_SRC_KORE_CULLING_FRUSTUMCULLER_H_
+
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/BoundingVolume.h"
+
+namespace kore {
+  /*! \brief Counters of one culling run. */
+  struct SCullingStats {
+    SCullingStats(void)
+      : numTested(0),
+        numVisible(0),
+        numCulled(0),
+        numOccluded(0) {
+    }
+
+    uint numTested;
+    uint numVisible;
+    uint numCulled;
+    uint numOccluded;  // Part of numCulled, hidden by occluders
+  };
+
+  /*! \brief Tests bounding volumes against a view frustum.
+  *   The volumes are processed in batches of eight, transposed into
+  *   structure-of-arrays form, and tested against all six planes with SSE
+  *   (two four-wide halves per batch). Without SSE, a scalar path is used.
+  */
+  class FrustumCuller {
+  public:
+    FrustumCuller(void);
+    ~FrustumCuller(void);
+
+    /*! \brief Tests boxes against the frustum. Empty boxes are culled.
+    *   \param boxes Pointers to the boxes to test.
+    *   \param count The number of boxes.
+    *   \param outVisible Receives 1 for every visible box, 0 otherwise.
+    *   \return The number of visible boxes. */
+    uint cull(const SFrustum& frustum, const SAABB* const* boxes,
+              const uint count, unsigned char* outVisible);
+
+    /*! \brief Tests spheres against the frustum. Empty spheres are culled.
+    *   \return The number of visible spheres. */
+    uint cull(const SFrustum& frustum, const SBoundingSphere* spheres,
+              const uint count, unsigned char* outVisible);
+
+  private:
+    static const uint BATCH_SIZE = 8;
+
+    // One batch in structure-of-arrays form. For spheres, ex holds the
+    // radius.
+    struct SBatch {
+      float cx[BATCH_SIZE];
+      float cy[BATCH_SIZE];
+      float cz[BATCH_SIZE];
+      float ex[BATCH_SIZE];
+      float ey[BATCH_SIZE];
+      float ez[BATCH_SIZE];
+      bool valid[BATCH_SIZE];
+    };
+
+    static uint testBatch(const SFrustum& frustum, const SBatch& batch,
+                          const bool spheres, const uint count,
+                          unsigned char* outVisible);
+  };
+};
+#endif  // KORE_SRC_KORE_CULLING_FRUSTUMCULLER_H_
@@ -0,0 +1,603 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "KoRE/Culling/GPUCuller.h"
+#include "KoRE/Mesh.h"
+#include "KoRE/SceneNode.h"
+#include "KoRE/SceneManager.h"
+#include "KoRE/RenderManager.h"
+#include "KoRE/ResourceManager.h"
+#include "KoRE/ShaderProgram.h"
+#include "KoRE/Texture.h"
+#include "KoRE/TransformHierarchy.h"
+#include "KoRE/Components/MeshComponent.h"
+#include "KoRE/Log.h"
+#include "KoRE/GLerror.h"
+
+namespace {
+  const char* CULL_SHADER_SOURCE =
+    "#version 430\n"
+    "layout(local_size_x = 64) in;\n"
+    "struct Object {\n"
+    "  mat4 transform;\n"
+    "  vec4 center;\n"
+    "  vec4 extents;\n"
+    "};\n"
+    "struct Command {\n"
+    "  uint count;\n"
+    "  uint instanceCount;\n"
+    "  uint firstIndex;\n"
+    "  int baseVertex;\n"
+    "  uint baseInstance;\n"
+    "};\n"
+    "layout(std430, binding = 0) readonly buffer Objects {\n"
+    "  Object objects[];\n"
+    "};\n"
+    "layout(std430, binding = 1) buffer Commands {\n"
+    "  Command commands[];\n"
+    "};\n"
+    "layout(std430, binding = 2) writeonly buffer VisibleIDs {\n"
+    "  uint visibleIDs[];\n"
+    "};\n"
+    "uniform mat4 u_viewProj;\n"
+    "uniform vec4 u_planes[6];\n"
+    "uniform uint u_numObjects;\n"
+    "uniform bool u_useHiZ;\n"
+    "uniform sampler2D u_hiZ;\n"
+    "uniform vec2 u_hiZSize;\n"
+    "uniform int u_hiZLevels;\n"
+    "\n"
+    "bool isOccluded(vec3 c, vec3 e) {\n"
+    "  vec3 minS = vec3(1.0);\n"
+    "  vec3 maxS = vec3(0.0);\n"
+    "  for (int i = 0; i < 8; ++i) {\n"
+    "    vec3 corner = c + e * vec3((i & 1) != 0 ? 1.0 : -1.0,\n"
+    "                               (i & 2) != 0 ? 1.0 : -1.0,\n"
+    "                               (i & 4) != 0 ? 1.0 : -1.0);\n"
+    "    vec4 clip = u_viewProj * vec4(corner, 1.0);\n"
+    "    if (clip.w <= 1e-6 || clip.z < -clip.w) {\n"
+    "      return false;\n"
+    "    }\n"
+    "    vec3 s = clip.xyz / clip.w * 0.5 + 0.5;\n"
+    "    minS = min(minS, s);\n"
+    "    maxS = max(maxS, s);\n"
+    "  }\n"
+    "  minS.xy = clamp(minS.xy, 0.0, 1.0);\n"
+    "  maxS.xy = clamp(maxS.xy, 0.0, 1.0);\n"
+    "  vec2 size = (maxS.xy - minS.xy) * u_hiZSize;\n"
+    "  int level = clamp(int(ceil(log2(max(max(size.x, size.y), 1.0)))),\n"
+    "                    0, u_hiZLevels - 1);\n"
+    "  ivec2 t0, t1;\n"
+    "  for (; level < u_hiZLevels; ++level) {\n"
+    "    ivec2 levelSize = textureSize(u_hiZ, level);\n"
+    "    t0 = clamp(ivec2(minS.xy * vec2(levelSize)), ivec2(0),\n"
+    "               levelSize - 1);\n"
+    "    t1 = clamp(ivec2(maxS.xy * vec2(levelSize)), ivec2(0),\n"
+    "               levelSize - 1);\n"
+    "    if (all(lessThanEqual(t1 - t0, ivec2(1)))) {\n"
+    "      break;\n"
+    "    }\n"
+    "  }\n"
+    "  if (level == u_hiZLevels) {\n"
+    "    return false;\n"
+    "  }\n"
+    "  float maxDepth =\n"
+    "    max(max(texelFetch(u_hiZ, t0, level).r,\n"
+    "            texelFetch(u_hiZ, ivec2(t1.x, t0.y), level).r),\n"
+    "        max(texelFetch(u_hiZ, ivec2(t0.x, t1.y), level).r,\n"
+    "            texelFetch(u_hiZ, t1, level).r));\n"
+    "  return minS.z > maxDepth;\n"
+    "}\n"
+    "\n"
+    "void main() {\n"
+    "  uint id = gl_GlobalInvocationID.x;\n"
+    "  if (id >= u_numObjects) {\n"
+    "    return;\n"
+    "  }\n"
+    "  mat4 m = objects[id].transform;\n"
+    "  vec4 localCenter = objects[id].center;\n"
+    "  vec3 localExtents = objects[id].extents.xyz;\n"
+    "  vec3 c = (m * vec4(localCenter.xyz, 1.0)).xyz;\n"
+    "  vec3 e = abs(m[0].xyz) * localExtents.x\n"
+    "         + abs(m[1].xyz) * localExtents.y\n"
+    "         + abs(m[2].xyz) * localExtents.z;\n"
+    "  for (int i = 0; i < 6; ++i) {\n"
+    "    if (dot(u_planes[i].xyz, c) + dot(abs(u_planes[i].xyz), e)\n"
+    "        + u_planes[i].w < 0.0) {\n"
+    "      return;\n"
+    "    }\n"
+    "  }\n"
+    "  if (u_useHiZ && isOccluded(c, e)) {\n"
+    "    return;\n"
+    "  }\n"
+    "  uint group = floatBitsToUint(localCenter.w);\n"
+    "  uint slot = atomicAdd(commands[group].instanceCount, 1u);\n"
+    "  visibleIDs[commands[group].baseInstance + slot] = id;\n"
+    "}\n";
+
+  // Reduces one level of the pyramid to the next one with a max-filter.
+  // Odd sizes include the extra row/column. u_copy copies the depth
+  // texture into level 0.
+  const char* HIZ_SHADER_SOURCE =
+    "#version 430\n"
+    "layout(local_size_x = 8, local_size_y = 8) in;\n"
+    "layout(r32f) writeonly uniform image2D u_dst;\n"
+    "uniform sampler2D u_src;\n"
+    "uniform int u_srcLevel;\n"
+    "uniform ivec2 u_srcSize;\n"
+    "uniform ivec2 u_dstSize;\n"
+    "uniform bool u_copy;\n"
+    "\n"
+    "void main() {\n"
+    "  ivec2 p = ivec2(gl_GlobalInvocationID.xy);\n"
+    "  if (any(greaterThanEqual(p, u_dstSize))) {\n"
+    "    return;\n"
+    "  }\n"
+    "  float depth = 0.0;\n"
+    "  if (u_copy) {\n"
+    "    depth = texelFetch(u_src, p, u_srcLevel).r;\n"
+    "  } else {\n"
+    "    ivec2 s = p * 2;\n"
+    "    ivec2 last = s + 1;\n"
+    "    if (p.x == u_dstSize.x - 1) {\n"
+    "      last.x = u_srcSize.x - 1;\n"
+    "    }\n"
+    "    if (p.y == u_dstSize.y - 1) {\n"
+    "      last.y = u_srcSize.y - 1;\n"
+    "    }\n"
+    "    last = min(last, u_srcSize - 1);\n"
+    "    for (int y = s.y; y <= last.y; ++y) {\n"
+    "      for (int x = s.x; x <= last.x; ++x) {\n"
+    "        depth = max(depth, texelFetch(u_src, ivec2(x, y),\n"
+    "                                      u_srcLevel).r);\n"
+    "      }\n"
+    "    }\n"
+    "  }\n"
+    "  imageStore(u_dst, p, vec4(depth));\n"
+    "}\n";
+
+  kore::ShaderProgram* createComputeProgram(const char* source,
+                                            const std::string& name) {
+    kore::ShaderProgram* program = new kore::ShaderProgram;
+    program->setName(name);
+    program->loadShaderSource(source, GL_COMPUTE_SHADER, name + ".comp");
+    if (!program->init()) {
+      delete program;
+      return NULL;
+    }
+    kore::ResourceManager::getInstance()->addShaderProgram(program);
+    return program;
+  }
+
+  // Number of work groups to cover size invocations
+  inline GLuint numGroups(const uint size, const uint groupSize) {
+    return (size + groupSize - 1) / groupSize;
+  }
+}
+
+kore::GPUCuller::GPUCuller(void)
+  : _dirtyBegin(0),
+    _dirtyEnd(0),
+    _layoutDirty(true),
+    _hierarchyVersion(KORE_UINT_INVALID),
+    _depthTexture(NULL),
+    _hiZTexture(0),
+    _hiZWidth(0),
+    _hiZHeight(0),
+    _hiZLevels(0),
+    _cullProgram(NULL),
+    _hiZProgram(NULL),
+    _pointSampler(NULL),
+    _pointMipSampler(NULL),
+    _objectBuffer(0),
+    _commandBuffer(0),
+    _visibleIDBuffer(0),
+    _objectCapacity(0) {
+}
+
+kore::GPUCuller::~GPUCuller(void) {
+  destroy();
+}
+
+bool kore::GPUCuller::init(void) {
+  if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "GPUCuller: compute shaders are not "
+                   "supported\n");
+    return false;
+  }
+
+  destroy();
+  _cullProgram = createComputeProgram(CULL_SHADER_SOURCE, "GPUCuller::cull");
+  _hiZProgram = createComputeProgram(HIZ_SHADER_SOURCE, "GPUCuller::hiZ");
+  if (_cullProgram == NULL || _hiZProgram == NULL) {
+    destroy();
+    return false;
+  }
+
+  _locViewProj = _cullProgram->getUniformLocation("u_viewProj");
+  _locPlanes = _cullProgram->getUniformLocation("u_planes");
+  _locNumObjects = _cullProgram->getUniformLocation("u_numObjects");
+  _locUseHiZ = _cullProgram->getUniformLocation("u_useHiZ");
+  _locHiZ = _cullProgram->getUniformLocation("u_hiZ");
+  _locHiZSize = _cullProgram->getUniformLocation("u_hiZSize");
+  _locHiZLevels = _cullProgram->getUniformLocation("u_hiZLevels");
+  _locSrc = _hiZProgram->getUniformLocation("u_src");
+  _locSrcLevel = _hiZProgram->getUniformLocation("u_srcLevel");
+  _locSrcSize = _hiZProgram->getUniformLocation("u_srcSize");
+  _locDstSize = _hiZProgram->getUniformLocation("u_dstSize");
+  _locCopy = _hiZProgram->getUniformLocation("u_copy");
+
+  // All reads are texelFetches, so only completeness matters.
+  ResourceManager* resMgr = ResourceManager::getInstance();
+  TexSamplerProperties samplerProps;
+  samplerProps.wrapping = glm::uvec3(GL_CLAMP_TO_EDGE);
+  samplerProps.magfilter = GL_NEAREST;
+  samplerProps.minfilter = GL_NEAREST;
+  _pointSampler = resMgr->requestTextureSampler(samplerProps);
+  samplerProps.minfilter = GL_NEAREST_MIPMAP_NEAREST;
+  _pointMipSampler = resMgr->requestTextureSampler(samplerProps);
+
+  glGenBuffers(1, &_objectBuffer);
+  glGenBuffers(1, &_commandBuffer);
+  glGenBuffers(1, &_visibleIDBuffer);
+  _objectCapacity = 0;
+  _layoutDirty = true;
+  return true;
+}
+
+void kore::GPUCuller::destroy(void) {
+  ResourceManager* resMgr = ResourceManager::getInstance();
+  if (_cullProgram != NULL) {
+    resMgr->removeShaderProgram(_cullProgram);
+    _cullProgram = NULL;
+  }
+  if (_hiZProgram != NULL) {
+    resMgr->removeShaderProgram(_hiZProgram);
+    _hiZProgram = NULL;
+  }
+  if (_pointSampler != NULL) {
+    resMgr->releaseTextureSampler(_pointSampler);
+    resMgr->releaseTextureSampler(_pointMipSampler);
+    _pointSampler = _pointMipSampler = NULL;
+  }
+  if (_hiZTexture != 0) {
+    glDeleteTextures(1, &_hiZTexture);
+    _hiZTexture = 0;
+    _hiZWidth = _hiZHeight = _hiZLevels = 0;
+  }
+
+  GLuint buffers[] = {_objectBuffer, _commandBuffer, _visibleIDBuffer};
+  for (uint i = 0; i < 3; ++i) {
+    if (buffers[i] != 0) {
+      glDeleteBuffers(1, &buffers[i]);
+    }
+  }
+  _objectBuffer = _commandBuffer = _visibleIDBuffer = 0;
+  _objectCapacity = 0;
+}
+
+uint kore::GPUCuller::addDrawGroup(const Mesh* mesh) {
+  if (mesh == NULL) {
+    return KORE_UINT_INVALID;
+  }
+
+  SDrawGroup group;
+  group.mesh = mesh;
+  group.numObjects = 0;
+  _groups.push_back(group);
+
+  SDrawIndirectCommand command;
+  memset(&command, 0, sizeof(SDrawIndirectCommand));
+  command.count = mesh->hasIndices()
+    ? static_cast<GLuint>(mesh->getIndices().size())
+    : mesh->getNumVertices();
+  _commands.push_back(command);
+
+  _layoutDirty = true;
+  return static_cast<uint>(_groups.size()) - 1;
+}
+
+uint kore::GPUCuller::addObject(const uint group, const SAABB& localBounds,
+                                const glm::mat4& transform) {
+  if (group >= _groups.size() || localBounds.isEmpty()) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "GPUCuller: invalid object\n");
+    return KORE_UINT_INVALID;
+  }
+
+  SGPUObject object;
+  object.transform = transform;
+  object.center = glm::vec4(localBounds.getCenter(), 0.0f);
+  object.extents = glm::vec4(localBounds.getExtents(), 0.0f);
+  // The shader reads the group index from the bits of center.w
+  memcpy(&object.center.w, &group, sizeof(uint));
+
+  _objects.push_back(object);
+  _objectGroups.push_back(group);
+  ++_groups[group].numObjects;
+  _layoutDirty = true;
+  return static_cast<uint>(_objects.size()) - 1;
+}
+
+uint kore::GPUCuller::addSceneNode(SceneNode* node) {
+  if (node == NULL) {
+    return KORE_UINT_INVALID;
+  }
+
+  uint firstObject = KORE_UINT_INVALID;
+  const std::vector<SceneNodeComponent*>& components = node->getComponents();
+  for (uint i = 0; i < components.size(); ++i) {
+    if (components[i]->getType() != COMPONENT_MESH) {
+      continue;
+    }
+
+    const Mesh* mesh = static_cast<MeshComponent*>(components[i])->getMesh();
+    if (mesh == NULL || mesh->getAABB().isEmpty()) {
+      continue;
+    }
+
+    uint group = KORE_UINT_INVALID;
+    for (uint iGroup = 0; iGroup < _groups.size(); ++iGroup) {
+      if (_groups[iGroup].mesh == mesh) {
+        group = iGroup;
+        break;
+      }
+    }
+    if (group == KORE_UINT_INVALID) {
+      group = addDrawGroup(mesh);
+    }
+
+    const uint object = addObject(group, mesh->getAABB(),
+                                  node->getTransform()->getGlobal());
+    _nodeObjects.push_back(std::make_pair(node, object));
+    if (firstObject == KORE_UINT_INVALID) {
+      firstObject = object;
+    }
+  }
+
+  _hierarchyVersion = KORE_UINT_INVALID;
+  return firstObject;
+}
+
+void kore::GPUCuller::setTransform(const uint object,
+                                   const glm::mat4& transform) {
+  if (object >= _objects.size()) {
+    return;
+  }
+
+  _objects[object].transform = transform;
+  if (_dirtyBegin >= _dirtyEnd) {
+    _dirtyBegin = object;
+    _dirtyEnd = object + 1;
+  } else {
+    _dirtyBegin = std::min(_dirtyBegin, object);
+    _dirtyEnd = std::max(_dirtyEnd, object + 1);
+  }
+}
+
+void kore::GPUCuller::updateSceneNodes(void) {
+  if (_nodeObjects.empty()) {
+    return;
+  }
+
+  const TransformHierarchy* hierarchy =
+    SceneManager::getInstance()->getTransformHierarchy();
+
+  // After structural changes, all node transforms are refreshed and the
+  // lookup from hierarchy indices is rebuilt. Otherwise only the nodes
+  // changed by the last update are touched.
+  if (_hierarchyVersion != hierarchy->getStructureVersion()) {
+    _hierarchyVersion = hierarchy->getStructureVersion();
+    _hierarchyToNodeObject.assign(hierarchy->size(), KORE_UINT_INVALID);
+    for (uint i = 0; i < _nodeObjects.size(); ++i) {
+      SceneNode* node = _nodeObjects[i].first;
+      setTransform(_nodeObjects[i].second, node->getTransform()->getGlobal());
+
+      // Nodes with several meshes map to their first entry, the others
+      // follow directly.
+      const uint hierarchyIdx = node->getHierarchyIndex();
+      if (hierarchyIdx < _hierarchyToNodeObject.size()
+          && _hierarchyToNodeObject[hierarchyIdx] == KORE_UINT_INVALID) {
+        _hierarchyToNodeObject[hierarchyIdx] = i;
+      }
+    }
+    return;
+  }
+
+  const std::vector<uint>& changed = hierarchy->getChangedNodes();
+  for (uint i = 0; i < changed.size(); ++i) {
+    if (changed[i] >= _hierarchyToNodeObject.size()
+        || _hierarchyToNodeObject[changed[i]] == KORE_UINT_INVALID) {
+      continue;
+    }
+
+    for (uint iEntry = _hierarchyToNodeObject[changed[i]];
+         iEntry < _nodeObjects.size(); ++iEntry) {
+      SceneNode* node = _nodeObjects[iEntry].first;
+      if (node->getHierarchyIndex() != changed[i]) {
+        break;
+      }
+      setTransform(_nodeObjects[iEntry].second,
+                   node->getTransform()->getGlobal());
+    }
+  }
+}
+
+void kore::GPUCuller::uploadObjects(void) {
+  RenderManager* renderMgr = RenderManager::getInstance();
+  const uint numObjects = static_cast<uint>(_objects.size());
+
+  if (_layoutDirty) {
+    // Every group gets a range of the visible-ID buffer.
+    uint offset = 0;
+    for (uint i = 0; i < _groups.size(); ++i) {
+      _commands[i].baseInstance = offset;
+      if (!_groups[i].mesh->hasIndices()) {
+        // baseInstance of a DrawArraysIndirectCommand
+        _commands[i].baseVertex = static_cast<GLint>(offset);
+      }
+      offset += _groups[i].numObjects;
+    }
+
+    if (numObjects > _objectCapacity) {
+      _objectCapacity = std::max(numObjects, _objectCapacity * 2);
+      renderMgr->bindBuffer(GL_SHADER_STORAGE_BUFFER, _objectBuffer);
+      glBufferData(GL_SHADER_STORAGE_BUFFER,
+                   _objectCapacity * sizeof(SGPUObject), NULL,
+                   GL_DYNAMIC_DRAW);
+      renderMgr->bindBuffer(GL_SHADER_STORAGE_BUFFER, _visibleIDBuffer);
+      glBufferData(GL_SHADER_STORAGE_BUFFER, _objectCapacity * sizeof(uint),
+                   NULL, GL_DYNAMIC_COPY);
+    }
+
+    renderMgr->bindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 _commands.size() * sizeof(SDrawIndirectCommand), NULL,
+                 GL_DYNAMIC_DRAW);
+    _dirtyBegin = 0;
+    _dirtyEnd = numObjects;
+    _layoutDirty = false;
+  }
+
+  if (_dirtyBegin < _dirtyEnd) {
+    renderMgr->bindBuffer(GL_SHADER_STORAGE_BUFFER, _objectBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                    _dirtyBegin * sizeof(SGPUObject),
+                    (_dirtyEnd - _dirtyBegin) * sizeof(SGPUObject),
+                    &_objects[_dirtyBegin]);
+    _dirtyBegin = _dirtyEnd = 0;
+  }
+
+  // Resets the instance counts for this frame.
+  renderMgr->bindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+  glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0,
+                  _commands.size() * sizeof(SDrawIndirectCommand),
+                  &_commands[0]);
+}
+
+void kore::GPUCuller::createHiZ(const uint width, const uint height) {
+  if (_hiZTexture != 0) {
+    glDeleteTextures(1, &_hiZTexture);
+  }
+
+  _hiZWidth = width;
+  _hiZHeight = height;
+  _hiZLevels = 1;
+  for (uint size = std::max(width, height); size > 1; size /= 2) {
+    ++_hiZLevels;
+  }
+
+  RenderManager* renderMgr = RenderManager::getInstance();
+  glGenTextures(1, &_hiZTexture);
+  renderMgr->bindTexture(0, GL_TEXTURE_2D, _hiZTexture);
+  glTexStorage2D(GL_TEXTURE_2D, _hiZLevels, GL_R32F, width, height);
+}
+
+void kore::GPUCuller::buildHiZ(void) {
+  const STextureProperties& props = _depthTexture->getProperties();
+  if (_hiZTexture == 0 || _hiZWidth != props.width
+      || _hiZHeight != props.height) {
+    createHiZ(props.width, props.height);
+  }
+
+  RenderManager* renderMgr = RenderManager::getInstance();
+  renderMgr->useShaderProgram(_hiZProgram->getProgramLocation());
+  glUniform1i(_locSrc, 0);
+  const glm::uvec3& groupSize = _hiZProgram->getComputeWorkGroupSize();
+
+  uint srcWidth = props.width;
+  uint srcHeight = props.height;
+  for (uint level = 0; level < _hiZLevels; ++level) {
+    const uint dstWidth = level == 0 ? srcWidth : std::max(1U, srcWidth / 2);
+    const uint dstHeight = level == 0 ? srcHeight
+                                      : std::max(1U, srcHeight / 2);
+    if (level == 0) {
+      renderMgr->bindTexture(0, GL_TEXTURE_2D, _depthTexture->getHandle());
+      renderMgr->bindSampler(0, _pointSampler->getHandle());
+      glUniform1i(_locSrcLevel, 0);
+    } else {
+      renderMgr->bindTexture(0, GL_TEXTURE_2D, _hiZTexture);
+      renderMgr->bindSampler(0, _pointMipSampler->getHandle());
+      glUniform1i(_locSrcLevel, level - 1);
+    }
+    glUniform1i(_locCopy, level == 0 ? GL_TRUE : GL_FALSE);
+    glUniform2i(_locSrcSize, srcWidth, srcHeight);
+    glUniform2i(_locDstSize, dstWidth, dstHeight);
+    glBindImageTexture(0, _hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY,
+                       GL_R32F);
+
+    glDispatchCompute(numGroups(dstWidth, groupSize.x),
+                      numGroups(dstHeight, groupSize.y), 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    srcWidth = dstWidth;
+    srcHeight = dstHeight;
+  }
+}
+
+void kore::GPUCuller::cull(const glm::mat4& viewProj) {
+  if (_cullProgram == NULL || _objects.empty()) {
+    return;
+  }
+
+  KORE_GL_CHECK_START();
+  updateSceneNodes();
+  uploadObjects();
+
+  const bool useHiZ = _depthTexture != NULL;
+  if (useHiZ) {
+    buildHiZ();
+  }
+
+  SFrustum frustum;
+  frustum.setFromMatrix(viewProj);
+
+  RenderManager* renderMgr = RenderManager::getInstance();
+  renderMgr->useShaderProgram(_cullProgram->getProgramLocation());
+  glUniformMatrix4fv(_locViewProj, 1, GL_FALSE, &viewProj[0][0]);
+  glUniform4fv(_locPlanes, 6, &frustum.planes[0][0]);
+  glUniform1ui(_locNumObjects, static_cast<GLuint>(_objects.size()));
+  glUniform1i(_locUseHiZ, useHiZ ? GL_TRUE : GL_FALSE);
+  if (useHiZ) {
+    renderMgr->bindTexture(0, GL_TEXTURE_2D, _hiZTexture);
+    renderMgr->bindSampler(0, _pointMipSampler->getHandle());
+    glUniform1i(_locHiZ, 0);
+    glUniform2f(_locHiZSize, static_cast<float>(_hiZWidth),
+                static_cast<float>(_hiZHeight));
+    glUniform1i(_locHiZLevels, _hiZLevels);
+  }
+
+  renderMgr->bindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING_OBJECTS,
+                            _objectBuffer);
+  renderMgr->bindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING_COMMANDS,
+                            _commandBuffer);
+  renderMgr->bindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING_VISIBLE_IDS,
+                            _visibleIDBuffer);
+
+  const uint numObjects = static_cast<uint>(_objects.size());
+  glDispatchCompute(
+    numGroups(numObjects, _cullProgram->getComputeWorkGroupSize().x), 1, 1);
+
+  // The commands are consumed as indirect draws, the visible IDs by the
+  // vertex shaders.
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+  KORE_GL_CHECK_FINISH("GPUCuller::cull", NULL);
+}
@@ -0,0 +1,180 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_CULLING_GPUCULLER_H_
+#define KORE_SRC_KORE_CULLING_GPUCULLER_H_
+
+#include <map>
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/BoundingVolume.h"
+
+namespace kore {
+  class Mesh;
+  class SceneNode;
+  class ShaderProgram;
+  class Texture;
+  class TextureSampler;
+
+  /*! \brief Layout of one command in the indirect buffer. Equals a
+  *          DrawElementsIndirectCommand. Non-indexed groups use the first
+  *          four members as DrawArraysIndirectCommand (firstIndex is the
+  *          first vertex and baseVertex the base instance). */
+  struct SDrawIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+  };
+
+  /*! \brief Frustum and Hi-Z occlusion culling in a compute shader.
+  *   Objects are instances of a draw group (a mesh). Their transforms and
+  *   local bounds are kept in a shader storage buffer, which is only
+  *   updated for changed objects. cull() resets the instance counts of all
+  *   commands, tests every object in parallel on the GPU and appends the
+  *   survivors of each group to its range in the visible-ID buffer:
+  *
+  *     visibleIDs[command.baseInstance + i], i < command.instanceCount
+  *
+  *   Each group is then drawn with one indirect draw of its command
+  *   (see getCommandOffset() and DrawIndirectOp), without reading anything
+  *   back to the CPU. The vertex shader fetches the object of an instance
+  *   with gl_BaseInstanceARB + gl_InstanceID from the visible-ID buffer.
+  *   The Hi-Z test uses a max-depth pyramid, which is built from a depth
+  *   texture of the previous frame if one is set.
+  *   Requires OpenGL 4.3.
+  */
+  class GPUCuller {
+  public:
+    /// Binding points of the buffers in the culling shader
+    enum EBindingPoint {
+      BINDING_OBJECTS = 0,
+      BINDING_COMMANDS = 1,
+      BINDING_VISIBLE_IDS = 2
+    };
+
+    GPUCuller(void);
+    ~GPUCuller(void);
+
+    /*! \brief Creates the compute ShaderPrograms, which are registered
+    *          with the ResourceManager, and the buffers.
+    *   \return False, if compute shaders are not supported. */
+    bool init(void);
+    void destroy(void);
+
+    /*! \brief Adds a draw group for a mesh and returns its index. */
+    uint addDrawGroup(const Mesh* mesh);
+
+    /*! \brief Adds an object to a group and returns its index. */
+    uint addObject(const uint group, const SAABB& localBounds,
+                   const glm::mat4& transform);
+
+    /*! \brief Adds an object for every mesh of a node. Its transform is
+    *          updated from the TransformHierarchy of the SceneManager.
+    *   \return The index of the first object or KORE_UINT_INVALID. */
+    uint addSceneNode(SceneNode* node);
+
+    void setTransform(const uint object, const glm::mat4& transform);
+
+    /*! \brief Sets the depth texture used to build the Hi-Z pyramid, e.g.
+    *          the depth attachment of the last frame. NULL disables the
+    *          occlusion test. */
+    inline void setDepthTexture(const Texture* depth) {_depthTexture = depth;}
+
+    /*! \brief Uploads changed objects and runs the culling shader.
+    *          Call once per frame after SceneManager::update(). */
+    void cull(const glm::mat4& viewProj);
+
+    inline uint getNumObjects(void) const
+      {return static_cast<uint>(_objects.size());}
+    inline uint getNumDrawGroups(void) const
+      {return static_cast<uint>(_groups.size());}
+
+    inline GLuint getObjectBuffer(void) const {return _objectBuffer;}
+    inline GLuint getCommandBuffer(void) const {return _commandBuffer;}
+    inline GLuint getVisibleIDBuffer(void) const {return _visibleIDBuffer;}
+
+    /*! \brief Byte offset of the command of a group in the command buffer */
+    inline GLuint getCommandOffset(const uint group) const
+      {return group * sizeof(SDrawIndirectCommand);}
+
+  private:
+    // std430 layout of an object in the object buffer.
+    // center.w holds the group index as uint bits.
+    struct SGPUObject {
+      glm::mat4 transform;
+      glm::vec4 center;
+      glm::vec4 extents;
+    };
+
+    struct SDrawGroup {
+      const Mesh* mesh;
+      uint numObjects;
+    };
+
+    void updateSceneNodes(void);
+    void uploadObjects(void);
+    void buildHiZ(void);
+    void createHiZ(const uint width, const uint height);
+
+    std::vector<SGPUObject> _objects;
+    std::vector<uint> _objectGroups;
+    std::vector<SDrawGroup> _groups;
+    std::vector<SDrawIndirectCommand> _commands;
+    uint _dirtyBegin;
+    uint _dirtyEnd;
+    bool _layoutDirty;
+
+    std::vector<std::pair<SceneNode*, uint> > _nodeObjects;
+    std::vector<uint> _hierarchyToNodeObject;
+    uint _hierarchyVersion;
+
+    const Texture* _depthTexture;
+    GLuint _hiZTexture;
+    uint _hiZWidth;
+    uint _hiZHeight;
+    uint _hiZLevels;
+
+    ShaderProgram* _cullProgram;
+    ShaderProgram* _hiZProgram;
+    // Depth textures have a single level, so they are only complete with a
+    // non-mipmapped filter. The pyramid levels need a mipmapped one.
+    const TextureSampler* _pointSampler;
+    const TextureSampler* _pointMipSampler;
+    GLuint _objectBuffer;
+    GLuint _commandBuffer;
+    GLuint _visibleIDBuffer;
+    uint _objectCapacity;
+
+    GLint _locViewProj;
+    GLint _locPlanes;
+    GLint _locNumObjects;
+    GLint _locUseHiZ;
+    GLint _locHiZ;
+    GLint _locHiZSize;
+    GLint _locHiZLevels;
+    GLint _locSrc;
+    GLint _locSrcLevel;
+    GLint _locSrcSize;
+    GLint _locDstSize;
+    GLint _locCopy;
+  };
+};
+#endif  // KORE_SRC_KORE_CULLING_GPUCULLER_H_
@@ -0,0 +1,541 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KORE_OCCLUSION_SSE
+#endif
+#include "KoRE/Culling/OcclusionCuller.h"
+#include "KoRE/SceneNode.h"
+#include "KoRE/Components/MeshComponent.h"
+#include "KoRE/Log.h"
+
+namespace {
+  const float W_EPSILON = 1e-6f;
+
+  // Projects a point to screen space (pixels, depth in [0,1]).
+  // Returns false if the point lies in front of the near plane.
+  inline bool project(const glm::mat4& viewProj, const glm::vec3& point,
+                      const float width, const float height,
+                      glm::vec4& outScreen) {
+    const glm::vec4 clip = viewProj * glm::vec4(point, 1.0f);
+    if (clip.w <= W_EPSILON || clip.z < -clip.w) {
+      return false;
+    }
+    const float invW = 1.0f / clip.w;
+    outScreen = glm::vec4((clip.x * invW * 0.5f + 0.5f) * width,
+                          (clip.y * invW * 0.5f + 0.5f) * height,
+                          clip.z * invW * 0.5f + 0.5f,
+                          1.0f);
+    return true;
+  }
+}
+
+kore::OcclusionCuller::OcclusionCuller(const uint width, const uint height)
+  : _width(((width > 0 ? width : 1) + TILE_SIZE - 1) & ~(TILE_SIZE - 1)),
+    _height(height > 0 ? height : 1),
+    _numThreads(1),
+    _rendered(false),
+    _frame(0),
+    _numPending(0),
+    _bandHeight(0),
+    _stopWorkers(false) {
+  _tilesX = _width / TILE_SIZE;
+  _tilesY = (_height + TILE_SIZE - 1) / TILE_SIZE;
+  _depth.assign(_width * _height, 1.0f);
+
+  // Level 0 holds the tiles, every further level halves the resolution
+  // until a single texel remains.
+  SHiZLevel level;
+  level.offset = 0;
+  level.width = _tilesX;
+  level.height = _tilesY;
+  _hiZLevels.push_back(level);
+  while (level.width > 1 || level.height > 1) {
+    level.offset += level.width * level.height;
+    level.width = (level.width + 1) / 2;
+    level.height = (level.height + 1) / 2;
+    _hiZLevels.push_back(level);
+  }
+  _hiZ.assign(level.offset + 1, 1.0f);
+
+  const uint hwThreads = std::thread::hardware_concurrency();
+  setNumThreads(hwThreads > 0 ? hwThreads : 1);
+}
+
+kore::OcclusionCuller::~OcclusionCuller(void) {
+  stopWorkers();
+  clearOccluders();
+}
+
+bool kore::OcclusionCuller::addOccluder(SceneNode* node) {
+  if (node == NULL) {
+    return false;
+  }
+
+  bool added = false;
+  const std::vector<SceneNodeComponent*>& components = node->getComponents();
+  for (uint i = 0; i < components.size(); ++i) {
+    if (components[i]->getType() != COMPONENT_MESH) {
+      continue;
+    }
+
+    const Mesh* mesh = static_cast<MeshComponent*>(components[i])->getMesh();
+    if (mesh == NULL || mesh->getCPUPositions().empty()) {
+      continue;
+    }
+
+    SOccluder* occluder = new SOccluder;
+    occluder->node = node;
+    occluder->positions = &mesh->getCPUPositions();
+    occluder->indices = &mesh->getIndices();
+    _occluders.push_back(occluder);
+    added = true;
+  }
+
+  if (!added) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "SceneNode %s has no mesh with CPU "
+                   "positions to be used as occluder\n",
+                   node->getName().c_str());
+  }
+  return added;
+}
+
+void kore::OcclusionCuller::
+addOccluder(SceneNode* node, const std::vector<glm::vec3>& positions,
+            const std::vector<uint>& indices) {
+  if (node == NULL || positions.empty()) {
+    return;
+  }
+
+  SOccluder* occluder = new SOccluder;
+  occluder->node = node;
+  occluder->ownPositions = positions;
+  occluder->ownIndices = indices;
+  occluder->positions = &occluder->ownPositions;
+  occluder->indices = &occluder->ownIndices;
+  _occluders.push_back(occluder);
+}
+
+void kore::OcclusionCuller::removeOccluder(const SceneNode* node) {
+  for (uint i = 0; i < _occluders.size(); ) {
+    if (_occluders[i]->node == node) {
+      delete _occluders[i];
+      _occluders.erase(_occluders.begin() + i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+void kore::OcclusionCuller::clearOccluders(void) {
+  for (uint i = 0; i < _occluders.size(); ++i) {
+    delete _occluders[i];
+  }
+  _occluders.clear();
+  _rendered = false;
+}
+
+void kore::OcclusionCuller::setNumThreads(const uint numThreads) {
+  const uint clamped = std::max(1U, std::min(numThreads, _tilesY));
+  if (clamped == _numThreads && _workers.size() + 1 == _numThreads) {
+    return;
+  }
+  stopWorkers();
+  _numThreads = clamped;
+  startWorkers();
+}
+
+void kore::OcclusionCuller::startWorkers(void) {
+  _stopWorkers = false;
+  for (uint band = 1; band < _numThreads; ++band) {
+    _workers.push_back(std::thread(&OcclusionCuller::workerLoop, this,
+                                   band, _frame));
+  }
+}
+
+void kore::OcclusionCuller::stopWorkers(void) {
+  {
+    std::lock_guard<std::mutex> lock(_workMutex);
+    _stopWorkers = true;
+  }
+  _workCondition.notify_all();
+  for (uint i = 0; i < _workers.size(); ++i) {
+    _workers[i].join();
+  }
+  _workers.clear();
+}
+
+void kore::OcclusionCuller::workerLoop(const uint band, uint frame) {
+  while (true) {
+    uint yBegin;
+    uint yEnd;
+    {
+      std::unique_lock<std::mutex> lock(_workMutex);
+      _workCondition.wait(lock, [this, frame] {
+        return _stopWorkers || _frame != frame;
+      });
+      if (_stopWorkers) {
+        return;
+      }
+      frame = _frame;
+      yBegin = std::min(band * _bandHeight, _height);
+      yEnd = std::min(yBegin + _bandHeight, _height);
+    }
+
+    // With fewer tile rows than threads, the last workers have no band.
+    if (yBegin < yEnd) {
+      renderBand(yBegin, yEnd);
+    }
+
+    std::lock_guard<std::mutex> lock(_workMutex);
+    if (--_numPending == 0) {
+      _doneCondition.notify_one();
+    }
+  }
+}
+
+void kore::OcclusionCuller::render(const glm::mat4& viewProj) {
+  _viewProj = viewProj;
+  transformOccluders();
+
+  // Every thread renders a band of whole tile rows, so it can also build
+  // the hierarchical Z of its band without synchronization.
+  const uint tilesPerBand = (_tilesY + _numThreads - 1) / _numThreads;
+  const uint bandHeight = tilesPerBand * TILE_SIZE;
+
+  if (!_workers.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(_workMutex);
+      _bandHeight = bandHeight;
+      _numPending = static_cast<uint>(_workers.size());
+      ++_frame;
+    }
+    _workCondition.notify_all();
+  }
+
+  renderBand(0, std::min(bandHeight, _height));
+
+  if (!_workers.empty()) {
+    std::unique_lock<std::mutex> lock(_workMutex);
+    _doneCondition.wait(lock, [this] {return _numPending == 0;});
+  }
+  buildHiZLevels();
+  _rendered = true;
+}
+
+void kore::OcclusionCuller::transformOccluders(void) {
+  _screenVertices.clear();
+  _triangles.clear();
+
+  const float width = static_cast<float>(_width);
+  const float height = static_cast<float>(_height);
+  for (uint iOcc = 0; iOcc < _occluders.size(); ++iOcc) {
+    const SOccluder* occluder = _occluders[iOcc];
+    const glm::mat4 mvp =
+      _viewProj * occluder->node->getTransform()->getGlobal();
+
+    const uint base = static_cast<uint>(_screenVertices.size());
+    const std::vector<glm::vec3>& positions = *occluder->positions;
+    const uint numPositions = static_cast<uint>(positions.size());
+    for (uint i = 0; i < numPositions; ++i) {
+      glm::vec4 screen;
+      if (!project(mvp, positions[i], width, height, screen)) {
+        screen = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+      }
+      _screenVertices.push_back(screen);
+    }
+
+    // Non-indexed meshes are treated as triangle lists.
+    const std::vector<uint>& indices = *occluder->indices;
+    if (indices.empty()) {
+      for (uint i = 0; i + 2 < numPositions; i += 3) {
+        _triangles.push_back(base + i);
+        _triangles.push_back(base + i + 1);
+        _triangles.push_back(base + i + 2);
+      }
+      continue;
+    }
+
+    for (uint i = 0; i + 2 < indices.size(); i += 3) {
+      if (indices[i] >= numPositions || indices[i + 1] >= numPositions
+          || indices[i + 2] >= numPositions) {
+        continue;
+      }
+      _triangles.push_back(base + indices[i]);
+      _triangles.push_back(base + indices[i + 1]);
+      _triangles.push_back(base + indices[i + 2]);
+    }
+  }
+}
+
+void kore::OcclusionCuller::renderBand(const uint yBegin, const uint yEnd) {
+  std::fill(_depth.begin() + yBegin * _width,
+            _depth.begin() + yEnd * _width, 1.0f);
+
+  for (uint i = 0; i < _triangles.size(); i += 3) {
+    const glm::vec4& a = _screenVertices[_triangles[i]];
+    const glm::vec4& b = _screenVertices[_triangles[i + 1]];
+    const glm::vec4& c = _screenVertices[_triangles[i + 2]];
+    // Triangles crossing the near plane are skipped instead of clipped.
+    if (a.w < 0.0f || b.w < 0.0f || c.w < 0.0f) {
+      continue;
+    }
+    rasterizeTriangle(a, b, c, yBegin, yEnd);
+  }
+
+  // Max-depth of every tile
+  for (uint ty = yBegin / TILE_SIZE; ty * TILE_SIZE < yEnd; ++ty) {
+    const uint tileYEnd = std::min((ty + 1) * TILE_SIZE, yEnd);
+    for (uint tx = 0; tx < _tilesX; ++tx) {
+      float maxDepth = 0.0f;
+      for (uint y = ty * TILE_SIZE; y < tileYEnd; ++y) {
+        const float* row = &_depth[y * _width + tx * TILE_SIZE];
+        for (uint x = 0; x < TILE_SIZE; ++x) {
+          maxDepth = std::max(maxDepth, row[x]);
+        }
+      }
+      _hiZ[ty * _tilesX + tx] = maxDepth;
+    }
+  }
+}
+
+void kore::OcclusionCuller::buildHiZLevels(void) {
+  for (uint l = 1; l < _hiZLevels.size(); ++l) {
+    const SHiZLevel& src = _hiZLevels[l - 1];
+    const SHiZLevel& dst = _hiZLevels[l];
+    const float* srcTexels = &_hiZ[src.offset];
+    float* dstTexels = &_hiZ[dst.offset];
+    for (uint y = 0; y < dst.height; ++y) {
+      const uint sy0 = y * 2;
+      const uint sy1 = std::min(sy0 + 1, src.height - 1);
+      for (uint x = 0; x < dst.width; ++x) {
+        const uint sx0 = x * 2;
+        const uint sx1 = std::min(sx0 + 1, src.width - 1);
+        dstTexels[y * dst.width + x] =
+          std::max(std::max(srcTexels[sy0 * src.width + sx0],
+                            srcTexels[sy0 * src.width + sx1]),
+                   std::max(srcTexels[sy1 * src.width + sx0],
+                            srcTexels[sy1 * src.width + sx1]));
+      }
+    }
+  }
+}
+
+void kore::OcclusionCuller::rasterizeTriangle(const glm::vec4& a,
+                                              const glm::vec4& b,
+                                              const glm::vec4& c,
+                                              const uint yBegin,
+                                              const uint yEnd) {
+  const float minXf = std::min(a.x, std::min(b.x, c.x));
+  const float maxXf = std::max(a.x, std::max(b.x, c.x));
+  const float minYf = std::min(a.y, std::min(b.y, c.y));
+  const float maxYf = std::max(a.y, std::max(b.y, c.y));
+
+  // Pixels are covered if their centers lie inside the triangle.
+  const int x0 = std::max(0, static_cast<int>(ceilf(minXf - 0.5f)));
+  const int x1 = std::min(static_cast<int>(_width) - 1,
+                          static_cast<int>(floorf(maxXf - 0.5f)));
+  const int y0 = std::max(static_cast<int>(yBegin),
+                          static_cast<int>(ceilf(minYf - 0.5f)));
+  const int y1 = std::min(static_cast<int>(yEnd) - 1,
+                          static_cast<int>(floorf(maxYf - 0.5f)));
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  // Twice the signed area. Dividing the edge functions by it yields
+  // barycentric weights that are positive inside for both windings.
+  const float area = (c.x - b.x) * (a.y - b.y) - (c.y - b.y) * (a.x - b.x);
+  if (fabs(area) < 1e-8f) {
+    return;
+  }
+  const float invArea = 1.0f / area;
+
+  // w_i(px, py) = wy_i + dx_i * (px - ox_i)
+  const float dx0 = -(c.y - b.y) * invArea;
+  const float dx1 = -(a.y - c.y) * invArea;
+  const float dx2 = -(b.y - a.y) * invArea;
+
+  const int xStart = x0 & ~3;
+  for (int y = y0; y <= y1; ++y) {
+    const float py = static_cast<float>(y) + 0.5f;
+    const float wy0 = (c.x - b.x) * (py - b.y) * invArea;
+    const float wy1 = (a.x - c.x) * (py - c.y) * invArea;
+    const float wy2 = (b.x - a.x) * (py - a.y) * invArea;
+    float* row = &_depth[y * _width];
+
+#ifdef KORE_OCCLUSION_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 four = _mm_set1_ps(4.0f);
+    const float fx = static_cast<float>(xStart) + 0.5f;
+    __m128 px = _mm_set_ps(fx + 3.0f, fx + 2.0f, fx + 1.0f, fx);
+    for (int x = xStart; x <= x1; x += 4) {
+      const __m128 w0 = _mm_add_ps(_mm_set1_ps(wy0),
+        _mm_mul_ps(_mm_set1_ps(dx0), _mm_sub_ps(px, _mm_set1_ps(b.x))));
+      const __m128 w1 = _mm_add_ps(_mm_set1_ps(wy1),
+        _mm_mul_ps(_mm_set1_ps(dx1), _mm_sub_ps(px, _mm_set1_ps(c.x))));
+      const __m128 w2 = _mm_add_ps(_mm_set1_ps(wy2),
+        _mm_mul_ps(_mm_set1_ps(dx2), _mm_sub_ps(px, _mm_set1_ps(a.x))));
+      const __m128 inside = _mm_and_ps(_mm_cmpge_ps(w0, zero),
+        _mm_and_ps(_mm_cmpge_ps(w1, zero), _mm_cmpge_ps(w2, zero)));
+
+      if (_mm_movemask_ps(inside) != 0) {
+        const __m128 z = _mm_add_ps(_mm_mul_ps(w0, _mm_set1_ps(a.z)),
+          _mm_add_ps(_mm_mul_ps(w1, _mm_set1_ps(b.z)),
+                     _mm_mul_ps(w2, _mm_set1_ps(c.z))));
+        const __m128 depth = _mm_loadu_ps(row + x);
+        const __m128 closest = _mm_min_ps(depth, z);
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest),
+                                         _mm_andnot_ps(inside, depth)));
+      }
+      px = _mm_add_ps(px, four);
+    }
+#else
+    for (int x = x0; x <= x1; ++x) {
+      const float px = static_cast<float>(x) + 0.5f;
+      const float w0 = wy0 + dx0 * (px - b.x);
+      const float w1 = wy1 + dx1 * (px - c.x);
+      const float w2 = wy2 + dx2 * (px - a.x);
+      if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+        continue;
+      }
+      const float z = w0 * a.z + w1 * b.z + w2 * c.z;
+      row[x] = std::min(row[x], z);
+    }
+#endif
+  }
+}
+
+bool kore::OcclusionCuller::isVisible(const SAABB& bounds) const {
+  if (!_rendered || _triangles.empty() || bounds.isEmpty()) {
+    return true;
+  }
+
+  const float width = static_cast<float>(_width);
+  const float height = static_cast<float>(_height);
+  float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+  float maxX = -FLT_MAX, maxY = -FLT_MAX;
+  for (uint i = 0; i < 8; ++i) {
+    const glm::vec3 corner((i & 1) ? bounds.max.x : bounds.min.x,
+                           (i & 2) ? bounds.max.y : bounds.min.y,
+                           (i & 4) ? bounds.max.z : bounds.min.z);
+    glm::vec4 screen;
+    if (!project(_viewProj, corner, width, height, screen)) {
+      return true;
+    }
+    minX = std::min(minX, screen.x);
+    maxX = std::max(maxX, screen.x);
+    minY = std::min(minY, screen.y);
+    maxY = std::max(maxY, screen.y);
+    minZ = std::min(minZ, screen.z);
+  }
+
+  // Boxes outside of the screen are left to frustum culling.
+  const int x0 = std::max(0, static_cast<int>(floorf(minX)));
+  const int x1 = std::min(static_cast<int>(_width) - 1,
+                          static_cast<int>(floorf(maxX)));
+  const int y0 = std::max(0, static_cast<int>(floorf(minY)));
+  const int y1 = std::min(static_cast<int>(_height) - 1,
+                          static_cast<int>(floorf(maxY)));
+  if (x0 > x1 || y0 > y1) {
+    return true;
+  }
+
+  // Pixels without occluder keep a depth of 1 and never hide anything.
+  minZ = std::min(minZ, 1.0f);
+
+  // Start at the finest level where the rectangle covers at most 2x2
+  // texels, large boxes are then decided by a few coarse texels.
+  uint level = 0;
+  int texelSize = static_cast<int>(TILE_SIZE);
+  while (level + 1 < _hiZLevels.size()
+         && (x1 / texelSize - x0 / texelSize > 1
+             || y1 / texelSize - y0 / texelSize > 1)) {
+    ++level;
+    texelSize *= 2;
+  }
+
+  for (int ty = y0 / texelSize; ty <= y1 / texelSize; ++ty) {
+    for (int tx = x0 / texelSize; tx <= x1 / texelSize; ++tx) {
+      if (isTexelVisible(level, tx, ty, x0, y0, x1, y1, minZ)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool kore::OcclusionCuller::isTexelVisible(const uint level, const int tx,
+                                           const int ty, const int x0,
+                                           const int y0, const int x1,
+                                           const int y1,
+                                           const float minZ) const {
+  const SHiZLevel& hiZLevel = _hiZLevels[level];
+  if (_hiZ[hiZLevel.offset + ty * hiZLevel.width + tx] < minZ) {
+    return false;
+  }
+
+  if (level > 0) {
+    // The texel is not completely in front of the box, test the texels of
+    // the finer level that overlap the rectangle.
+    const int childSize = static_cast<int>(TILE_SIZE << (level - 1));
+    const SHiZLevel& childLevel = _hiZLevels[level - 1];
+    const int cy1 = std::min(std::min(ty * 2 + 1, y1 / childSize),
+                             static_cast<int>(childLevel.height) - 1);
+    const int cx1 = std::min(std::min(tx * 2 + 1, x1 / childSize),
+                             static_cast<int>(childLevel.width) - 1);
+    for (int cy = std::max(ty * 2, y0 / childSize); cy <= cy1; ++cy) {
+      for (int cx = std::max(tx * 2, x0 / childSize); cx <= cx1; ++cx) {
+        if (isTexelVisible(level - 1, cx, cy, x0, y0, x1, y1, minZ)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // The tile is not completely in front of the box, test its pixels.
+  const int ts = static_cast<int>(TILE_SIZE);
+  const int py1 = std::min(y1, (ty + 1) * ts - 1);
+  const int px1 = std::min(x1, (tx + 1) * ts - 1);
+  for (int y = std::max(y0, ty * ts); y <= py1; ++y) {
+    const float* row = &_depth[y * _width];
+    for (int x = std::max(x0, tx * ts); x <= px1; ++x) {
+      if (row[x] >= minZ) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+uint kore::OcclusionCuller::cull(const SAABB* const* boxes, const uint count,
+                                 unsigned char* outVisible) const {
+  uint numVisible = 0;
+  for (uint i = 0; i < count; ++i) {
+    outVisible[i] = (boxes[i] == NULL || isVisible(*boxes[i])) ? 1 : 0;
+    numVisible += outVisible[i];
+  }
+  return numVisible;
+}
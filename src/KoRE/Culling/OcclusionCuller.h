@@ -0,0 +1,152 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_CULLING_OCCLUSIONCULLER_H_
+#define KORE_SRC_KORE_CULLING_OCCLUSIONCULLER_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "KoRE/Common.h"
+#include "KoRE/BoundingVolume.h"
+
+namespace kore {
+  class SceneNode;
+
+  /*! \brief Software occlusion culling against a low resolution depth buffer.
+  *   Designated occluder meshes are rasterized on the CPU into a small depth
+  *   buffer (closer is smaller, cleared to 1). The buffer is split into
+  *   horizontal bands which are rasterized on worker threads, four pixels
+  *   at a time with SSE. The workers are started once and wait for the
+  *   next render() call in between. Afterwards, the max-depth of every 8x8
+  *   tile is stored as the finest hierarchical Z level, and every coarser
+  *   level stores the max-depth of 2x2 texels of the level below.
+  *   A bounding box is occluded if its nearest projected depth lies behind
+  *   the farthest occluder depth over its whole screen rectangle. The test
+  *   starts at the level where the rectangle covers at most 2x2 texels and
+  *   descends only into texels that don't hide the box.
+  *   The test is conservative: Boxes and occluder triangles crossing the
+  *   near plane are treated as visible and as no occluders, respectively.
+  *   render() has to be called once per frame after the transforms were
+  *   updated, before any NodePasses are tested.
+  */
+  class OcclusionCuller {
+  public:
+    /*! \brief The width is rounded up to a multiple of the tile size. */
+    explicit OcclusionCuller(const uint width = 256, const uint height = 128);
+    ~OcclusionCuller(void);
+
+    /*! \brief Uses the meshes of a node as occluder. The meshes need
+    *          their CPU positions (see MeshLoader::setRetainPositions).
+    *   \return False, if the node has no suitable mesh. */
+    bool addOccluder(SceneNode* node);
+
+    /*! \brief Uses custom (e.g. simplified) geometry in the object space
+    *          of a node as occluder. Three indices form a triangle. */
+    void addOccluder(SceneNode* node, const std::vector<glm::vec3>& positions,
+                     const std::vector<uint>& indices);
+
+    void removeOccluder(const SceneNode* node);
+    void clearOccluders(void);
+    inline uint getNumOccluders(void) const
+      {return static_cast<uint>(_occluders.size());}
+
+    /*! \brief Sets the number of threads used to rasterize, including the
+    *          thread calling render(). Restarts the worker threads. */
+    void setNumThreads(const uint numThreads);
+    inline uint getNumThreads(void) const {return _numThreads;}
+
+    /*! \brief Rasterizes all occluders with the given view-projection. */
+    void render(const glm::mat4& viewProj);
+
+    /*! \brief Returns false, if the world-space box is fully hidden behind
+    *          the occluders of the last render() call. */
+    bool isVisible(const SAABB& bounds) const;
+
+    /*! \brief Tests a set of boxes. NULL and empty boxes are visible.
+    *   \param outVisible Receives 1 for every visible box, 0 otherwise.
+    *   \return The number of visible boxes. */
+    uint cull(const SAABB* const* boxes, const uint count,
+              unsigned char* outVisible) const;
+
+    inline uint getWidth(void) const {return _width;}
+    inline uint getHeight(void) const {return _height;}
+    inline const std::vector<float>& getDepthBuffer(void) const
+      {return _depth;}
+
+  private:
+    static const uint TILE_SIZE = 8;
+
+    /// A level of the hierarchical Z, stored in _hiZ from offset on.
+    struct SHiZLevel {
+      uint offset;
+      uint width;
+      uint height;
+    };
+
+    struct SOccluder {
+      SceneNode* node;
+      const std::vector<glm::vec3>* positions;
+      const std::vector<uint>* indices;
+      std::vector<glm::vec3> ownPositions;
+      std::vector<uint> ownIndices;
+    };
+
+    void startWorkers(void);
+    void stopWorkers(void);
+    void workerLoop(const uint band, uint frame);
+    void transformOccluders(void);
+    void renderBand(const uint yBegin, const uint yEnd);
+    void rasterizeTriangle(const glm::vec4& a, const glm::vec4& b,
+                           const glm::vec4& c, const uint yBegin,
+                           const uint yEnd);
+    void buildHiZLevels(void);
+    /// True if any pixel of the rectangle [x0, x1] x [y0, y1] inside
+    /// texel (tx, ty) of a level is not in front of minZ.
+    bool isTexelVisible(const uint level, const int tx, const int ty,
+                        const int x0, const int y0, const int x1,
+                        const int y1, const float minZ) const;
+
+    uint _width;
+    uint _height;
+    uint _tilesX;
+    uint _tilesY;
+    uint _numThreads;
+    bool _rendered;
+    glm::mat4 _viewProj;
+    std::vector<SOccluder*> _occluders;
+    std::vector<glm::vec4> _screenVertices;  // w < 0: behind the near plane
+    std::vector<uint> _triangles;
+    std::vector<float> _depth;
+    std::vector<float> _hiZ;  // all levels, finest first
+    std::vector<SHiZLevel> _hiZLevels;
+
+    // Workers render bands 1..n, the thread calling render() renders band 0.
+    std::vector<std::thread> _workers;
+    std::mutex _workMutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _doneCondition;
+    uint _frame;  // Incremented by render() to wake the workers
+    uint _numPending;  // Workers that haven't finished the current frame
+    uint _bandHeight;
+    bool _stopWorkers;
+  };
+};
+#endif  // KORE_SRC_KORE_CULLING_OCCLUSIONCULLER_H_
@@ -32,13 +32,64 @@ unsigned int kore::DatatypeUtil::getSizeFromGLdatatype(GLenum datatype) {
             return 16;  // sizeof(glm::vec4)
             break;
         default:
-            Log::getInstance()->
-                write("[ERROR] No size for GL-datatype implemented!");
+            KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                           "No size for GL-datatype implemented!");
                 return 0;
             break;
         }
 }
 
+bool kore::DatatypeUtil::getDatatypeInfo(GLenum datatype,
+                                         SDatatypeInfo& info) {
+  info.scalarSize = 4;
+  info.rows = 1;
+  info.columns = 1;
+
+  switch (datatype) {
+    case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+      return true;
+    case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2:
+    case GL_BOOL_VEC2:
+      info.rows = 2; return true;
+    case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3:
+    case GL_BOOL_VEC3:
+      info.rows = 3; return true;
+    case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4:
+    case GL_BOOL_VEC4:
+      info.rows = 4; return true;
+    case GL_FLOAT_MAT2:   info.rows = 2; info.columns = 2; return true;
+    case GL_FLOAT_MAT3:   info.rows = 3; info.columns = 3; return true;
+    case GL_FLOAT_MAT4:   info.rows = 4; info.columns = 4; return true;
+    case GL_FLOAT_MAT2x3: info.rows = 3; info.columns = 2; return true;
+    case GL_FLOAT_MAT2x4: info.rows = 4; info.columns = 2; return true;
+    case GL_FLOAT_MAT3x2: info.rows = 2; info.columns = 3; return true;
+    case GL_FLOAT_MAT3x4: info.rows = 4; info.columns = 3; return true;
+    case GL_FLOAT_MAT4x2: info.rows = 2; info.columns = 4; return true;
+    case GL_FLOAT_MAT4x3: info.rows = 3; info.columns = 4; return true;
+    default:
+      break;
+  }
+
+  info.scalarSize = 8;
+  switch (datatype) {
+    case GL_DOUBLE:                                        return true;
+    case GL_DOUBLE_VEC2:   info.rows = 2;                  return true;
+    case GL_DOUBLE_VEC3:   info.rows = 3;                  return true;
+    case GL_DOUBLE_VEC4:   info.rows = 4;                  return true;
+    case GL_DOUBLE_MAT2:   info.rows = 2; info.columns = 2; return true;
+    case GL_DOUBLE_MAT3:   info.rows = 3; info.columns = 3; return true;
+    case GL_DOUBLE_MAT4:   info.rows = 4; info.columns = 4; return true;
+    case GL_DOUBLE_MAT2x3: info.rows = 3; info.columns = 2; return true;
+    case GL_DOUBLE_MAT2x4: info.rows = 4; info.columns = 2; return true;
+    case GL_DOUBLE_MAT3x2: info.rows = 2; info.columns = 3; return true;
+    case GL_DOUBLE_MAT3x4: info.rows = 4; info.columns = 3; return true;
+    case GL_DOUBLE_MAT4x2: info.rows = 2; info.columns = 4; return true;
+    case GL_DOUBLE_MAT4x3: info.rows = 3; info.columns = 4; return true;
+    default:
+      return false;
+  }
+}
+
 const std::string kore::DatatypeUtil::typeToString(GLenum datatype) const {
   switch (datatype) {
   default:
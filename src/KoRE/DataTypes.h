@@ -25,9 +25,22 @@
 #include "KoRE/Log.h"
 
 namespace kore {
+  /*! \brief Component-layout of a GL datatype.
+             Scalars and vectors are treated as matrices with one column. */
+  struct SDatatypeInfo {
+    GLuint scalarSize;  // Size of one component in bytes
+    GLuint rows;        // Number of components per column
+    GLuint columns;     // Number of columns
+  };
+
   class DatatypeUtil {
   public:
     static unsigned int getSizeFromGLdatatype(GLenum datatype);
+
+    /*! \brief Retrieve the component-layout of a scalar, vector or matrix
+    *          datatype (e.g. GL_FLOAT_MAT3 -> 4 bytes, 3 rows, 3 columns).
+    *   \return False, if the datatype is not a scalar, vector or matrix. */
+    static bool getDatatypeInfo(GLenum datatype, SDatatypeInfo& info);
     const std::string typeToString(GLenum datatype) const;
     const GLenum stringToType(const std::string& type) const; 
   };
@@ -53,6 +53,14 @@ void kore::FrameBuffer::setName(const std::string& name) {
     return;
   }
   _name = name;
+  applyDebugLabel();
+}
+
+void kore::FrameBuffer::applyDebugLabel(void) const {
+  // Framebuffer names become objects when they are bound the first time.
+  if (GLerror::areDebugAnnotationsEnabled() && glIsFramebuffer(_handle)) {
+    GLerror::setObjectLabel(GL_FRAMEBUFFER, _handle, _name);
+  }
 }
 
 void kore::FrameBuffer::destroy() {
@@ -87,9 +95,9 @@ void kore::FrameBuffer::addTextureAttachment(Texture* tex,
 
   // check if texture is already attached
   if (std::find(_textures.begin(), _textures.end(), tex) != _textures.end()) {
-    Log::getInstance()
-      ->write("[ERROR] '%s' : Cannot attach '%s', Texture already attached!\n",
-      _name.c_str(), tex->getName().c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER,
+                   "'%s' : Cannot attach '%s', Texture already attached!\n",
+                   _name.c_str(), tex->getName().c_str());
     return;
   }
 
@@ -125,6 +133,9 @@ void kore::FrameBuffer::addTextureAttachment(Texture* tex,
                          attachment,
                          tex->getProperties().targetType,
                          tex->getHandle(), 0);
+  applyDebugLabel();
+  ResourceManager::getInstance()->getGPUMemoryTracker()
+    .setType(tex->getID(), GPUMEM_FRAMEBUFFER);
 
   texInfo->texLocation = tex->getHandle();
   texInfo->texTarget = tex->getProperties().targetType;
@@ -156,8 +167,8 @@ void kore::FrameBuffer::
     ResourceManager::getInstance()->addTexture(pTex);
     addTextureAttachment(pTex, attatchment);
   } else {
-    Log::getInstance()->write("[ERROR] Requested Texture could not be"
-                              "created for the FBO '%s'", _name.c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Requested Texture could not be"
+                   "created for the FBO '%s'", _name.c_str());
     KORE_SAFE_DELETE(pTex);
   }
 }
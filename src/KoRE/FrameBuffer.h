@@ -52,6 +52,10 @@ namespace kore {
     */
     void setName(const std::string& name);
 
+    /*! \brief Labels the GL framebuffer with its name
+    *          (see GLerror::setDebugAnnotationsEnabled). */
+    void applyDebugLabel(void) const;
+
     /// The name of a Framebuffer is unique
     inline const std::string getName() const {return _name;}
 
@@ -0,0 +1,676 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/FrameCapture.h"
+#include <fstream>
+#include <cstring>
+#include "KoRE/Log.h"
+#include "KoRE/DataTypes.h"
+
+bool kore::FrameCapture::_capturing = false;
+
+namespace {
+  /// Capabilities whose state is stored at the start of a capture.
+  const GLenum g_stateCaps[] = {
+    GL_DEPTH_TEST,
+    GL_CULL_FACE,
+    GL_BLEND,
+    GL_SCISSOR_TEST,
+    GL_STENCIL_TEST,
+    GL_POLYGON_OFFSET_FILL,
+    GL_RASTERIZER_DISCARD
+  };
+
+  /// Picks the format and type that read back level 0 of the bound 2D
+  /// texture without conversion: integer textures as integers, depth and
+  /// depth-stencil textures with their stencil bits, everything else as
+  /// float RGBA so float render targets keep their range.
+  void getReadbackFormat(GLenum& format, GLenum& type, uint& texelSize) {
+    GLint depthSize = 0;
+    GLint stencilSize = 0;
+    GLint depthType = GL_NONE;
+    GLint redType = GL_NONE;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_DEPTH_SIZE,
+                             &depthSize);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_STENCIL_SIZE,
+                             &stencilSize);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_DEPTH_TYPE,
+                             &depthType);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_RED_TYPE,
+                             &redType);
+
+    if (depthSize > 0 && stencilSize > 0) {
+      format = GL_DEPTH_STENCIL;
+      if (depthType == GL_FLOAT) {
+        type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+        texelSize = 8;
+      } else {
+        type = GL_UNSIGNED_INT_24_8;
+        texelSize = 4;
+      }
+    } else if (depthSize > 0) {
+      format = GL_DEPTH_COMPONENT;
+      type = GL_FLOAT;
+      texelSize = 4;
+    } else if (stencilSize > 0) {
+      format = GL_STENCIL_INDEX;
+      type = GL_UNSIGNED_BYTE;
+      texelSize = 1;
+    } else if (redType == GL_INT || redType == GL_UNSIGNED_INT) {
+      format = GL_RGBA_INTEGER;
+      type = redType;
+      texelSize = 16;
+    } else {
+      format = GL_RGBA;
+      type = GL_FLOAT;
+      texelSize = 16;
+    }
+  }
+}
+
+kore::FrameCapture* kore::FrameCapture::getInstance(void) {
+  static FrameCapture theInstance;
+  return &theInstance;
+}
+
+kore::FrameCapture::FrameCapture(void)
+  : _requested(false),
+    _filename(""),
+    _recordStart(0),
+    _numUnsupported(0),
+    _nextClientIndexBuffer(0x80000000) {
+}
+
+kore::FrameCapture::~FrameCapture(void) {
+}
+
+void kore::FrameCapture::requestCapture(const std::string& filename) {
+  _filename = filename;
+  _requested = true;
+}
+
+void kore::FrameCapture::beginFrame(void) {
+  if (!_requested) {
+    return;
+  }
+
+  _requested = false;
+  _capturing = true;
+  _numUnsupported = 0;
+  _nextClientIndexBuffer = 0x80000000;
+  _data.clear();
+  _programs.clear();
+  _buffers.clear();
+  _textures.clear();
+  _samplers.clear();
+  _framebuffers.clear();
+  _data.insert(_data.end(), KORE_CAPTURE_MAGIC,
+               KORE_CAPTURE_MAGIC + sizeof(KORE_CAPTURE_MAGIC));
+  snapshotState();
+}
+
+void kore::FrameCapture::endFrame(void) {
+  if (!_capturing) {
+    return;
+  }
+  _capturing = false;
+
+  std::ofstream file(_filename.c_str(), std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameCapture: Could not open '%s'\n",
+                   _filename.c_str());
+    _data.clear();
+    return;
+  }
+  file.write(reinterpret_cast<const char*>(&_data[0]), _data.size());
+  file.close();
+
+  Log::getInstance()->write(LOG_INFO, LOG_CATEGORY_RENDER,
+                            "FrameCapture: Wrote %u bytes to '%s' "
+                            "(%u unsupported operations)\n",
+                            static_cast<uint>(_data.size()),
+                            _filename.c_str(), _numUnsupported);
+  _data.clear();
+}
+
+void kore::FrameCapture::recordUseProgram(const GLuint program) {
+  snapshotProgram(program);
+  beginRecord(CAPTURE_USE_PROGRAM);
+  writeUInt(program);
+  endRecord();
+}
+
+void kore::FrameCapture::recordUniform(const GLuint program,
+                                       const std::string& name,
+                                       const GLenum type,
+                                       const GLuint count,
+                                       const void* data) {
+  SDatatypeInfo info;
+  if (data == NULL || !DatatypeUtil::getDatatypeInfo(type, info)) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RENDER, "FrameCapture: Uniform '%s' has an "
+                     "unsupported type\n", name.c_str());
+    ++_numUnsupported;
+    return;
+  }
+
+  snapshotProgram(program);
+  beginRecord(CAPTURE_UNIFORM);
+  writeUInt(program);
+  writeString(name);
+  writeUInt(type);
+  writeUInt(count);
+  writeBlob(data, info.scalarSize * info.rows * info.columns * count);
+  endRecord();
+}
+
+void kore::FrameCapture::recordAttribute(const GLuint program,
+                                         const GLuint vao,
+                                         const GLuint vbo,
+                                         const std::string& name,
+                                         const GLint numComponents,
+                                         const GLenum componentType,
+                                         const GLsizei stride,
+                                         const GLintptr offset) {
+  snapshotProgram(program);
+  snapshotBuffer(vbo);
+  beginRecord(CAPTURE_ATTRIBUTE);
+  writeUInt(program);
+  writeUInt(vao);
+  writeUInt(vbo);
+  writeString(name);
+  writeInt(numComponents);
+  writeUInt(componentType);
+  writeInt(stride);
+  writeUInt(static_cast<uint>(offset));
+  endRecord();
+}
+
+void kore::FrameCapture::recordTextureBinding(const GLuint program,
+                                              const std::string& name,
+                                              const GLuint unit,
+                                              const GLenum target,
+                                              const GLuint texture,
+                                              const GLuint sampler) {
+  snapshotProgram(program);
+  snapshotTexture(target, texture);
+  snapshotSampler(sampler);
+  beginRecord(CAPTURE_TEXTURE_BINDING);
+  writeUInt(program);
+  writeString(name);
+  writeUInt(unit);
+  writeUInt(target);
+  writeUInt(texture);
+  writeUInt(sampler);
+  endRecord();
+}
+
+void kore::FrameCapture::recordDraw(const GLuint vao, const GLuint ibo,
+                                    const GLenum mode, const GLsizei count) {
+  if (ibo != 0) {
+    snapshotBuffer(ibo);
+  }
+  beginRecord(CAPTURE_DRAW);
+  writeUInt(vao);
+  writeUInt(ibo);
+  writeUInt(mode);
+  writeInt(count);
+  endRecord();
+}
+
+void kore::FrameCapture::
+  recordDrawClientIndices(const GLuint vao, const GLenum mode,
+                          const std::vector<unsigned int>& indices) {
+  // Client-side indices are stored as a buffer with a handle outside of the
+  // range GL hands out, so the replay can treat the draw like an IBO draw.
+  const GLuint handle = _nextClientIndexBuffer++;
+  beginRecord(CAPTURE_BUFFER);
+  writeUInt(handle);
+  writeBlob(indices.empty() ? NULL : &indices[0],
+            static_cast<uint>(indices.size() * sizeof(unsigned int)));
+  endRecord();
+  _buffers.insert(handle);
+
+  recordDraw(vao, handle, mode, static_cast<GLsizei>(indices.size()));
+}
+
+void kore::FrameCapture::
+  recordFramebufferBinding(const GLenum target, const GLuint fbo,
+                           const std::vector<GLenum>& drawBuffers) {
+  snapshotFramebuffer(fbo);
+  beginRecord(CAPTURE_FRAMEBUFFER_BINDING);
+  writeUInt(target);
+  writeUInt(fbo);
+  writeUInt(static_cast<uint>(drawBuffers.size()));
+  for (uint i = 0; i < drawBuffers.size(); ++i) {
+    writeUInt(drawBuffers[i]);
+  }
+  endRecord();
+}
+
+void kore::FrameCapture::recordClear(const GLbitfield mask, const float r,
+                                     const float g, const float b,
+                                     const float a) {
+  beginRecord(CAPTURE_CLEAR);
+  writeUInt(mask);
+  writeFloat(r);
+  writeFloat(g);
+  writeFloat(b);
+  writeFloat(a);
+  endRecord();
+}
+
+void kore::FrameCapture::recordViewport(const GLint x, const GLint y,
+                                        const GLsizei w, const GLsizei h) {
+  beginRecord(CAPTURE_VIEWPORT);
+  writeInt(x);
+  writeInt(y);
+  writeInt(w);
+  writeInt(h);
+  endRecord();
+}
+
+void kore::FrameCapture::recordEnable(const GLenum cap, const bool enable) {
+  beginRecord(CAPTURE_ENABLE);
+  writeUInt(cap);
+  writeUInt(enable ? 1 : 0);
+  endRecord();
+}
+
+void kore::FrameCapture::recordColorMask(const bool r, const bool g,
+                                         const bool b, const bool a) {
+  beginRecord(CAPTURE_COLOR_MASK);
+  writeUInt(r ? 1 : 0);
+  writeUInt(g ? 1 : 0);
+  writeUInt(b ? 1 : 0);
+  writeUInt(a ? 1 : 0);
+  endRecord();
+}
+
+void kore::FrameCapture::recordMemoryBarrier(const GLbitfield bits) {
+  beginRecord(CAPTURE_MEMORY_BARRIER);
+  writeUInt(bits);
+  endRecord();
+}
+
+void kore::FrameCapture::recordDispatch(const GLuint x, const GLuint y,
+                                        const GLuint z) {
+  beginRecord(CAPTURE_DISPATCH);
+  writeUInt(x);
+  writeUInt(y);
+  writeUInt(z);
+  endRecord();
+}
+
+void kore::FrameCapture::recordUniformBlock(const GLuint program,
+                                            const std::string& name,
+                                            const GLuint binding,
+                                            const void* data,
+                                            const uint size) {
+  snapshotProgram(program);
+  beginRecord(CAPTURE_UNIFORM_BLOCK);
+  writeUInt(program);
+  writeString(name);
+  writeUInt(binding);
+  writeBlob(data, size);
+  endRecord();
+}
+
+void kore::FrameCapture::recordBufferBinding(const GLenum target,
+                                             const GLuint index,
+                                             const GLuint buffer) {
+  snapshotBuffer(buffer);
+  beginRecord(CAPTURE_BUFFER_BINDING);
+  writeUInt(target);
+  writeUInt(index);
+  writeUInt(buffer);
+  endRecord();
+}
+
+void kore::FrameCapture::recordDrawIndirect(const GLenum mode,
+                                            const GLenum indexType,
+                                            const GLuint indirectBuffer,
+                                            const GLintptr offset,
+                                            const GLsizei drawCount,
+                                            const GLsizei stride) {
+  GLint vao = 0;
+  GLint ibo = 0;
+  GLint buffer = indirectBuffer;
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+  if (indexType != GL_NONE) {
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &ibo);
+  }
+  if (buffer == 0) {
+    glGetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &buffer);
+  }
+  snapshotBuffer(ibo);
+  snapshotBuffer(buffer);
+
+  beginRecord(CAPTURE_DRAW_INDIRECT);
+  writeUInt(vao);
+  writeUInt(ibo);
+  writeUInt(buffer);
+  writeUInt(mode);
+  writeUInt(indexType);
+  writeUInt(static_cast<uint>(offset));
+  writeInt(drawCount);
+  writeInt(stride);
+  endRecord();
+}
+
+void kore::FrameCapture::recordDispatchIndirect(const GLuint indirectBuffer,
+                                                const GLintptr offset) {
+  snapshotBuffer(indirectBuffer);
+  beginRecord(CAPTURE_DISPATCH_INDIRECT);
+  writeUInt(indirectBuffer);
+  writeUInt(static_cast<uint>(offset));
+  endRecord();
+}
+
+void kore::FrameCapture::recordUnsupported(const EOperationType type) {
+  ++_numUnsupported;
+  beginRecord(CAPTURE_UNSUPPORTED);
+  writeUInt(type);
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotState(void) {
+  const uint numCaps = sizeof(g_stateCaps) / sizeof(g_stateCaps[0]);
+  GLint depthFunc = GL_LESS;
+  GLboolean depthMask = GL_TRUE;
+  GLint cullFace = GL_BACK;
+  GLint frontFace = GL_CCW;
+  GLint viewport[4] = {0, 0, 0, 0};
+  GLint blend[6] = {GL_ONE, GL_ZERO, GL_ONE, GL_ZERO, GL_FUNC_ADD,
+                    GL_FUNC_ADD};
+  GLboolean colorMask[4] = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
+  glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+  glGetIntegerv(GL_CULL_FACE_MODE, &cullFace);
+  glGetIntegerv(GL_FRONT_FACE, &frontFace);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glGetIntegerv(GL_BLEND_SRC_RGB, &blend[0]);
+  glGetIntegerv(GL_BLEND_DST_RGB, &blend[1]);
+  glGetIntegerv(GL_BLEND_SRC_ALPHA, &blend[2]);
+  glGetIntegerv(GL_BLEND_DST_ALPHA, &blend[3]);
+  glGetIntegerv(GL_BLEND_EQUATION_RGB, &blend[4]);
+  glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blend[5]);
+  glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+
+  beginRecord(CAPTURE_STATE);
+  writeUInt(numCaps);
+  for (uint i = 0; i < numCaps; ++i) {
+    writeUInt(g_stateCaps[i]);
+    writeUInt(glIsEnabled(g_stateCaps[i]) ? 1 : 0);
+  }
+  writeUInt(depthFunc);
+  writeUInt(depthMask ? 1 : 0);
+  writeUInt(cullFace);
+  writeUInt(frontFace);
+  for (uint i = 0; i < 4; ++i) {
+    writeInt(viewport[i]);
+  }
+  for (uint i = 0; i < 6; ++i) {
+    writeUInt(blend[i]);
+  }
+  for (uint i = 0; i < 4; ++i) {
+    writeUInt(colorMask[i] ? 1 : 0);
+  }
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotProgram(const GLuint program) {
+  if (program == 0 || !_programs.insert(program).second) {
+    return;
+  }
+
+  GLuint shaders[8];
+  GLsizei numShaders = 0;
+  glGetAttachedShaders(program, 8, &numShaders, shaders);
+
+  beginRecord(CAPTURE_PROGRAM);
+  writeUInt(program);
+  writeUInt(numShaders);
+  for (GLsizei i = 0; i < numShaders; ++i) {
+    GLint type = 0;
+    GLint length = 0;
+    glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type);
+    glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length);
+
+    std::string source;
+    if (length > 0) {
+      std::vector<char> chars(length);
+      glGetShaderSource(shaders[i], length, NULL, &chars[0]);
+      source = &chars[0];
+    }
+    writeUInt(type);
+    writeString(source);
+  }
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotBuffer(const GLuint buffer) {
+  if (buffer == 0 || !_buffers.insert(buffer).second) {
+    return;
+  }
+
+  // Read through the copy-read target so no binding the RenderManager
+  // caches is touched.
+  GLint prevBuffer = 0;
+  glGetIntegerv(GL_COPY_READ_BUFFER_BINDING, &prevBuffer);
+  glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+
+  GLint size = 0;
+  glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+  std::vector<unsigned char> content(size > 0 ? size : 0);
+  if (size > 0) {
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, size, &content[0]);
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, prevBuffer);
+
+  beginRecord(CAPTURE_BUFFER);
+  writeUInt(buffer);
+  writeBlob(content.empty() ? NULL : &content[0],
+            static_cast<uint>(content.size()));
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotTexture(const GLenum target,
+                                         const GLuint texture) {
+  if (texture == 0 || !_textures.insert(texture).second) {
+    return;
+  }
+
+  if (target != GL_TEXTURE_2D) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RENDER, "FrameCapture: Only 2D textures are "
+                     "captured (texture %u)\n", texture);
+    return;
+  }
+
+  GLint prevTexture = 0;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+
+  GLint width = 0;
+  GLint height = 0;
+  GLint internalFormat = 0;
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT,
+                           &internalFormat);
+
+  GLenum format = GL_RGBA;
+  GLenum type = GL_FLOAT;
+  uint texelSize = 16;
+  getReadbackFormat(format, type, texelSize);
+
+  std::vector<unsigned char> texels(width * height * texelSize);
+  if (!texels.empty()) {
+    GLint prevAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, format, type, &texels[0]);
+    glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+  }
+  glBindTexture(GL_TEXTURE_2D, prevTexture);
+
+  beginRecord(CAPTURE_TEXTURE);
+  writeUInt(texture);
+  writeUInt(target);
+  writeInt(width);
+  writeInt(height);
+  writeUInt(internalFormat);
+  writeUInt(format);
+  writeUInt(type);
+  writeBlob(texels.empty() ? NULL : &texels[0],
+            static_cast<uint>(texels.size()));
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotSampler(const GLuint sampler) {
+  if (sampler == 0 || !_samplers.insert(sampler).second) {
+    return;
+  }
+
+  static const GLenum params[] = {
+    GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S,
+    GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R, GL_TEXTURE_COMPARE_MODE,
+    GL_TEXTURE_COMPARE_FUNC
+  };
+
+  // Without EXT_texture_filter_anisotropic the parameter can't be queried
+  // and anisotropic filtering is off.
+  GLfloat maxAnisotropy = 1.0f;
+  if (GLEW_EXT_texture_filter_anisotropic) {
+    glGetSamplerParameterfv(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                            &maxAnisotropy);
+  }
+  GLfloat lodBias = 0.0f;
+  GLfloat minLod = 0.0f;
+  GLfloat maxLod = 0.0f;
+  GLfloat borderColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  glGetSamplerParameterfv(sampler, GL_TEXTURE_LOD_BIAS, &lodBias);
+  glGetSamplerParameterfv(sampler, GL_TEXTURE_MIN_LOD, &minLod);
+  glGetSamplerParameterfv(sampler, GL_TEXTURE_MAX_LOD, &maxLod);
+  glGetSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+  beginRecord(CAPTURE_SAMPLER);
+  writeUInt(sampler);
+  for (uint i = 0; i < sizeof(params) / sizeof(params[0]); ++i) {
+    GLint value = 0;
+    glGetSamplerParameteriv(sampler, params[i], &value);
+    writeInt(value);
+  }
+  writeFloat(maxAnisotropy);
+  writeFloat(lodBias);
+  writeFloat(minLod);
+  writeFloat(maxLod);
+  for (uint i = 0; i < 4; ++i) {
+    writeFloat(borderColor[i]);
+  }
+  endRecord();
+}
+
+void kore::FrameCapture::snapshotFramebuffer(const GLuint fbo) {
+  if (fbo == 0 || !_framebuffers.insert(fbo).second) {
+    return;
+  }
+
+  GLint prevFBO = 0;
+  GLint maxColorAttachments = 0;
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFBO);
+  glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &maxColorAttachments);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+
+  std::vector<GLenum> attachments;
+  attachments.push_back(GL_DEPTH_ATTACHMENT);
+  attachments.push_back(GL_STENCIL_ATTACHMENT);
+  for (GLint i = 0; i < maxColorAttachments; ++i) {
+    attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
+  }
+
+  std::vector<GLenum> usedAttachments;
+  std::vector<GLuint> textures;
+  for (uint i = 0; i < attachments.size(); ++i) {
+    GLint objectType = GL_NONE;
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, attachments[i],
+        GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &objectType);
+    if (objectType != GL_TEXTURE) {
+      continue;
+    }
+    GLint texture = 0;
+    glGetFramebufferAttachmentParameteriv(GL_READ_FRAMEBUFFER, attachments[i],
+        GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &texture);
+    usedAttachments.push_back(attachments[i]);
+    textures.push_back(texture);
+  }
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, prevFBO);
+
+  // Attachments are recreated empty; their content is what the frame renders.
+  for (uint i = 0; i < textures.size(); ++i) {
+    snapshotTexture(GL_TEXTURE_2D, textures[i]);
+  }
+
+  beginRecord(CAPTURE_FRAMEBUFFER);
+  writeUInt(fbo);
+  writeUInt(static_cast<uint>(usedAttachments.size()));
+  for (uint i = 0; i < usedAttachments.size(); ++i) {
+    writeUInt(usedAttachments[i]);
+    writeUInt(textures[i]);
+  }
+  endRecord();
+}
+
+void kore::FrameCapture::beginRecord(const ECaptureRecord type) {
+  _recordStart = _data.size();
+  writeUInt(type);
+  writeUInt(0);  // Payload size, patched in endRecord
+}
+
+void kore::FrameCapture::endRecord(void) {
+  const uint payloadSize =
+    static_cast<uint>(_data.size() - _recordStart - 2 * sizeof(uint));
+  memcpy(&_data[_recordStart + sizeof(uint)], &payloadSize, sizeof(uint));
+}
+
+void kore::FrameCapture::writeUInt(const uint value) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  _data.insert(_data.end(), bytes, bytes + sizeof(uint));
+}
+
+void kore::FrameCapture::writeInt(const int value) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  _data.insert(_data.end(), bytes, bytes + sizeof(int));
+}
+
+void kore::FrameCapture::writeFloat(const float value) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  _data.insert(_data.end(), bytes, bytes + sizeof(float));
+}
+
+void kore::FrameCapture::writeString(const std::string& str) {
+  writeBlob(str.c_str(), static_cast<uint>(str.size()));
+}
+
+void kore::FrameCapture::writeBlob(const void* data, const uint size) {
+  writeUInt(size);
+  if (size > 0) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    _data.insert(_data.end(), bytes, bytes + size);
+  }
+}
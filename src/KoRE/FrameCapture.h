@@ -0,0 +1,185 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_FRAMECAPTURE_H_
+#define KORE_SRC_KORE_FRAMECAPTURE_H_
+
+#include <string>
+#include <vector>
+#include <set>
+#include "KoRE/Common.h"
+#include "KoRE/Operations/Operation.h"
+
+namespace kore {
+  /// Record types of a capture file. Every record is stored as
+  /// [uint32 type][uint32 payload size][payload].
+  enum ECaptureRecord {
+    // Resources, written before the first command that references them.
+    CAPTURE_PROGRAM = 1,      // handle, numShaders, {type, source}
+    CAPTURE_BUFFER,           // handle, data
+    CAPTURE_TEXTURE,          // handle, target, w, h, internalFormat,
+                              // format, type, data
+    CAPTURE_SAMPLER,          // handle, minFilter, magFilter, wrapS, wrapT,
+                              // wrapR, compareMode, compareFunc,
+                              // maxAnisotropy, lodBias, minLod, maxLod,
+                              // borderColor[4]
+    CAPTURE_FRAMEBUFFER,      // handle, numAttachments, {attachment, tex}
+
+    // Commands in execution order.
+    CAPTURE_USE_PROGRAM = 100,  // program
+    CAPTURE_UNIFORM,            // program, name, type, count, data
+    CAPTURE_ATTRIBUTE,          // program, vao, vbo, name, numComponents,
+                                // componentType, stride, offset
+    CAPTURE_TEXTURE_BINDING,    // program, name, unit, target, tex, sampler
+    CAPTURE_DRAW,               // vao, ibo, mode, count
+    CAPTURE_FRAMEBUFFER_BINDING,  // target, fbo, numDrawBuffers, {buffer}
+    CAPTURE_CLEAR,              // mask, r, g, b, a
+    CAPTURE_VIEWPORT,           // x, y, w, h
+    CAPTURE_ENABLE,             // cap, enable
+    CAPTURE_COLOR_MASK,         // r, g, b, a
+    CAPTURE_MEMORY_BARRIER,     // bits
+    CAPTURE_DISPATCH,           // x, y, z
+    CAPTURE_UNSUPPORTED,        // operation type
+    CAPTURE_UNIFORM_BLOCK,      // program, name, binding, data
+    CAPTURE_BUFFER_BINDING,     // target, index, buffer
+    CAPTURE_DRAW_INDIRECT,      // vao, ibo, buffer, mode, indexType,
+                                // offset, drawCount, stride
+    CAPTURE_DISPATCH_INDIRECT,  // buffer, offset
+    CAPTURE_STATE               // numCaps, {cap, enabled}, depthFunc,
+                                // depthMask, cullFace, frontFace,
+                                // viewport[4], blendSrcRGB, blendDstRGB,
+                                // blendSrcAlpha, blendDstAlpha,
+                                // blendEquationRGB, blendEquationAlpha,
+                                // colorMask[4]
+  };
+
+  static const char KORE_CAPTURE_MAGIC[8] = {'K', 'O', 'R', 'E',
+                                             'C', 'A', 'P', '3'};
+
+  /*! \brief Captures the operation stream of one frame together with the
+  *   GL resources it references into a file that FrameReplay can execute
+  *   without the scene, e.g. for profiling or for comparing optimizers.
+  *   Operations describe themselves through Operation::record(). Resources
+  *   are read back from GL by handle the first time a command references
+  *   them, so their content is the one at that point of the frame. The
+  *   fixed-function state the frame starts with is stored first, because
+  *   operations only record the state they change.
+  *   Capturing stalls the pipeline and is meant for debugging only.
+  */
+  class FrameCapture {
+  public:
+    static FrameCapture* getInstance(void);
+    ~FrameCapture(void);
+
+    /*! \brief Captures the next frame rendered by the RenderManager. */
+    void requestCapture(const std::string& filename);
+
+    /*! \brief Returns true while a frame is being captured. */
+    static inline bool isCapturing(void) {return _capturing;}
+
+    /// Called by the RenderManager around the execution of the operations.
+    void beginFrame(void);
+    void endFrame(void);
+
+    /// Recording interface for the operations.
+    void recordUseProgram(const GLuint program);
+    void recordUniform(const GLuint program, const std::string& name,
+                       const GLenum type, const GLuint count,
+                       const void* data);
+    void recordAttribute(const GLuint program, const GLuint vao,
+                         const GLuint vbo, const std::string& name,
+                         const GLint numComponents,
+                         const GLenum componentType, const GLsizei stride,
+                         const GLintptr offset);
+    void recordTextureBinding(const GLuint program, const std::string& name,
+                              const GLuint unit, const GLenum target,
+                              const GLuint texture, const GLuint sampler);
+    void recordDraw(const GLuint vao, const GLuint ibo, const GLenum mode,
+                    const GLsizei count);
+    /// Draws with client-side indices. The indices are stored as buffer.
+    void recordDrawClientIndices(const GLuint vao, const GLenum mode,
+                                 const std::vector<unsigned int>& indices);
+    void recordFramebufferBinding(const GLenum target, const GLuint fbo,
+                                  const std::vector<GLenum>& drawBuffers);
+    void recordClear(const GLbitfield mask, const float r, const float g,
+                     const float b, const float a);
+    void recordViewport(const GLint x, const GLint y, const GLsizei w,
+                        const GLsizei h);
+    void recordEnable(const GLenum cap, const bool enable);
+    void recordColorMask(const bool r, const bool g, const bool b,
+                         const bool a);
+    void recordMemoryBarrier(const GLbitfield bits);
+    void recordDispatch(const GLuint x, const GLuint y, const GLuint z);
+    /// Binds the contents of a uniform block. The data is stored with the
+    /// command, because streamed blocks live in a ring-buffer that is
+    /// overwritten during the frame.
+    void recordUniformBlock(const GLuint program, const std::string& name,
+                            const GLuint binding, const void* data,
+                            const uint size);
+    /// Binds a whole buffer to target or, unless index is KORE_UINT_INVALID,
+    /// to an indexed binding point of target.
+    void recordBufferBinding(const GLenum target, const GLuint index,
+                             const GLuint buffer);
+    /// The vertex array and element buffer are taken from the GL state, as
+    /// is the indirect buffer if 0 is passed.
+    void recordDrawIndirect(const GLenum mode, const GLenum indexType,
+                            const GLuint indirectBuffer,
+                            const GLintptr offset, const GLsizei drawCount,
+                            const GLsizei stride);
+    void recordDispatchIndirect(const GLuint indirectBuffer,
+                                const GLintptr offset);
+    void recordUnsupported(const EOperationType type);
+
+    /// Number of operations that could not be captured in the last capture.
+    inline uint getNumUnsupported(void) const {return _numUnsupported;}
+
+  private:
+    FrameCapture(void);
+
+    void snapshotState(void);
+    void snapshotProgram(const GLuint program);
+    void snapshotBuffer(const GLuint buffer);
+    void snapshotTexture(const GLenum target, const GLuint texture);
+    void snapshotSampler(const GLuint sampler);
+    void snapshotFramebuffer(const GLuint fbo);
+
+    void beginRecord(const ECaptureRecord type);
+    void endRecord(void);
+    void writeUInt(const uint value);
+    void writeInt(const int value);
+    void writeFloat(const float value);
+    void writeString(const std::string& str);
+    void writeBlob(const void* data, const uint size);
+
+    static bool _capturing;
+    bool _requested;
+    std::string _filename;
+    std::vector<unsigned char> _data;
+    size_t _recordStart;
+    uint _numUnsupported;
+    GLuint _nextClientIndexBuffer;
+
+    std::set<GLuint> _programs;
+    std::set<GLuint> _buffers;
+    std::set<GLuint> _textures;
+    std::set<GLuint> _samplers;
+    std::set<GLuint> _framebuffers;
+  };
+};
+#endif  // KORE_SRC_KORE_FRAMECAPTURE_H_
@@ -0,0 +1,865 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/FrameReplay.h"
+#include <fstream>
+#include <cstring>
+#include "KoRE/Log.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/DataTypes.h"
+
+kore::FrameReplay::FrameReplay(void)
+  : _readPos(0),
+    _recordEnd(0),
+    _numDrawCalls(0),
+    _numSkipped(0),
+    _defaultFramebuffer(0),
+    _uniformBlockBuffer(0) {
+}
+
+kore::FrameReplay::~FrameReplay(void) {
+  destroy();
+}
+
+bool kore::FrameReplay::load(const std::string& filename) {
+  destroy();
+
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: Could not open '%s'\n",
+                   filename.c_str());
+    return false;
+  }
+  file.seekg(0, std::ios::end);
+  _data.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0, std::ios::beg);
+  if (!_data.empty()) {
+    file.read(reinterpret_cast<char*>(&_data[0]), _data.size());
+  }
+  file.close();
+
+  if (_data.size() < sizeof(KORE_CAPTURE_MAGIC)
+      || memcmp(&_data[0], KORE_CAPTURE_MAGIC,
+                sizeof(KORE_CAPTURE_MAGIC)) != 0) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: '%s' is not a frame "
+                   "capture\n", filename.c_str());
+    _data.clear();
+    return false;
+  }
+
+  _readPos = sizeof(KORE_CAPTURE_MAGIC);
+  while (_readPos < _data.size()) {
+    uint type = 0;
+    uint size = 0;
+    _recordEnd = _data.size();
+    if (!readUInt(type) || !readUInt(size)
+        || _readPos + size > _data.size()) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: '%s' is truncated\n",
+                     filename.c_str());
+      destroy();
+      return false;
+    }
+    _recordEnd = _readPos + size;
+
+    const ECaptureRecord recordType = static_cast<ECaptureRecord>(type);
+    const bool success = recordType < CAPTURE_USE_PROGRAM
+                       ? createResource(recordType)
+                       : decodeCommand(recordType);
+    if (!success) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: Invalid record of type "
+                     "%u in '%s'\n", type, filename.c_str());
+      destroy();
+      return false;
+    }
+    _readPos = _recordEnd;
+  }
+
+  createUniformBlockBuffer();
+
+  if (_numSkipped > 0) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RENDER, "FrameReplay: %u captured operations "
+                     "can't be replayed and are skipped\n",
+                     _numSkipped);
+  }
+  return true;
+}
+
+void kore::FrameReplay::destroy(void) {
+  for (auto it = _programs.begin(); it != _programs.end(); ++it) {
+    glDeleteProgram(it->second);
+  }
+  for (auto it = _buffers.begin(); it != _buffers.end(); ++it) {
+    glDeleteBuffers(1, &it->second);
+  }
+  for (auto it = _textures.begin(); it != _textures.end(); ++it) {
+    glDeleteTextures(1, &it->second);
+  }
+  for (auto it = _samplers.begin(); it != _samplers.end(); ++it) {
+    glDeleteSamplers(1, &it->second);
+  }
+  for (auto it = _framebuffers.begin(); it != _framebuffers.end(); ++it) {
+    glDeleteFramebuffers(1, &it->second);
+  }
+  for (auto it = _vaos.begin(); it != _vaos.end(); ++it) {
+    glDeleteVertexArrays(1, &it->second);
+  }
+  if (_uniformBlockBuffer != 0) {
+    glDeleteBuffers(1, &_uniformBlockBuffer);
+    _uniformBlockBuffer = 0;
+  }
+
+  _programs.clear();
+  _buffers.clear();
+  _textures.clear();
+  _samplers.clear();
+  _framebuffers.clear();
+  _vaos.clear();
+  _commands.clear();
+  _commandData.clear();
+  _uniformBlockData.clear();
+  _data.clear();
+  _readPos = 0;
+  _recordEnd = 0;
+  _numDrawCalls = 0;
+  _numSkipped = 0;
+}
+
+void kore::FrameReplay::execute(void) const {
+  // Frames start on the default framebuffer.
+  glBindFramebuffer(GL_FRAMEBUFFER, _defaultFramebuffer);
+  for (uint i = 0; i < _commands.size(); ++i) {
+    const SReplayCommand& cmd = _commands[i];
+    switch (cmd.type) {
+      case CAPTURE_USE_PROGRAM:
+        glUseProgram(cmd.object);
+      break;
+
+      case CAPTURE_UNIFORM:
+        glUseProgram(cmd.object);
+        executeUniform(cmd);
+      break;
+
+      case CAPTURE_ATTRIBUTE:
+        glBindVertexArray(cmd.object);
+        glBindBuffer(GL_ARRAY_BUFFER, cmd.args[0]);
+        glEnableVertexAttribArray(cmd.location);
+        glVertexAttribPointer(cmd.location, cmd.args[1], cmd.args[2],
+                              GL_FALSE, cmd.args[3],
+                              KORE_BUFFER_OFFSET(cmd.args[4]));
+      break;
+
+      case CAPTURE_TEXTURE_BINDING:
+        glUseProgram(cmd.object);
+        glUniform1i(cmd.location, cmd.args[0]);
+        glActiveTexture(GL_TEXTURE0 + cmd.args[0]);
+        glBindTexture(cmd.args[1], cmd.args[2]);
+        glBindSampler(cmd.args[0], cmd.args[3]);
+      break;
+
+      case CAPTURE_DRAW:
+        glBindVertexArray(cmd.object);
+        if (cmd.args[0] != 0) {
+          glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cmd.args[0]);
+          glDrawElements(cmd.args[1], cmd.args[2], GL_UNSIGNED_INT,
+                         KORE_BUFFER_OFFSET(0));
+        } else {
+          glDrawArrays(cmd.args[1], 0, cmd.args[2]);
+        }
+      break;
+
+      case CAPTURE_FRAMEBUFFER_BINDING:
+        if (cmd.object == 0 && _defaultFramebuffer != 0) {
+          const GLenum drawBuffer = GL_COLOR_ATTACHMENT0;
+          glBindFramebuffer(cmd.args[0], _defaultFramebuffer);
+          if (cmd.args[0] != GL_READ_FRAMEBUFFER) {
+            glDrawBuffers(1, &drawBuffer);
+          }
+          break;
+        }
+        glBindFramebuffer(cmd.args[0], cmd.object);
+        if (cmd.args[1] > 0) {
+          glDrawBuffers(cmd.args[1], reinterpret_cast<const GLenum*>(
+                          &_commandData[cmd.dataOffset]));
+        }
+      break;
+
+      case CAPTURE_CLEAR: {
+        float color[4];
+        memcpy(color, &cmd.args[1], sizeof(color));
+        glClearColor(color[0], color[1], color[2], color[3]);
+        glClear(cmd.args[0]);
+      }
+      break;
+
+      case CAPTURE_VIEWPORT:
+        glViewport(cmd.args[0], cmd.args[1], cmd.args[2], cmd.args[3]);
+      break;
+
+      case CAPTURE_ENABLE:
+        if (cmd.args[1]) {
+          glEnable(cmd.args[0]);
+        } else {
+          glDisable(cmd.args[0]);
+        }
+      break;
+
+      case CAPTURE_COLOR_MASK:
+        glColorMask(cmd.args[0], cmd.args[1], cmd.args[2], cmd.args[3]);
+      break;
+
+      case CAPTURE_STATE:
+        executeState(cmd);
+      break;
+
+      case CAPTURE_MEMORY_BARRIER:
+        glMemoryBarrier(cmd.args[0]);
+      break;
+
+      case CAPTURE_DISPATCH:
+        glDispatchCompute(cmd.args[0], cmd.args[1], cmd.args[2]);
+      break;
+
+      case CAPTURE_UNIFORM_BLOCK:
+        glBindBufferRange(GL_UNIFORM_BUFFER, cmd.args[0], _uniformBlockBuffer,
+                          cmd.args[1], cmd.args[2]);
+      break;
+
+      case CAPTURE_BUFFER_BINDING:
+        if (cmd.args[1] == KORE_UINT_INVALID) {
+          glBindBuffer(cmd.args[0], cmd.args[2]);
+        } else {
+          glBindBufferBase(cmd.args[0], cmd.args[1], cmd.args[2]);
+        }
+      break;
+
+      case CAPTURE_DRAW_INDIRECT: {
+        const GLvoid* offset = KORE_BUFFER_OFFSET(cmd.args[4]);
+        glBindVertexArray(cmd.object);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, cmd.args[1]);
+        if (cmd.args[3] == GL_NONE) {
+          glMultiDrawArraysIndirect(cmd.args[2], offset, cmd.args[5],
+                                    cmd.args[6]);
+        } else {
+          glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cmd.args[0]);
+          glMultiDrawElementsIndirect(cmd.args[2], cmd.args[3], offset,
+                                      cmd.args[5], cmd.args[6]);
+        }
+      }
+      break;
+
+      case CAPTURE_DISPATCH_INDIRECT:
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, cmd.args[0]);
+        glDispatchComputeIndirect(cmd.args[1]);
+      break;
+
+      default:
+      break;
+    }
+  }
+}
+
+void kore::FrameReplay::executeState(const SReplayCommand& cmd) const {
+  const uint* values =
+    reinterpret_cast<const uint*>(&_commandData[cmd.dataOffset]);
+  for (uint i = 0; i < cmd.args[0]; ++i, values += 2) {
+    if (values[1]) {
+      glEnable(values[0]);
+    } else {
+      glDisable(values[0]);
+    }
+  }
+  glDepthFunc(values[0]);
+  glDepthMask(values[1] ? GL_TRUE : GL_FALSE);
+  glCullFace(values[2]);
+  glFrontFace(values[3]);
+  glViewport(static_cast<GLint>(values[4]), static_cast<GLint>(values[5]),
+             static_cast<GLsizei>(values[6]), static_cast<GLsizei>(values[7]));
+  glBlendFuncSeparate(values[8], values[9], values[10], values[11]);
+  glBlendEquationSeparate(values[12], values[13]);
+  glColorMask(values[14] ? GL_TRUE : GL_FALSE, values[15] ? GL_TRUE : GL_FALSE,
+              values[16] ? GL_TRUE : GL_FALSE, values[17] ? GL_TRUE : GL_FALSE);
+}
+
+void kore::FrameReplay::executeUniform(const SReplayCommand& cmd) const {
+  const GLint loc = cmd.location;
+  const GLsizei count = cmd.args[1];
+  const unsigned char* data = &_commandData[cmd.dataOffset];
+  const GLfloat* f = reinterpret_cast<const GLfloat*>(data);
+  const GLint* i = reinterpret_cast<const GLint*>(data);
+  const GLuint* ui = reinterpret_cast<const GLuint*>(data);
+
+  switch (cmd.args[0]) {
+    case GL_FLOAT:       glUniform1fv(loc, count, f); break;
+    case GL_FLOAT_VEC2:  glUniform2fv(loc, count, f); break;
+    case GL_FLOAT_VEC3:  glUniform3fv(loc, count, f); break;
+    case GL_FLOAT_VEC4:  glUniform4fv(loc, count, f); break;
+    case GL_BOOL: case GL_INT:
+      glUniform1iv(loc, count, i); break;
+    case GL_BOOL_VEC2: case GL_INT_VEC2:
+      glUniform2iv(loc, count, i); break;
+    case GL_BOOL_VEC3: case GL_INT_VEC3:
+      glUniform3iv(loc, count, i); break;
+    case GL_BOOL_VEC4: case GL_INT_VEC4:
+      glUniform4iv(loc, count, i); break;
+    case GL_UNSIGNED_INT:       glUniform1uiv(loc, count, ui); break;
+    case GL_UNSIGNED_INT_VEC2:  glUniform2uiv(loc, count, ui); break;
+    case GL_UNSIGNED_INT_VEC3:  glUniform3uiv(loc, count, ui); break;
+    case GL_UNSIGNED_INT_VEC4:  glUniform4uiv(loc, count, ui); break;
+    case GL_FLOAT_MAT2:
+      glUniformMatrix2fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3:
+      glUniformMatrix3fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4:
+      glUniformMatrix4fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT2x3:
+      glUniformMatrix2x3fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT2x4:
+      glUniformMatrix2x4fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3x2:
+      glUniformMatrix3x2fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT3x4:
+      glUniformMatrix3x4fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4x2:
+      glUniformMatrix4x2fv(loc, count, GL_FALSE, f); break;
+    case GL_FLOAT_MAT4x3:
+      glUniformMatrix4x3fv(loc, count, GL_FALSE, f); break;
+    default:
+    break;
+  }
+}
+
+bool kore::FrameReplay::createResource(const ECaptureRecord type) {
+  uint handle = 0;
+  if (!readUInt(handle)) {
+    return false;
+  }
+
+  switch (type) {
+    case CAPTURE_PROGRAM: {
+      const GLuint program = createProgram();
+      if (program == 0) {
+        return false;
+      }
+      _programs[handle] = program;
+    }
+    break;
+
+    case CAPTURE_BUFFER: {
+      const unsigned char* content = NULL;
+      uint size = 0;
+      if (!readBlob(content, size)) {
+        return false;
+      }
+      GLuint buffer = 0;
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      glBufferData(GL_COPY_WRITE_BUFFER, size, content, GL_STATIC_DRAW);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+      _buffers[handle] = buffer;
+    }
+    break;
+
+    case CAPTURE_TEXTURE: {
+      uint target = 0;
+      int width = 0;
+      int height = 0;
+      uint internalFormat = 0;
+      uint format = 0;
+      uint texelType = 0;
+      const unsigned char* texels = NULL;
+      uint size = 0;
+      if (!readUInt(target) || !readInt(width) || !readInt(height)
+          || !readUInt(internalFormat) || !readUInt(format)
+          || !readUInt(texelType) || !readBlob(texels, size)) {
+        return false;
+      }
+      GLuint texture = 0;
+      glGenTextures(1, &texture);
+      glBindTexture(GL_TEXTURE_2D, texture);
+      GLint prevAlignment = 4;
+      glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0,
+                   format, texelType, size > 0 ? texels : NULL);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+      // Only level 0 is captured. Mipmaps of filterable color textures are
+      // rebuilt for samplers that use mipmapped filtering.
+      if (format == GL_RGBA && width > 0 && height > 0) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+      }
+      glBindTexture(GL_TEXTURE_2D, 0);
+      _textures[handle] = texture;
+    }
+    break;
+
+    case CAPTURE_SAMPLER: {
+      static const GLenum params[] = {
+        GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S,
+        GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R, GL_TEXTURE_COMPARE_MODE,
+        GL_TEXTURE_COMPARE_FUNC
+      };
+      GLuint sampler = 0;
+      glGenSamplers(1, &sampler);
+      for (uint i = 0; i < sizeof(params) / sizeof(params[0]); ++i) {
+        int value = 0;
+        if (!readInt(value)) {
+          glDeleteSamplers(1, &sampler);
+          return false;
+        }
+        glSamplerParameteri(sampler, params[i], value);
+      }
+
+      float maxAnisotropy = 1.0f;
+      float lodBias = 0.0f;
+      float minLod = 0.0f;
+      float maxLod = 0.0f;
+      float borderColor[4];
+      if (!readFloat(maxAnisotropy) || !readFloat(lodBias)
+          || !readFloat(minLod) || !readFloat(maxLod)
+          || !readFloat(borderColor[0]) || !readFloat(borderColor[1])
+          || !readFloat(borderColor[2]) || !readFloat(borderColor[3])) {
+        glDeleteSamplers(1, &sampler);
+        return false;
+      }
+      if (maxAnisotropy > 1.0f && GLEW_EXT_texture_filter_anisotropic) {
+        glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                            maxAnisotropy);
+      }
+      glSamplerParameterf(sampler, GL_TEXTURE_LOD_BIAS, lodBias);
+      glSamplerParameterf(sampler, GL_TEXTURE_MIN_LOD, minLod);
+      glSamplerParameterf(sampler, GL_TEXTURE_MAX_LOD, maxLod);
+      glSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+      _samplers[handle] = sampler;
+    }
+    break;
+
+    case CAPTURE_FRAMEBUFFER: {
+      uint numAttachments = 0;
+      if (!readUInt(numAttachments)) {
+        return false;
+      }
+      GLuint fbo = 0;
+      glGenFramebuffers(1, &fbo);
+      glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+      for (uint i = 0; i < numAttachments; ++i) {
+        uint attachment = 0;
+        uint texture = 0;
+        if (!readUInt(attachment) || !readUInt(texture)) {
+          glBindFramebuffer(GL_FRAMEBUFFER, 0);
+          glDeleteFramebuffers(1, &fbo);
+          return false;
+        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D,
+                               mapHandle(_textures, texture, "texture"), 0);
+      }
+      GLerror::gl_ValidateFBO("FrameReplay");
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      _framebuffers[handle] = fbo;
+    }
+    break;
+
+    default:
+      return false;
+  }
+  return true;
+}
+
+bool kore::FrameReplay::decodeCommand(const ECaptureRecord type) {
+  SReplayCommand cmd;
+  cmd.type = type;
+
+  switch (type) {
+    case CAPTURE_USE_PROGRAM: {
+      uint program = 0;
+      if (!readUInt(program)) {
+        return false;
+      }
+      cmd.object = mapHandle(_programs, program, "program");
+    }
+    break;
+
+    case CAPTURE_UNIFORM: {
+      uint program = 0;
+      std::string name;
+      const unsigned char* values = NULL;
+      uint size = 0;
+      SDatatypeInfo info;
+      if (!readUInt(program) || !readString(name) || !readUInt(cmd.args[0])
+          || !readUInt(cmd.args[1]) || !readBlob(values, size)
+          || !DatatypeUtil::getDatatypeInfo(cmd.args[0], info)) {
+        return false;
+      }
+      // The blob has to hold exactly count values of the type, or the
+      // glUniform call would read past it.
+      const uint64 typeSize = info.scalarSize * info.rows * info.columns;
+      if (cmd.args[1] == 0
+          || static_cast<uint64>(size) != typeSize * cmd.args[1]) {
+        KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: Uniform '%s' has "
+                       "%u bytes of data for %u values\n",
+                       name.c_str(), size, cmd.args[1]);
+        return false;
+      }
+      cmd.dataOffset = storeCommandData(values, size);
+      cmd.object = mapHandle(_programs, program, "program");
+      cmd.location = glGetUniformLocation(cmd.object, name.c_str());
+    }
+    break;
+
+    case CAPTURE_ATTRIBUTE: {
+      uint program = 0;
+      uint vao = 0;
+      uint vbo = 0;
+      std::string name;
+      if (!readUInt(program) || !readUInt(vao) || !readUInt(vbo)
+          || !readString(name) || !readUInt(cmd.args[1])
+          || !readUInt(cmd.args[2]) || !readUInt(cmd.args[3])
+          || !readUInt(cmd.args[4])) {
+        return false;
+      }
+      cmd.object = mapVAO(vao);
+      cmd.args[0] = mapHandle(_buffers, vbo, "buffer");
+      cmd.location = glGetAttribLocation(
+        mapHandle(_programs, program, "program"), name.c_str());
+      if (cmd.location < 0) {
+        return true;  // Attribute not used by the program
+      }
+    }
+    break;
+
+    case CAPTURE_TEXTURE_BINDING: {
+      uint program = 0;
+      std::string name;
+      uint texture = 0;
+      uint sampler = 0;
+      if (!readUInt(program) || !readString(name) || !readUInt(cmd.args[0])
+          || !readUInt(cmd.args[1]) || !readUInt(texture)
+          || !readUInt(sampler)) {
+        return false;
+      }
+      cmd.object = mapHandle(_programs, program, "program");
+      cmd.location = glGetUniformLocation(cmd.object, name.c_str());
+      cmd.args[2] = mapHandle(_textures, texture, "texture");
+      cmd.args[3] = mapHandle(_samplers, sampler, "sampler");
+    }
+    break;
+
+    case CAPTURE_DRAW: {
+      uint vao = 0;
+      uint ibo = 0;
+      if (!readUInt(vao) || !readUInt(ibo) || !readUInt(cmd.args[1])
+          || !readUInt(cmd.args[2])) {
+        return false;
+      }
+      cmd.object = mapVAO(vao);
+      cmd.args[0] = mapHandle(_buffers, ibo, "buffer");
+      ++_numDrawCalls;
+    }
+    break;
+
+    case CAPTURE_FRAMEBUFFER_BINDING: {
+      uint fbo = 0;
+      if (!readUInt(cmd.args[0]) || !readUInt(fbo)
+          || !readUInt(cmd.args[1])) {
+        return false;
+      }
+      cmd.object = mapHandle(_framebuffers, fbo, "framebuffer");
+      const size_t size = cmd.args[1] * sizeof(GLenum);
+      if (size > _recordEnd - _readPos) {
+        return false;
+      }
+      cmd.dataOffset = storeCommandData(size > 0 ? &_data[_readPos] : NULL,
+                                        static_cast<uint>(size));
+    }
+    break;
+
+    case CAPTURE_CLEAR: {
+      float color[4];
+      if (!readUInt(cmd.args[0]) || !readFloat(color[0])
+          || !readFloat(color[1]) || !readFloat(color[2])
+          || !readFloat(color[3])) {
+        return false;
+      }
+      memcpy(&cmd.args[1], color, sizeof(color));
+    }
+    break;
+
+    case CAPTURE_VIEWPORT:
+    case CAPTURE_COLOR_MASK:
+      if (!readUInt(cmd.args[0]) || !readUInt(cmd.args[1])
+          || !readUInt(cmd.args[2]) || !readUInt(cmd.args[3])) {
+        return false;
+      }
+    break;
+
+    case CAPTURE_ENABLE:
+      if (!readUInt(cmd.args[0]) || !readUInt(cmd.args[1])) {
+        return false;
+      }
+    break;
+
+    case CAPTURE_STATE: {
+      // The {cap, enabled} pairs are followed by 18 fixed values.
+      if (!readUInt(cmd.args[0])) {
+        return false;
+      }
+      const size_t size = (cmd.args[0] * 2 + 18) * sizeof(uint);
+      if (size != _recordEnd - _readPos) {
+        return false;
+      }
+      cmd.dataOffset = storeCommandData(&_data[_readPos],
+                                        static_cast<uint>(size));
+    }
+    break;
+
+    case CAPTURE_MEMORY_BARRIER:
+      if (!readUInt(cmd.args[0])) {
+        return false;
+      }
+    break;
+
+    case CAPTURE_DISPATCH:
+      if (!readUInt(cmd.args[0]) || !readUInt(cmd.args[1])
+          || !readUInt(cmd.args[2])) {
+        return false;
+      }
+    break;
+
+    case CAPTURE_UNIFORM_BLOCK: {
+      uint program = 0;
+      std::string name;
+      const unsigned char* values = NULL;
+      uint size = 0;
+      if (!readUInt(program) || !readString(name) || !readUInt(cmd.args[0])
+          || !readBlob(values, size)) {
+        return false;
+      }
+      cmd.object = mapHandle(_programs, program, "program");
+      const GLuint blockIndex = glGetUniformBlockIndex(cmd.object,
+                                                       name.c_str());
+      if (size == 0 || blockIndex == GL_INVALID_INDEX) {
+        return true;  // Block not used by the program
+      }
+      // Bindings assigned by the ShaderProgram aren't part of the captured
+      // source, so they are restored here.
+      glUniformBlockBinding(cmd.object, blockIndex, cmd.args[0]);
+
+      GLint alignment = 1;
+      glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+      const size_t offset = (_uniformBlockData.size() + alignment - 1)
+                            / alignment * alignment;
+      _uniformBlockData.resize(offset + size, 0);
+      memcpy(&_uniformBlockData[offset], values, size);
+      cmd.args[1] = static_cast<GLuint>(offset);
+      cmd.args[2] = size;
+    }
+    break;
+
+    case CAPTURE_BUFFER_BINDING: {
+      uint buffer = 0;
+      if (!readUInt(cmd.args[0]) || !readUInt(cmd.args[1])
+          || !readUInt(buffer)) {
+        return false;
+      }
+      cmd.args[2] = mapHandle(_buffers, buffer, "buffer");
+    }
+    break;
+
+    case CAPTURE_DRAW_INDIRECT: {
+      uint vao = 0;
+      uint ibo = 0;
+      uint buffer = 0;
+      if (!readUInt(vao) || !readUInt(ibo) || !readUInt(buffer)
+          || !readUInt(cmd.args[2]) || !readUInt(cmd.args[3])
+          || !readUInt(cmd.args[4]) || !readUInt(cmd.args[5])
+          || !readUInt(cmd.args[6])) {
+        return false;
+      }
+      cmd.object = mapVAO(vao);
+      cmd.args[0] = mapHandle(_buffers, ibo, "buffer");
+      cmd.args[1] = mapHandle(_buffers, buffer, "buffer");
+      _numDrawCalls += cmd.args[5];
+    }
+    break;
+
+    case CAPTURE_DISPATCH_INDIRECT: {
+      uint buffer = 0;
+      if (!readUInt(buffer) || !readUInt(cmd.args[1])) {
+        return false;
+      }
+      cmd.args[0] = mapHandle(_buffers, buffer, "buffer");
+    }
+    break;
+
+    case CAPTURE_UNSUPPORTED:
+      ++_numSkipped;
+      return true;
+
+    default:
+      return false;
+  }
+
+  _commands.push_back(cmd);
+  return true;
+}
+
+GLuint kore::FrameReplay::createProgram(void) {
+  uint numShaders = 0;
+  if (!readUInt(numShaders)) {
+    return 0;
+  }
+
+  const GLuint program = glCreateProgram();
+  std::vector<GLuint> shaders;
+  for (uint i = 0; i < numShaders; ++i) {
+    uint type = 0;
+    std::string source;
+    if (!readUInt(type) || !readString(source)) {
+      break;
+    }
+
+    const GLuint shader = glCreateShader(type);
+    const GLchar* src = source.c_str();
+    glShaderSource(shader, 1, &src, NULL);
+    glCompileShader(shader);
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: A captured shader "
+                     "failed to compile\n");
+    }
+    glAttachShader(program, shader);
+    shaders.push_back(shader);
+  }
+
+  glLinkProgram(program);
+  // The program keeps the shaders alive as long as they are attached.
+  for (uint i = 0; i < shaders.size(); ++i) {
+    glDeleteShader(shaders[i]);
+  }
+
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked != GL_TRUE || shaders.size() != numShaders) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "FrameReplay: A captured program "
+                   "failed to link\n");
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+GLuint kore::FrameReplay::mapHandle(const std::map<GLuint, GLuint>& handles,
+                                    const GLuint captured,
+                                    const char* kind) const {
+  if (captured == 0) {
+    return 0;
+  }
+
+  auto it = handles.find(captured);
+  if (it == handles.end()) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RENDER, "FrameReplay: Capture references "
+                     "unknown %s %u\n", kind, captured);
+    return 0;
+  }
+  return it->second;
+}
+
+GLuint kore::FrameReplay::mapVAO(const GLuint captured) {
+  // Vertex array state is rebuilt by the attribute commands, so VAOs
+  // are created on first reference.
+  auto it = _vaos.find(captured);
+  if (it != _vaos.end()) {
+    return it->second;
+  }
+
+  GLuint vao = 0;
+  glGenVertexArrays(1, &vao);
+  _vaos[captured] = vao;
+  return vao;
+}
+
+bool kore::FrameReplay::readUInt(uint& value) {
+  if (_readPos + sizeof(uint) > _recordEnd) {
+    return false;
+  }
+  memcpy(&value, &_data[_readPos], sizeof(uint));
+  _readPos += sizeof(uint);
+  return true;
+}
+
+bool kore::FrameReplay::readInt(int& value) {
+  if (_readPos + sizeof(int) > _recordEnd) {
+    return false;
+  }
+  memcpy(&value, &_data[_readPos], sizeof(int));
+  _readPos += sizeof(int);
+  return true;
+}
+
+bool kore::FrameReplay::readFloat(float& value) {
+  if (_readPos + sizeof(float) > _recordEnd) {
+    return false;
+  }
+  memcpy(&value, &_data[_readPos], sizeof(float));
+  _readPos += sizeof(float);
+  return true;
+}
+
+bool kore::FrameReplay::readString(std::string& str) {
+  const unsigned char* data = NULL;
+  uint size = 0;
+  if (!readBlob(data, size)) {
+    return false;
+  }
+  str.assign(reinterpret_cast<const char*>(data), size);
+  return true;
+}
+
+bool kore::FrameReplay::readBlob(const unsigned char*& data, uint& size) {
+  if (!readUInt(size) || _readPos + size > _recordEnd) {
+    return false;
+  }
+  data = size > 0 ? &_data[_readPos] : NULL;
+  _readPos += size;
+  return true;
+}
+
+void kore::FrameReplay::createUniformBlockBuffer(void) {
+  if (_uniformBlockData.empty()) {
+    return;
+  }
+  glGenBuffers(1, &_uniformBlockBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _uniformBlockBuffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, _uniformBlockData.size(),
+               &_uniformBlockData[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  _uniformBlockData.clear();
+}
+
+uint kore::FrameReplay::storeCommandData(const unsigned char* data,
+                                         const uint size) {
+  // Payloads are padded to multiples of 8 bytes, so each one starts
+  // aligned for floats, ints and doubles.
+  const uint offset = static_cast<uint>(_commandData.size());
+  _commandData.resize(offset + ((size + 7) & ~7u), 0);
+  if (size > 0) {
+    memcpy(&_commandData[offset], data, size);
+  }
+  return offset;
+}
@@ -0,0 +1,133 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_FRAMEREPLAY_H_
+#define KORE_SRC_KORE_FRAMEREPLAY_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include "KoRE/Common.h"
+#include "KoRE/FrameCapture.h"
+
+namespace kore {
+  /*! \brief Replays a frame written by FrameCapture without the scene,
+  *   the operations or the optimizer. load() recreates the captured GL
+  *   resources and decodes the command stream, so execute() only issues
+  *   the GL calls and can be timed in isolation. Handles are remapped to
+  *   the newly created objects and uniform/attribute locations are looked
+  *   up by name.
+  *   The replay uses the GL directly and ignores the state caches of the
+  *   RenderManager.
+  */
+  class FrameReplay {
+  public:
+    FrameReplay(void);
+    ~FrameReplay(void);
+
+    /*! \brief Loads a capture file and creates its GL resources.
+    *   \return False if the file could not be read or is no capture. */
+    bool load(const std::string& filename);
+
+    /*! \brief Issues the GL calls of the captured frame. */
+    void execute(void) const;
+
+    /*! \brief Deletes all GL resources created by load(). */
+    void destroy(void);
+
+    /*! \brief Redirects commands that target the default framebuffer to
+    *   the given FBO, e.g. in a context without a window surface. The back
+    *   buffer maps to its first color attachment. 0 restores the default.
+    */
+    inline void setDefaultFramebuffer(const GLuint fbo) {
+      _defaultFramebuffer = fbo;
+    }
+
+    inline uint getNumCommands(void) const {
+      return static_cast<uint>(_commands.size());
+    }
+    inline uint getNumDrawCalls(void) const {return _numDrawCalls;}
+    /// Number of captured operations the replay can't reproduce.
+    inline uint getNumSkipped(void) const {return _numSkipped;}
+
+  private:
+    /// A decoded command. The meaning of the fields depends on the type.
+    struct SReplayCommand {
+      SReplayCommand(void)
+        : type(CAPTURE_UNSUPPORTED),
+          object(0),
+          location(-1),
+          dataOffset(0) {
+        for (uint i = 0; i < 8; ++i) {
+          args[i] = 0;
+        }
+      }
+
+      ECaptureRecord type;
+      GLuint object;                // Program, VAO or FBO
+      GLint location;               // Uniform or attribute location
+      GLuint args[8];
+      uint dataOffset;              // Uniform values or draw buffers in
+                                    // _commandData
+    };
+
+    bool createResource(const ECaptureRecord type);
+    bool decodeCommand(const ECaptureRecord type);
+    void executeUniform(const SReplayCommand& cmd) const;
+    /// Restores the fixed-function state the captured frame started with.
+    void executeState(const SReplayCommand& cmd) const;
+
+    GLuint createProgram(void);
+    GLuint mapHandle(const std::map<GLuint, GLuint>& handles,
+                     const GLuint captured, const char* kind) const;
+    GLuint mapVAO(const GLuint captured);
+
+    bool readUInt(uint& value);
+    bool readInt(int& value);
+    bool readFloat(float& value);
+    bool readString(std::string& str);
+    bool readBlob(const unsigned char*& data, uint& size);
+    uint storeCommandData(const unsigned char* data, const uint size);
+    void createUniformBlockBuffer(void);
+
+    std::vector<unsigned char> _data;
+    size_t _readPos;
+    size_t _recordEnd;
+
+    std::vector<SReplayCommand> _commands;
+    /// Payloads of the commands, copied out of the file so every payload
+    /// starts 8 byte aligned.
+    std::vector<unsigned char> _commandData;
+    uint _numDrawCalls;
+    uint _numSkipped;
+    GLuint _defaultFramebuffer;
+    /// Contents of the captured uniform blocks, uploaded into one buffer
+    /// once the whole capture is decoded.
+    std::vector<unsigned char> _uniformBlockData;
+    GLuint _uniformBlockBuffer;
+
+    std::map<GLuint, GLuint> _programs;
+    std::map<GLuint, GLuint> _buffers;
+    std::map<GLuint, GLuint> _textures;
+    std::map<GLuint, GLuint> _samplers;
+    std::map<GLuint, GLuint> _framebuffers;
+    std::map<GLuint, GLuint> _vaos;
+  };
+};
+#endif  // KORE_SRC_KORE_FRAMEREPLAY_H_
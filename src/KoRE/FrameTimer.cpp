@@ -0,0 +1,221 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/FrameTimer.h"
+
+#include <algorithm>
+#include <cmath>
+
+const double kore::FrameTimeWindow::BUCKET_WIDTH_MS = 0.1;
+
+kore::FrameTimeWindow::FrameTimeWindow(void)
+  : _samples(WINDOW_SIZE, 0.0),
+    _histogram(NUM_BUCKETS, 0),
+    _next(0),
+    _count(0) {
+}
+
+namespace {
+  inline uint getBucket(const double ms) {
+    if (ms <= 0.0) {
+      return 0;
+    }
+    const double bucket = ms / kore::FrameTimeWindow::BUCKET_WIDTH_MS;
+    if (bucket >= kore::FrameTimeWindow::NUM_BUCKETS - 1) {
+      return kore::FrameTimeWindow::NUM_BUCKETS - 1;
+    }
+    return static_cast<uint>(bucket);
+  }
+}
+
+void kore::FrameTimeWindow::addSample(const double ms) {
+  if (_count == WINDOW_SIZE) {
+    // The oldest sample leaves the window.
+    --_histogram[getBucket(_samples[_next])];
+  } else {
+    ++_count;
+  }
+
+  _samples[_next] = ms;
+  ++_histogram[getBucket(ms)];
+  _next = (_next + 1) % WINDOW_SIZE;
+}
+
+double kore::FrameTimeWindow::getPercentile(const uint percent) const {
+  // Rank of the sample (1-based) that is the percentile.
+  const uint rank = std::max(1u, (_count * percent + 99) / 100);
+  uint cumulative = 0;
+  for (uint i = 0; i < NUM_BUCKETS; ++i) {
+    cumulative += _histogram[i];
+    if (cumulative >= rank) {
+      // Report the center of the bucket.
+      return (static_cast<double>(i) + 0.5) * BUCKET_WIDTH_MS;
+    }
+  }
+  return static_cast<double>(NUM_BUCKETS) * BUCKET_WIDTH_MS;
+}
+
+void kore::FrameTimeWindow::getStats(SFrameTimeStats& rvStats) const {
+  rvStats = SFrameTimeStats();
+  if (_count == 0) {
+    return;
+  }
+
+  // Walk the samples from the oldest to the newest.
+  const uint first = _count < WINDOW_SIZE ? 0 : _next;
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  double sumDeltas = 0.0;
+  double minMS = _samples[first];
+  double maxMS = _samples[first];
+  double previous = _samples[first];
+  for (uint i = 0; i < _count; ++i) {
+    const double ms = _samples[(first + i) % WINDOW_SIZE];
+    sum += ms;
+    sumSquares += ms * ms;
+    minMS = std::min(minMS, ms);
+    maxMS = std::max(maxMS, ms);
+    if (i > 0) {
+      sumDeltas += std::fabs(ms - previous);
+    }
+    previous = ms;
+  }
+
+  const double n = static_cast<double>(_count);
+  rvStats.numSamples = _count;
+  rvStats.lastMS = previous;
+  rvStats.avgMS = sum / n;
+  rvStats.minMS = minMS;
+  rvStats.maxMS = maxMS;
+  rvStats.stdDevMS =
+    std::sqrt(std::max(0.0, sumSquares / n - rvStats.avgMS * rvStats.avgMS));
+  rvStats.jitterMS = _count > 1 ? sumDeltas / (n - 1.0) : 0.0;
+
+  // The histogram only has a limited resolution - keep the percentiles
+  // within the exact range of the samples.
+  rvStats.p50MS = std::min(std::max(getPercentile(50), minMS), maxMS);
+  rvStats.p95MS = std::min(std::max(getPercentile(95), minMS), maxMS);
+  rvStats.p99MS = std::min(std::max(getPercentile(99), minMS), maxMS);
+}
+
+void kore::FrameTimeWindow::reset(void) {
+  std::fill(_histogram.begin(), _histogram.end(), 0);
+  _next = 0;
+  _count = 0;
+}
+
+kore::FrameTimer::FrameTimer(void)
+  : _hasLastFrame(false),
+    _frameCount(0) {
+}
+
+kore::FrameTimer::~FrameTimer(void) {
+}
+
+void kore::FrameTimer::endFrame(void) {
+  const Timer::Clock::time_point now = Timer::Clock::now();
+  if (_hasLastFrame) {
+    const std::chrono::duration<double, std::milli> frameTime =
+      now - _lastFrameEnd;
+    _frameWindow.addSample(frameTime.count());
+  }
+  _lastFrameEnd = now;
+  _hasLastFrame = true;
+  ++_frameCount;
+
+  for (uint i = 0; i < _sections.size(); ++i) {
+    SSection& section = _sections[i];
+    if (section.running) {
+      // Sections spanning the frame boundary are cut at the boundary.
+      endSection(i);
+      section.window.addSample(section.accumulatedMS);
+      section.accumulatedMS = 0.0;
+      beginSection(i);
+    } else {
+      section.window.addSample(section.accumulatedMS);
+      section.accumulatedMS = 0.0;
+    }
+  }
+}
+
+uint kore::FrameTimer::getSectionID(const std::string& name) {
+  auto it = _sectionIDs.find(name);
+  if (it != _sectionIDs.end()) {
+    return it->second;
+  }
+
+  const uint id = static_cast<uint>(_sections.size());
+  _sections.push_back(SSection());
+  _sections.back().name = name;
+  _sectionIDs[name] = id;
+  return id;
+}
+
+void kore::FrameTimer::beginSection(const uint sectionID) {
+  if (sectionID >= _sections.size()) {
+    return;
+  }
+
+  SSection& section = _sections[sectionID];
+  section.begin = Timer::Clock::now();
+  section.running = true;
+}
+
+void kore::FrameTimer::endSection(const uint sectionID) {
+  if (sectionID >= _sections.size() || !_sections[sectionID].running) {
+    return;
+  }
+
+  SSection& section = _sections[sectionID];
+  const std::chrono::duration<double, std::milli> duration =
+    Timer::Clock::now() - section.begin;
+  section.accumulatedMS += duration.count();
+  section.running = false;
+}
+
+void kore::FrameTimer::getFrameStats(SFrameTimeStats& rvStats) const {
+  _frameWindow.getStats(rvStats);
+}
+
+bool kore::FrameTimer::getSectionStats(const std::string& name,
+                                       SFrameTimeStats& rvStats) const {
+  auto it = _sectionIDs.find(name);
+  if (it == _sectionIDs.end()) {
+    return false;
+  }
+  _sections[it->second].window.getStats(rvStats);
+  return true;
+}
+
+void kore::FrameTimer::
+  getSectionNames(std::vector<std::string>& rvNames) const {
+  rvNames.clear();
+  for (uint i = 0; i < _sections.size(); ++i) {
+    rvNames.push_back(_sections[i].name);
+  }
+}
+
+void kore::FrameTimer::reset(void) {
+  _frameWindow.reset();
+  for (uint i = 0; i < _sections.size(); ++i) {
+    _sections[i].window.reset();
+    _sections[i].accumulatedMS = 0.0;
+  }
+  _hasLastFrame = false;
+}
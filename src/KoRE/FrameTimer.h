@@ -0,0 +1,138 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_FRAMETIMER_H_
+#define KORE_SRC_KORE_FRAMETIMER_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "KoRE/Common.h"
+#include "KoRE/Timer.h"
+
+namespace kore {
+  /*! \brief Statistics over the samples in the window of a FrameTimer.
+  *          All times are in milliseconds. */
+  struct SFrameTimeStats {
+    SFrameTimeStats(void)
+      : numSamples(0),
+        lastMS(0.0), avgMS(0.0), minMS(0.0), maxMS(0.0),
+        p50MS(0.0), p95MS(0.0), p99MS(0.0),
+        jitterMS(0.0), stdDevMS(0.0) {
+    }
+
+    uint numSamples;
+    double lastMS;
+    double avgMS;
+    double minMS;
+    double maxMS;
+    double p50MS;
+    double p95MS;
+    double p99MS;
+    double jitterMS;  // Mean absolute change between consecutive samples
+    double stdDevMS;
+  };
+
+  /*! \brief Rolling window of time samples with a histogram, so percentiles
+  *          can be read without sorting. The histogram has a resolution of
+  *          BUCKET_WIDTH_MS; longer samples than the histogram covers are
+  *          counted in the last bucket. */
+  class FrameTimeWindow {
+  public:
+    static const uint WINDOW_SIZE = 512;
+    static const uint NUM_BUCKETS = 1000;
+    static const double BUCKET_WIDTH_MS;
+
+    FrameTimeWindow(void);
+
+    void addSample(const double ms);
+    void getStats(SFrameTimeStats& rvStats) const;
+    void reset(void);
+
+    inline uint getNumSamples(void) const {return _count;}
+
+  private:
+    double getPercentile(const uint percent) const;
+
+    std::vector<double> _samples;  // Ring of WINDOW_SIZE samples
+    std::vector<uint> _histogram;
+    uint _next;
+    uint _count;
+  };
+
+  /*! \brief Measures frame times and named sections of a frame with a
+  *          steady clock. Call endFrame() once per frame - the frame time is
+  *          the wall time between two calls, so it includes everything the
+  *          application does between frames, e.g. swapping buffers.
+  */
+  class FrameTimer {
+  public:
+    FrameTimer(void);
+    ~FrameTimer(void);
+
+    /*! \brief Marks the end of a frame and records its duration. */
+    void endFrame(void);
+
+    /*! \brief Returns the id of a named section. Look ids up once, not per
+    *          frame. */
+    uint getSectionID(const std::string& name);
+
+    /*! \brief Starts or stops measuring a section. A section may be
+    *          measured several times per frame; the times are summed up
+    *          and recorded as one sample at endFrame(). */
+    void beginSection(const uint sectionID);
+    void endSection(const uint sectionID);
+
+    /*! \brief Returns the statistics of the frame times. */
+    void getFrameStats(SFrameTimeStats& rvStats) const;
+
+    /*! \brief Returns the statistics of a section.
+    *   \return false if there is no section with that name. */
+    bool getSectionStats(const std::string& name,
+                         SFrameTimeStats& rvStats) const;
+
+    /*! \brief Returns the names of all sections. */
+    void getSectionNames(std::vector<std::string>& rvNames) const;
+
+    inline uint64 getFrameCount(void) const {return _frameCount;}
+
+    /*! \brief Clears all samples, e.g. after loading when the frame times
+    *          aren't representative. */
+    void reset(void);
+
+  private:
+    struct SSection {
+      SSection(void) : accumulatedMS(0.0), running(false) {}
+
+      std::string name;
+      Timer::Clock::time_point begin;
+      double accumulatedMS;
+      bool running;
+      FrameTimeWindow window;
+    };
+
+    Timer::Clock::time_point _lastFrameEnd;
+    bool _hasLastFrame;
+    uint64 _frameCount;
+    FrameTimeWindow _frameWindow;
+    std::vector<SSection> _sections;
+    std::unordered_map<std::string, uint> _sectionIDs;
+  };
+};
+#endif  // KORE_SRC_KORE_FRAMETIMER_H_
@@ -0,0 +1,167 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/GLerror.h"
+#include <algorithm>
+#include "KoRE/ResourceManager.h"
+
+bool kore::GLerror::_operationChecks = true;
+bool kore::GLerror::_callbackInstalled = false;
+bool kore::GLerror::_debugAnnotations = false;
+
+namespace {
+  const char* getSourceName(const GLenum source) {
+    switch (source) {
+      case GL_DEBUG_SOURCE_API: return "API";
+      case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "Window system";
+      case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader compiler";
+      case GL_DEBUG_SOURCE_THIRD_PARTY: return "Third party";
+      case GL_DEBUG_SOURCE_APPLICATION: return "Application";
+      default: return "Other";
+    }
+  }
+
+  const char* getTypeName(const GLenum type) {
+    switch (type) {
+      case GL_DEBUG_TYPE_ERROR: return "Error";
+      case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated";
+      case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "Undefined behavior";
+      case GL_DEBUG_TYPE_PORTABILITY: return "Portability";
+      case GL_DEBUG_TYPE_PERFORMANCE: return "Performance";
+      default: return "Other";
+    }
+  }
+
+  // The log is thread safe, so the callback may be called from a driver
+  // thread when the output is asynchronous.
+  void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id,
+                              GLenum severity, GLsizei length,
+                              const GLchar* message, const void* userParam) {
+    kore::ELogLevel level = kore::LOG_INFO;
+    if (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH) {
+      level = kore::LOG_ERROR;
+    } else if (severity == GL_DEBUG_SEVERITY_MEDIUM) {
+      level = kore::LOG_WARNING;
+    }
+
+    KORE_LOG(level, kore::LOG_CATEGORY_GL, "%s (%s, id %u): %s\n",
+             getTypeName(type), getSourceName(source), id, message);
+  }
+}
+
+const char* kore::GLerror::getErrorName(const GLenum err) {
+  switch (err) {
+    case GL_NO_ERROR: return "NO ERROR";
+    case GL_INVALID_ENUM: return "INVALID ENUM";
+    case GL_INVALID_VALUE: return "INVALID VALUE";
+    case GL_INVALID_OPERATION: return "INVALID OPERATION";
+    case GL_INVALID_FRAMEBUFFER_OPERATION:
+      return "INVALID FRAMEBUFFER OPERATION";
+    case GL_STACK_OVERFLOW: return "STACK OVERFLOW";
+    case GL_STACK_UNDERFLOW: return "STACK UNDERFLOW";
+    case GL_OUT_OF_MEMORY: return "OUT OF MEMORY";
+    case GL_TABLE_TOO_LARGE: return "TABLE TOO LARGE";
+    default: return "UNKNOWN ERROR";
+  }
+}
+
+bool kore::GLerror::installDebugCallback(const bool synchronous) {
+  if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug) {
+    KORE_LOG_WARNING(LOG_CATEGORY_GL, "GL_KHR_debug is not supported. "
+                     "Falling back to glGetError checks\n");
+    return false;
+  }
+
+  glEnable(GL_DEBUG_OUTPUT);
+  if (synchronous) {
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  } else {
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  }
+
+  // Notifications (e.g. buffer placement hints) would flood the log.
+  glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE,
+                        GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
+  glDebugMessageCallback(reinterpret_cast<GLDEBUGPROC>(&debugCallback),
+                         NULL);
+  _callbackInstalled = true;
+  return true;
+}
+
+void kore::GLerror::removeDebugCallback() {
+  if (!_callbackInstalled) {
+    return;
+  }
+
+  glDebugMessageCallback(NULL, NULL);
+  glDisable(GL_DEBUG_OUTPUT);
+  _callbackInstalled = false;
+}
+
+bool kore::GLerror::setDebugAnnotationsEnabled(const bool enabled) {
+  if (!enabled) {
+    _debugAnnotations = false;
+    return true;
+  }
+
+  if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug) {
+    KORE_LOG_WARNING(LOG_CATEGORY_GL, "GL_KHR_debug is not supported, "
+                     "debug annotations stay disabled\n");
+    return false;
+  }
+
+  if (!_debugAnnotations) {
+    _debugAnnotations = true;
+    ResourceManager::getInstance()->applyDebugLabels();
+  }
+  return true;
+}
+
+void kore::GLerror::setObjectLabel(const GLenum identifier,
+                                   const GLuint name,
+                                   const std::string& label) {
+  if (!_debugAnnotations || name == 0 || name == KORE_GLUINT_HANDLE_INVALID
+      || label.empty()) {
+    return;
+  }
+
+  // The limit is at least 256 and doesn't change, so it is queried once.
+  static GLint maxLength = 0;
+  if (maxLength == 0) {
+    glGetIntegerv(GL_MAX_LABEL_LENGTH, &maxLength);
+  }
+  const GLsizei length =
+    std::min(static_cast<GLsizei>(label.size()), maxLength - 1);
+  glObjectLabel(identifier, name, length, label.c_str());
+}
+
+void kore::GLerror::pushDebugGroup(const std::string& name) {
+  if (!_debugAnnotations) {
+    return;
+  }
+  glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0,
+                   static_cast<GLsizei>(name.size()), name.c_str());
+}
+
+void kore::GLerror::popDebugGroup() {
+  if (!_debugAnnotations) {
+    return;
+  }
+  glPopDebugGroup();
+}
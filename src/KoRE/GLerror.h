@@ -20,9 +20,38 @@
 #ifndef CORE_INCLUDE_CORE_GLERROR_H_
 #define CORE_INCLUDE_CORE_GLERROR_H_
 
+#include <string>
 #include "KoRE/Common.h"
 #include "KoRE/Log.h"
 
+// Per-operation GL error checks are compiled out in release builds.
+// Define KORE_GL_ERROR_CHECKS to 0 or 1 to override.
+#ifndef KORE_GL_ERROR_CHECKS
+#ifdef NDEBUG
+#define KORE_GL_ERROR_CHECKS 0
+#else
+#define KORE_GL_ERROR_CHECKS 1
+#endif
+#endif
+
+#if KORE_GL_ERROR_CHECKS
+#define KORE_GL_CHECK_START()                                          \
+  do {                                                                 \
+    if (kore::GLerror::isOperationCheckEnabled()) {                    \
+      kore::GLerror::gl_ErrorCheckStart();                             \
+    }                                                                  \
+  } while (0)
+#define KORE_GL_CHECK_FINISH(context, detail)                          \
+  do {                                                                 \
+    if (kore::GLerror::isOperationCheckEnabled()) {                    \
+      kore::GLerror::gl_ErrorCheckFinish(context, detail);             \
+    }                                                                  \
+  } while (0)
+#else
+#define KORE_GL_CHECK_START() do {} while (0)
+#define KORE_GL_CHECK_FINISH(context, detail) do {} while (0)
+#endif
+
 namespace kore {
   class GLerror {
   public:
@@ -30,35 +59,23 @@ namespace kore {
       glGetError();
     }
 
-    static bool gl_ErrorCheckFinish(const std::string& message) {
+    /*! \brief Logs the pending GL error, if any.
+    *   The message is only formatted if an error occured.
+    *   \param context Short description of the failed call.
+    *   \param detail Optional name of the involved object, may be NULL.
+    *   \return true if there was no error. */
+    static bool gl_ErrorCheckFinish(const char* context,
+                                    const char* detail = NULL) {
       GLenum err = glGetError();
+      if (err == GL_NO_ERROR) {
+        return true;
+      }
 
-      Log* pLog = Log::getInstance();
-      switch( err ) {
-      case GL_INVALID_ENUM: {
-        pLog->write("[GL-ERROR] INVALID ENUM: %s\n", message.c_str());
-      }break;
-      case GL_INVALID_VALUE: {
-           pLog->write("[GL-ERROR] INVALID VALUE: %s\n", message.c_str());
-      }break;
-      case GL_INVALID_OPERATION: {
-        pLog->write("[GL-ERROR] INVALID OPERATION: %s\n", message.c_str());
-      }break;
-      case GL_STACK_OVERFLOW: {
-        pLog->write("[GL-ERROR] STACK OVERFLOW: %s\n", message.c_str());
-      }break;
-      case GL_STACK_UNDERFLOW: {
-        pLog->write("[GL-ERROR] STACK UNDERFLOW: %s\n", message.c_str());
-      }break;
-      case GL_OUT_OF_MEMORY: {
-         pLog->write("[GL-ERROR] OUT OF MEMORY: %s\n", message.c_str());
-      }break;
-      case GL_TABLE_TOO_LARGE: {
-         pLog->write("[GL-ERROR] TABLE TOO LARGE: %s\n", message.c_str());
-      }break;
-     }
-
-      return err == GL_NO_ERROR;
+      Log::getInstance()->write(LOG_ERROR, LOG_CATEGORY_GL, "%s: %s%s%s\n",
+                                getErrorName(err), context,
+                                detail != NULL ? " " : "",
+                                detail != NULL ? detail : "");
+      return false;
     }
 
     static bool gl_ValidateFBO(const std::string& message) {
@@ -68,29 +85,79 @@ namespace kore {
 
       switch( error ) {
         case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
-          pLog->write("[FRAMEBUFFER-ERROR]"
-            " GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT: %s\n", message.c_str());
+          pLog->write(LOG_ERROR, LOG_CATEGORY_GL, "Framebuffer "
+            "GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT: %s\n", message.c_str());
         break;
         case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
-          pLog->write("[FRAMEBUFFER-ERROR]"
-      " GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT: %s\n", message.c_str());
+          pLog->write(LOG_ERROR, LOG_CATEGORY_GL, "Framebuffer "
+            "GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT: %s\n", message.c_str());
         break;
         case GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER:
-          pLog->write("[FRAMEBUFFER-ERROR]"
-            " GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER: %s\n", message.c_str());
+          pLog->write(LOG_ERROR, LOG_CATEGORY_GL, "Framebuffer "
+            "GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER: %s\n", message.c_str());
         break;
         case GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER:
-          pLog->write("[FRAMEBUFFER-ERROR]"
+          pLog->write(LOG_ERROR, LOG_CATEGORY_GL, "Framebuffer "
             "GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER: %s\n", message.c_str());
         break;
         case GL_FRAMEBUFFER_UNSUPPORTED:
-          pLog->write("[FRAMEBUFFER-ERROR]"
+          pLog->write(LOG_ERROR, LOG_CATEGORY_GL, "Framebuffer "
             "GL_FRAMEBUFFER_UNSUPPORTED: %s\n", message.c_str());
         break;
       }
 
-      return error == GL_NO_ERROR;
+      return error == GL_FRAMEBUFFER_COMPLETE;
     }
+
+    static const char* getErrorName(const GLenum err);
+
+    /*! \brief Installs a GL_KHR_debug message callback that reports GL
+    *          errors and warnings to the log as the driver detects them.
+    *          While the callback is installed, the per-operation
+    *          glGetError checks are skipped.
+    *   \param synchronous Report messages from within the offending GL call
+    *          (GL_DEBUG_OUTPUT_SYNCHRONOUS). Slower, but easier to debug.
+    *   \return false if GL_KHR_debug is not supported. */
+    static bool installDebugCallback(const bool synchronous = false);
+    static void removeDebugCallback();
+    static inline bool isDebugCallbackInstalled() {return _callbackInstalled;}
+
+    /*! \brief Enables or disables the glGetError checks of the operations
+    *          at runtime (only in builds with KORE_GL_ERROR_CHECKS). */
+    static inline void setOperationCheckEnabled(const bool enabled)
+      {_operationChecks = enabled;}
+    static inline bool isOperationCheckEnabled()
+      {return _operationChecks && !_callbackInstalled;}
+
+    /*! \brief Enables GL_KHR_debug annotations at runtime: GL objects are
+    *          labeled with their KoRE names and FrameBufferStages and
+    *          ShaderProgramPasses are wrapped into debug groups, so
+    *          graphics debuggers, GPU profilers and apitrace show the
+    *          structure of a frame. Enabling labels all resources the
+    *          ResourceManager already holds. While disabled, no
+    *          annotation calls are made.
+    *   \return false if GL_KHR_debug is not supported. */
+    static bool setDebugAnnotationsEnabled(const bool enabled);
+    static inline bool areDebugAnnotationsEnabled()
+      {return _debugAnnotations;}
+
+    /*! \brief Labels a GL object, so debug messages and graphics debuggers
+    *          show its name. Does nothing while debug annotations are
+    *          disabled. The object has to be bound once before.
+    *   \param identifier The namespace of the object,
+    *          e.g. GL_TEXTURE, GL_BUFFER, GL_PROGRAM or GL_FRAMEBUFFER. */
+    static void setObjectLabel(const GLenum identifier, const GLuint name,
+                               const std::string& label);
+
+    /*! \brief Opens or closes a debug group while debug annotations are
+    *          enabled. Groups have to be closed in reverse order. */
+    static void pushDebugGroup(const std::string& name);
+    static void popDebugGroup();
+
+  private:
+    static bool _operationChecks;
+    static bool _callbackInstalled;
+    static bool _debugAnnotations;
   };  // end class
 }  // end namespace
 #endif
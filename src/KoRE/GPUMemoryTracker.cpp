@@ -0,0 +1,329 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/GPUMemoryTracker.h"
+
+#include <algorithm>
+#include "KoRE/Log.h"
+
+namespace {
+  inline double toMB(const GLuint64 bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+  }
+
+  bool compareAllocationSize(const kore::SGPUAllocation& a,
+                             const kore::SGPUAllocation& b) {
+    return a.bytes > b.bytes;
+  }
+}
+
+kore::GPUMemoryTracker::GPUMemoryTracker(void)
+  : _owner("") {
+  for (uint i = 0; i <= GPUMEM_TOTAL; ++i) {
+    _usage[i] = 0;
+    _peakUsage[i] = 0;
+    _budgets[i] = 0;
+    _policies[i] = BUDGET_LOG;
+  }
+}
+
+kore::GPUMemoryTracker::~GPUMemoryTracker(void) {
+}
+
+bool kore::GPUMemoryTracker::allocate(const uint64 resourceID,
+                                      const EGPUMemoryType type,
+                                      const std::string& name,
+                                      const GLuint64 bytes) {
+  auto it = _allocations.find(resourceID);
+  const EGPUMemoryType allocType =
+    it != _allocations.end() ? it->second.type : type;
+  const GLuint64 oldBytes = it != _allocations.end() ? it->second.bytes : 0;
+  const GLuint64 addedBytes = bytes > oldBytes ? bytes - oldBytes : 0;
+
+  if (!checkBudget(allocType, addedBytes, name, true)) {
+    return false;
+  }
+
+  if (it == _allocations.end()) {
+    SGPUAllocation& alloc = _allocations[resourceID];
+    alloc.type = type;
+    alloc.owner = _owner;
+    it = _allocations.find(resourceID);
+  }
+
+  removeUsage(allocType, oldBytes);
+  addUsage(allocType, bytes);
+  it->second.name = name;
+  it->second.bytes = bytes;
+  return true;
+}
+
+void kore::GPUMemoryTracker::release(const uint64 resourceID) {
+  auto it = _allocations.find(resourceID);
+  if (it == _allocations.end()) {
+    return;
+  }
+
+  removeUsage(it->second.type, it->second.bytes);
+  _allocations.erase(it);
+}
+
+void kore::GPUMemoryTracker::setType(const uint64 resourceID,
+                                     const EGPUMemoryType type) {
+  auto it = _allocations.find(resourceID);
+  if (it == _allocations.end() || it->second.type == type
+      || type == GPUMEM_TOTAL) {
+    return;
+  }
+
+  // The total doesn't change, so only the budget of the new type matters.
+  SGPUAllocation& alloc = it->second;
+  if (_budgets[type] != 0
+      && _usage[type] + alloc.bytes > _budgets[type]) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RESOURCE, "'%s' (%.2f MB) exceeds the %s "
+                     "budget of %.2f MB\n", alloc.name.c_str(),
+                     toMB(alloc.bytes), getTypeName(type),
+                     toMB(_budgets[type]));
+  }
+
+  removeUsage(alloc.type, alloc.bytes);
+  alloc.type = type;
+  addUsage(alloc.type, alloc.bytes);
+}
+
+void kore::GPUMemoryTracker::setBudget(const EGPUMemoryType type,
+                                       const GLuint64 bytes,
+                                       const EGPUBudgetPolicy policy) {
+  _budgets[type] = bytes;
+  _policies[type] = policy;
+
+  if (bytes != 0 && _usage[type] > bytes) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RESOURCE, "The %s budget of %.2f MB is "
+                     "exceeded already (%.2f MB in use)\n",
+                     getTypeName(type), toMB(bytes),
+                     toMB(_usage[type]));
+  }
+}
+
+void kore::GPUMemoryTracker::
+  getUsageByOwner(std::map<std::string, GLuint64>& rvUsage) const {
+  rvUsage.clear();
+  for (auto it = _allocations.begin(); it != _allocations.end(); ++it) {
+    rvUsage[it->second.owner] += it->second.bytes;
+  }
+}
+
+void kore::GPUMemoryTracker::
+  getAllocations(std::vector<SGPUAllocation>& rvAllocations) const {
+  rvAllocations.clear();
+  rvAllocations.reserve(_allocations.size());
+  for (auto it = _allocations.begin(); it != _allocations.end(); ++it) {
+    rvAllocations.push_back(it->second);
+  }
+  std::sort(rvAllocations.begin(), rvAllocations.end(),
+            compareAllocationSize);
+}
+
+void kore::GPUMemoryTracker::logReport(const uint maxAllocations) const {
+  Log* log = Log::getInstance();
+  KORE_LOG_INFO(LOG_CATEGORY_RESOURCE, "GPU memory:\n");
+  for (uint i = 0; i <= GPUMEM_TOTAL; ++i) {
+    const EGPUMemoryType type = static_cast<EGPUMemoryType>(i);
+    if (_budgets[i] != 0) {
+      KORE_LOG_INFO(LOG_CATEGORY_RESOURCE,
+                    "  %-12s %10.2f MB (peak %.2f MB, budget %.2f MB)\n",
+                    getTypeName(type), toMB(_usage[i]), toMB(_peakUsage[i]),
+                    toMB(_budgets[i]));
+    } else {
+      KORE_LOG_INFO(LOG_CATEGORY_RESOURCE,
+                    "  %-12s %10.2f MB (peak %.2f MB)\n", getTypeName(type),
+                    toMB(_usage[i]), toMB(_peakUsage[i]));
+    }
+  }
+
+  std::map<std::string, GLuint64> ownerUsage;
+  getUsageByOwner(ownerUsage);
+  KORE_LOG_INFO(LOG_CATEGORY_RESOURCE, "GPU memory per owner:\n");
+  for (auto it = ownerUsage.begin(); it != ownerUsage.end(); ++it) {
+    KORE_LOG_INFO(LOG_CATEGORY_RESOURCE, "  %10.2f MB  %s\n", toMB(it->second),
+                  it->first.empty() ? "<none>" : it->first.c_str());
+  }
+
+  std::vector<SGPUAllocation> allocations;
+  getAllocations(allocations);
+  const uint numAllocations =
+    std::min(maxAllocations, static_cast<uint>(allocations.size()));
+  KORE_LOG_INFO(LOG_CATEGORY_RESOURCE, "Largest GPU allocations:\n");
+  for (uint i = 0; i < numAllocations; ++i) {
+    KORE_LOG_INFO(LOG_CATEGORY_RESOURCE,
+                  "  %10.2f MB  %-12s %s\n", toMB(allocations[i].bytes),
+                  getTypeName(allocations[i].type),
+                  allocations[i].name.c_str());
+  }
+}
+
+bool kore::GPUMemoryTracker::checkBudget(const EGPUMemoryType type,
+                                         const GLuint64 addedBytes,
+                                         const std::string& name,
+                                         const bool canRefuse) const {
+  if (addedBytes == 0) {
+    return true;
+  }
+
+  // Check the budget of the type first, then the total budget.
+  const EGPUMemoryType budgetTypes[2] = {type, GPUMEM_TOTAL};
+  const uint numBudgets = type == GPUMEM_TOTAL ? 1 : 2;
+  for (uint i = 0; i < numBudgets; ++i) {
+    const EGPUMemoryType budgetType = budgetTypes[i];
+    const GLuint64 budget = _budgets[budgetType];
+    if (budget == 0 || _usage[budgetType] + addedBytes <= budget) {
+      continue;
+    }
+
+    if (canRefuse && _policies[budgetType] == BUDGET_REFUSE) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Refused %.2f MB for '%s': the %s "
+                     "budget of %.2f MB would be exceeded "
+                     "(%.2f MB in use)\n", toMB(addedBytes),
+                     name.c_str(), getTypeName(budgetType),
+                     toMB(budget), toMB(_usage[budgetType]));
+      return false;
+    }
+
+    KORE_LOG_WARNING(LOG_CATEGORY_RESOURCE, "'%s' (%.2f MB) exceeds the %s "
+                     "budget of %.2f MB (%.2f MB in use)\n",
+                     name.c_str(), toMB(addedBytes),
+                     getTypeName(budgetType), toMB(budget),
+                     toMB(_usage[budgetType]));
+  }
+  return true;
+}
+
+void kore::GPUMemoryTracker::addUsage(const EGPUMemoryType type,
+                                      const GLuint64 bytes) {
+  _usage[type] += bytes;
+  _usage[GPUMEM_TOTAL] += bytes;
+  _peakUsage[type] = std::max(_peakUsage[type], _usage[type]);
+  _peakUsage[GPUMEM_TOTAL] =
+    std::max(_peakUsage[GPUMEM_TOTAL], _usage[GPUMEM_TOTAL]);
+}
+
+void kore::GPUMemoryTracker::removeUsage(const EGPUMemoryType type,
+                                         const GLuint64 bytes) {
+  _usage[type] -= std::min(_usage[type], bytes);
+  _usage[GPUMEM_TOTAL] -= std::min(_usage[GPUMEM_TOTAL], bytes);
+}
+
+const char* kore::GPUMemoryTracker::getTypeName(const EGPUMemoryType type) {
+  switch (type) {
+    case GPUMEM_MESH: return "Mesh";
+    case GPUMEM_TEXTURE: return "Texture";
+    case GPUMEM_FRAMEBUFFER: return "FrameBuffer";
+    case GPUMEM_BUFFER: return "Buffer";
+    case GPUMEM_TOTAL: return "Total";
+  }
+  return "Unknown";
+}
+
+GLuint64 kore::GPUMemoryTracker::
+  getTextureByteSize(const STextureProperties& properties,
+                     const bool mipChain) {
+  const GLuint64 bytesPerTexel =
+    getBytesPerTexel(properties.internalFormat, properties.format,
+                     properties.pixelType);
+
+  GLuint64 width = std::max(properties.width, 1u);
+  GLuint64 height = std::max(properties.height, 1u);
+  GLuint64 depth = std::max(properties.depth, 1u);
+
+  GLuint64 bytes = width * height * depth * bytesPerTexel;
+  while (mipChain && (width > 1 || height > 1 || depth > 1)) {
+    width = std::max<GLuint64>(width / 2, 1);
+    height = std::max<GLuint64>(height / 2, 1);
+    depth = std::max<GLuint64>(depth / 2, 1);
+    bytes += width * height * depth * bytesPerTexel;
+  }
+  return bytes;
+}
+
+uint kore::GPUMemoryTracker::getBytesPerTexel(const GLuint internalFormat,
+                                              const GLuint format,
+                                              const GLuint pixelType) {
+  switch (internalFormat) {
+    case GL_R8: case GL_R8I: case GL_R8UI: case GL_R8_SNORM:
+      return 1;
+    case GL_RG8: case GL_RG8I: case GL_RG8UI: case GL_RG8_SNORM:
+    case GL_R16: case GL_R16F: case GL_R16I: case GL_R16UI:
+    case GL_DEPTH_COMPONENT16:
+      return 2;
+    case GL_RGB8: case GL_SRGB8: case GL_RGB8I: case GL_RGB8UI:
+      return 3;
+    case GL_RGBA8: case GL_SRGB8_ALPHA8: case GL_RGBA8I: case GL_RGBA8UI:
+    case GL_RGB10_A2: case GL_R11F_G11F_B10F: case GL_RGB9_E5:
+    case GL_RG16: case GL_RG16F: case GL_RG16I: case GL_RG16UI:
+    case GL_R32F: case GL_R32I: case GL_R32UI:
+    case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32:
+    case GL_DEPTH_COMPONENT32F: case GL_DEPTH24_STENCIL8:
+      // 24 bit depth is stored in 32 bit by all common hardware.
+      return 4;
+    case GL_RGB16: case GL_RGB16F: case GL_RGB16I: case GL_RGB16UI:
+      return 6;
+    case GL_RGBA16: case GL_RGBA16F: case GL_RGBA16I: case GL_RGBA16UI:
+    case GL_RG32F: case GL_RG32I: case GL_RG32UI:
+    case GL_DEPTH32F_STENCIL8:
+      return 8;
+    case GL_RGB32F: case GL_RGB32I: case GL_RGB32UI:
+      return 12;
+    case GL_RGBA32F: case GL_RGBA32I: case GL_RGBA32UI:
+      return 16;
+    default:
+      break;
+  }
+
+  // Unsized internal format: estimate from the pixel transfer format.
+  uint numComponents = 4;
+  switch (format) {
+    case GL_RED: case GL_GREEN: case GL_BLUE: case GL_ALPHA:
+    case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX:
+      numComponents = 1;
+      break;
+    case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL:
+      numComponents = 2;
+      break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER:
+      numComponents = 3;
+      break;
+    default:
+      break;
+  }
+
+  uint componentSize = 1;
+  switch (pixelType) {
+    case GL_SHORT: case GL_UNSIGNED_SHORT: case GL_HALF_FLOAT:
+      componentSize = 2;
+      break;
+    case GL_INT: case GL_UNSIGNED_INT: case GL_FLOAT:
+      componentSize = 4;
+      break;
+    case GL_UNSIGNED_INT_24_8:
+      return 4;
+    default:
+      break;
+  }
+  return numComponents * componentSize;
+}
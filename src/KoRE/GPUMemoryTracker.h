@@ -0,0 +1,145 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_GPUMEMORYTRACKER_H_
+#define KORE_SRC_KORE_GPUMEMORYTRACKER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "KoRE/Common.h"
+#include "KoRE/Texture.h"
+
+namespace kore {
+  /// The kinds of resources the GPUMemoryTracker accounts for.
+  enum EGPUMemoryType {
+    GPUMEM_MESH,         // Vertex- and index-buffers of meshes
+    GPUMEM_TEXTURE,      // Textures including their mip chains
+    GPUMEM_FRAMEBUFFER,  // Textures attached to FrameBuffers
+    GPUMEM_BUFFER,       // IndexedBuffers
+    GPUMEM_TOTAL         // All of the above
+  };
+
+  /// What happens to allocations that exceed a budget.
+  enum EGPUBudgetPolicy {
+    BUDGET_LOG,     // The allocation is done, but a warning is logged
+    BUDGET_REFUSE   // The allocation is refused and an error is logged
+  };
+
+  /*! \brief The video memory accounted for one resource. */
+  struct SGPUAllocation {
+    SGPUAllocation(void)
+      : type(GPUMEM_TOTAL),
+        bytes(0) {
+    }
+
+    EGPUMemoryType type;
+    std::string name;
+    std::string owner;  // The scene that was loading when it was allocated
+    GLuint64 bytes;
+  };
+
+  /*! \brief Accounts for the video memory of KoRE's resources.
+  *   Resources report the size of their GL storage before they allocate it,
+  *   so allocations over a budget can be refused. The sizes are computed
+  *   from the requested dimensions and formats - the driver may need more
+  *   for alignment and padding, so the numbers are a lower bound.
+  *   Every allocation is tagged with the owner set via setOwner(..), e.g.
+  *   the scene file that is being loaded.
+  */
+  class GPUMemoryTracker {
+  public:
+    GPUMemoryTracker(void);
+    ~GPUMemoryTracker(void);
+
+    /*! \brief Reports the storage of a resource before it is allocated.
+    *          Allocating again for the same resource replaces its size;
+    *          type and owner of the first allocation are kept.
+    *   \return false if the allocation exceeds a budget with the policy
+    *           BUDGET_REFUSE. Nothing is recorded in that case. */
+    bool allocate(const uint64 resourceID, const EGPUMemoryType type,
+                  const std::string& name, const GLuint64 bytes);
+
+    /*! \brief Reports that the storage of a resource has been deleted. */
+    void release(const uint64 resourceID);
+
+    /*! \brief Moves an allocation to another type, e.g. when a texture is
+    *          attached to a FrameBuffer. Budgets are only logged here,
+    *          because the memory is allocated already. */
+    void setType(const uint64 resourceID, const EGPUMemoryType type);
+
+    /*! \brief Sets the budget of a type, or of all types with GPUMEM_TOTAL.
+    *   \param bytes The budget in bytes. 0 removes the budget. */
+    void setBudget(const EGPUMemoryType type, const GLuint64 bytes,
+                   const EGPUBudgetPolicy policy = BUDGET_LOG);
+    inline GLuint64 getBudget(const EGPUMemoryType type) const
+      {return _budgets[type];}
+
+    /*! \brief Returns the bytes currently allocated for a type, or for all
+    *          types with GPUMEM_TOTAL. */
+    inline GLuint64 getUsage(const EGPUMemoryType type) const
+      {return _usage[type];}
+
+    /*! \brief Returns the highest usage of a type since the start. */
+    inline GLuint64 getPeakUsage(const EGPUMemoryType type) const
+      {return _peakUsage[type];}
+
+    /*! \brief Returns the bytes allocated per owner. */
+    void getUsageByOwner(std::map<std::string, GLuint64>& rvUsage) const;
+
+    /*! \brief Returns all allocations, the largest first. */
+    void getAllocations(std::vector<SGPUAllocation>& rvAllocations) const;
+
+    /*! \brief Sets the owner new allocations are tagged with. */
+    inline void setOwner(const std::string& owner) {_owner = owner;}
+    inline const std::string& getOwner(void) const {return _owner;}
+
+    /*! \brief Writes the usage per type and owner and the largest
+    *          allocations to the Log. */
+    void logReport(const uint maxAllocations = 10) const;
+
+    static const char* getTypeName(const EGPUMemoryType type);
+
+    /*! \brief Returns the size of a texture with the provided properties.
+    *   \param mipChain Include all mip levels down to 1x1. */
+    static GLuint64 getTextureByteSize(const STextureProperties& properties,
+                                       const bool mipChain);
+
+    /*! \brief Returns the bytes per texel of an internal format.
+    *          Unsized formats are estimated from format and pixel type. */
+    static uint getBytesPerTexel(const GLuint internalFormat,
+                                 const GLuint format,
+                                 const GLuint pixelType);
+
+  private:
+    bool checkBudget(const EGPUMemoryType type, const GLuint64 addedBytes,
+                     const std::string& name, const bool canRefuse) const;
+    void addUsage(const EGPUMemoryType type, const GLuint64 bytes);
+    void removeUsage(const EGPUMemoryType type, const GLuint64 bytes);
+
+    std::unordered_map<uint64, SGPUAllocation> _allocations;
+    GLuint64 _usage[GPUMEM_TOTAL + 1];
+    GLuint64 _peakUsage[GPUMEM_TOTAL + 1];
+    GLuint64 _budgets[GPUMEM_TOTAL + 1];
+    EGPUBudgetPolicy _policies[GPUMEM_TOTAL + 1];
+    std::string _owner;
+  };
+};
+#endif  // KORE_SRC_KORE_GPUMEMORYTRACKER_H_
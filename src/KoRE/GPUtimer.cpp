@@ -26,162 +26,213 @@
 
 #include "KoRE/GPUtimer.h"
 
-using namespace kore;
+#include <algorithm>
+
+#include "KoRE/Log.h"
 
-#define TIMING_NOT_AVAILABLE 0xFFFFFFFFFFFFFFFF
+using namespace kore;
 
 GPUtimer* GPUtimer::getInstance() {
   static GPUtimer instance;
   return &instance;
 }
 
-
-GPUtimer::GPUtimer() {
-
+GPUtimer::GPUtimer()
+  : _enabled(true),
+    _overflowWarned(false),
+    _frameIndex(0),
+    _numDroppedFrames(0) {
+  for (uint i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+    _frames[i].scopes.reserve(MAX_SCOPES_PER_FRAME);
+  }
 }
 
 GPUtimer::~GPUtimer() {
-  
-  for (auto iter = _queryObjects.begin(); iter != _queryObjects.end(); iter++) {
-    GLuint val = (*iter);
-    glDeleteQueries(1, &val);
+  for (uint i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+    if (_frames[i].fence != 0) {
+      glDeleteSync(_frames[i].fence);
+    }
   }
-}
 
-void GPUtimer::queryTimestamp(const std::string& name, GLuint queryObject) {
-  if (std::find(_queryObjects.begin(), _queryObjects.end(), queryObject) 
-    == _queryObjects.end())
-  {
-      _queryObjects.push_back(queryObject);
-      _queryNames[queryObject] = name;
-      glQueryCounter(queryObject, GL_TIMESTAMP);
+  if (!_queries.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(_queries.size()), &_queries[0]);
   }
 }
 
-void GPUtimer::checkQueryResults() {
-  std::vector<GLuint> finishedList;
-
-  for (auto iter = _queryObjects.begin(); iter != _queryObjects.end(); iter++) {
+void GPUtimer::createQueries() {
+  _queries.resize(FRAMES_IN_FLIGHT * MAX_SCOPES_PER_FRAME * 2);
+  glGenQueries(static_cast<GLsizei>(_queries.size()), &_queries[0]);
+}
 
-    GLuint available = GL_FALSE;
-    glGetQueryObjectuiv((*iter), GL_QUERY_RESULT_AVAILABLE, &available);
-    
-    if (available) {
-      finishedList.push_back((*iter));
-    }
+uint GPUtimer::startDurationQuery(const std::string& name) {
+  if (!_enabled) {
+    return KORE_UINT_INVALID;
   }
 
-  for (uint i = 0; i < finishedList.size(); ++i) {
-    // Remove from queryObjects-list
-    _queryObjects.erase(std::find(_queryObjects.begin(),
-                                  _queryObjects.end(),
-                                  finishedList[i]));
-
-
-    GLuint64 result;
-    glGetQueryObjectui64v(finishedList[i], GL_QUERY_RESULT, &result);
-    _timestamps[finishedList[i]] = result;
+  if (_queries.empty()) {
+    createQueries();
   }
-}
-
 
-GLuint64 GPUtimer::getQueryResult(const uint queryID) {
-  if (isTimestampAvailable(queryID)) {
-    return _timestamps[queryID];
+  const uint slot = _frameIndex % FRAMES_IN_FLIGHT;
+  SFrame& frame = _frames[slot];
+  if (frame.scopes.size() >= MAX_SCOPES_PER_FRAME) {
+    if (!_overflowWarned) {
+      KORE_LOG_WARNING(LOG_CATEGORY_GL, "GPUtimer: More than %u scopes "
+                       "in one frame. Further scopes are ignored\n",
+                       MAX_SCOPES_PER_FRAME);
+      _overflowWarned = true;
+    }
+    return KORE_UINT_INVALID;
   }
 
-  return TIMING_NOT_AVAILABLE;
-}
+  uint statsIndex;
+  auto it = _statsIndices.find(name);
+  if (it == _statsIndices.end()) {
+    statsIndex = static_cast<uint>(_stats.size());
+    _stats.push_back(SScopeStats());
+    _stats.back().name = name;
+    _stats.back().samples.resize(STATS_WINDOW_SIZE, 0);
+    _statsIndices[name] = statsIndex;
+  } else {
+    statsIndex = it->second;
+  }
 
-const std::string& GPUtimer::getQueryName(const uint queryID) {
-  return _queryNames.find(queryID)->second;
-}
+  const uint scopeID = static_cast<uint>(frame.scopes.size());
+  SScope scope;
+  scope.statsIndex = statsIndex;
+  scope.ended = false;
+  frame.scopes.push_back(scope);
 
-void GPUtimer::removeQueryResult(const uint queryID) {
-   
-   glDeleteQueries(1, &queryID);
-   
-   _queryNames.erase(_queryNames.find(queryID));
-   _timestamps.erase(_timestamps.find(queryID));
-   _durationQueries.erase(_durationQueries.find(queryID));
+  glQueryCounter(getQuery(slot, scopeID, false), GL_TIMESTAMP);
+  return scopeID;
 }
 
+void GPUtimer::endDurationQuery(const uint scopeID) {
+  const uint slot = _frameIndex % FRAMES_IN_FLIGHT;
+  SFrame& frame = _frames[slot];
+  if (scopeID >= frame.scopes.size() || frame.scopes[scopeID].ended) {
+    return;
+  }
 
-void GPUtimer::startDurationQuery(const std::string& name, GLuint queryObject) {
-  queryTimestamp(name, queryObject);
+  glQueryCounter(getQuery(slot, scopeID, true), GL_TIMESTAMP);
+  frame.scopes[scopeID].ended = true;
 }
 
-void GPUtimer::endDurationQuery(const uint startQueryID) {
-  auto iter = _durationQueries.find(startQueryID);
-
-  GLuint endQuery = 0;
-  if (iter == _durationQueries.end()) {
-    // No entry in the durationQuery-table yet. 
-    glGenQueries(1, &endQuery);
-  } else {
-     endQuery = iter->second;
+void GPUtimer::endFrame() {
+  const uint closedSlot = _frameIndex % FRAMES_IN_FLIGHT;
+  SFrame& closed = _frames[closedSlot];
+  closed.frameIndex = _frameIndex;
+  if (!closed.scopes.empty()) {
+    closed.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
   }
+  ++_frameIndex;
+
+  // Resolve all finished frames from the oldest to the newest. Frames
+  // complete in order, so the first unfinished one ends the search.
+  const uint nextSlot = _frameIndex % FRAMES_IN_FLIGHT;
+  for (uint i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+    const uint slot = (nextSlot + i) % FRAMES_IN_FLIGHT;
+    if (_frames[slot].fence == 0) {
+      continue;
+    }
 
-  _durationQueries[startQueryID] = endQuery;
-  queryTimestamp("", endQuery);
-}
-
-GLuint64 GPUtimer::getDurationMS(const uint startQueryID) {
-  auto iter = _durationQueries.find(startQueryID);
+    GLenum status = glClientWaitSync(_frames[slot].fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+      break;
+    }
+    resolveFrame(slot);
+  }
 
-  if (iter == _durationQueries.end()) {
-    // No entry in the durationQuery-table. 
-    // endDurationQUery() wasn't called yet
-    return TIMING_NOT_AVAILABLE;
+  // The slot of the next frame still hasn't finished on the GPU.
+  // Drop its results instead of waiting for them.
+  SFrame& next = _frames[nextSlot];
+  if (next.fence != 0) {
+    glDeleteSync(next.fence);
+    next.fence = 0;
+    ++_numDroppedFrames;
   }
+  next.scopes.clear();
+}
 
-  GLuint endQueryID = iter->second;
+void GPUtimer::resolveFrame(const uint slot) {
+  SFrame& frame = _frames[slot];
+  glDeleteSync(frame.fence);
+  frame.fence = 0;
 
-  if (isTimestampAvailable(startQueryID) 
-      && isTimestampAvailable(endQueryID)) {
-        GLuint64 duration = 
-          static_cast<double>(getQueryResult(endQueryID) - getQueryResult(startQueryID));
+  _lastResults.clear();
+  for (uint i = 0; i < frame.scopes.size(); ++i) {
+    const SScope& scope = frame.scopes[i];
+    if (!scope.ended) {
+      continue;
+    }
 
-        return duration;
+    GLuint64 start = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(getQuery(slot, i, false), GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(getQuery(slot, i, true), GL_QUERY_RESULT, &end);
+    const GLuint64 duration = end > start ? end - start : 0;
+
+    SScopeStats& stats = _stats[scope.statsIndex];
+    stats.samples[stats.next] = duration;
+    stats.next = (stats.next + 1) % STATS_WINDOW_SIZE;
+    stats.count = std::min(stats.count + 1, STATS_WINDOW_SIZE);
+    stats.lastNS = duration;
+
+    SDurationResult result;
+    result.durationNS = duration;
+    result.name = stats.name;
+    result.frameIndex = frame.frameIndex;
+    _lastResults.push_back(result);
   }
+  frame.scopes.clear();
+}
 
-  return TIMING_NOT_AVAILABLE;  // Timestamps are not both available (yet)
+void GPUtimer::
+  getDurationResultsMS(std::vector<SDurationResult>& rvResults) const {
+  rvResults = _lastResults;
 }
 
-void GPUtimer::getDurationResultsMS(std::vector<SDurationResult>& rvResults) {
-  rvResults.clear();
-  for (auto iter = _durationQueries.begin(); iter != _durationQueries.end(); iter++) {
-    GLuint queryID = iter->first;
-    GLuint64 duration = getDurationMS(queryID);
-
-    if (duration != TIMING_NOT_AVAILABLE) {
-      SDurationResult currResult;
-      currResult.durationNS = duration;
-      currResult.name = getQueryName(queryID);
-      currResult.startQueryID = queryID;
-      rvResults.push_back(currResult);
-    }
+bool GPUtimer::getStats(const std::string& name,
+                        SGPUTimerStats& rvStats) const {
+  auto it = _statsIndices.find(name);
+  if (it == _statsIndices.end() || _stats[it->second].count == 0) {
+    return false;
   }
 
-}
-
-void GPUtimer::removeDurationQuery(const uint startQueryID) {
-  auto iter = _durationQueries.find(startQueryID);
+  const SScopeStats& stats = _stats[it->second];
+  std::vector<GLuint64> sorted(stats.samples.begin(),
+                               stats.samples.begin() + stats.count);
+  std::sort(sorted.begin(), sorted.end());
 
-  if (iter == _durationQueries.end()) {
-    // No entry in the durationQuery-table. 
-    // This queryID was not created using startDurationQuery...
-    return;
+  GLuint64 sum = 0;
+  for (uint i = 0; i < sorted.size(); ++i) {
+    sum += sorted[i];
   }
 
-  uint endQueryID = iter->second;
-  removeQueryResult(startQueryID);
-  removeQueryResult(endQueryID);
-  _durationQueries.erase(iter);
+  const uint last = stats.count - 1;
+  rvStats.minNS = sorted.front();
+  rvStats.maxNS = sorted.back();
+  rvStats.avgNS = sum / stats.count;
+  rvStats.p50NS = sorted[(last * 50) / 100];
+  rvStats.p95NS = sorted[(last * 95) / 100];
+  rvStats.p99NS = sorted[(last * 99) / 100];
+  rvStats.numSamples = stats.count;
+  return true;
 }
 
+void GPUtimer::getScopeNames(std::vector<std::string>& rvNames) const {
+  rvNames.clear();
+  for (uint i = 0; i < _stats.size(); ++i) {
+    rvNames.push_back(_stats[i].name);
+  }
+}
 
-bool kore::GPUtimer::isTimestampAvailable( const uint queryID )
-{
-  return _timestamps.find(queryID) != _timestamps.end();
+void GPUtimer::resetStats() {
+  for (uint i = 0; i < _stats.size(); ++i) {
+    _stats[i].next = 0;
+    _stats[i].count = 0;
+    _stats[i].lastNS = 0;
+  }
+  _lastResults.clear();
+  _numDroppedFrames = 0;
 }
@@ -27,45 +27,131 @@
 #ifndef GPUTIMER_H_
 #define  GPUTIMER_H_
 
-#include <list>
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 #include "KoRE/Common.h"
 
 namespace kore {
+  /*! \brief The latest resolved duration of a named scope. */
   struct SDurationResult {
     GLuint64 durationNS;
     std::string name;
-    GLuint startQueryID;
+    uint frameIndex;
   };
 
+  /*! \brief Rolling statistics over the last
+  *          GPUtimer::STATS_WINDOW_SIZE durations of a named scope. */
+  struct SGPUTimerStats {
+    SGPUTimerStats(void)
+      : minNS(0), avgNS(0), maxNS(0),
+        p50NS(0), p95NS(0), p99NS(0),
+        numSamples(0) {
+    }
+
+    GLuint64 minNS;
+    GLuint64 avgNS;
+    GLuint64 maxNS;
+    GLuint64 p50NS;
+    GLuint64 p95NS;
+    GLuint64 p99NS;
+    uint numSamples;
+  };
+
+  /*! \brief Measures GPU durations of named scopes with timestamp queries.
+  *   Query objects live in a fixed ring of FRAMES_IN_FLIGHT frames that is
+  *   allocated once. Each frame is closed with a fence in endFrame() and its
+  *   queries are read back only when the slot is about to be reused and the
+  *   fence has signaled, so reading results never stalls the pipeline.
+  *   If the GPU is more than FRAMES_IN_FLIGHT frames behind, the results of
+  *   the oldest frame are dropped instead.
+  */
   class GPUtimer {
   public:
+    static const uint FRAMES_IN_FLIGHT = 4;
+    static const uint MAX_SCOPES_PER_FRAME = 128;
+    static const uint STATS_WINDOW_SIZE = 128;
+
     static GPUtimer* getInstance();
     ~GPUtimer();
 
-    void queryTimestamp(const std::string& name, GLuint queryObject);
+    /*! \brief Issues the start timestamp of a named scope.
+    *   \return An id to pass to endDurationQuery or KORE_UINT_INVALID if the
+    *           timer is disabled or the frame's query budget is used up. */
+    uint startDurationQuery(const std::string& name);
+
+    /*! \brief Issues the end timestamp of a scope started this frame. */
+    void endDurationQuery(const uint scopeID);
+
+    /*! \brief Closes the current frame and resolves the oldest one,
+    *          if the GPU has finished it. Call once per frame. */
+    void endFrame();
+
+    /*! \brief Returns the durations of the most recently resolved frame. */
+    void getDurationResultsMS(std::vector<SDurationResult>& rvResults) const;
+
+    /*! \brief Returns the rolling statistics of a named scope.
+    *   \return false if no duration of that scope was resolved yet. */
+    bool getStats(const std::string& name, SGPUTimerStats& rvStats) const;
+
+    /*! \brief Returns the names of all scopes that were ever measured. */
+    void getScopeNames(std::vector<std::string>& rvNames) const;
 
-    void startDurationQuery(const std::string& name, GLuint queryObject);
-    void endDurationQuery(const uint startQueryID);
+    /*! \brief Clears the rolling statistics of all scopes. */
+    void resetStats();
 
-    void checkQueryResults();
-    GLuint64 getDurationMS(const uint startQueryID);
+    inline void setEnabled(const bool enabled) {_enabled = enabled;}
+    inline bool isEnabled() const {return _enabled;}
 
-    bool isTimestampAvailable(const uint queryID);
-    GLuint64 getQueryResult(const uint queryID);
-    void getDurationResultsMS(std::vector<SDurationResult>& rvResults);
-    const std::string& getQueryName(const uint queryID);
-    void removeQueryResult(const uint queryID);
-    void removeDurationQuery(const uint startQueryID);
+    /*! \brief Returns the number of frames whose results were dropped
+    *          because the GPU had not finished them in time. */
+    inline uint getNumDroppedFrames() const {return _numDroppedFrames;}
 
   private:
     GPUtimer();
 
-    std::list<GLuint> _queryObjects;
-    std::map<GLuint, std::string> _queryNames;
-    std::map<GLuint, GLuint> _durationQueries;
-    std::map<GLuint, GLuint64> _timestamps;
+    struct SScope {
+      uint statsIndex;
+      bool ended;
+    };
+
+    struct SFrame {
+      SFrame(void) : fence(0), frameIndex(0) {}
+
+      GLsync fence;
+      uint frameIndex;
+      std::vector<SScope> scopes;
+    };
+
+    struct SScopeStats {
+      SScopeStats(void) : next(0), count(0), lastNS(0) {}
+
+      std::string name;
+      std::vector<GLuint64> samples;  // Ring of STATS_WINDOW_SIZE samples
+      uint next;
+      uint count;
+      GLuint64 lastNS;
+    };
+
+    void createQueries();
+    void resolveFrame(const uint slot);
+    inline GLuint getQuery(const uint slot, const uint scope,
+                           const bool end) const {
+      return _queries[(slot * MAX_SCOPES_PER_FRAME + scope) * 2
+                      + (end ? 1 : 0)];
+    }
+
+    bool _enabled;
+    bool _overflowWarned;
+    uint _frameIndex;
+    uint _numDroppedFrames;
+    std::vector<GLuint> _queries;  // slot || scope || start/end
+    SFrame _frames[FRAMES_IN_FLIGHT];
+    std::vector<SScopeStats> _stats;
+    std::unordered_map<std::string, uint> _statsIndices;
+    std::vector<SDurationResult> _lastResults;
   };
 }
 
-#endif
\ No newline at end of file
+#endif  // GPUTIMER_H_
@@ -0,0 +1,224 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_HANDLETABLE_H_
+#define KORE_SRC_KORE_HANDLETABLE_H_
+
+#include <vector>
+#include <unordered_map>
+#include "KoRE/Common.h"
+
+namespace kore {
+  /*! \brief A generational handle into a HandleTable. The index addresses a
+  *          slot, the generation is bumped every time the slot is freed, so
+  *          handles to removed resources can be detected as stale.
+  *          A generation of 0 is never handed out and marks an invalid handle.
+  */
+  struct ResourceHandle {
+    ResourceHandle(void)
+      : index(KORE_UINT_INVALID),
+        generation(0) {
+    }
+
+    ResourceHandle(const uint idx, const uint gen)
+      : index(idx),
+        generation(gen) {
+    }
+
+    bool operator==(const ResourceHandle& other) const {
+      return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const ResourceHandle& other) const {
+      return !(*this == other);
+    }
+
+    uint index;
+    uint generation;
+  };
+
+  /*! \brief Slot-array storage for resources.
+  *   Resource pointers are kept densely packed in one vector so iterating
+  *   over all resources touches contiguous memory. Slots map handles to
+  *   positions in the dense array and are recycled through a free list.
+  *   The uint64-IDs of BaseResource are mapped to handles to support the
+  *   ID-based API of the ResourceManager.
+  *   The table never deletes the stored resources - that is up to the owner.
+  */
+  template <typename T>
+  class HandleTable {
+  public:
+    HandleTable(void) {}
+    ~HandleTable(void) {}
+
+    /*! \brief Inserts a resource and returns its new handle.
+    *   \return The handle of the resource or an invalid handle, if a
+    *           resource with the same id is already in the table. */
+    ResourceHandle insert(const uint64 id, T* resource) {
+      if (_idToHandle.find(id) != _idToHandle.end()) {
+        return ResourceHandle();
+      }
+
+      uint slotIdx;
+      if (!_freeSlots.empty()) {
+        slotIdx = _freeSlots.back();
+        _freeSlots.pop_back();
+      } else {
+        slotIdx = static_cast<uint>(_slots.size());
+        _slots.push_back(SSlot());
+      }
+
+      SSlot& slot = _slots[slotIdx];
+      slot.denseIndex = static_cast<uint>(_dense.size());
+      _dense.push_back(resource);
+      _denseSlots.push_back(slotIdx);
+      _denseIDs.push_back(id);
+
+      ResourceHandle handle(slotIdx, slot.generation);
+      _idToHandle[id] = handle;
+      return handle;
+    }
+
+    /*! \brief Returns true if the handle refers to a live resource. */
+    inline bool isValid(const ResourceHandle& handle) const {
+      return handle.generation != 0
+          && handle.index < _slots.size()
+          && _slots[handle.index].generation == handle.generation
+          && _slots[handle.index].denseIndex != KORE_UINT_INVALID;
+    }
+
+    /*! \brief Retrieve a resource from its handle.
+    *   \return The resource or NULL if the handle is stale or invalid. */
+    inline T* get(const ResourceHandle& handle) const {
+      if (!isValid(handle)) {
+        return NULL;
+      }
+      return _dense[_slots[handle.index].denseIndex];
+    }
+
+    /*! \brief Returns the handle for a resource id or an invalid handle. */
+    ResourceHandle getHandle(const uint64 id) const {
+      auto it = _idToHandle.find(id);
+      if (it == _idToHandle.end()) {
+        return ResourceHandle();
+      }
+      return it->second;
+    }
+
+    /*! \brief Retrieve a resource from its id or NULL. */
+    inline T* getByID(const uint64 id) const {
+      return get(getHandle(id));
+    }
+
+    inline bool contains(const uint64 id) const {
+      return _idToHandle.find(id) != _idToHandle.end();
+    }
+
+    /*! \brief Removes a resource from the table. The last resource is moved
+    *          into the freed position so the storage stays dense.
+    *          The generation of the slot is increased, which invalidates
+    *          all outstanding handles to the removed resource.
+    *   \return The removed resource or NULL if the handle was stale. */
+    T* remove(const ResourceHandle& handle) {
+      if (!isValid(handle)) {
+        return NULL;
+      }
+
+      SSlot& slot = _slots[handle.index];
+      const uint denseIdx = slot.denseIndex;
+      const uint lastIdx = static_cast<uint>(_dense.size()) - 1;
+      T* resource = _dense[denseIdx];
+      _idToHandle.erase(_denseIDs[denseIdx]);
+
+      if (denseIdx != lastIdx) {
+        _dense[denseIdx] = _dense[lastIdx];
+        _denseSlots[denseIdx] = _denseSlots[lastIdx];
+        _denseIDs[denseIdx] = _denseIDs[lastIdx];
+        _slots[_denseSlots[denseIdx]].denseIndex = denseIdx;
+      }
+      _dense.pop_back();
+      _denseSlots.pop_back();
+      _denseIDs.pop_back();
+
+      slot.denseIndex = KORE_UINT_INVALID;
+      if (++slot.generation == 0) {
+        slot.generation = 1;
+      }
+      _freeSlots.push_back(handle.index);
+      return resource;
+    }
+
+    inline T* removeByID(const uint64 id) {
+      return remove(getHandle(id));
+    }
+
+    /*! \brief Returns the densely packed list of all resources.
+    *          The order changes when resources are removed. */
+    inline const std::vector<T*>& getResources(void) const {
+      return _dense;
+    }
+
+    inline uint size(void) const {
+      return static_cast<uint>(_dense.size());
+    }
+
+    /*! \brief Returns the resource at a position in the dense storage. */
+    inline T* at(const uint denseIdx) const {
+      if (denseIdx >= _dense.size()) {
+        return NULL;
+      }
+      return _dense[denseIdx];
+    }
+
+    /*! \brief Removes all entries. Live handles become stale. */
+    void clear(void) {
+      for (uint i = 0; i < _denseSlots.size(); ++i) {
+        SSlot& slot = _slots[_denseSlots[i]];
+        slot.denseIndex = KORE_UINT_INVALID;
+        if (++slot.generation == 0) {
+          slot.generation = 1;
+        }
+        _freeSlots.push_back(_denseSlots[i]);
+      }
+      _dense.clear();
+      _denseSlots.clear();
+      _denseIDs.clear();
+      _idToHandle.clear();
+    }
+
+  private:
+    struct SSlot {
+      SSlot(void)
+        : generation(1),
+          denseIndex(KORE_UINT_INVALID) {
+      }
+
+      uint generation;
+      uint denseIndex;
+    };
+
+    std::vector<T*> _dense;
+    std::vector<uint> _denseSlots;  // dense index || slot index
+    std::vector<uint64> _denseIDs;  // dense index || resource id
+    std::vector<SSlot> _slots;
+    std::vector<uint> _freeSlots;
+    std::unordered_map<uint64, ResourceHandle> _idToHandle;
+  };
+};
+#endif  // KORE_SRC_KORE_HANDLETABLE_H_
@@ -46,8 +46,8 @@ const uint64 kore::IDManager::getID(const std::string& url) const {
 
 void kore::IDManager::registerURL(uint64 id, const std::string& url) {
   if (_mapURL.find(id) != _mapURL.end()) {
-    Log::getInstance()->write("[WARNING] The ID %i already has an URL"
-                              " registered: %s", id, url.c_str());
+    KORE_LOG_WARNING(LOG_CATEGORY_SCENE, "The ID %i already has an URL"
+                     " registered: %s", id, url.c_str());
     return;
   }
   _mapURL[id] = url;
@@ -21,6 +21,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Log.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/ResourceManager.h"
 
 kore::IndexedBuffer::IndexedBuffer()
   : _name("UNNAMED"),
@@ -44,6 +45,13 @@ bool kore::IndexedBuffer::create(GLuint bufferTarget,
     destroy();
   }
 
+  if (!ResourceManager::getInstance()->getGPUMemoryTracker()
+      .allocate(getID(), GPUMEM_BUFFER, name, sizeInBytes)) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "IndexedBuffer '%s' exceeds the GPU "
+                   "memory budget\n", name.c_str());
+    return false;
+  }
+
   RenderManager* renderMgr = RenderManager::getInstance();
 
   GLerror::gl_ErrorCheckStart();
@@ -53,7 +61,7 @@ bool kore::IndexedBuffer::create(GLuint bufferTarget,
   bool success = GLerror::gl_ErrorCheckFinish("IndexedBuffer::create");
 
   if (!success) {
-    Log::getInstance()->write("[ERROR] IndexedBuffer creation failed");
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "IndexedBuffer creation failed");
     destroy();
     return false;
   }
@@ -71,8 +79,8 @@ bool kore::IndexedBuffer::uploadData(uint offset,
                                      uint sizeInBytes,
                                      GLvoid* data) {
   if (_handle == KORE_GLUINT_HANDLE_INVALID) {
-    Log::getInstance()->write("[ERROR] Use IndexedBuffer::create"
-                              " before trying to upload data");
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Use IndexedBuffer::create"
+                   " before trying to upload data");
     return false;
   }
 
@@ -83,7 +91,7 @@ bool kore::IndexedBuffer::uploadData(uint offset,
   bool success = GLerror::gl_ErrorCheckFinish("IndexedBuffer::uploadData");
 
   if (!success) {
-    Log::getInstance()->write("[ERROR] Failed to upload buffer Data");
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Failed to upload buffer Data");
     return false;
   }
 
@@ -91,6 +99,7 @@ bool kore::IndexedBuffer::uploadData(uint offset,
 }
 
 void kore::IndexedBuffer::destroy() {
+  ResourceManager::getInstance()->getGPUMemoryTracker().release(getID());
   glDeleteBuffers(1, &_handle);
   _handle = KORE_GLUINT_HANDLE_INVALID;
   _bufferTarget = KORE_GLUINT_HANDLE_INVALID;
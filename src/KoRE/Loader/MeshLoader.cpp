@@ -32,7 +32,8 @@ kore::MeshLoader* kore::MeshLoader::getInstance() {
   return &clInstance;
 }
 
-kore::MeshLoader::MeshLoader() {
+kore::MeshLoader::MeshLoader()
+  : _retainPositions(false) {
 }
 
 kore::MeshLoader::~MeshLoader() {
@@ -82,7 +83,16 @@ kore::Mesh*
         loadFaceIndices(pAiMesh, pMesh);
     }
 
-    pMesh->createAttributeBuffers(BUFFERTYPE_INTERLEAVED);
+    // Needs the vertex data, which is freed when the buffers are created.
+    pMesh->computeBounds();
+    if (_retainPositions) {
+      pMesh->retainPositions();
+    }
+    if (!pMesh->createAttributeBuffers(BUFFERTYPE_INTERLEAVED)) {
+      KORE_LOG_ERROR(LOG_CATEGORY_LOADER, "Mesh '%s' could not be loaded\n",
+                     pMesh->getName().c_str());
+      KORE_SAFE_DELETE(pMesh);
+    }
     return pMesh;
 }
 
@@ -220,9 +230,9 @@ void kore::MeshLoader::
     } else if (pAiMesh->GetNumColorChannels() == 4) {
         att.type = GL_FLOAT_VEC4;
     } else {
-        Log::getInstance()->write("[WARNING] Mesh %s has an"
-                                  "unsupported number of color channels: %i",
-                                  pMesh->getName().c_str());
+        KORE_LOG_WARNING(LOG_CATEGORY_LOADER, "Mesh %s has an"
+                         "unsupported number of color channels: %i",
+                         pMesh->getName().c_str());
         free(pVertexData);
         return;
     }
@@ -257,9 +267,9 @@ void kore::MeshLoader::
   } else if (pAiMesh->GetNumUVChannels() == 3) {
       att.type = GL_FLOAT_VEC3;
   } else {
-    Log::getInstance()->write("[WARNING] Mesh %s has an unsupported"
-                              "number of UV channels: %i",
-                              pMesh->getName().c_str());
+    KORE_LOG_WARNING(LOG_CATEGORY_LOADER, "Mesh %s has an unsupported"
+                     "number of UV channels: %i",
+                     pMesh->getName().c_str());
     free(pVertexData);
     return;
   }*/
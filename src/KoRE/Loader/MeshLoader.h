@@ -52,6 +52,11 @@ namespace kore {
     std::string getCameraName(const aiCamera* paiCamera,
                               const uint uSceneCameraIdx);
 
+    /// If set, loaded meshes keep a CPU copy of their positions
+    inline void setRetainPositions(const bool retain)
+      {_retainPositions = retain;}
+    inline bool getRetainPositions() const {return _retainPositions;}
+
   private:
     MeshLoader();
 
@@ -77,6 +82,7 @@ namespace kore {
 
     glm::mat4 glmMatFromAiMat(const aiMatrix4x4& aiMat);
     Assimp::Importer _aiImporter;
+    bool _retainPositions;
   };
 };
 #endif  // CORE_INCLUDE_CORE_MESHLOADER_H_
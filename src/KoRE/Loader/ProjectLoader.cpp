@@ -17,7 +17,7 @@ kore::ProjectLoader* kore::ProjectLoader::getInstance() {
 }
 
 void kore::ProjectLoader::loadProject(const std::string& path) {
-  kore::Log::getInstance()->write("[Debug] Loading '%s'\n", path.c_str());
+  KORE_LOG_DEBUG(LOG_CATEGORY_LOADER, "Loading '%s'\n", path.c_str());
   // loading resources
   // loading scenegraph
   // loading renderflow
@@ -42,12 +42,11 @@ void kore::ProjectLoader::saveProject(const std::string& path) {
 
   // Textures
   TiXmlElement* texture;
-  for(auto texIt = ResMgr->_textures.begin();
-      texIt != ResMgr->_textures.end();
-      texIt++) {
+  const std::vector<Texture*>& textures = ResMgr->_textures.getResources();
+  for(uint i = 0; i < textures.size(); ++i) {
     texture = new TiXmlElement("Texture");
-    STextureProperties prop = texIt->second->getProperties();
-    texture->SetAttribute("name", texIt->second->getName().c_str());
+    STextureProperties prop = textures[i]->getProperties();
+    texture->SetAttribute("name", textures[i]->getName().c_str());
     texture->SetAttribute("width", prop.width);
     texture->SetAttribute("height", prop.height);
     resources->LinkEndChild(texture);
@@ -63,11 +62,11 @@ void kore::ProjectLoader::saveProject(const std::string& path) {
 
   // finally, save to file
   if(doc.SaveFile(path.c_str())) {
-    kore::Log::getInstance()->write("[DEBUG] writing file '%s'\n",
-                                    path.c_str());
+    KORE_LOG_DEBUG(LOG_CATEGORY_LOADER, "writing file '%s'\n",
+                   path.c_str());
   } else {
-    kore::Log::getInstance()->write("[ERROR] could not write file '%s'\n",
-                                    path.c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_LOADER, "could not write file '%s'\n",
+                   path.c_str());
   }
 
   // TODO(dospelt) runtime error when deleting created pointers.
@@ -58,8 +58,8 @@ const aiScene* kore::SceneLoader::readScene(const std::string& szScenePath) {
     );
 
   if (!pAiScene) {
-    Log::getInstance()->write("[ERROR] Scene '%s' could not be read\n%s\n",
-                              szScenePath.c_str(), _aiImporter.GetErrorString());
+    KORE_LOG_ERROR(LOG_CATEGORY_LOADER, "Scene '%s' could not be read\n%s\n",
+                   szScenePath.c_str(), _aiImporter.GetErrorString());
     return NULL;
   }
 
@@ -80,15 +80,14 @@ void kore::SceneLoader::loadScene(const std::string& szScenePath,
   loadResources(szScenePath, pAiScene);
   loadSceneGraph(pAiScene->mRootNode, parent, pAiScene, szScenePath);
 
-  Log::getInstance()
-    ->write("[DEBUG] Scene '%s' successfully loaded:\n"
-            "\t %i meshes\n"
-            "\t %i cameras\n"
-            "\t %i nodes\n",
-            szScenePath.c_str(),
-            _meshcount,
-            _cameracount,
-            _nodecount);
+  KORE_LOG_DEBUG(LOG_CATEGORY_LOADER, "Scene '%s' successfully loaded:\n"
+                 "\t %i meshes\n"
+                 "\t %i cameras\n"
+                 "\t %i nodes\n",
+                 szScenePath.c_str(),
+                 _meshcount,
+                 _cameracount,
+                 _nodecount);
 }
 
 void kore::SceneLoader::loadResources(const std::string& szScenePath,
@@ -105,6 +104,9 @@ void kore::SceneLoader::loadResources(const std::string& szScenePath,
     for (uint i = 0; i < pAiScene->mNumMeshes; ++i) {
       aiMesh* aiMesh = pAiScene->mMeshes[i];
       Mesh* mesh  = MeshLoader::getInstance()->loadMesh(pAiScene,i);
+      if (mesh == NULL) {
+        continue;
+      }
       std::string meshURL = idMgr->genURL(meshName(aiMesh), szScenePath, i);
       idMgr->registerURL(mesh->getID(), meshURL);
       resMgr->addMesh(mesh);
@@ -190,10 +192,8 @@ void kore::SceneLoader::loadSceneGraph(const aiNode* ainode,
 
     SceneNode* node = new SceneNode;
     node->getTransform()->setLocal(glmMatFromAiMat(ainode->mTransformation));
-    node->_parent = parentNode;
-    node->_dirty = true;
-    node->_name = ainode->mName.C_Str();
-    parentNode->_children.push_back(node);
+    node->setName(ainode->mName.C_Str());
+    parentNode->addChild(node);
     _nodecount++;
 
     // Load light if this node has one
@@ -253,43 +253,40 @@ void kore::SceneLoader::loadSceneGraph(const aiNode* ainode,
                                           ainode->mMeshes[0]);
       uint64 meshID = idMgr->getID(meshURL);
       
+      // Meshes that failed to load are skipped.
       Mesh* mesh = resMgr->getMesh(meshID);
-      MeshComponent* meshComponent = new MeshComponent;
-      meshComponent->setMesh(mesh);
-      node->addComponent(meshComponent);
+      if (mesh != NULL) {
+        MeshComponent* meshComponent = new MeshComponent;
+        meshComponent->setMesh(mesh);
+        node->addComponent(meshComponent);
 
-      // Look up Material in the resourceManager and add it to a new
-      // MaterialComponent
-      MaterialComponent* materialComponent = new MaterialComponent;
+        // Look up Material in the resourceManager and add it to a new
+        // MaterialComponent
+        MaterialComponent* materialComponent = new MaterialComponent;
 
-      std::string matURL =
-        idMgr->genURL(materialName(), szScenePath, aimesh->mMaterialIndex);
-      uint64 matID = idMgr->getID(matURL);
+        std::string matURL =
+          idMgr->genURL(materialName(), szScenePath, aimesh->mMaterialIndex);
+        uint64 matID = idMgr->getID(matURL);
 
-      Material* mat = resMgr->getMaterial(matID);
-      materialComponent->setMaterial(mat);
+        Material* mat = resMgr->getMaterial(matID);
+        materialComponent->setMaterial(mat);
 
-      node->addComponent(materialComponent);
+        node->addComponent(materialComponent);
 
-      // Generate a TexturesComponent from all loaded textures defined in the
-      // material.
-      TexturesComponent* texComponent =
-        genTexComponentFromTextures(aiscene->mMaterials[aimesh->mMaterialIndex]);
+        // Generate a TexturesComponent from all loaded textures defined in the
+        // material.
+        TexturesComponent* texComponent =
+          genTexComponentFromTextures(aiscene->mMaterials[aimesh->mMaterialIndex]);
 
 
-      // If there are textures, the texComponent is valid (non-NULL).
-      if (texComponent != NULL) {
-        node->addComponent(texComponent);
+        // If there are textures, the texComponent is valid (non-NULL).
+        if (texComponent != NULL) {
+          node->addComponent(texComponent);
+        }
       }
 
     // Make additional copies for any more meshes
     for (uint iMesh = 1; iMesh < ainode->mNumMeshes; ++iMesh) {
-      SceneNode* copyNode = new SceneNode;
-      copyNode->_transform->setLocal(glmMatFromAiMat(ainode->mTransformation));
-      copyNode->_parent = parentNode;
-      copyNode->_dirty = true;
-      parentNode->_children.push_back(copyNode);
-      
       const aiMesh* aimesh = aiscene->mMeshes[ainode->mMeshes[iMesh]];
       std::string meshURL = idMgr->genURL(meshName(aimesh),
                                           szScenePath,
@@ -297,6 +294,13 @@ void kore::SceneLoader::loadSceneGraph(const aiNode* ainode,
       uint64 meshID = idMgr->getID(meshURL);
 
       Mesh* mesh = resMgr->getMesh(meshID);
+      if (mesh == NULL) {
+        continue;
+      }
+
+      SceneNode* copyNode = new SceneNode;
+      copyNode->_transform->setLocal(glmMatFromAiMat(ainode->mTransformation));
+      parentNode->addChild(copyNode);
 
       MeshComponent* meshComponent = new MeshComponent;
       meshComponent->setMesh(mesh);
@@ -562,7 +566,9 @@ kore::ETextureSemantics
         case (aiTextureType_UNKNOWN       ):
           return TEXSEMANTICS_UNKNOWN;
         default: 
-          Log::getInstance()->write("[WARNING] (SceneLoader) aiTextureType not implemented in KoRE!\n");
+          KORE_LOG_WARNING(LOG_CATEGORY_LOADER,
+                           "(SceneLoader) aiTextureType not implemented "
+                           "in KoRE!\n");
           return TEXSEMANTICS_UNKNOWN;
     }
 }
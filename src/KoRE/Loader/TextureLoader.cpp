@@ -58,10 +58,10 @@ kore::Texture*
   uint err = lodepng::decode(imageData, width, height, pngState, buffer);
 
   if ( err != 0) {
-    kore::Log::getInstance()->write("[ERROR] Failed to load texture '%s' :\n"
-                                    "\t%s\n",
-                                    loadFilePath.c_str(),
-                                    lodepng_error_text(err));
+    KORE_LOG_ERROR(LOG_CATEGORY_LOADER, "Failed to load texture '%s' :\n"
+                   "\t%s\n",
+                   loadFilePath.c_str(),
+                   lodepng_error_text(err));
     return NULL;
   } else {
     kore::Texture* tex = new Texture();
@@ -90,15 +90,13 @@ kore::Texture*
       ResourceManager::getInstance()->addTexture(tex);
       std::string url = IDManager::getInstance()->genURL("", filepath, 0);
       IDManager::getInstance()->registerURL(tex->getID(), url);
-      kore::Log::getInstance()
-        ->write("[DEBUG] Texture '%s' successfully loaded.\n",
-        filepath.c_str());
+      KORE_LOG_DEBUG(LOG_CATEGORY_LOADER, "Texture '%s' successfully loaded.\n",
+                     filepath.c_str());
       tex->genMipmapHierarchy();
       return tex;
     } else {
-      kore::Log::getInstance()
-        ->write("[ERROR] Texture '%s' could not be loaded.\n",
-        filepath.c_str());
+      KORE_LOG_ERROR(LOG_CATEGORY_LOADER, "Texture '%s' could not be loaded.\n",
+                     filepath.c_str());
       KORE_SAFE_DELETE(tex);
       return NULL;
     }
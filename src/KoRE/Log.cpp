@@ -23,7 +23,9 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include <time.h>
+#include <chrono>
 #include <string>
 
 #include "KoRE/Log.h"
@@ -33,7 +35,21 @@ kore::Log* kore::Log::getInstance(void) {
   return &theInstance;
 }
 
-kore::Log::Log(void) {
+kore::Log::Log(void)
+  : _enqueuePos(0),
+    _dequeuePos(0),
+    _numDroppedReported(0),
+    _numDropped(0),
+    _numWritten(0),
+    _numEnqueued(0),
+    _minLevel(LOG_DEBUG),
+    _categoryMask(0xFFFFFFFF),
+    _running(true),
+    _urgent(false) {
+  for (unsigned int i = 0; i < RING_SIZE; ++i) {
+    _ring[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
   _logname = "KoRE_Log.txt";
   FILE* pfile = fopen(_logname.c_str(), "w");
   if (pfile!= 0) {
@@ -42,33 +58,217 @@ kore::Log::Log(void) {
     fprintf(pfile, "KoRE Log - %s\n", ctime(&rawtime));
     fclose(pfile);
   }
+
+  _flushThread = std::thread(&kore::Log::flushThreadMain, this);
 }
 
 kore::Log::~Log(void) {
-  FILE* pfile = fopen(_logname.c_str(), "a");
-  if (pfile!= 0) {
-    fprintf(pfile, "%s\n", "\nEnd of Log");
-    fclose(pfile);
+  _running = false;
+  _wakeCondition.notify_one();
+  if (_flushThread.joinable()) {
+    _flushThread.join();
+  }
+}
+
+const char* kore::Log::getLevelName(const ELogLevel level) {
+  switch (level) {
+    case LOG_DEBUG: return "DEBUG";
+    case LOG_INFO: return "INFO";
+    case LOG_WARNING: return "WARNING";
+    case LOG_ERROR: return "ERROR";
+    default: return "UNKNOWN";
+  }
+}
+
+const char* kore::Log::getCategoryName(const ELogCategory category) {
+  switch (category) {
+    case LOG_CATEGORY_CORE: return "Core";
+    case LOG_CATEGORY_RENDER: return "Render";
+    case LOG_CATEGORY_GL: return "GL";
+    case LOG_CATEGORY_SHADER: return "Shader";
+    case LOG_CATEGORY_RESOURCE: return "Resource";
+    case LOG_CATEGORY_LOADER: return "Loader";
+    case LOG_CATEGORY_SCENE: return "Scene";
+    default: return "Unknown";
+  }
+}
+
+void kore::Log::setCategoryEnabled(const ELogCategory category,
+                                   const bool enabled) {
+  if (enabled) {
+    _categoryMask.fetch_or(1u << category);
+  } else {
+    _categoryMask.fetch_and(~(1u << category));
   }
 }
 
 void kore::Log::write(const char* format, ...) {
+  // Derive the level from the prefix of the untagged messages,
+  // e.g. "[ERROR]", "[GL-ERROR]" or "[WARNING]".
+  ELogLevel level = LOG_INFO;
+  if (format[0] == '[') {
+    const char* end = strchr(format, ']');
+    if (end != NULL) {
+      std::string tag(format, end - format);
+      if (tag.find("ERROR") != std::string::npos) {
+        level = LOG_ERROR;
+      } else if (tag.find("WARNING") != std::string::npos) {
+        level = LOG_WARNING;
+      } else if (tag.find("DEBUG") != std::string::npos) {
+        level = LOG_DEBUG;
+      }
+    }
+  }
+
+  if (!isEnabled(level, LOG_CATEGORY_CORE)) {
+    return;
+  }
+
   va_list args;
-  FILE* pfile = fopen(_logname.c_str(), "a");
-  if (pfile!= 0) {
-      va_start(args, format);
-      vfprintf(pfile, format, args);
-      va_end(args);
-      fclose(pfile);
+  va_start(args, format);
+  enqueue(level, LOG_CATEGORY_CORE, false, format, args);
+  va_end(args);
+}
+
+void kore::Log::write(const ELogLevel level, const ELogCategory category,
+                      const char* format, ...) {
+  if (!isEnabled(level, category)) {
+    return;
   }
 
-#if defined WIN32 || defined WIN64
-  // Also print to VisualStudio-console
-  char szBuf[ 100000 ];
+  va_list args;
   va_start(args, format);
-  vsprintf(szBuf, format, args);
+  enqueue(level, category, true, format, args);
   va_end(args);
+}
+
+void kore::Log::enqueue(const ELogLevel level, const ELogCategory category,
+                        const bool tagged, const char* format,
+                        va_list args) {
+  // Claim a slot. A slot is free for position pos if its sequence equals
+  // pos, it holds a message once the sequence is pos + 1.
+  unsigned int pos = _enqueuePos.load(std::memory_order_relaxed);
+  SLogEntry* entry = NULL;
+  while (true) {
+    entry = &_ring[pos & (RING_SIZE - 1)];
+    const unsigned int seq = entry->sequence.load(std::memory_order_acquire);
+    const int diff = static_cast<int>(seq - pos);
+    if (diff == 0) {
+      if (_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The ring is full. Logging must never stall the calling thread, so
+      // the message is dropped whatever its level. The flush thread is
+      // woken to make room for the next ones.
+      _numDropped.fetch_add(1, std::memory_order_relaxed);
+      _urgent = true;
+      _wakeCondition.notify_one();
+      return;
+    } else {
+      pos = _enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
 
-  OutputDebugStringA(szBuf);
+  int length = 0;
+  if (tagged) {
+    length = snprintf(entry->text, MAX_MESSAGE_LENGTH, "[%s][%s] ",
+                      getLevelName(level), getCategoryName(category));
+  }
+  const int written = vsnprintf(entry->text + length,
+                                MAX_MESSAGE_LENGTH - length, format, args);
+  if (written < 0 || length + written >= static_cast<int>(MAX_MESSAGE_LENGTH)) {
+    // Truncated - keep the line break so the next message starts cleanly.
+    entry->text[MAX_MESSAGE_LENGTH - 2] = '\n';
+    entry->text[MAX_MESSAGE_LENGTH - 1] = '\0';
+  }
+
+  entry->sequence.store(pos + 1, std::memory_order_release);
+  _numEnqueued.fetch_add(1, std::memory_order_release);
+
+  if (level >= LOG_ERROR || (pos & (RING_SIZE / 4 - 1)) == 0) {
+    // Get errors to the file quickly in case the application crashes and
+    // wake the flush thread early during bursts, before the ring fills up.
+    _urgent = true;
+    _wakeCondition.notify_one();
+  }
+}
+
+bool kore::Log::drain(FILE* pfile) {
+  bool wroteAny = false;
+  while (true) {
+    SLogEntry& entry = _ring[_dequeuePos & (RING_SIZE - 1)];
+    const unsigned int seq = entry.sequence.load(std::memory_order_acquire);
+    if (seq != _dequeuePos + 1) {
+      break;
+    }
+
+    if (pfile != 0) {
+      fputs(entry.text, pfile);
+    }
+#if defined WIN32 || defined WIN64
+    // Also print to VisualStudio-console
+    OutputDebugStringA(entry.text);
 #endif
+
+    entry.sequence.store(_dequeuePos + RING_SIZE, std::memory_order_release);
+    ++_dequeuePos;
+    _numWritten.fetch_add(1, std::memory_order_release);
+    wroteAny = true;
+  }
+
+  const unsigned int numDropped = _numDropped.load(std::memory_order_relaxed);
+  if (numDropped != _numDroppedReported) {
+    char text[128];
+    snprintf(text, sizeof(text), "[WARNING] Log: %u messages were dropped "
+             "because the log ring was full\n",
+             numDropped - _numDroppedReported);
+    _numDroppedReported = numDropped;
+    if (pfile != 0) {
+      fputs(text, pfile);
+    }
+#if defined WIN32 || defined WIN64
+    OutputDebugStringA(text);
+#endif
+    wroteAny = true;
+  }
+
+  if (wroteAny && pfile != 0) {
+    fflush(pfile);
+  }
+  return wroteAny;
+}
+
+void kore::Log::flushThreadMain(void) {
+  FILE* pfile = fopen(_logname.c_str(), "a");
+
+  while (_running) {
+    drain(pfile);
+    _flushedCondition.notify_all();
+
+    std::unique_lock<std::mutex> lock(_wakeMutex);
+    _wakeCondition.wait_for(lock, std::chrono::milliseconds(10),
+                            [this] {return _urgent || !_running;});
+    _urgent = false;
+  }
+
+  drain(pfile);
+  _flushedCondition.notify_all();
+
+  if (pfile!= 0) {
+    fprintf(pfile, "%s\n", "\nEnd of Log");
+    fclose(pfile);
+  }
+}
+
+void kore::Log::flush(void) {
+  const unsigned int target = _numEnqueued.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(_wakeMutex);
+  while (_running
+         && _numWritten.load(std::memory_order_acquire) < target) {
+    _urgent = true;
+    _wakeCondition.notify_one();
+    _flushedCondition.wait_for(lock, std::chrono::milliseconds(10));
+  }
 }
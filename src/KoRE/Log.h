@@ -20,18 +20,147 @@
 #ifndef CORE_INCLUDE_CORE_LOG_H_
 #define CORE_INCLUDE_CORE_LOG_H_
 
+#include <stdio.h>
+#include <stdarg.h>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace kore {
+  enum ELogLevel {
+    LOG_DEBUG = 0,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+
+    NUM_LOG_LEVELS
+  };
+
+  enum ELogCategory {
+    LOG_CATEGORY_CORE = 0,
+    LOG_CATEGORY_RENDER,
+    LOG_CATEGORY_GL,
+    LOG_CATEGORY_SHADER,
+    LOG_CATEGORY_RESOURCE,
+    LOG_CATEGORY_LOADER,
+    LOG_CATEGORY_SCENE,
+
+    NUM_LOG_CATEGORIES
+  };
+
+  /*! \brief Asynchronous logger.
+  *   Messages are formatted by the calling thread directly into a slot of a
+  *   fixed-size lock-free ring buffer (multiple producers, single consumer).
+  *   A background thread drains the ring and writes the messages to the
+  *   log file and, on Windows, to the debugger console.
+  *   If the ring is full, messages of every level are dropped and counted,
+  *   so logging never blocks the caller. The number of dropped messages is
+  *   written to the log with the next flush.
+  *   Messages longer than MAX_MESSAGE_LENGTH are truncated.
+  */
   class Log {
   public:
+    static const unsigned int RING_SIZE = 2048;  // Has to be a power of two
+    static const unsigned int MAX_MESSAGE_LENGTH = 512;
+
     static Log *getInstance(void);
-    /// write to file and/or console
+
+    /// write to file and/or console.
+    /// The level is taken from a "[ERROR]" or "[WARNING]" prefix,
+    /// otherwise it is LOG_INFO.
     void write(const char* format, ...);
+
+    /// write a message with a level and a category.
+    void write(const ELogLevel level, const ELogCategory category,
+               const char* format, ...);
+
+    /*! \brief Returns true if messages of the level and category would be
+    *          written. Use this to skip the formatting of arguments. */
+    inline bool isEnabled(const ELogLevel level,
+                          const ELogCategory category) const {
+      return level >= _minLevel.load(std::memory_order_relaxed)
+          && (_categoryMask.load(std::memory_order_relaxed)
+              & (1u << category)) != 0;
+    }
+
+    inline void setMinLevel(const ELogLevel level) {_minLevel = level;}
+    inline ELogLevel getMinLevel(void) const {
+      return static_cast<ELogLevel>(_minLevel.load());
+    }
+
+    void setCategoryEnabled(const ELogCategory category, const bool enabled);
+
+    /*! \brief Blocks until all queued messages have been written.
+    *          Don't call this from the render loop. */
+    void flush(void);
+
+    /// Returns the number of messages dropped because the ring was full.
+    inline unsigned int getNumDroppedMessages(void) const {
+      return _numDropped.load(std::memory_order_relaxed);
+    }
+
+    static const char* getLevelName(const ELogLevel level);
+    static const char* getCategoryName(const ELogCategory category);
+
   private:
     Log(void);
     virtual ~Log(void);
+
+    struct SLogEntry {
+      std::atomic<unsigned int> sequence;
+      char text[MAX_MESSAGE_LENGTH];
+    };
+
+    void enqueue(const ELogLevel level, const ELogCategory category,
+                 const bool tagged, const char* format, va_list args);
+    void flushThreadMain(void);
+    bool drain(FILE* pfile);
+
     std::string _logname;
+    SLogEntry _ring[RING_SIZE];
+    std::atomic<unsigned int> _enqueuePos;
+    unsigned int _dequeuePos;  // Only touched by the flush thread
+    unsigned int _numDroppedReported;  // Only touched by the flush thread
+    std::atomic<unsigned int> _numDropped;
+    std::atomic<unsigned int> _numWritten;
+    std::atomic<unsigned int> _numEnqueued;
+    std::atomic<int> _minLevel;
+    std::atomic<unsigned int> _categoryMask;
+
+    std::atomic<bool> _running;
+    std::atomic<bool> _urgent;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _flushedCondition;
+    std::thread _flushThread;
   };
 };
+
+/*! \brief Logging macros. The arguments aren't evaluated if the level or
+*          category is disabled. KORE_LOG_DEBUG is compiled out in release
+*          builds unless KORE_LOG_ENABLE_DEBUG is defined. */
+#define KORE_LOG(level, category, ...)                                      \
+  do {                                                                      \
+    kore::Log* kore_pLog_ = kore::Log::getInstance();                       \
+    if (kore_pLog_->isEnabled(level, category)) {                           \
+      kore_pLog_->write(level, category, __VA_ARGS__);                      \
+    }                                                                       \
+  } while (0)
+
+#if defined(NDEBUG) && !defined(KORE_LOG_ENABLE_DEBUG)
+#define KORE_LOG_DEBUG(category, ...) do {} while (0)
+#else
+#define KORE_LOG_DEBUG(category, ...) \
+  KORE_LOG(kore::LOG_DEBUG, category, __VA_ARGS__)
+#endif
+
+#define KORE_LOG_INFO(category, ...) \
+  KORE_LOG(kore::LOG_INFO, category, __VA_ARGS__)
+#define KORE_LOG_WARNING(category, ...) \
+  KORE_LOG(kore::LOG_WARNING, category, __VA_ARGS__)
+#define KORE_LOG_ERROR(category, ...) \
+  KORE_LOG(kore::LOG_ERROR, category, __VA_ARGS__)
+
 #endif  // CORE_INCLUDE_CORE_LOG_H_
@@ -25,6 +25,7 @@
 #include "KoRE/RenderManager.h"
 #include "KoRE/DataTypes.h"
 #include "KoRE/Log.h"
+#include "KoRE/GLerror.h"
 
 
 
@@ -38,6 +39,8 @@ kore::Mesh::Mesh(void)
 }
 
 kore::Mesh::~Mesh(void) {
+    ResourceManager::getInstance()->getGPUMemoryTracker().release(getID());
+
     if (_IBOloc != KORE_GLUINT_HANDLE_INVALID) {
       glDeleteBuffers(1, &_IBOloc);
     }
@@ -112,6 +115,15 @@ const std::string& kore::Mesh::getName() const {
     return _name;
 }
 
+void kore::Mesh::applyDebugLabel(void) const {
+  if (!GLerror::areDebugAnnotationsEnabled()) {
+    return;
+  }
+  GLerror::setObjectLabel(GL_VERTEX_ARRAY, _VAOloc, _name);
+  GLerror::setObjectLabel(GL_BUFFER, _VBOloc, _name + " VBO");
+  GLerror::setObjectLabel(GL_BUFFER, _IBOloc, _name + " IBO");
+}
+
 const GLenum kore::Mesh::getPrimitiveType() const {
     return _primitiveType;
 }
@@ -134,23 +146,63 @@ const kore::MeshAttributeArray* kore::Mesh::
         return NULL;
 }
 
-void kore::Mesh::
-createAttributeBuffers(const kore::EMeshBufferType bufferType) {
+void kore::Mesh::computeBounds(void) {
+  const MeshAttributeArray* positions = getAttributeByName("v_position");
+  if (!positions || !positions->data
+      || positions->componentType != GL_FLOAT
+      || positions->numComponents < 3) {
+    KORE_LOG_WARNING(LOG_CATEGORY_RESOURCE, "No bounds for Mesh %s: "
+                     "no position data available\n",
+                     _name.c_str());
+    return;
+  }
 
-  if (_attributes.size() == 0) {
-    Log::getInstance()->write("[ERROR] Can't create GL buffer objects for Mesh"
-                              "%s because it has no loaded attributes!",
-                              _name.c_str());
+  if (_VBOloc != KORE_GLUINT_HANDLE_INVALID) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Bounds of Mesh %s can't be computed"
+                   " after the buffers were created\n",
+                   _name.c_str());
     return;
   }
-  
-  RenderManager* renderer = RenderManager::getInstance();
-  glGenVertexArrays(1,&_VAOloc);
-  renderer->bindVAO(_VAOloc);
-  
 
-  GLuint uVBO;
-  glGenBuffers(1, &uVBO);
+  const float* data = static_cast<const float*>(positions->data);
+  const uint numPositions = positions->numValues / positions->numComponents;
+  _aabb = BoundingVolumeUtil::computeAABB(data, numPositions,
+                                          positions->numComponents);
+  _boundingSphere = BoundingVolumeUtil::computeSphere(data, numPositions,
+                                                      _aabb,
+                                                      positions->numComponents);
+}
+
+void kore::Mesh::retainPositions(void) {
+  const MeshAttributeArray* positions = getAttributeByName("v_position");
+  if (!positions || !positions->data
+      || positions->componentType != GL_FLOAT
+      || positions->numComponents < 3
+      || _VBOloc != KORE_GLUINT_HANDLE_INVALID) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Positions of Mesh %s can't be "
+                   "retained\n", _name.c_str());
+    return;
+  }
+
+  const float* data = static_cast<const float*>(positions->data);
+  const uint numPositions = positions->numValues / positions->numComponents;
+  _cpuPositions.resize(numPositions);
+  for (uint i = 0; i < numPositions; ++i) {
+    const float* p = data + i * positions->numComponents;
+    _cpuPositions[i] = glm::vec3(p[0], p[1], p[2]);
+  }
+}
+
+bool kore::Mesh::
+createAttributeBuffers(const kore::EMeshBufferType bufferType) {
+
+  if (_attributes.size() == 0) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   "Can't create GL buffer objects for Mesh"
+                   "%s because it has no loaded attributes!",
+                   _name.c_str());
+    return false;
+  }
 
   // Determine byte-size needed for the VBO
   uint uBufferSizeByte = 0;
@@ -160,6 +212,28 @@ createAttributeBuffers(const kore::EMeshBufferType bufferType) {
                       (rAttArray.numValues / rAttArray.numComponents);
   }
 
+  // Indices only take video memory if they are uploaded into an IBO.
+  const bool createIBO = _indices.size() > 0;
+  GLuint64 gpuBytes = static_cast<GLuint64>(uBufferSizeByte);
+  if (createIBO) {
+    gpuBytes += static_cast<GLuint64>(_indices.size()) * 4;
+  }
+
+  if (!ResourceManager::getInstance()->getGPUMemoryTracker()
+      .allocate(getID(), GPUMEM_MESH, _name, gpuBytes)) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Mesh %s exceeds the GPU memory "
+                   "budget!\n", _name.c_str());
+    return false;
+  }
+  
+  RenderManager* renderer = RenderManager::getInstance();
+  glGenVertexArrays(1,&_VAOloc);
+  renderer->bindVAO(_VAOloc);
+  
+
+  GLuint uVBO;
+  glGenBuffers(1, &uVBO);
+
   renderer->bindVBO(uVBO);
   glBufferData(GL_ARRAY_BUFFER,
               (uBufferSizeByte),
@@ -224,7 +298,7 @@ createAttributeBuffers(const kore::EMeshBufferType bufferType) {
   renderer->bindVBO(0);
 
   // Load indices into IBO
-  if (_indices.size() > 0) {
+  if (createIBO) {
     GLuint uIBO;
     glGenBuffers(1, &uIBO);
     renderer->bindIBO(uIBO);
@@ -238,4 +312,7 @@ createAttributeBuffers(const kore::EMeshBufferType bufferType) {
     _IBOloc = uIBO;
     renderer->bindIBO(0);
   }
+
+  applyDebugLabel();
+  return true;
 }
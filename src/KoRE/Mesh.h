@@ -24,6 +24,7 @@
 #include <vector>
 #include "KoRE/DataTypes.h"
 #include "KoRE/BaseResource.h"
+#include "KoRE/BoundingVolume.h"
 
 namespace kore {
   enum EMeshBufferType {
@@ -69,14 +70,39 @@ namespace kore {
     const kore::MeshAttributeArray*
       getAttributeByName(const std::string& szName) const;
 
-    void createAttributeBuffers(const EMeshBufferType bufferType);
+    /*! \brief Uploads the attributes and indices into GL buffers and frees
+    *          the CPU copies.
+    *   \return false if there are no attributes or the buffers exceed the
+    *           GPU memory budget (see GPUMemoryTracker). */
+    bool createAttributeBuffers(const EMeshBufferType bufferType);
+
+    /*! \brief Computes the bounding volumes from the "v_position"
+    *          attribute. Has to be called while the vertex data is still
+    *          on the CPU, i.e. before createAttributeBuffers(). */
+    void computeBounds(void);
+
+    /*! \brief Keeps a CPU copy of the "v_position" attribute, e.g. for
+    *          software occlusion culling. Has to be called before
+    *          createAttributeBuffers(). */
+    void retainPositions(void);
+
+    inline const std::vector<glm::vec3>& getCPUPositions() const
+      {return _cpuPositions;}
+
+    inline const SAABB& getAABB() const {return _aabb;}
+    inline const SBoundingSphere& getBoundingSphere() const
+      {return _boundingSphere;}
 
     const std::vector<unsigned int>& getIndices() const;
     const unsigned int getNumVertices() const;
     const bool hasIndices() const;
     const GLenum getPrimitiveType() const;
     const std::string& getName() const;
-    void setName(const std::string& name) {_name = name;}
+    void setName(const std::string& name) {_name = name; applyDebugLabel();}
+
+    /*! \brief Labels the VAO, VBO and IBO with the name of the mesh
+    *          (see GLerror::setDebugAnnotationsEnabled). */
+    void applyDebugLabel(void) const;
 
     const GLuint getVBO() const;
     const GLuint getVAO() const;
@@ -93,6 +119,9 @@ namespace kore {
     GLuint                          _VBOloc;
     GLuint                          _VAOloc;
     GLuint                          _IBOloc;
+    SAABB                           _aabb;
+    SBoundingSphere                 _boundingSphere;
+    std::vector<glm::vec3>          _cpuPositions;
   };
 
   struct SMeshInformation {
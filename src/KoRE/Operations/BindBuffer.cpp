@@ -22,19 +22,30 @@
 #include "KoRE/ShaderProgram.h"
 #include "KoRE/RenderManager.h"
 #include "KoRE/IndexedBuffer.h"
+#include "KoRE/Operations/MemoryBarrierOp.h"
+#include "KoRE/FrameCapture.h"
 
 
-kore::BindBuffer::BindBuffer() : _buf(0), _bufTarget(0) {
+kore::BindBuffer::BindBuffer()
+  : _buf(0), _bufTarget(0), _bindingPoint(KORE_UINT_INVALID) {
     _type = OP_BINDBUFFER;
 }
 
 kore::BindBuffer::
   BindBuffer(const GLenum bufferTarget, const GLuint bufLoc)
-    : _buf(0), _bufTarget(0) {
+    : _buf(0), _bufTarget(0), _bindingPoint(KORE_UINT_INVALID) {
     _type = OP_BINDBUFFER;
     connect(bufferTarget, bufLoc);
 }
 
+kore::BindBuffer::
+  BindBuffer(const GLenum bufferTarget, const GLuint bufLoc,
+             const uint bindingPoint)
+    : _buf(0), _bufTarget(0), _bindingPoint(KORE_UINT_INVALID) {
+    _type = OP_BINDBUFFER;
+    connect(bufferTarget, bufLoc, bindingPoint);
+}
+
 kore::BindBuffer::~BindBuffer() {
 }
 
@@ -44,6 +55,12 @@ void kore::BindBuffer::update(void) {
 void kore::BindBuffer::reset(void) {
 }
 
+void kore::BindBuffer::record(FrameCapture* capture) const {
+  if (_buf) {
+    capture->recordBufferBinding(_bufTarget, _bindingPoint, _buf);
+  }
+}
+
 bool kore::BindBuffer::isValid() const {
   return true;;
 }
@@ -52,13 +69,36 @@ bool kore::BindBuffer::dependsOn(const void* thing) const {
   return false;
 }
 
+void kore::BindBuffer::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+  if (_buf) {
+    reads.push_back(SResourceAccess(RESOURCE_BUFFER, _buf,
+                    MemoryBarrierOp::getBarrierBits(_bufTarget)));
+  }
+}
+
 void kore::BindBuffer::doExecute() const {
- if (_buf) {
+ if (!_buf) {
+   return;
+ }
+
+ if (_bindingPoint == KORE_UINT_INVALID) {
    _renderManager->bindBuffer(_bufTarget, _buf);
+ } else {
+   _renderManager->bindBufferBase(_bufTarget, _bindingPoint, _buf);
  }
 }
 
 void kore::BindBuffer::connect(const GLenum bufferTarget, const GLuint bufLoc) {
   _bufTarget = bufferTarget;
   _buf = bufLoc;
+  _bindingPoint = KORE_UINT_INVALID;
+}
+
+void kore::BindBuffer::connect(const GLenum bufferTarget, const GLuint bufLoc,
+                               const uint bindingPoint) {
+  _bufTarget = bufferTarget;
+  _buf = bufLoc;
+  _bindingPoint = bindingPoint;
 }
@@ -29,18 +29,30 @@ namespace kore {
   public:
     BindBuffer();
     explicit BindBuffer(const GLenum bufferTarget, const GLuint bufLoc);
+
+    /*! \brief Binds the buffer to an indexed binding point of the target
+    *          (e.g. GL_SHADER_STORAGE_BUFFER), see connect(). */
+    BindBuffer(const GLenum bufferTarget, const GLuint bufLoc,
+               const uint bindingPoint);
     virtual ~BindBuffer();
 
     void connect(const GLenum bufferTarget, const GLuint bufLoc);
+    void connect(const GLenum bufferTarget, const GLuint bufLoc,
+                 const uint bindingPoint);
 
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     virtual bool isValid() const;
     virtual bool dependsOn(const void* thing) const;
+    virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                     std::vector<SResourceAccess>& writes)
+                                     const;
 
   private:
     GLuint _buf;
     GLenum _bufTarget;
+    uint _bindingPoint;  // KORE_UINT_INVALID for the generic binding
 
     virtual void doExecute() const;
   };
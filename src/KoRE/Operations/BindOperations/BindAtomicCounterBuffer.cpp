@@ -22,6 +22,7 @@
 #include "KoRE/ShaderProgram.h"
 #include "KoRE/RenderManager.h"
 #include "KoRE/IndexedBuffer.h"
+#include "KoRE/FrameCapture.h"
 
 
 kore::BindAtomicCounterBuffer::BindAtomicCounterBuffer() {
@@ -43,6 +44,16 @@ void kore::BindAtomicCounterBuffer::update(void) {
 void kore::BindAtomicCounterBuffer::reset(void) {
 }
 
+void kore::BindAtomicCounterBuffer::record(FrameCapture* capture) const {
+  IndexedBuffer* acBuffer =
+    static_cast<IndexedBuffer*>(_componentUniform->data);
+  if (acBuffer) {
+    capture->recordBufferBinding(GL_ATOMIC_COUNTER_BUFFER,
+                                 _shaderUniform->atomicCounterBindingPoint,
+                                 acBuffer->getHandle());
+  }
+}
+
 void kore::BindAtomicCounterBuffer::doExecute() const {
   uint bindingPoint = _shaderUniform->atomicCounterBindingPoint;
   IndexedBuffer* acBuffer =
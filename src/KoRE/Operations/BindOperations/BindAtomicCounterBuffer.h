@@ -36,6 +36,7 @@ namespace kore {
 
       virtual void update(void);
       virtual void reset(void);
+      virtual void record(FrameCapture* capture) const;
 
     private:
 
@@ -19,6 +19,7 @@
 #include "KoRE/Operations/BindOperations/BindAttribute.h"
 #include "KoRE/RenderManager.h"
 #include "KoRE/GLerror.h"
+#include "KoRE/FrameCapture.h"
 
 kore::BindAttribute::BindAttribute(void) : kore::BindOperation() {
   _type = OP_BINDATTRIBUTE;
@@ -54,7 +55,7 @@ void kore::BindAttribute::doExecute(void) const {
   const Mesh* mesh = _meshInfo->mesh;
   const MeshAttributeArray* meshAtt = _meshInfo->meshAtt;
 
-  GLerror::gl_ErrorCheckStart();
+  KORE_GL_CHECK_START();
   _renderManager->bindVAO(mesh->getVAO());
   _renderManager->bindVBO(mesh->getVBO());
   glEnableVertexAttribArray(_shaderUniform->location);
@@ -64,7 +65,7 @@ void kore::BindAttribute::doExecute(void) const {
                         GL_FALSE,
                         meshAtt->stride,
                         KORE_BUFFER_OFFSET((uint)meshAtt->data));
-  GLerror::gl_ErrorCheckFinish("BindAttribute " + _shaderUniform->name);
+  KORE_GL_CHECK_FINISH("BindAttribute", _shaderUniform->name.c_str());
 }
 
 void kore::BindAttribute::update(void) {
@@ -72,3 +73,13 @@ void kore::BindAttribute::update(void) {
 
 void kore::BindAttribute::reset(void) {
 }
+
+void kore::BindAttribute::record(FrameCapture* capture) const {
+  const Mesh* mesh = _meshInfo->mesh;
+  const MeshAttributeArray* meshAtt = _meshInfo->meshAtt;
+  capture->recordAttribute(_shaderUniform->shader->getProgramLocation(),
+                           mesh->getVAO(), mesh->getVBO(),
+                           _shaderUniform->name, meshAtt->numComponents,
+                           meshAtt->componentType, meshAtt->stride,
+                           reinterpret_cast<GLintptr>(meshAtt->data));
+}
@@ -32,6 +32,7 @@ namespace kore {
     virtual ~BindAttribute(void);
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     void connect(const ShaderData* meshData, const ShaderInput* shaderInput);
 
   private:
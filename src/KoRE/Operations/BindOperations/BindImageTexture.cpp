@@ -71,12 +71,13 @@ void kore::BindImageTexture::doExecute(void) const {
   _renderManager->
     useShaderProgram(_shaderUniform->shader->getProgramLocation());
 
-  GLerror::gl_ErrorCheckStart();
+  KORE_GL_CHECK_START();
   glUniform1i(_shaderUniform->location, _shaderUniform->imgUnit);
-  GLerror::gl_ErrorCheckFinish("BindImageTexture::execute");
+  KORE_GL_CHECK_FINISH("BindImageTexture::execute", NULL);
   STextureInfo* pTexInfo = static_cast<STextureInfo*>(_componentUniform->data); 
 
- // Log::getInstance()->write("ImageUnit = %u\n", _shaderUniform->imgUnit);
+ // KORE_LOG_DEBUG(LOG_CATEGORY_RENDER,
+ //                "ImageUnit = %u\n", _shaderUniform->imgUnit);
 
   glBindImageTexture(_shaderUniform->imgUnit,
                      pTexInfo->texLocation,
@@ -147,3 +148,21 @@ GLuint kore::BindImageTexture::
           return internalFormat;
     }
 }
+
+void kore::BindImageTexture::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+  if (_componentUniform == NULL || _componentUniform->data == NULL) {
+    return;
+  }
+  const STextureInfo* pTexInfo =
+    static_cast<const STextureInfo*>(_componentUniform->data);
+  if (_access != GL_WRITE_ONLY) {
+    reads.push_back(SResourceAccess(RESOURCE_TEXTURE, pTexInfo->texLocation,
+                                    GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+  }
+  if (_access != GL_READ_ONLY) {
+    writes.push_back(SResourceAccess(RESOURCE_TEXTURE,
+                                     pTexInfo->texLocation));
+  }
+}
@@ -36,6 +36,9 @@ namespace kore {
       virtual void reset(void);
       void connect(const ShaderData* texData,
         const ShaderInput* shaderInput, GLuint access);
+      virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                       std::vector<SResourceAccess>& writes)
+                                       const;
   private:
 	GLuint _access;
 
@@ -21,6 +21,7 @@
 #include "KoRE/Operations/BindOperations/BindTexture.h"
 #include "KoRE/GLerror.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::BindTexture::BindTexture()
 : BindOperation() {
@@ -55,7 +56,7 @@ void kore::BindTexture::connect(const kore::ShaderData* texData,
 }
 
 void kore::BindTexture::doExecute(void) const {
-  GLerror::gl_ErrorCheckStart();
+  KORE_GL_CHECK_START();
   _renderManager->
     useShaderProgram(_shaderUniform->shader->getProgramLocation());
   _renderManager->activeTexture(_shaderUniform->texUnit);
@@ -67,9 +68,9 @@ void kore::BindTexture::doExecute(void) const {
     _shaderUniform->shader->getSampler(_shaderUniform->texUnit);
 
   if (!pSampler) {
-    Log::getInstance()->write("[ERROR] BindTexture: No textureSampler"
-                              "available in the shader for texUnit %i.",
-                              _shaderUniform->texUnit);
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "BindTexture: No textureSampler"
+                   "available in the shader for texUnit %i.",
+                   _shaderUniform->texUnit);
   }
 
   _renderManager->bindTexture(_shaderUniform->texUnit,
@@ -77,7 +78,8 @@ void kore::BindTexture::doExecute(void) const {
                               pTexInfo->texLocation);
   _renderManager->bindSampler(_shaderUniform->texUnit,
                               pSampler->getHandle());
-  GLerror::gl_ErrorCheckFinish("BindTextureOperation " + _shaderUniform->name);
+  KORE_GL_CHECK_FINISH("BindTextureOperation",
+                       _shaderUniform->name.c_str());
 }
 
 void kore::BindTexture::update(void) {
@@ -85,3 +87,27 @@ void kore::BindTexture::update(void) {
 
 void kore::BindTexture::reset(void) {
 }
+
+void kore::BindTexture::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+  if (_componentUniform == NULL || _componentUniform->data == NULL) {
+    return;
+  }
+  const STextureInfo* pTexInfo =
+    static_cast<const STextureInfo*>(_componentUniform->data);
+  reads.push_back(SResourceAccess(RESOURCE_TEXTURE, pTexInfo->texLocation,
+                                  GL_TEXTURE_FETCH_BARRIER_BIT));
+}
+
+void kore::BindTexture::record(FrameCapture* capture) const {
+  const STextureInfo* pTexInfo =
+    static_cast<const STextureInfo*>(_componentUniform->data);
+  const TextureSampler* pSampler =
+    _shaderUniform->shader->getSampler(_shaderUniform->texUnit);
+  capture->recordTextureBinding(_shaderUniform->shader->getProgramLocation(),
+                                _shaderUniform->name,
+                                _shaderUniform->texUnit,
+                                pTexInfo->texTarget, pTexInfo->texLocation,
+                                pSampler ? pSampler->getHandle() : 0);
+}
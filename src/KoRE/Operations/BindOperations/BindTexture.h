@@ -35,8 +35,12 @@ namespace kore {
     virtual ~BindTexture(void);
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     void connect(const ShaderData* texData,
                  const ShaderInput* shaderInput);
+    virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                     std::vector<SResourceAccess>& writes)
+                                     const;
   private:
     void init();
     virtual void doExecute(void) const;
@@ -25,6 +25,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Components/SceneNodeComponent.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::BindUniform::BindUniform(void)
                            : kore::BindOperation() {
@@ -66,13 +67,14 @@ void kore::BindUniform::reset(void) {
 
 void kore::BindUniform::doExecute(void) const {
   if(!_componentUniform) {
-    Log::getInstance()->write("[ERROR] Uniform binding undefined");
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Uniform binding undefined");
     return;
   }
 
-  GLerror::gl_ErrorCheckStart();
+  KORE_GL_CHECK_START();
   _renderManager->
     useShaderProgram(_shaderUniform->shader->getProgramLocation());
+  _componentUniform->resolve();
 
   switch (_componentUniform->type) {
     case GL_FLOAT:
@@ -258,8 +260,8 @@ void kore::BindUniform::doExecute(void) const {
   case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
     //glActiveTexture(GL_TEXTURE0 + _componentUniform->texUnit);
     //glProgramUniform1i(_shaderID, _shaderUniform->location, _componentUniform->texUnit);
-    kore::Log::getInstance()->write("[ERROR] sampler type was adressed"
-                                    "as uniform");
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "sampler type was adressed"
+                   "as uniform");
   break;
 /*
 
@@ -385,9 +387,27 @@ break;
 
 break; */
     default:
-     kore::Log::getInstance()->write("[ERROR] Unknown uniform binding\n");
+     KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Unknown uniform binding\n");
     break;
   }
-  GLerror::gl_ErrorCheckFinish("BindUniformOperation: " +
-                                _shaderUniform->name);
+  KORE_GL_CHECK_FINISH("BindUniformOperation:",
+                       _shaderUniform->name.c_str());
+}
+
+void kore::BindUniform::record(FrameCapture* capture) const {
+  if (!_componentUniform) {
+    return;
+  }
+
+  // Scalar ints, bools and doubles are uploaded as a single value.
+  _componentUniform->resolve();
+  GLuint count = _componentUniform->size;
+  switch (_componentUniform->type) {
+    case GL_INT: case GL_BOOL: case GL_UNSIGNED_INT: case GL_DOUBLE:
+      count = 1;
+    break;
+  }
+  capture->recordUniform(_shaderUniform->shader->getProgramLocation(),
+                         _shaderUniform->name, _componentUniform->type,
+                         count, _componentUniform->data);
 }
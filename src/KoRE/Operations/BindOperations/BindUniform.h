@@ -34,6 +34,7 @@ namespace kore {
     virtual ~BindUniform(void);
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     void connect(const ShaderData* componentUni,
                  const ShaderInput* shaderUni);
   private:
@@ -0,0 +1,117 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/Operations/BindOperations/BindUniformBlock.h"
+
+#include <string.h>
+
+#include "KoRE/RenderManager.h"
+#include "KoRE/UniformBuffer.h"
+#include "KoRE/UniformBlockLayout.h"
+#include "KoRE/FrameCapture.h"
+
+kore::BindUniformBlock::BindUniformBlock()
+  : _streamed(false) {
+  _type = OP_BINDUNIFORMBLOCK;
+}
+
+kore::BindUniformBlock::
+  BindUniformBlock(const ShaderData* data, const ShaderInput* shaderInput,
+                   const bool streamed)
+  : _streamed(streamed) {
+  connect(data, shaderInput);
+  _type = OP_BINDUNIFORMBLOCK;
+}
+
+kore::BindUniformBlock::~BindUniformBlock() {
+}
+
+void kore::BindUniformBlock::update(void) {
+}
+
+void kore::BindUniformBlock::reset(void) {
+}
+
+void kore::BindUniformBlock::record(FrameCapture* capture) const {
+  UniformBuffer* uniformBuffer =
+    static_cast<UniformBuffer*>(_componentUniform->data);
+  const UniformBlockLayout* layout =
+    static_cast<const UniformBlockLayout*>(_shaderUniform->additionalData);
+
+  // Streamed or not, the block holds these values when it is bound.
+  std::vector<GLubyte> values(layout->getDataSize(), 0);
+  if (!values.empty()) {
+    uniformBuffer->write(_shaderUniform, &values[0]);
+  }
+  capture->recordUniformBlock(_shaderUniform->shader->getProgramLocation(),
+                              _shaderUniform->name,
+                              _shaderUniform->uniformBlockBinding,
+                              values.empty() ? NULL : &values[0],
+                              static_cast<uint>(values.size()));
+}
+
+void kore::BindUniformBlock::doExecute() const {
+  UniformBuffer* uniformBuffer =
+    static_cast<UniformBuffer*>(_componentUniform->data);
+  const UniformBlockLayout* layout =
+    static_cast<const UniformBlockLayout*>(_shaderUniform->additionalData);
+
+  if (_streamed) {
+    StreamingBuffer* stream = _renderManager->getUniformStream();
+    GLintptr offset = 0;
+    GLubyte* dst = stream->allocate(layout->getDataSize(), offset);
+    if (dst) {
+      // The ring still holds data of earlier frames, and members without a
+      // matching value aren't written.
+      memset(dst, 0, layout->getDataSize());
+      uniformBuffer->write(_shaderUniform, dst);
+      stream->commit(offset, layout->getDataSize());
+      _renderManager->bindBufferRange(GL_UNIFORM_BUFFER,
+                                      _shaderUniform->uniformBlockBinding,
+                                      stream->getHandle(), offset,
+                                      layout->getDataSize());
+      return;
+    }
+    // The ring is full for this frame: use the static buffer instead.
+  }
+
+  GLuint bufferHandle = uniformBuffer->update(_shaderUniform);
+  _renderManager->bindBufferRange(GL_UNIFORM_BUFFER,
+                                  _shaderUniform->uniformBlockBinding,
+                                  bufferHandle, 0, layout->getDataSize());
+}
+
+void kore::BindUniformBlock::connect(const ShaderData* data,
+                                     const ShaderInput* shaderInput) {
+  if (!data || !shaderInput
+      || data->type != GL_UNIFORM_BUFFER
+      || shaderInput->type != GL_UNIFORM_BLOCK
+      || !shaderInput->additionalData) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "BindUniformBlock: ShaderData and "
+                   "ShaderInput have to be a uniform buffer and "
+                   "a uniform block\n");
+    // Make invalid
+    _shaderUniform = NULL;
+    _componentUniform = NULL;
+    return;
+  }
+
+  _shaderUniform = shaderInput;
+  _componentUniform = data;
+}
@@ -0,0 +1,59 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_OPERATIONS_BINDUNIFORMBLOCK_H_
+#define KORE_SRC_KORE_OPERATIONS_BINDUNIFORMBLOCK_H_
+
+#include "KoRE/Common.h"
+#include "KoRE/Operations/BindOperations/BindOperation.h"
+#include "KoRE/ShaderInput.h"
+
+namespace kore {
+  /*! \brief Binds the UniformBuffer of a component (e.g. the "Uniform Buffer"
+  *          ShaderData of a Material or Transform) to a uniform block.
+  *          The buffer is only re-uploaded if its values changed.
+  *          In streamed mode, the values are written into the uniform
+  *          ring-buffer of the RenderManager on every execution instead,
+  *          which suits data that changes every frame (e.g. transforms).
+  */
+  class BindUniformBlock : public BindOperation {
+    public:
+      BindUniformBlock();
+      explicit BindUniformBlock(const ShaderData* data,
+                                const ShaderInput* shaderInput,
+                                const bool streamed = false);
+      virtual ~BindUniformBlock();
+
+      void connect(const ShaderData* data, const ShaderInput* shaderInput);
+
+      virtual void update(void);
+      virtual void reset(void);
+      virtual void record(FrameCapture* capture) const;
+
+      inline void setStreamed(const bool streamed) {_streamed = streamed;}
+      inline bool isStreamed() const {return _streamed;}
+
+    private:
+      bool _streamed;
+
+      virtual void doExecute() const;
+  };
+}
+
+#endif  // KORE_SRC_KORE_OPERATIONS_BINDUNIFORMBLOCK_H_
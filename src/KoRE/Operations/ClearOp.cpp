@@ -22,6 +22,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Log.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::ClearOp::ClearOp() :
     kore::Operation() {
@@ -66,6 +67,13 @@ bool kore::ClearOp::dependsOn(const void* thing) const {
   return false;
 }
 
+void kore::ClearOp::record(FrameCapture* capture) const {
+  if (_clear_bit != 0) {
+    capture->recordClear(_clear_bit, _clearcolor.x, _clearcolor.y,
+                         _clearcolor.z, _clearcolor.w);
+  }
+}
+
 bool kore::ClearOp::isValid(void) const {
   return true;
 }
@@ -22,6 +22,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Log.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::ColorMaskOp::ColorMaskOp()
   : _colorMask(true, true, true, true),
@@ -60,6 +61,11 @@ bool kore::ColorMaskOp::dependsOn(const void* thing) const {
   return false;
 }
 
+void kore::ColorMaskOp::record(FrameCapture* capture) const {
+  capture->recordColorMask(_colorMask.r, _colorMask.g,
+                           _colorMask.b, _colorMask.a);
+}
+
 bool kore::ColorMaskOp::isValid(void) const {
   return true;
 }
@@ -0,0 +1,115 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/Operations/DispatchComputeOp.h"
+#include "KoRE/RenderManager.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/FrameCapture.h"
+
+kore::DispatchComputeOp::DispatchComputeOp()
+  : _indirectBuffer(0),
+    _indirectOffset(0) {
+  _type = OP_DISPATCHCOMPUTE;
+  _numGroups[0] = _numGroups[1] = _numGroups[2] = 0;
+}
+
+kore::DispatchComputeOp::DispatchComputeOp(const GLuint numGroupsX,
+                                           const GLuint numGroupsY,
+                                           const GLuint numGroupsZ)
+  : _indirectBuffer(0),
+    _indirectOffset(0) {
+  _type = OP_DISPATCHCOMPUTE;
+  connect(numGroupsX, numGroupsY, numGroupsZ);
+}
+
+kore::DispatchComputeOp::~DispatchComputeOp() {
+}
+
+void kore::DispatchComputeOp::connect(const GLuint numGroupsX,
+                                      const GLuint numGroupsY,
+                                      const GLuint numGroupsZ) {
+  _numGroups[0] = numGroupsX;
+  _numGroups[1] = numGroupsY;
+  _numGroups[2] = numGroupsZ;
+  _indirectBuffer = 0;
+  _indirectOffset = 0;
+}
+
+void kore::DispatchComputeOp::connectIndirect(const GLuint indirectBuffer,
+                                              const GLintptr offset) {
+  _numGroups[0] = _numGroups[1] = _numGroups[2] = 0;
+  _indirectBuffer = indirectBuffer;
+  _indirectOffset = offset;
+}
+
+void kore::DispatchComputeOp::addRead(const EResourceType type,
+                                      const GLuint handle,
+                                      const GLbitfield barrierBits) {
+  _reads.push_back(SResourceAccess(type, handle, barrierBits));
+}
+
+void kore::DispatchComputeOp::addWrite(const EResourceType type,
+                                       const GLuint handle) {
+  _writes.push_back(SResourceAccess(type, handle));
+}
+
+void kore::DispatchComputeOp::update(void) {
+}
+
+void kore::DispatchComputeOp::reset(void) {
+}
+
+bool kore::DispatchComputeOp::isValid() const {
+  return _indirectBuffer != 0
+      || (_numGroups[0] > 0 && _numGroups[1] > 0 && _numGroups[2] > 0);
+}
+
+void kore::DispatchComputeOp::record(FrameCapture* capture) const {
+  if (_indirectBuffer != 0) {
+    capture->recordDispatchIndirect(_indirectBuffer, _indirectOffset);
+  } else {
+    capture->recordDispatch(_numGroups[0], _numGroups[1], _numGroups[2]);
+  }
+}
+
+bool kore::DispatchComputeOp::dependsOn(const void* thing) const {
+  return false;
+}
+
+void kore::DispatchComputeOp::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+  reads.insert(reads.end(), _reads.begin(), _reads.end());
+  writes.insert(writes.end(), _writes.begin(), _writes.end());
+  if (_indirectBuffer != 0) {
+    reads.push_back(SResourceAccess(RESOURCE_BUFFER, _indirectBuffer,
+                                    GL_COMMAND_BARRIER_BIT));
+  }
+}
+
+void kore::DispatchComputeOp::doExecute() const {
+  KORE_GL_CHECK_START();
+  if (_indirectBuffer != 0) {
+    _renderManager->bindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _indirectBuffer);
+    glDispatchComputeIndirect(_indirectOffset);
+  } else {
+    glDispatchCompute(_numGroups[0], _numGroups[1], _numGroups[2]);
+  }
+  KORE_GL_CHECK_FINISH("DispatchComputeOp::execute", NULL);
+}
@@ -0,0 +1,82 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_OPERATIONS_DISPATCHCOMPUTEOP_H_
+#define KORE_SRC_KORE_OPERATIONS_DISPATCHCOMPUTEOP_H_
+
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/Operations/Operation.h"
+
+namespace kore {
+  /*! \brief Runs the compute shader of the current program, either with a
+  *          fixed number of work groups (glDispatchCompute) or with the
+  *          group counts stored in a buffer (glDispatchComputeIndirect).
+  *          The buffers and textures the shader reads and writes can be
+  *          declared, so the optimizer inserts the required memory
+  *          barriers between this dispatch and the operations that consume
+  *          its results.
+  */
+  class DispatchComputeOp : public Operation {
+  public:
+    DispatchComputeOp();
+    DispatchComputeOp(const GLuint numGroupsX, const GLuint numGroupsY,
+                      const GLuint numGroupsZ);
+    virtual ~DispatchComputeOp();
+
+    void connect(const GLuint numGroupsX, const GLuint numGroupsY,
+                 const GLuint numGroupsZ);
+
+    /*! \brief Reads the group counts from a buffer.
+    *   \param indirectBuffer The buffer with the DispatchIndirectCommand.
+    *   \param offset The byte offset of the command in the buffer. */
+    void connectIndirect(const GLuint indirectBuffer, const GLintptr offset);
+
+    /*! \brief Declares a resource the compute shader reads.
+    *   \param barrierBits The way the shader accesses the resource, e.g.
+    *          GL_SHADER_STORAGE_BARRIER_BIT or GL_TEXTURE_FETCH_BARRIER_BIT*/
+    void addRead(const EResourceType type, const GLuint handle,
+                 const GLbitfield barrierBits);
+
+    /*! \brief Declares a resource the compute shader writes. */
+    void addWrite(const EResourceType type, const GLuint handle);
+
+    inline bool isIndirect() const {return _indirectBuffer != 0;}
+
+    virtual void update(void);
+    virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
+    virtual bool isValid() const;
+    virtual bool dependsOn(const void* thing) const;
+    virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                     std::vector<SResourceAccess>& writes)
+                                     const;
+
+  private:
+    GLuint _numGroups[3];
+    GLuint _indirectBuffer;
+    GLintptr _indirectOffset;
+    std::vector<SResourceAccess> _reads;
+    std::vector<SResourceAccess> _writes;
+
+    virtual void doExecute() const;
+  };
+}
+
+#endif  // KORE_SRC_KORE_OPERATIONS_DISPATCHCOMPUTEOP_H_
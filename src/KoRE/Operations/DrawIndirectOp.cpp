@@ -20,14 +20,26 @@
 #include "KoRE/Operations/DrawIndirectOp.h"
 #include "KoRE/ShaderProgram.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
-kore::DrawIndirectOp::DrawIndirectOp() : _mode(0), _bufOffset(0) {
+kore::DrawIndirectOp::DrawIndirectOp()
+  : _mode(0),
+    _indexType(GL_NONE),
+    _bufOffset(0),
+    _drawCount(1),
+    _stride(0),
+    _indirectBuffer(0) {
     _type = OP_DRAWINDIRECT;
 }
 
 kore::DrawIndirectOp::
   DrawIndirectOp(const GLenum mode, const GLuint bufOffset)
-  : _mode(0), _bufOffset(0) {
+  : _mode(0),
+    _indexType(GL_NONE),
+    _bufOffset(0),
+    _drawCount(1),
+    _stride(0),
+    _indirectBuffer(0) {
     _type = OP_DRAWINDIRECT;
     connect(mode, bufOffset);
 }
@@ -41,6 +53,11 @@ void kore::DrawIndirectOp::update(void) {
 void kore::DrawIndirectOp::reset(void) {
 }
 
+void kore::DrawIndirectOp::record(FrameCapture* capture) const {
+  capture->recordDrawIndirect(_mode, _indexType, _indirectBuffer, _bufOffset,
+                              _drawCount, _stride);
+}
+
 bool kore::DrawIndirectOp::isValid() const {
   return true;
 }
@@ -49,11 +66,49 @@ bool kore::DrawIndirectOp::dependsOn(const void* thing) const {
   return true;
 }
 
+void kore::DrawIndirectOp::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+  if (_indirectBuffer != 0) {
+    reads.push_back(SResourceAccess(RESOURCE_BUFFER, _indirectBuffer,
+                                    GL_COMMAND_BARRIER_BIT));
+  }
+}
+
 void kore::DrawIndirectOp::doExecute() const {
- glDrawArraysIndirect(_mode, (void*)_bufOffset);
+  if (_indirectBuffer != 0) {
+    _renderManager->bindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+  }
+
+  const GLvoid* offset = reinterpret_cast<const GLvoid*>(
+    static_cast<GLintptr>(_bufOffset));
+  if (_indexType == GL_NONE) {
+    if (_drawCount > 1) {
+      glMultiDrawArraysIndirect(_mode, offset, _drawCount, _stride);
+    } else {
+      glDrawArraysIndirect(_mode, offset);
+    }
+  } else {
+    if (_drawCount > 1) {
+      glMultiDrawElementsIndirect(_mode, _indexType, offset, _drawCount,
+                                  _stride);
+    } else {
+      glDrawElementsIndirect(_mode, _indexType, offset);
+    }
+  }
 }
 
 void kore::DrawIndirectOp::connect(const GLenum mode, const GLuint bufOffset) {
+  connect(mode, GL_NONE, bufOffset, 1, 0);
+}
+
+void kore::DrawIndirectOp::connect(const GLenum mode, const GLenum indexType,
+                                   const GLuint bufOffset,
+                                   const GLsizei drawCount,
+                                   const GLsizei stride) {
   _mode = mode;
+  _indexType = indexType;
   _bufOffset = bufOffset;
+  _drawCount = drawCount;
+  _stride = stride;
 }
@@ -24,6 +24,11 @@
 #include "KoRE/Operations/Operation.h"
 
 namespace kore {
+  /*! \brief Draws with the commands in the bound GL_DRAW_INDIRECT_BUFFER.
+  *   Without an index type, DrawArraysIndirectCommands are used, otherwise
+  *   DrawElementsIndirectCommands. With a draw count greater than one, the
+  *   commands are submitted with a single multi-draw call.
+  */
   class DrawIndirectOp : public Operation {
   public:
     DrawIndirectOp();
@@ -32,14 +37,36 @@ namespace kore {
 
     void connect(const GLenum mode, const GLuint bufOffset);
 
+    /*! \brief Draws drawCount commands, starting at bufOffset.
+    *   \param indexType The type of the indices (e.g. GL_UNSIGNED_INT) or
+    *          GL_NONE for non-indexed draws.
+    *   \param stride The distance between two commands in bytes or 0 for
+    *          tightly packed commands. */
+    void connect(const GLenum mode, const GLenum indexType,
+                 const GLuint bufOffset, const GLsizei drawCount,
+                 const GLsizei stride = 0);
+
+    /*! \brief Binds a buffer to GL_DRAW_INDIRECT_BUFFER before drawing.
+    *          Pass 0 to use the buffer bound at execution time. */
+    inline void setIndirectBuffer(const GLuint buffer)
+      {_indirectBuffer = buffer;}
+
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     virtual bool isValid() const;
     virtual bool dependsOn(const void* thing) const;
+    virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                     std::vector<SResourceAccess>& writes)
+                                     const;
 
   private:
     GLenum _mode;
+    GLenum _indexType;
     GLuint _bufOffset;
+    GLsizei _drawCount;
+    GLsizei _stride;
+    GLuint _indirectBuffer;
 
     virtual void doExecute() const;
   };
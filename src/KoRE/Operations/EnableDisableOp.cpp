@@ -22,6 +22,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Log.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::EnableDisableOp::EnableDisableOp()
   : _enable(false),
@@ -60,6 +61,10 @@ bool kore::EnableDisableOp::dependsOn(const void* thing) const {
   return false;
 }
 
+void kore::EnableDisableOp::record(FrameCapture* capture) const {
+  capture->recordEnable(_glType, _enable);
+}
+
 bool kore::EnableDisableOp::isValid(void) const {
   return true;
 }
@@ -20,6 +20,7 @@
 
 #include "KoRE/Operations/MemoryBarrierOp.h"
 #include "KoRE/GLerror.h"
+#include "KoRE/FrameCapture.h"
 
 
 kore::MemoryBarrierOp::MemoryBarrierOp() 
@@ -37,9 +38,9 @@ kore::MemoryBarrierOp::~MemoryBarrierOp() {
 }
 
 void kore::MemoryBarrierOp::doExecute(void) const {
-  GLerror::gl_ErrorCheckStart();
+  KORE_GL_CHECK_START();
   glMemoryBarrier(_barrierBits);
-  GLerror::gl_ErrorCheckFinish("MemoryBarrierOp::execute");
+  KORE_GL_CHECK_FINISH("MemoryBarrierOp::execute", NULL);
 }
 
 void kore::MemoryBarrierOp::update(void) {
@@ -52,6 +53,10 @@ bool kore::MemoryBarrierOp::isValid(void) const {
   return true;
 }
 
+void kore::MemoryBarrierOp::record(FrameCapture* capture) const {
+  capture->recordMemoryBarrier(_barrierBits);
+}
+
 bool kore::MemoryBarrierOp::dependsOn(const void* thing) const {
   return false;
 }
@@ -59,3 +64,33 @@ bool kore::MemoryBarrierOp::dependsOn(const void* thing) const {
 void kore::MemoryBarrierOp::connect(const GLuint barrierBits) {
   _barrierBits = barrierBits;
 }
+
+GLbitfield kore::MemoryBarrierOp::getBarrierBits(const GLenum bufferTarget) {
+  switch (bufferTarget) {
+    case GL_ARRAY_BUFFER:
+      return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return GL_ELEMENT_ARRAY_BARRIER_BIT;
+    case GL_UNIFORM_BUFFER:
+      return GL_UNIFORM_BARRIER_BIT;
+    case GL_SHADER_STORAGE_BUFFER:
+      return GL_SHADER_STORAGE_BARRIER_BIT;
+    case GL_ATOMIC_COUNTER_BUFFER:
+      return GL_ATOMIC_COUNTER_BARRIER_BIT;
+    case GL_DRAW_INDIRECT_BUFFER:
+    case GL_DISPATCH_INDIRECT_BUFFER:
+      return GL_COMMAND_BARRIER_BIT;
+    case GL_PIXEL_PACK_BUFFER:
+    case GL_PIXEL_UNPACK_BUFFER:
+      return GL_PIXEL_BUFFER_BARRIER_BIT;
+    case GL_TEXTURE_BUFFER:
+      return GL_TEXTURE_FETCH_BARRIER_BIT;
+    case GL_TRANSFORM_FEEDBACK_BUFFER:
+      return GL_TRANSFORM_FEEDBACK_BARRIER_BIT;
+    case GL_COPY_READ_BUFFER:
+    case GL_COPY_WRITE_BUFFER:
+      return GL_BUFFER_UPDATE_BARRIER_BIT;
+    default:
+      return GL_ALL_BARRIER_BITS;
+  }
+}
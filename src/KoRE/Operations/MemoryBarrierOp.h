@@ -35,6 +35,7 @@ namespace kore {
 
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     virtual bool isValid(void) const;
     virtual bool dependsOn(const void* thing) const;
 
@@ -44,6 +45,10 @@ namespace kore {
     */
     void connect(const GLuint barrierBits);
 
+    /*! \brief Returns the barrier bits needed before a buffer that was
+    *          written by shaders is read through the given target. */
+    static GLbitfield getBarrierBits(const GLenum bufferTarget);
+
   private:
     GLuint _barrierBits;
 
@@ -19,6 +19,7 @@
 
 #include "KoRE/Operations/Operation.h"
 #include "Kore/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::Operation::Operation(void)
   : _type(OP_UNDEFINED),
@@ -35,11 +36,24 @@ bool kore::Operation::isValid( void ) const {
   return _type != OP_UNDEFINED;
 }
 
+void kore::Operation::
+  getResourceAccesses(std::vector<SResourceAccess>& reads,
+                      std::vector<SResourceAccess>& writes) const {
+}
+
+void kore::Operation::record(FrameCapture* capture) const {
+  capture->recordUnsupported(_type);
+}
+
 void kore::Operation::execute() const {
   if (!isValid()) {
     return;
   }
 
+  if (FrameCapture::isCapturing()) {
+    record(FrameCapture::getInstance());
+  }
+
   // Call the dynamic implementation only if the Op is valid!
   doExecute();
 }
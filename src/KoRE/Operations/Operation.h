@@ -21,6 +21,8 @@
 #define CORE_INCLUDE_CORE_OPERATION_H_
 
 #include <memory>
+#include <vector>
+#include "KoRE/Common.h"
 
 namespace kore {
   enum EOperationType {
@@ -44,7 +46,10 @@ namespace kore {
     OP_FUNCTION,
     OP_DRAWINDIRECT,
     OP_BINDBUFFER,
-    OP_CLEAR
+    OP_CLEAR,
+    OP_BINDUNIFORMBLOCK,
+    OP_DISPATCHCOMPUTE,
+    OP_PROFILEMARKER
   };
 
   enum EOperationExecutionType {
@@ -52,8 +57,32 @@ namespace kore {
     EXECUTE_REPEATING
   };
 
+  enum EResourceType {
+    RESOURCE_BUFFER,
+    RESOURCE_TEXTURE
+  };
+
+  /*! \brief A GL object that an operation reads or writes on the GPU.
+  *          For reads, barrierBits describe how the resource is consumed
+  *          (e.g. GL_COMMAND_BARRIER_BIT for indirect buffers), so the
+  *          optimizer can insert the matching glMemoryBarrier after
+  *          incoherent writes. */
+  struct SResourceAccess {
+    SResourceAccess(const EResourceType resType, const GLuint resHandle,
+                    const GLbitfield bits = 0)
+      : type(resType),
+        handle(resHandle),
+        barrierBits(bits) {
+    }
+
+    EResourceType type;
+    GLuint handle;
+    GLbitfield barrierBits;
+  };
+
   class SceneNodeComponent;
   class RenderManager;
+  class FrameCapture;
   class Operation {
   public:
     Operation(void);
@@ -66,6 +95,19 @@ namespace kore {
     virtual bool dependsOn(const void* thing) const = 0;
     virtual bool isValid(void) const;
 
+    /*! \brief Appends the resources this operation reads and writes
+    *          through shader storage, image stores or indirect commands.
+    *          Operations without such accesses declare nothing. */
+    virtual void getResourceAccesses(std::vector<SResourceAccess>& reads,
+                                     std::vector<SResourceAccess>& writes)
+                                     const;
+
+    /*! \brief Describes what this operation does to the GL in terms of
+    *          the FrameCapture interface. Called right before the operation
+    *          is executed while a frame is captured. Operations that can't
+    *          be captured are recorded as unsupported. */
+    virtual void record(FrameCapture* capture) const;
+
     inline const EOperationType getType() const {return _type;}
     
     inline const EOperationExecutionType getExecutionType() const {return _executionType;}
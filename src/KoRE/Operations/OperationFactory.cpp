@@ -21,8 +21,10 @@
 
 #include "KoRE/Operations/BindOperations/BindAttribute.h"
 #include "KoRE/Operations/BindOperations/BindUniform.h"
+#include "KoRE/Operations/BindOperations/BindUniformBlock.h"
 #include "KoRE/Operations/BindOperations/BindImageTexture.h"
 #include "KoRE/Operations/BindOperations/BindTexture.h"
+#include "KoRE/Operations/DispatchComputeOp.h"
 #include "KoRE/Operations/MemoryBarrierOp.h"
 #include "KoRE/Operations/RenderMesh.h"
 #include "KoRE/Operations/SelectNodes.h"
@@ -43,6 +45,17 @@ kore::BindOperation*
                                  const SceneNodeComponent* component,
                                  const std::string& shaderInputName,
                                  const ShaderProgram* shaderProg) {
+  StringTable* strTable = StringTable::getInstance();
+  return create(opType, strTable->intern(shaderDataName), component,
+                strTable->intern(shaderInputName), shaderProg);
+}
+
+kore::BindOperation*
+  kore::OperationFactory::create(const EOperationType opType,
+                                 const StringID shaderDataName,
+                                 const SceneNodeComponent* component,
+                                 const StringID shaderInputName,
+                                 const ShaderProgram* shaderProg) {
   switch(opType) {
     case OP_BINDATTRIBUTE:
       return new BindAttribute(component->getShaderData(shaderDataName), 
@@ -56,10 +69,14 @@ kore::BindOperation*
     case OP_BINDIMAGETEXTURE:
       return new BindImageTexture(component->getShaderData(shaderDataName), 
                                   shaderProg->getUniform(shaderInputName));
+    case OP_BINDUNIFORMBLOCK:
+      return new BindUniformBlock(component->getShaderData(shaderDataName),
+        shaderProg->getUniformBlock(
+          StringTable::getInstance()->getString(shaderInputName)));
     default:
-      Log::getInstance()->write("[ERROR] The requested Operation-type is no"
-                                "bind Operation or not implemented yet in"
-                                "the OperationFactory");
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type is no"
+                     "bind Operation or not implemented yet in"
+                     "the OperationFactory");
       return NULL;
   }
 }
@@ -72,9 +89,9 @@ kore::Operation*
       return new UseShaderProgram(shaderProg);
 
     default:
-      Log::getInstance()->write("[ERROR] The requested Operation-type can not"
-                                "be created with this overload of the"
-                                "create-function.");
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type can not"
+                     "be created with this overload of the"
+                     "create-function.");
       return NULL;
   }
 }
@@ -97,9 +114,9 @@ kore::Operation*
       }
 
     default:
-      Log::getInstance()->write("[ERROR] The requested Operation-type can not"
-                                "be created with this overload of the"
-                                "create-function.");
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type can not"
+                     "be created with this overload of the"
+                     "create-function.");
       return NULL;
   }
 }
@@ -107,6 +124,54 @@ kore::Operation*
 kore::Operation*
   kore::OperationFactory::create(const EOperationType opType,
                                  const GLuint bitfield) {
-  
-  return new MemoryBarrierOp(bitfield);
+  switch(opType) {
+    case OP_MEMORYBARRIER:
+      return new MemoryBarrierOp(bitfield);
+
+    default:
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type can not"
+                     "be created with this overload of the"
+                     "create-function.");
+      return NULL;
+  }
+}
+
+kore::Operation*
+  kore::OperationFactory::create(const EOperationType opType,
+                                 const GLuint numGroupsX,
+                                 const GLuint numGroupsY,
+                                 const GLuint numGroupsZ) {
+  switch(opType) {
+    case OP_DISPATCHCOMPUTE:
+      return new DispatchComputeOp(numGroupsX, numGroupsY, numGroupsZ);
+
+    default:
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type can not"
+                     "be created with this overload of the"
+                     "create-function.");
+      return NULL;
+  }
+}
+
+kore::Operation*
+  kore::OperationFactory::create(const EOperationType opType,
+                                 const IndexedBuffer* indirectBuffer,
+                                 const GLintptr offset) {
+  switch(opType) {
+    case OP_DISPATCHCOMPUTE:
+      {
+        if (indirectBuffer == NULL) {
+          return NULL;
+        }
+        DispatchComputeOp* op = new DispatchComputeOp;
+        op->connectIndirect(indirectBuffer->getHandle(), offset);
+        return op;
+      }
+
+    default:
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "The requested Operation-type can not"
+                     "be created with this overload of the"
+                     "create-function.");
+      return NULL;
+  }
 }
@@ -27,6 +27,7 @@
 #include "KoRE/Operations/BindOperations/BindOperation.h"
 #include "KoRE/Components/SceneNodeComponent.h"
 #include "KoRE/ShaderProgram.h"
+#include "KoRE/IndexedBuffer.h"
 
 namespace kore {
   class OperationFactory {
@@ -37,6 +38,13 @@ namespace kore {
                                    const std::string& shaderInputName,
                                    const ShaderProgram* shaderProg);
 
+      /// Same as above with interned names, avoids all string comparisons.
+      static BindOperation* create(const EOperationType opType,
+                                   const StringID shaderDataName,
+                                   const SceneNodeComponent* component,
+                                   const StringID shaderInputName,
+                                   const ShaderProgram* shaderProg);
+
       static Operation* create(const EOperationType opType,
                                const ShaderProgram* shaderProg);
 
@@ -49,6 +57,18 @@ namespace kore {
       static Operation* create(const EOperationType opType,
                                const GLuint bitfield);
 
+      /// Creates a direct compute dispatch (OP_DISPATCHCOMPUTE).
+      static Operation* create(const EOperationType opType,
+                               const GLuint numGroupsX,
+                               const GLuint numGroupsY,
+                               const GLuint numGroupsZ);
+
+      /// Creates an indirect compute dispatch (OP_DISPATCHCOMPUTE) that
+      /// reads its group counts from the buffer at the byte offset.
+      static Operation* create(const EOperationType opType,
+                               const IndexedBuffer* indirectBuffer,
+                               const GLintptr offset);
+
       ~OperationFactory();
 
   private:
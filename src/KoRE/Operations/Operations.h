@@ -22,6 +22,7 @@
 #include "BindOperations/BindImageTexture.h"
 #include "BindOperations/BindTexture.h"
 #include "BindOperations/BindUniform.h"
+#include "BindOperations/BindUniformBlock.h"
 #include "ColorMaskOp.h"
 #include "EnableDisableOp.h"
 #include "FunctionOp.h"
@@ -35,5 +36,7 @@
 #include "ViewportOp.h"
 #include "BindBuffer.h"
 #include "DrawIndirectOp.h"
+#include "DispatchComputeOp.h"
+#include "ProfileMarkerOp.h"
 #include "OperationFactory.h"
 #include "ClearOp.h"
\ No newline at end of file
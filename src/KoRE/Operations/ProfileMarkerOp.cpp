@@ -0,0 +1,73 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/Operations/ProfileMarkerOp.h"
+#include "KoRE/Profiler.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/FrameCapture.h"
+
+kore::ProfileMarkerOp::ProfileMarkerOp()
+  : _name(KORE_STRINGID_INVALID),
+    _begin(true),
+    _scopes(MARKER_PROFILE) {
+  _type = OP_PROFILEMARKER;
+}
+
+kore::ProfileMarkerOp::~ProfileMarkerOp() {
+}
+
+void kore::ProfileMarkerOp::connect(const StringID name, const bool begin,
+                                    const uint scopes) {
+  _name = name;
+  _begin = begin;
+  _scopes = scopes;
+}
+
+void kore::ProfileMarkerOp::update(void) {
+}
+
+void kore::ProfileMarkerOp::reset(void) {
+}
+
+bool kore::ProfileMarkerOp::dependsOn(const void* thing) const {
+  return false;
+}
+
+void kore::ProfileMarkerOp::record(FrameCapture* capture) const {
+  // Markers don't touch the GL.
+}
+
+void kore::ProfileMarkerOp::doExecute() const {
+  if (_begin) {
+    if (_scopes & MARKER_PROFILE) {
+      Profiler::getInstance()->beginScope(_name);
+    }
+    if (_scopes & MARKER_DEBUG_GROUP) {
+      GLerror::pushDebugGroup(StringTable::getInstance()->getString(_name));
+    }
+  } else {
+    // Scopes close in reverse order
+    if (_scopes & MARKER_DEBUG_GROUP) {
+      GLerror::popDebugGroup();
+    }
+    if (_scopes & MARKER_PROFILE) {
+      Profiler::getInstance()->endScope();
+    }
+  }
+}
@@ -0,0 +1,62 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_OPERATIONS_PROFILEMARKEROP_H_
+#define KORE_SRC_KORE_OPERATIONS_PROFILEMARKEROP_H_
+
+#include "KoRE/Common.h"
+#include "KoRE/StringTable.h"
+#include "KoRE/Operations/Operation.h"
+
+namespace kore {
+  /// The kinds of scopes a ProfileMarkerOp opens or closes.
+  enum EMarkerScope {
+    MARKER_PROFILE      = 1 << 0,  // Profiler scope
+    MARKER_DEBUG_GROUP  = 1 << 1   // KHR_debug group (glPushDebugGroup)
+  };
+
+  /*! \brief Opens or closes a scope of the Profiler and/or a KHR_debug
+  *          group during execution. */
+  class ProfileMarkerOp : public Operation {
+  public:
+    ProfileMarkerOp();
+    virtual ~ProfileMarkerOp();
+
+    /*! \brief A begin-marker opens a scope with the name, an end-marker
+    *          closes the innermost scope.
+    *   \param scopes Combination of EMarkerScope flags. Begin- and
+    *          end-marker of a scope have to use the same flags. */
+    void connect(const StringID name, const bool begin,
+                 const uint scopes = MARKER_PROFILE);
+
+    virtual void update(void);
+    virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
+    virtual bool dependsOn(const void* thing) const;
+
+  private:
+    StringID _name;
+    bool _begin;
+    uint _scopes;
+
+    virtual void doExecute() const;
+  };
+}
+
+#endif  // KORE_SRC_KORE_OPERATIONS_PROFILEMARKEROP_H_
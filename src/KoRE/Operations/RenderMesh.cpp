@@ -21,6 +21,7 @@
 #include "KoRE/RenderManager.h"
 #include "KoRE/GLerror.h"
 #include <vector>
+#include "KoRE/FrameCapture.h"
 
 kore::RenderMesh::RenderMesh(void)
   : _meshComponent(NULL),
@@ -48,7 +49,7 @@ void kore::RenderMesh::connect(const kore::MeshComponent* mesh) {
 
 void kore::RenderMesh::doExecute(void) const {
 
-    GLerror::gl_ErrorCheckStart();
+    KORE_GL_CHECK_START();
     const Mesh* mesh = _meshComponent->getMesh();
 
     if (mesh == NULL) {
@@ -87,7 +88,7 @@ void kore::RenderMesh::doExecute(void) const {
                    mesh->getNumVertices());
     }
 
-  GLerror::gl_ErrorCheckFinish("RenderMeshOperation " + mesh->getName());
+  KORE_GL_CHECK_FINISH("RenderMeshOperation", mesh->getName().c_str());
 }
 
 void kore::RenderMesh::update(void) {
@@ -100,6 +101,25 @@ bool kore::RenderMesh::isValid(void) const {
   return _meshComponent && _shaderProgram;
 }
 
+void kore::RenderMesh::record(FrameCapture* capture) const {
+  const Mesh* mesh = _meshComponent->getMesh();
+  if (mesh == NULL) {
+    return;
+  }
+
+  if (mesh->hasIndices() && !mesh->usesIBO()) {
+    capture->recordDrawClientIndices(mesh->getVAO(), mesh->getPrimitiveType(),
+                                     mesh->getIndices());
+  } else if (mesh->hasIndices()) {
+    capture->recordDraw(mesh->getVAO(), mesh->getIBO(),
+                        mesh->getPrimitiveType(),
+                        mesh->getIndices().size());
+  } else {
+    capture->recordDraw(mesh->getVAO(), 0, mesh->getPrimitiveType(),
+                        mesh->getNumVertices());
+  }
+}
+
 const kore::MeshComponent* kore::RenderMesh::getMesh() const {
     return _meshComponent;
 }
@@ -19,6 +19,7 @@
 
 #include "KoRE/Operations/UseFBO.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::UseFBO::UseFBO()
 : _frameBuffer(NULL),
@@ -70,6 +71,11 @@ bool kore::UseFBO::isValid(void) const {
   return _frameBuffer != NULL;
 }
 
+void kore::UseFBO::record(FrameCapture* capture) const {
+  capture->recordFramebufferBinding(_frameBufferTarget,
+                                    _frameBuffer->getHandle(), _drawBuffers);
+}
+
 bool kore::UseFBO::dependsOn(const void* thing) const {
   return thing == _frameBuffer;
 }
@@ -19,6 +19,7 @@
 
 #include "KoRE/Operations/UseShaderProgram.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::UseShaderProgram::UseShaderProgram()
   : _program(NULL), 
@@ -53,6 +54,10 @@ bool kore::UseShaderProgram::isValid(void) const {
   return _program != NULL;
 }
 
+void kore::UseShaderProgram::record(FrameCapture* capture) const {
+  capture->recordUseProgram(_program->getProgramLocation());
+}
+
 bool kore::UseShaderProgram::dependsOn(const void* thing) const {
   return _program == thing;
 }
@@ -33,6 +33,7 @@ namespace kore {
 
     virtual void update(void);
     virtual void reset(void);
+    virtual void record(FrameCapture* capture) const;
     virtual bool isValid(void) const;
     virtual bool dependsOn(const void* thing) const;
 
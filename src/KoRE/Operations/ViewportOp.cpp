@@ -22,6 +22,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/Log.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/FrameCapture.h"
 
 kore::ViewportOp::ViewportOp()
   : _viewport(0, 0, 0, 0),
@@ -57,6 +58,11 @@ bool kore::ViewportOp::dependsOn(const void* thing) const {
   return false;
 }
 
+void kore::ViewportOp::record(FrameCapture* capture) const {
+  capture->recordViewport(_viewport.x, _viewport.y,
+                          _viewport.z, _viewport.w);
+}
+
 bool kore::ViewportOp::isValid(void) const {
   return true;
 }
@@ -18,10 +18,101 @@
 */
 
 #include "KoRE/Optimization/Optimizer.h"
+#include "KoRE/Operations/MemoryBarrierOp.h"
+#include "KoRE/Operations/ProfileMarkerOp.h"
 
-kore::Optimizer::Optimizer() {
+kore::Optimizer::Optimizer()
+  : _numMarkers(0) {
 }
 
 kore::Optimizer::~Optimizer() {
+  for (uint i = 0; i < _barrierOps.size(); ++i) {
+    KORE_SAFE_DELETE(_barrierOps[i]);
+  }
+  _barrierOps.clear();
+  for (uint i = 0; i < _markerOps.size(); ++i) {
+    KORE_SAFE_DELETE(_markerOps[i]);
+  }
+  _markerOps.clear();
 }
 
+const kore::Operation*
+  kore::Optimizer::getProfileMarker(const StringID name,
+                                    const bool begin,
+                                    const uint scopes) const {
+  if (_numMarkers == _markerOps.size()) {
+    _markerOps.push_back(new ProfileMarkerOp());
+  }
+  ProfileMarkerOp* marker = _markerOps[_numMarkers++];
+  marker->connect(name, begin, scopes);
+  return marker;
+}
+
+void kore::Optimizer::resetProfileMarkers(void) const {
+  _numMarkers = 0;
+}
+
+void kore::Optimizer::
+  insertMemoryBarriers(std::list<const Operation*>& operationList) const {
+  uint numBarriers = 0;
+  _pendingWrites.clear();
+
+  // Pending writes keep the barrier bits already issued after them in
+  // barrierBits. A later consumer only needs the bits that are missing, and
+  // a write is only retired once every kind of consumer is covered.
+  for (auto it = operationList.begin(); it != operationList.end(); ++it) {
+    _reads.clear();
+    _writes.clear();
+    (*it)->getResourceAccesses(_reads, _writes);
+
+    GLbitfield barrierBits = 0;
+    for (uint iRead = 0; iRead < _reads.size(); ++iRead) {
+      for (uint iWrite = 0; iWrite < _pendingWrites.size(); ++iWrite) {
+        const SResourceAccess& write = _pendingWrites[iWrite];
+        if (write.type == _reads[iRead].type
+            && write.handle == _reads[iRead].handle) {
+          barrierBits |= _reads[iRead].barrierBits & ~write.barrierBits;
+        }
+      }
+    }
+
+    if (barrierBits != 0) {
+      if (numBarriers == _barrierOps.size()) {
+        _barrierOps.push_back(new MemoryBarrierOp());
+      }
+      MemoryBarrierOp* barrier = _barrierOps[numBarriers++];
+      barrier->connect(barrierBits);
+      operationList.insert(it, barrier);
+
+      // A barrier orders all earlier writes, not only those it was
+      // inserted for.
+      for (uint iWrite = 0; iWrite < _pendingWrites.size(); ) {
+        _pendingWrites[iWrite].barrierBits |= barrierBits;
+        if (_pendingWrites[iWrite].barrierBits == GL_ALL_BARRIER_BITS) {
+          _pendingWrites[iWrite] = _pendingWrites.back();
+          _pendingWrites.pop_back();
+        } else {
+          ++iWrite;
+        }
+      }
+    }
+
+    // A new write to a resource replaces its pending write and needs all
+    // barriers again.
+    for (uint iNew = 0; iNew < _writes.size(); ++iNew) {
+      const SResourceAccess write(_writes[iNew].type, _writes[iNew].handle);
+      bool replaced = false;
+      for (uint iWrite = 0; iWrite < _pendingWrites.size(); ++iWrite) {
+        if (_pendingWrites[iWrite].type == write.type
+            && _pendingWrites[iWrite].handle == write.handle) {
+          _pendingWrites[iWrite] = write;
+          replaced = true;
+          break;
+        }
+      }
+      if (!replaced) {
+        _pendingWrites.push_back(write);
+      }
+    }
+  }
+}
@@ -23,10 +23,13 @@
 #include <list>
 
 #include "KoRE/Common.h"
+#include "KoRE/StringTable.h"
 #include "KoRE/Operations/Operation.h"
+#include "KoRE/Operations/ProfileMarkerOp.h"
 #include "KoRE/Passes/FrameBufferStage.h"
 
 namespace kore {
+  class MemoryBarrierOp;
   class Optimizer {
     public: 
       Optimizer();
@@ -41,6 +44,35 @@ namespace kore {
       */
       virtual void optimize(const std::vector<FrameBufferStage*>& stages,
                             std::list<const Operation*>& operationList) const = 0;
+
+    protected:
+      /*! \brief Inserts a MemoryBarrierOp before every operation that
+      *          reads a resource which an earlier operation in the list
+      *          declared as written (see Operation::getResourceAccesses).
+      *          The barrier bits are taken from the declared reads. Each
+      *          consumer of a write only gets the bits that no earlier
+      *          barrier after the write has issued yet.
+      *          The inserted operations are owned by the optimizer and
+      *          reused in the next frame. */
+      void insertMemoryBarriers(
+        std::list<const Operation*>& operationList) const;
+
+      /*! \brief Returns a pooled marker operation that opens (begin) or
+      *          closes a Profiler scope and/or a KHR_debug group (see
+      *          EMarkerScope). The pool is reused after
+      *          resetProfileMarkers(). */
+      const Operation* getProfileMarker(
+        const StringID name, const bool begin,
+        const uint scopes = MARKER_PROFILE) const;
+      void resetProfileMarkers(void) const;
+
+    private:
+      mutable std::vector<MemoryBarrierOp*> _barrierOps;
+      mutable std::vector<ProfileMarkerOp*> _markerOps;
+      mutable uint _numMarkers;
+      mutable std::vector<SResourceAccess> _pendingWrites;
+      mutable std::vector<SResourceAccess> _reads;
+      mutable std::vector<SResourceAccess> _writes;
   };
 }
 
@@ -18,6 +18,9 @@
 */
 
 #include "KoRE/Optimization/SimpleOptimizer.h"
+#include "KoRE/Profiler.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/SceneNode.h"
 
 kore::SimpleOptimizer::SimpleOptimizer() {
 }
@@ -38,6 +41,19 @@ void kore::SimpleOptimizer::
      return;
   } */
   operationList.clear();
+  resetProfileMarkers();
+
+  // Profiler scopes mirror the stage/program/node hierarchy. Stages and
+  // program passes are also wrapped into KHR_debug groups, so graphics
+  // debuggers show the structure of the frame.
+  // Node names are interned by the nodes, there are too many to intern
+  // them every frame.
+  StringTable* strTable = StringTable::getInstance();
+  static const StringID nodePassID = strTable->intern("NodePass");
+  const bool profiling = Profiler::getInstance()->isEnabled();
+  const uint passScopes =
+    (profiling ? MARKER_PROFILE : 0)
+    | (GLerror::areDebugAnnotationsEnabled() ? MARKER_DEBUG_GROUP : 0);
 
   for (uint iFBO = 0; iFBO < stages.size(); ++iFBO) {
     if (stages[iFBO]->getExecutionType() == EXECUTE_ONCE && stages[iFBO]->getExecuted()) {
@@ -46,6 +62,13 @@ void kore::SimpleOptimizer::
 
     stages[iFBO]->setExecuted(true);
 
+    if (passScopes != 0) {
+      const FrameBuffer* fbo = stages[iFBO]->getFrameBuffer();
+      operationList.push_back(getProfileMarker(
+        strTable->intern(fbo ? fbo->getName() : "FrameBufferStage"), true,
+        passScopes));
+    }
+
     // FBO stage internal startup
     const std::vector<Operation*>& fboInternalStartupOps =
       stages[iFBO]->getInternalStartupOperations();
@@ -69,6 +92,12 @@ void kore::SimpleOptimizer::
 
       programPasses[iProgram]->setExecuted(true);
 
+      if (passScopes != 0) {
+        operationList.push_back(getProfileMarker(
+          strTable->intern(programPasses[iProgram]->getName()), true,
+          passScopes));
+      }
+
       // Program pass internal startup
       const std::vector<Operation*>& programInternalStartupOps =
         programPasses[iProgram]->getInternalStartupOperations();
@@ -87,14 +116,26 @@ void kore::SimpleOptimizer::
       const std::vector<NodePass*>& nodePasses =
         programPasses[iProgram]->getNodePasses();
 
+      programPasses[iProgram]->cullNodePasses();
+
       for (uint iNode = 0; iNode < nodePasses.size(); ++iNode) {
         if (nodePasses[iNode]->getExecutionType() == EXECUTE_ONCE
           && nodePasses[iNode]->getExecuted()) {
             continue;
         }
 
+        if (!programPasses[iProgram]->isNodePassVisible(iNode)) {
+          continue;
+        }
+
         nodePasses[iNode]->setExecuted(true);
 
+        if (profiling) {
+          const SceneNode* node = nodePasses[iNode]->getSceneNode();
+          operationList.push_back(getProfileMarker(
+            node ? node->getNameID() : nodePassID, true));
+        }
+
         // Node pass startup
         const std::vector<Operation*>& nodeStartupOps =
           nodePasses[iNode]->getStartupOperations();
@@ -121,6 +162,11 @@ void kore::SimpleOptimizer::
         for (uint iFinishOp = 0; iFinishOp < nodeFinishOps.size(); ++iFinishOp) {
           operationList.push_back(nodeFinishOps[iFinishOp]);
         }
+
+        if (profiling) {
+          operationList.push_back(getProfileMarker(KORE_STRINGID_INVALID,
+                                                   false));
+        }
       }  // Node Passes
       // Program pass finish
       const std::vector<Operation*>& programFinishOps =
@@ -134,6 +180,11 @@ void kore::SimpleOptimizer::
       for (uint iFinishOp = 0; iFinishOp < programInternalFinishOps.size(); ++iFinishOp) {
         operationList.push_back(programInternalFinishOps[iFinishOp]);
       }
+
+      if (passScopes != 0) {
+        operationList.push_back(getProfileMarker(KORE_STRINGID_INVALID,
+                                                 false, passScopes));
+      }
     }  // Program Passes
     // FBO stage finish
     const std::vector<Operation*>& fboFinishOps =
@@ -147,6 +198,13 @@ void kore::SimpleOptimizer::
     for (uint iFinishOp = 0; iFinishOp < fboInternalFinishOps.size(); ++iFinishOp) {
       operationList.push_back(fboInternalFinishOps[iFinishOp]);
     }
+
+    if (passScopes != 0) {
+      operationList.push_back(getProfileMarker(KORE_STRINGID_INVALID, false,
+                                               passScopes));
+    }
   }  // FrameBuffer passes
+
+  insertMemoryBarriers(operationList);
 }
 
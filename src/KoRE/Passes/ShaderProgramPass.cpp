@@ -20,6 +20,7 @@
 #include "KoRE/Passes/ShaderProgrampass.h"
 #include "KoRE/Operations/UseShaderProgram.h"
 #include "KoRE/Log.h"
+#include "KoRE/SceneManager.h"
 #include "../GPUtimer.h"
 #include "../Operations/FunctionOp.h"
 
@@ -28,8 +29,10 @@ kore::ShaderProgramPass::ShaderProgramPass(void)
   : _program(NULL),
     _executionType(EXECUTE_REPEATING),
     _executed(false),
-    _timerQuery(0),
+    _timerScope(KORE_UINT_INVALID),
     _useGPUProfiling(false),
+    _cullingCamera(NULL),
+    _occlusionCuller(NULL),
     _name("UNNAMED PASS") {
 }
 
@@ -37,8 +40,10 @@ kore::ShaderProgramPass::ShaderProgramPass(ShaderProgram* prog)
   : _program(NULL),
     _executionType(EXECUTE_REPEATING),
     _executed(false),
-    _timerQuery(0),
+    _timerScope(KORE_UINT_INVALID),
     _useGPUProfiling(false),
+    _cullingCamera(NULL),
+    _occlusionCuller(NULL),
     _name("UNNAMED PASS") {
   setShaderProgram(prog);
 }
@@ -142,13 +147,76 @@ void kore::ShaderProgramPass::removeFinishOperation(Operation* op) {
 }
 
 void kore::ShaderProgramPass::startQuery() {
-  if (_timerQuery == 0) {
-    glGenQueries(1, &_timerQuery);
-  }
-
-  GPUtimer::getInstance()->startDurationQuery(this->_name, _timerQuery);
+  _timerScope = GPUtimer::getInstance()->startDurationQuery(_name);
 } 
 
 void kore::ShaderProgramPass::endQuery() {
-  GPUtimer::getInstance()->endDurationQuery(_timerQuery);
+  GPUtimer::getInstance()->endDurationQuery(_timerScope);
+  _timerScope = KORE_UINT_INVALID;
+}
+
+void kore::ShaderProgramPass::cullNodePasses() {
+  _cullingStats = SCullingStats();
+  if (_cullingCamera == NULL) {
+    return;
+  }
+
+  const uint numPasses = static_cast<uint>(_nodePasses.size());
+  _nodeVisibility.assign(numPasses, 1);
+  if (numPasses == 0) {
+    return;
+  }
+
+  // Nodes in the scene graph are looked up in the visibility computed from
+  // the BVH of the SceneManager. Detached nodes are tested directly.
+  // Nodes without bounds can't be culled.
+  const SFrustum frustum = _cullingCamera->getFrustumWS();
+  const std::vector<unsigned char>& sceneVisibility =
+    SceneManager::getInstance()->getFrustumVisibility(frustum);
+
+  _cullingBounds.clear();
+  _cullingPassIndices.clear();
+  for (uint i = 0; i < numPasses; ++i) {
+    const SceneNode* node = _nodePasses[i]->getSceneNode();
+    if (node == NULL || node->getWorldBounds().isEmpty()) {
+      continue;
+    }
+
+    ++_cullingStats.numTested;
+    const uint hierarchyIdx = node->getHierarchyIndex();
+    if (hierarchyIdx < sceneVisibility.size()) {
+      _nodeVisibility[i] = sceneVisibility[hierarchyIdx];
+    } else {
+      _cullingBounds.push_back(&node->getWorldBounds());
+      _cullingPassIndices.push_back(i);
+    }
+  }
+
+  if (!_cullingBounds.empty()) {
+    _cullingResults.resize(_cullingBounds.size());
+    _frustumCuller.cull(frustum, &_cullingBounds[0],
+                        static_cast<uint>(_cullingBounds.size()),
+                        &_cullingResults[0]);
+    for (uint i = 0; i < _cullingPassIndices.size(); ++i) {
+      _nodeVisibility[_cullingPassIndices[i]] = _cullingResults[i];
+    }
+  }
+
+  if (_occlusionCuller != NULL) {
+    for (uint i = 0; i < numPasses; ++i) {
+      const SceneNode* node = _nodePasses[i]->getSceneNode();
+      if (_nodeVisibility[i] == 0 || node == NULL) {
+        continue;
+      }
+      if (!_occlusionCuller->isVisible(node->getWorldBounds())) {
+        _nodeVisibility[i] = 0;
+        ++_cullingStats.numOccluded;
+      }
+    }
+  }
+
+  for (uint i = 0; i < numPasses; ++i) {
+    _cullingStats.numVisible += _nodeVisibility[i];
+  }
+  _cullingStats.numCulled = numPasses - _cullingStats.numVisible;
 }
@@ -24,6 +24,9 @@
 #include "KoRE/ShaderProgram.h"
 #include "KoRE/Passes/NodePass.h"
 #include "Kore/FrameBuffer.h"
+#include "KoRE/Components/Camera.h"
+#include "KoRE/Culling/FrustumCuller.h"
+#include "KoRE/Culling/OcclusionCuller.h"
 
 namespace kore {
   class ShaderProgramPass {
@@ -66,7 +69,36 @@ namespace kore {
     inline const std::string& getName() const {return _name;}
     inline std::string* getNamePtr() {return &_name;}
 
-    inline GLuint getTimerQueryObject() const {return _timerQuery;}
+    /*! \brief Enables frustum culling of the NodePasses against the
+    *          frustum of a camera. Pass NULL to disable culling. */
+    inline void setCullingCamera(const Camera* camera)
+      {_cullingCamera = camera;}
+    inline const Camera* getCullingCamera() const {return _cullingCamera;}
+
+    /*! \brief Additionally tests the NodePasses that survive frustum
+    *          culling against the depth buffer of an OcclusionCuller.
+    *          The culler has to be rendered from the culling camera before.
+    *          Pass NULL to disable occlusion culling. */
+    inline void setOcclusionCuller(const OcclusionCuller* culler)
+      {_occlusionCuller = culler;}
+    inline const OcclusionCuller* getOcclusionCuller() const
+      {return _occlusionCuller;}
+
+    /*! \brief Tests the world bounds of the nodes of all NodePasses against
+    *          the culling camera, using the BVH of the SceneManager.
+    *          NodePasses without a node or without bounds are always
+    *          visible. */
+    void cullNodePasses();
+
+    /*! \brief Returns true if the NodePass at the index survived the last
+    *          culling run. */
+    inline bool isNodePassVisible(const uint index) const {
+      return _cullingCamera == NULL || index >= _nodeVisibility.size()
+             || _nodeVisibility[index] != 0;
+    }
+
+    inline const SCullingStats& getCullingStats() const
+      {return _cullingStats;}
     
   protected:
     uint64 _id;
@@ -83,11 +115,20 @@ namespace kore {
 
     std::string _name;
     
-    GLuint _timerQuery;
+    uint _timerScope;  // Scope of the GPUtimer in the current frame
     void startQuery();
     void endQuery();
     bool _useGPUProfiling;
 
+    const Camera* _cullingCamera;
+    const OcclusionCuller* _occlusionCuller;
+    FrustumCuller _frustumCuller;
+    SCullingStats _cullingStats;
+    std::vector<unsigned char> _nodeVisibility;
+    std::vector<const SAABB*> _cullingBounds;
+    std::vector<uint> _cullingPassIndices;
+    std::vector<unsigned char> _cullingResults;
+
   };
 
 }
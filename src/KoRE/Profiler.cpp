@@ -0,0 +1,282 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include "KoRE/Profiler.h"
+#include "KoRE/Log.h"
+
+namespace {
+  const uint QUERY_BATCH_SIZE = 64;
+
+  std::string escapeJSON(const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (uint i = 0; i < str.size(); ++i) {
+      const char c = str[i];
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        result += ' ';
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+}
+
+kore::Profiler* kore::Profiler::getInstance(void) {
+  static Profiler instance;
+  return &instance;
+}
+
+kore::Profiler::Profiler(void)
+  : _enabled(false),
+    _frameActive(false),
+    _capturing(false),
+    _maxGPUDepth(4),
+    _frameIndex(0),
+    _gpuOffsetNS(0),
+    _hasGPUOffset(false) {
+  _frameName = StringTable::getInstance()->intern("Frame");
+}
+
+kore::Profiler::~Profiler(void) {
+  // The GL context may be gone at static destruction, so the query
+  // objects are left to it.
+}
+
+void kore::Profiler::setEnabled(const bool enabled) {
+  if (!enabled) {
+    endFrame();
+  }
+  _enabled = enabled;
+}
+
+GLuint64 kore::Profiler::getCPUTimeNS(void) {
+  // The steady clock never jumps, e.g. when the system time is adjusted.
+  return static_cast<GLuint64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void kore::Profiler::beginFrame(void) {
+  _frameActive = true;
+  _stack.clear();
+
+  SFrameSlot& slot = _slots[_frameIndex % FRAME_LATENCY];
+  if (slot.active) {
+    resolve(slot);
+  }
+
+  slot.active = true;
+  slot.frameIndex = _frameIndex;
+  slot.events.clear();
+  slot.numQueries = 0;
+
+  slot.startCPUNS = getCPUTimeNS();
+  slot.startQuery = issueQuery(slot);
+
+  beginScope(_frameName, true);
+}
+
+void kore::Profiler::endFrame(void) {
+  if (!_frameActive) {
+    return;
+  }
+
+  while (!_stack.empty()) {
+    endScope();
+  }
+  _frameActive = false;
+  ++_frameIndex;
+}
+
+uint kore::Profiler::issueQuery(SFrameSlot& slot) {
+  if (slot.numQueries == slot.queries.size()) {
+    const uint oldSize = static_cast<uint>(slot.queries.size());
+    slot.queries.resize(oldSize + QUERY_BATCH_SIZE);
+    glGenQueries(QUERY_BATCH_SIZE, &slot.queries[oldSize]);
+  }
+
+  glQueryCounter(slot.queries[slot.numQueries], GL_TIMESTAMP);
+  return slot.numQueries++;
+}
+
+void kore::Profiler::beginScope(const StringID name, const bool gpu) {
+  if (!_enabled) {
+    return;
+  }
+  if (!_frameActive) {
+    beginFrame();
+  }
+
+  SFrameSlot& slot = _slots[_frameIndex % FRAME_LATENCY];
+  SProfileEvent event;
+  event.name = name;
+  event.depth = static_cast<uint>(_stack.size());
+  event.frameIndex = _frameIndex;
+  event.cpuBeginNS = getCPUTimeNS();
+  event.cpuEndNS = event.cpuBeginNS;
+  event.gpuBeginNS = 0;
+  event.gpuEndNS = 0;
+  event.hasGPU = false;
+  event.gpuBeginQuery = KORE_UINT_INVALID;
+  event.gpuEndQuery = KORE_UINT_INVALID;
+  if (gpu && event.depth < _maxGPUDepth) {
+    event.gpuBeginQuery = issueQuery(slot);
+  }
+
+  _stack.push_back(static_cast<uint>(slot.events.size()));
+  slot.events.push_back(event);
+}
+
+void kore::Profiler::beginScope(const std::string& name, const bool gpu) {
+  if (_enabled) {
+    beginScope(StringTable::getInstance()->intern(name), gpu);
+  }
+}
+
+void kore::Profiler::endScope(void) {
+  if (!_enabled || _stack.empty()) {
+    return;
+  }
+
+  SFrameSlot& slot = _slots[_frameIndex % FRAME_LATENCY];
+  SProfileEvent& event = slot.events[_stack.back()];
+  _stack.pop_back();
+
+  if (event.gpuBeginQuery != KORE_UINT_INVALID) {
+    event.gpuEndQuery = issueQuery(slot);
+  }
+  event.cpuEndNS = getCPUTimeNS();
+}
+
+void kore::Profiler::resolve(SFrameSlot& slot) {
+  slot.active = false;
+
+  // Timestamps complete in order, so the last query tells whether the
+  // whole frame is available.
+  bool gpuAvailable = false;
+  if (slot.numQueries > 0) {
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.numQueries - 1],
+                       GL_QUERY_RESULT_AVAILABLE, &available);
+    gpuAvailable = available != 0;
+  }
+
+  if (gpuAvailable) {
+    GLuint64 start = 0;
+    glGetQueryObjectui64v(slot.queries[slot.startQuery], GL_QUERY_RESULT,
+                          &start);
+    const GLint64 offset =
+      static_cast<GLint64>(slot.startCPUNS) - static_cast<GLint64>(start);
+    if (!_hasGPUOffset || offset > _gpuOffsetNS) {
+      _gpuOffsetNS = offset;
+      _hasGPUOffset = true;
+    }
+  }
+
+  for (uint i = 0; i < slot.events.size(); ++i) {
+    SProfileEvent& event = slot.events[i];
+    if (!gpuAvailable || event.gpuBeginQuery == KORE_UINT_INVALID
+        || event.gpuEndQuery == KORE_UINT_INVALID) {
+      continue;
+    }
+
+    GLuint64 begin = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(slot.queries[event.gpuBeginQuery], GL_QUERY_RESULT,
+                          &begin);
+    glGetQueryObjectui64v(slot.queries[event.gpuEndQuery], GL_QUERY_RESULT,
+                          &end);
+    event.gpuBeginNS = static_cast<GLuint64>(begin + _gpuOffsetNS);
+    event.gpuEndNS = static_cast<GLuint64>(end + _gpuOffsetNS);
+    event.hasGPU = true;
+  }
+
+  _lastResolved = slot.events;
+  if (_capturing) {
+    _captured.insert(_captured.end(), slot.events.begin(), slot.events.end());
+  }
+}
+
+void kore::Profiler::startCapture(void) {
+  _captured.clear();
+  _capturing = true;
+}
+
+void kore::Profiler::stopCapture(void) {
+  _capturing = false;
+}
+
+bool kore::Profiler::writeChromeTrace(const std::string& file) const {
+  FILE* pFile = fopen(file.c_str(), "w");
+  if (pFile == NULL) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Could not write profiler trace %s\n",
+                   file.c_str());
+    return false;
+  }
+
+  GLuint64 baseNS = 0;
+  if (!_captured.empty()) {
+    baseNS = _captured[0].cpuBeginNS;
+  }
+
+  fprintf(pFile, "{\"traceEvents\":[\n");
+  fprintf(pFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+  fprintf(pFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+
+  const StringTable* strTable = StringTable::getInstance();
+  for (uint i = 0; i < _captured.size(); ++i) {
+    const SProfileEvent& event = _captured[i];
+    const std::string name = escapeJSON(strTable->getString(event.name));
+    const unsigned long long frame =
+      static_cast<unsigned long long>(event.frameIndex);
+
+    // trace_event timestamps are in microseconds
+    fprintf(pFile, ",\n{\"name\":\"%s\",\"cat\":\"cpu\",\"ph\":\"X\","
+                   "\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,"
+                   "\"args\":{\"frame\":%llu}}",
+            name.c_str(),
+            static_cast<double>(event.cpuBeginNS - baseNS) / 1000.0,
+            static_cast<double>(event.cpuEndNS - event.cpuBeginNS) / 1000.0,
+            frame);
+
+    if (event.hasGPU) {
+      fprintf(pFile, ",\n{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\","
+                     "\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"args\":{\"frame\":%llu}}",
+              name.c_str(),
+              (static_cast<double>(event.gpuBeginNS)
+                - static_cast<double>(baseNS)) / 1000.0,
+              static_cast<double>(event.gpuEndNS - event.gpuBeginNS)
+                / 1000.0,
+              frame);
+    }
+  }
+
+  fprintf(pFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  fclose(pFile);
+  return true;
+}
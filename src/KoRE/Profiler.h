@@ -0,0 +1,168 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_PROFILER_H_
+#define KORE_SRC_KORE_PROFILER_H_
+
+#include <string>
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/StringTable.h"
+
+namespace kore {
+  /*! \brief One resolved scope of a profiled frame. Times are in
+  *          nanoseconds on the CPU clock; GPU timestamps are converted to
+  *          it with the offset estimated from the frame start queries. */
+  struct SProfileEvent {
+    StringID name;
+    uint depth;
+    GLuint64 frameIndex;
+    GLuint64 cpuBeginNS;
+    GLuint64 cpuEndNS;
+    GLuint64 gpuBeginNS;
+    GLuint64 gpuEndNS;
+    bool hasGPU;  // False if no queries were issued or they got lost
+
+    // Internal: query indices of the frame slot
+    uint gpuBeginQuery;
+    uint gpuEndQuery;
+  };
+
+  /*! \brief Hierarchical CPU/GPU frame profiler.
+  *   Scopes are nested; each scope records CPU times and, up to a maximum
+  *   depth, GPU timestamp queries. The optimizer wraps FrameBufferStages,
+  *   ShaderProgramPasses and NodePasses into scopes when the profiler is
+  *   enabled.
+  *   The queries of a frame are resolved FRAME_LATENCY frames later, when
+  *   the slot is reused. If the GPU is still not done then, the GPU times
+  *   of that frame are dropped instead of waiting.
+  *   Every frame starts with a timestamp query, paired with the CPU time it
+  *   was issued at. A query can't execute before it is issued, so each
+  *   resolved pair bounds the offset between the clocks from below. The
+  *   largest bound so far converts GPU to CPU times, without querying the
+  *   GL clock synchronously.
+  *   A frame begins with the first scope after endFrame(), which the
+  *   RenderManager calls at the end of renderFrame().
+  */
+  class Profiler {
+  public:
+    static const uint FRAME_LATENCY = 4;
+
+    static Profiler* getInstance(void);
+    ~Profiler(void);
+
+    void setEnabled(const bool enabled);
+    inline bool isEnabled(void) const {return _enabled;}
+
+    /*! \brief Scopes at this depth and deeper are measured on the CPU
+    *          only. The frame scope has depth 0. */
+    inline void setMaxGPUDepth(const uint depth) {_maxGPUDepth = depth;}
+    inline uint getMaxGPUDepth(void) const {return _maxGPUDepth;}
+
+    void beginScope(const StringID name, const bool gpu = true);
+    void beginScope(const std::string& name, const bool gpu = true);
+    void endScope(void);
+    void endFrame(void);
+
+    /*! \brief Collects all resolved frames until stopCapture(). */
+    void startCapture(void);
+    void stopCapture(void);
+    inline bool isCapturing(void) const {return _capturing;}
+
+    /*! \brief Writes the captured frames as Chrome trace_event JSON
+    *          (load in chrome://tracing or Perfetto). CPU scopes are on
+    *          thread 1, GPU scopes on thread 2. */
+    bool writeChromeTrace(const std::string& file) const;
+
+    /// The events of the most recently resolved frame
+    inline const std::vector<SProfileEvent>& getLastResolvedFrame() const
+      {return _lastResolved;}
+
+  private:
+    struct SFrameSlot {
+      SFrameSlot(void)
+        : active(false),
+          frameIndex(0),
+          numQueries(0),
+          startQuery(KORE_UINT_INVALID),
+          startCPUNS(0) {
+      }
+
+      bool active;
+      GLuint64 frameIndex;
+      std::vector<SProfileEvent> events;
+      std::vector<GLuint> queries;
+      uint numQueries;
+      uint startQuery;       // timestamp query issued at the frame start
+      GLuint64 startCPUNS;   // cpu time the start query was issued at
+    };
+
+    Profiler(void);
+
+    void beginFrame(void);
+    void resolve(SFrameSlot& slot);
+    uint issueQuery(SFrameSlot& slot);
+    static GLuint64 getCPUTimeNS(void);
+
+    bool _enabled;
+    bool _frameActive;
+    bool _capturing;
+    uint _maxGPUDepth;
+    GLuint64 _frameIndex;
+    StringID _frameName;
+    GLint64 _gpuOffsetNS;  // cpu time - gpu time
+    bool _hasGPUOffset;
+    SFrameSlot _slots[FRAME_LATENCY];
+    std::vector<uint> _stack;  // indices of the open events
+    std::vector<SProfileEvent> _lastResolved;
+    std::vector<SProfileEvent> _captured;
+  };
+
+  /*! \brief Opens a profiler scope for the lifetime of the object. */
+  class ProfileScope {
+  public:
+    explicit ProfileScope(const StringID name, const bool gpu = false)
+      : _active(Profiler::getInstance()->isEnabled()) {
+      if (_active) {
+        Profiler::getInstance()->beginScope(name, gpu);
+      }
+    }
+
+    ~ProfileScope(void) {
+      if (_active) {
+        Profiler::getInstance()->endScope();
+      }
+    }
+
+  private:
+    bool _active;
+  };
+};
+
+#define KORE_PROFILE_CONCAT_(a, b) a##b
+#define KORE_PROFILE_CONCAT(a, b) KORE_PROFILE_CONCAT_(a, b)
+
+/// Profiles the rest of the enclosing block on the CPU.
+#define KORE_PROFILE_SCOPE(name) \
+  static const kore::StringID KORE_PROFILE_CONCAT(_koreProfileID, __LINE__) \
+    = kore::StringTable::getInstance()->intern(name); \
+  kore::ProfileScope KORE_PROFILE_CONCAT(_koreProfileScope, __LINE__)( \
+    KORE_PROFILE_CONCAT(_koreProfileID, __LINE__))
+
+#endif  // KORE_SRC_KORE_PROFILER_H_
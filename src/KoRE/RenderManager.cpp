@@ -24,6 +24,8 @@
 #include "KoRE/Log.h"
 #include "KoRE/GLerror.h"
 #include "KoRE/Optimization/SimpleOptimizer.h"
+#include "KoRE/Profiler.h"
+#include "KoRE/FrameCapture.h"
 
 kore::RenderManager* kore::RenderManager::getInstance(void) {
   static kore::RenderManager theInstance;
@@ -40,7 +42,10 @@ kore::RenderManager::RenderManager(void)
     _activeTextureUnitIndex(0),
     _screenRes(0,0),
     _shaderProgram(KORE_GLUINT_HANDLE_INVALID),
-    _useGPUprofiling(false) {
+    _useGPUprofiling(false),
+    _uniformStreamFrameSize(KORE_UNIFORM_STREAM_FRAME_SIZE) {
+  _optimizeSection = _frameTimer.getSectionID("RenderManager::optimize");
+  _executeSection = _frameTimer.getSectionID("RenderManager::execute");
 
   //sync internal states with opengl-states:
   
@@ -72,13 +77,13 @@ kore::RenderManager::RenderManager(void)
                                                 TextureTargets::TEXTURE_2D_MULTISAMPLE_ARRAY;
 
   if (_vTexTargetMap.size() != TextureTargets::NUM_TEXTURE_TARGETS) {
-    Log::getInstance()->write("[ERROR] Not all texture targets where"
-                              " added into the textureTargetMap");
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Not all texture targets where"
+                   " added into the textureTargetMap");
   }
 
   if (_vBufferTargetMap.size() != BufferTargets::NUM_BUFFER_TARGETS) {
-    Log::getInstance()->write("[ERROR] Not all buffer targets where"
-                              " added into the bufferTargetMap");
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "Not all buffer targets where"
+                   " added into the bufferTargetMap");
   }
 
   memset(_boundTextures, 0, sizeof(GLuint) *
@@ -99,6 +104,12 @@ kore::RenderManager::RenderManager(void)
   memset(_boundAtomicBuffers, 0, sizeof(GLuint) *
                                  GL_MAX_COMBINED_ATOMIC_COUNTERS);
 
+  memset(_boundUniformBuffers, 0, sizeof(SBufferRange) *
+                                  KORE_MAX_UNIFORM_BUFFER_BINDINGS);
+
+  memset(_boundShaderStorageBuffers, 0, sizeof(SBufferRange) *
+                                 KORE_MAX_SHADER_STORAGE_BUFFER_BINDINGS);
+
   activeTexture(0);  // Activate texture unit 0 by default
 
   _shdScreenRes.data = &_screenRes;
@@ -138,13 +149,53 @@ void kore::RenderManager::renderFrame(void) {
     setOptimizer(new SimpleOptimizer);
   }
 
-  // For now, just optimize every frame... later do this only on changes
-  // in operations.
-  _optimizer->optimize(_frameBufferStages, _operations);
+  Profiler* profiler = Profiler::getInstance();
+  {
+    // For now, just optimize every frame... later do this only on changes
+    // in operations.
+    KORE_PROFILE_SCOPE("RenderManager::optimize");
+    _frameTimer.beginSection(_optimizeSection);
+    _optimizer->optimize(_frameBufferStages, _operations);
+    _frameTimer.endSection(_optimizeSection);
+  }
+
+  _uniformStream.beginFrame();
+  FrameCapture* capture = FrameCapture::getInstance();
+  capture->beginFrame();
+
+  if (profiler->isEnabled()) {
+    static const StringID executeName =
+      StringTable::getInstance()->intern("RenderManager::execute");
+    profiler->beginScope(executeName, true);
+  }
+  _frameTimer.beginSection(_executeSection);
 
     for (auto it = _operations.begin(); it != _operations.end(); ++it) {
         (*it)->execute();
     }
+
+  _frameTimer.endSection(_executeSection);
+  profiler->endScope();
+  capture->endFrame();
+  _uniformStream.endFrame();
+  GPUtimer::getInstance()->endFrame();
+  profiler->endFrame();
+  _frameTimer.endFrame();
+}
+
+kore::StreamingBuffer* kore::RenderManager::getUniformStream() {
+  if (!_uniformStream.isCreated()) {
+    _uniformStream.create(GL_UNIFORM_BUFFER, _uniformStreamFrameSize);
+  }
+  return &_uniformStream;
+}
+
+void kore::RenderManager::
+  setUniformStreamFrameSize(const GLsizeiptr frameSize) {
+  _uniformStreamFrameSize = frameSize;
+  if (_uniformStream.isCreated()) {
+    _uniformStream.create(GL_UNIFORM_BUFFER, _uniformStreamFrameSize);
+  }
 }
 
 void kore::RenderManager::resolutionChanged() {
@@ -350,8 +401,8 @@ void kore::RenderManager::bindBuffer(const GLenum bufferTarget,
   auto buf = _vBufferTargetMap.find(bufferTarget);
   
   if (buf == _vBufferTargetMap.end()) {
-    Log::getInstance()->write("[ERROR] RenderManager::bindbuffer(): "
-                              "Buffer-target is invalid");
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "RenderManager::bindbuffer(): "
+                   "Buffer-target is invalid");
     return;
   }
 
@@ -374,16 +425,73 @@ void kore::RenderManager::bindBufferBase(const GLenum indexedBufferTarget,
       }
     break;
 
-    // TODO(dlazarek): Implement for GL_UNIFORM_BUFFER,
-    //                               GL_TRANSFORM_FEEDBACK_BUFFER, etc...
+    case GL_UNIFORM_BUFFER:
+    case GL_SHADER_STORAGE_BUFFER:
+      bindBufferRange(indexedBufferTarget, bindingPoint, bufferHandle, 0, 0);
+    break;
+
+    // TODO(dlazarek): Implement for GL_TRANSFORM_FEEDBACK_BUFFER, etc...
 
     default:
-      Log::getInstance()->write("[ERROR] RenderManager::bindBufferBase - "
-        "The requested indexedBufferTarget is not implemented or is invalid");
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "RenderManager::bindBufferBase - "
+                     "The requested indexedBufferTarget is not "
+                     "implemented or is invalid");
     break;
   }
 }
 
+void kore::RenderManager::bindBufferRange(const GLenum indexedBufferTarget,
+                                          const uint bindingPoint,
+                                          const GLuint bufferHandle,
+                                          const GLintptr offset,
+                                          const GLsizeiptr size) {
+  SBufferRange* boundRanges = NULL;
+  uint numBindings = 0;
+  switch (indexedBufferTarget) {
+    case GL_UNIFORM_BUFFER:
+      boundRanges = _boundUniformBuffers;
+      numBindings = KORE_MAX_UNIFORM_BUFFER_BINDINGS;
+    break;
+
+    case GL_SHADER_STORAGE_BUFFER:
+      boundRanges = _boundShaderStorageBuffers;
+      numBindings = KORE_MAX_SHADER_STORAGE_BUFFER_BINDINGS;
+    break;
+
+    default:
+      KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "RenderManager::bindBufferRange - "
+                     "The requested indexedBufferTarget is not "
+                     "implemented or is invalid");
+    return;
+  }
+
+  if (bindingPoint >= numBindings) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "RenderManager::bindBufferRange - "
+                   "binding point %u is out of range\n",
+                   bindingPoint);
+    return;
+  }
+
+  SBufferRange& range = boundRanges[bindingPoint];
+  if (range.handle == bufferHandle
+      && range.offset == offset
+      && range.size == size) {
+    return;
+  }
+
+  range.handle = bufferHandle;
+  range.offset = offset;
+  range.size = size;
+  if (size == 0) {
+    glBindBufferBase(indexedBufferTarget, bindingPoint, bufferHandle);
+  } else {
+    glBindBufferRange(indexedBufferTarget, bindingPoint, bufferHandle,
+                      offset, size);
+  }
+  // Indexed binding also changes the generic binding point.
+  _boundBuffers[_vBufferTargetMap[indexedBufferTarget]] = bufferHandle;
+}
+
 void kore::RenderManager::setColorMask(bool red,
                                        bool green,
                                        bool blue,
@@ -29,6 +29,8 @@
 #include "KoRE/Passes/FrameBufferStage.h"
 #include "KoRE/Optimization/Optimizer.h"
 #include "KoRE/GPUtimer.h"
+#include "KoRE/StreamingBuffer.h"
+#include "KoRE/FrameTimer.h"
 
 namespace kore {
   enum EOpInsertPos {
@@ -151,6 +153,12 @@ namespace kore {
                         const uint bindingPoint,
                         const GLuint bufferHandle);
 
+    void bindBufferRange(const GLenum indexedBufferTarget,
+                         const uint bindingPoint,
+                         const GLuint bufferHandle,
+                         const GLintptr offset,
+                         const GLsizeiptr size);
+
    /* void removeOperation(const Operation* operation);
     void removeShaderProgramPass(const ShaderProgramPass* progPass);
     void removeNodePass(const NodePass* nodePass);
@@ -173,6 +181,21 @@ namespace kore {
       return _useGPUprofiling;
     }
 
+    /*! \brief Returns the triple-buffered ring-buffer for per-draw uniform
+    *          data. It is created on first use and advanced once per
+    *          renderFrame(). */
+    StreamingBuffer* getUniformStream();
+
+    /*! \brief Sets the number of bytes available per frame in the uniform
+    *          stream. Recreates the stream if it already exists. */
+    void setUniformStreamFrameSize(const GLsizeiptr frameSize);
+
+    /*! \brief Returns the wall-clock frame timer. Every renderFrame() ends
+    *          a frame and records the sections "RenderManager::optimize"
+    *          and "RenderManager::execute". */
+    inline const FrameTimer& getFrameTimer() const {return _frameTimer;}
+    inline FrameTimer& getFrameTimer() {return _frameTimer;}
+
   private:
     RenderManager(void);
     
@@ -193,6 +216,14 @@ namespace kore {
     GLuint _ibo;
     GLuint _shaderProgram;
     GLuint _boundAtomicBuffers[GL_MAX_COMBINED_ATOMIC_COUNTER_BUFFERS];
+    struct SBufferRange {
+      GLuint handle;
+      GLintptr offset;
+      GLsizeiptr size;  // 0 for the whole buffer (glBindBufferBase)
+    };
+    SBufferRange _boundUniformBuffers[KORE_MAX_UNIFORM_BUFFER_BINDINGS];
+    SBufferRange
+      _boundShaderStorageBuffers[KORE_MAX_SHADER_STORAGE_BUFFER_BINDINGS];
     GLuint _boundTextures[GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS]
                          [TextureTargets::NUM_TEXTURE_TARGETS];
     GLuint _boundSamplers[GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS];
@@ -208,6 +239,13 @@ namespace kore {
     kore::ShaderData _shdScreenRes;
 
     bool _useGPUprofiling;
+
+    StreamingBuffer _uniformStream;
+    GLsizeiptr _uniformStreamFrameSize;
+
+    FrameTimer _frameTimer;
+    uint _optimizeSection;
+    uint _executeSection;
     //////////////////////////////////////////////////////////////////////////
   };
 };
@@ -32,80 +32,69 @@
 
 const std::string kore::ResourceManager::RESOURCE_PATH_INTERNAL("INTERNAL");
 
+namespace {
+  template <typename T>
+  void deleteAll(kore::HandleTable<T>& table) {
+    const std::vector<T*>& resources = table.getResources();
+    for (uint i = 0; i < resources.size(); ++i) {
+      delete resources[i];
+    }
+    table.clear();
+  }
+}
+
 kore::ResourceManager* kore::ResourceManager::getInstance(void) {
   static kore::ResourceManager theInstance;
   return &theInstance;
 }
 
 kore::ResourceManager::ResourceManager(void) {
+  _gpuMemory.setOwner(RESOURCE_PATH_INTERNAL);
 }
 
 kore::ResourceManager::~ResourceManager(void) {
-  // Delete all shaders. 
-  for (auto it = _shaders.begin(); it != _shaders.end(); ++it) {
-    delete it->second;
-  }
-  _shaders.clear();
+  // Delete all shaders.
+  deleteAll(_shaders);
 
   // Delete textures.
-  for (auto itPath = _textures.begin(); itPath != _textures.end(); ++itPath) {
-    delete itPath->second;
-  }
-  _textures.clear();
-  
+  deleteAll(_textures);
+
   // Delete shaderPrograms.
-  for (auto it2 = _shaderPrograms.begin();
-            it2 != _shaderPrograms.end();
-            ++it2) {
-    delete it2->second;
-  }
-  _shaderPrograms.clear();
+  deleteAll(_shaderPrograms);
 
   // Delete all texture samplers.
-  for (uint i = 0; i < _textureSamplers.size(); ++i) {
-    KORE_SAFE_DELETE(_textureSamplers[i]);
+  for (auto it = _textureSamplers.begin();
+       it != _textureSamplers.end(); ++it) {
+    KORE_SAFE_DELETE(it->second.sampler);
   }
   _textureSamplers.clear();
 
   // Delete all mesh resources and entries.
-  for (auto it = _meshes.begin(); it != _meshes.end(); ++it) {
-    Mesh* mesh = it->second;
-    delete mesh;
-  }
-  _meshes.clear();
-    
-  // Delete Framebuffers.
-  for (auto it = _frameBuffers.begin(); it != _frameBuffers.end(); ++it) {
-    delete it->second;
-  }
-
-  _frameBuffers.clear();
-  
-  // Delete Texture samplers
-  for (uint i = 0; i < _textureSamplers.size(); ++i) {
-    KORE_SAFE_DELETE(_textureSamplers[i]);
-  }
+  deleteAll(_meshes);
 
-  _textureSamplers.clear();
+  // Delete Framebuffers.
+  deleteAll(_frameBuffers);
 
   // Delete Materials
-  for(auto it = _materials.begin(); it != _materials.end(); ++it) {
-    delete it->second;
-  }
+  deleteAll(_materials);
 
   // Delete IndexedBuffers
-  for (auto it = _indexedBuffers.begin(); it != _indexedBuffers.end(); ++it) {
-    delete it->second;
-  }
+  deleteAll(_indexedBuffers);
 }
 
 void kore::ResourceManager::loadScene(const std::string& filename,
                                       kore::SceneNode* parent) {
+  const std::string prevOwner = _gpuMemory.getOwner();
+  _gpuMemory.setOwner(filename);
   kore::SceneLoader::getInstance()->loadScene(filename, parent);
+  _gpuMemory.setOwner(prevOwner);
 }
 
 void kore::ResourceManager::loadResources(const std::string& filename) {
+  const std::string prevOwner = _gpuMemory.getOwner();
+  _gpuMemory.setOwner(filename);
   kore::SceneLoader::getInstance()->loadResources(filename);
+  _gpuMemory.setOwner(prevOwner);
 }
 
 void kore::ResourceManager::saveProject(const std::string& filename) {
@@ -122,80 +111,88 @@ kore::Texture*
 }
 
 void kore::ResourceManager::addMesh(kore::Mesh* mesh) {
-  if (_meshes.count(mesh->getID())) {
-    return;
-  }
-
-  _meshes[mesh->getID()] = mesh;
+  _meshes.insert(mesh->getID(), mesh);
 }
 
 
 void kore::ResourceManager::addTexture(kore::Texture* texture) {
-  if (_textures.count(texture->getID())) {
-    return;
-  }
-
-  _textures[texture->getID()] = texture;
+  _textures.insert(texture->getID(), texture);
 }
 
 void kore::ResourceManager::addShaderProgram(ShaderProgram* program) {
-  if(_shaderPrograms.count(program->getID())) {
-    kore::Log::getInstance()
-      ->write("[ERROR] ShaderProgram '%s' already in RenderManager\n",
-              program->getName().c_str());
+  if(_shaderPrograms.contains(program->getID())) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   "ShaderProgram '%s' already in RenderManager\n",
+                   program->getName().c_str());
     return;
   }
-  _shaderPrograms[program->getID()] = program;
+  _shaderPrograms.insert(program->getID(), program);
 }
 
 kore::ShaderProgram* kore::ResourceManager
   ::getShaderProgram(const uint64 id) const {
-    if (_shaderPrograms.count(id)) {
-      return _shaderPrograms.find(id)->second;
-    }
-    return NULL;
+    return _shaderPrograms.getByID(id);
+}
+
+kore::ShaderProgram* kore::ResourceManager
+  ::getShaderProgram(const ResourceHandle& handle) const {
+    return _shaderPrograms.get(handle);
+}
+
+kore::ResourceHandle kore::ResourceManager
+  ::getShaderProgramHandle(const uint64 id) const {
+    return _shaderPrograms.getHandle(id);
 }
 
 kore::Mesh* kore::ResourceManager::getMesh(const uint64 id) {
-  if (!(_meshes.count(id))) {
-    return NULL;
-  }
+  return _meshes.getByID(id);
+}
 
-  return _meshes[id];
+kore::Mesh* kore::ResourceManager::getMesh(const ResourceHandle& handle) const {
+  return _meshes.get(handle);
+}
+
+kore::ResourceHandle
+  kore::ResourceManager::getMeshHandle(const uint64 id) const {
+  return _meshes.getHandle(id);
 }
 
 kore::Texture* kore::ResourceManager::getTexture(const uint64 id) {
-  if (!_textures.count(id)) {
-    return NULL;
-  }
-  return _textures[id];
+  return _textures.getByID(id);
+}
+
+kore::Texture*
+  kore::ResourceManager::getTexture(const ResourceHandle& handle) const {
+  return _textures.get(handle);
+}
+
+kore::ResourceHandle
+  kore::ResourceManager::getTextureHandle(const uint64 id) const {
+  return _textures.getHandle(id);
 }
 
 kore::Shader* kore::ResourceManager::getShader(const uint64 id) {
-  if (_shaders.count(id) == 0) {
-    return NULL;
-  }
-  return _shaders[id];
+  return _shaders.getByID(id);
 }
 
 void kore::ResourceManager::addShader(kore::Shader* shader) {
-  if(_shaders.count(shader->getID())) {
-    kore::Log::getInstance()
-      ->write("[ERROR] Shader '%s' already in RenderManager\n",
-      shader->getName().c_str());
+  if(_shaders.contains(shader->getID())) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   "Shader '%s' already in RenderManager\n",
+                   shader->getName().c_str());
     return;
   }
-  _shaders[shader->getID()] = shader;
+  _shaders.insert(shader->getID(), shader);
 }
 
 const kore::TextureSampler*
   kore::ResourceManager::
   requestTextureSampler(const TexSamplerProperties& properties) {
     // First look for a sampler that satisfies the provided properties
-    for (uint i = 0; i < _textureSamplers.size(); ++i) {
-      if (_textureSamplers[i]->getProperties() == properties) {
-        return _textureSamplers[i];
-      }
+    auto it = _textureSamplers.find(properties);
+    if (it != _textureSamplers.end()) {
+      ++it->second.refCount;
+      return it->second.sampler;
     }
 
     // Otherwise: Construct a new Sampler
@@ -203,61 +200,114 @@ const kore::TextureSampler*
     bool success = sampler->create(properties);
 
     if (!success) {
-      Log::getInstance()->write("[ERROR] TextureSampler creation failed!");
+      KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "TextureSampler creation failed!");
+      delete sampler;
       return NULL;
     }
 
-    _textureSamplers.push_back(sampler);
+    STextureSamplerEntry& entry = _textureSamplers[properties];
+    entry.sampler = sampler;
+    entry.refCount = 1;
     return sampler;
 }
 
+void kore::ResourceManager::
+  releaseTextureSampler(const TextureSampler* sampler) {
+    if (!sampler) {
+      return;
+    }
+
+    auto it = _textureSamplers.find(sampler->getProperties());
+    if (it == _textureSamplers.end() || it->second.sampler != sampler) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "Released TextureSampler is not "
+                     "managed by the ResourceManager\n");
+      return;
+    }
+
+    if (--it->second.refCount == 0) {
+      delete it->second.sampler;
+      _textureSamplers.erase(it);
+    }
+}
+
+void kore::ResourceManager::applyDebugLabels(void) {
+  const std::vector<Shader*>& shaders = _shaders.getResources();
+  for (uint i = 0; i < shaders.size(); ++i) {
+    shaders[i]->applyDebugLabel();
+  }
+
+  const std::vector<ShaderProgram*>& programs =
+    _shaderPrograms.getResources();
+  for (uint i = 0; i < programs.size(); ++i) {
+    programs[i]->applyDebugLabel();
+  }
+
+  const std::vector<Mesh*>& meshes = _meshes.getResources();
+  for (uint i = 0; i < meshes.size(); ++i) {
+    meshes[i]->applyDebugLabel();
+  }
+
+  const std::vector<Texture*>& textures = _textures.getResources();
+  for (uint i = 0; i < textures.size(); ++i) {
+    textures[i]->applyDebugLabel();
+  }
+
+  const std::vector<FrameBuffer*>& fbos = _frameBuffers.getResources();
+  for (uint i = 0; i < fbos.size(); ++i) {
+    fbos[i]->applyDebugLabel();
+  }
+}
+
 void kore::ResourceManager::
   addFramebuffer(FrameBuffer* fbo) {
-    if (!_frameBuffers.count(fbo->getID())) {
-      _frameBuffers[fbo->getID()] = fbo;
-       kore::Log::getInstance()->write("[DEBUG] added Framebuffer '%s'\n", fbo->getName().c_str());
+    if (!_frameBuffers.contains(fbo->getID())) {
+      _frameBuffers.insert(fbo->getID(), fbo);
+       KORE_LOG_DEBUG(LOG_CATEGORY_RESOURCE,
+                      "added Framebuffer '%s'\n", fbo->getName().c_str());
     } else {
-      kore::Log::getInstance()->write("[ERROR] Framebuffer '%s' could not be added\n", fbo->getName().c_str());
+      KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                     "Framebuffer '%s' could not be added\n",
+                     fbo->getName().c_str());
     }
 }
 
 kore::FrameBuffer*
   kore::ResourceManager::getFramebuffer(const uint64 id) {
-    auto it = _frameBuffers.find(id);
-    if (it != _frameBuffers.end()) {
-      return it->second;
-    }
+    return _frameBuffers.getByID(id);
+}
+
+kore::FrameBuffer*
+  kore::ResourceManager::getFramebuffer(const ResourceHandle& handle) const {
+    return _frameBuffers.get(handle);
+}
 
-    return NULL;
+kore::ResourceHandle
+  kore::ResourceManager::getFramebufferHandle(const uint64 id) const {
+    return _frameBuffers.getHandle(id);
 }
 
 void kore::ResourceManager::
   removeFramebuffer(FrameBuffer* fbo) {
-    for (auto it = _frameBuffers.begin(); it != _frameBuffers.end(); ++it) {
-      if (it->second == fbo) {
-        KORE_SAFE_DELETE(it->second);
-        _frameBuffers.erase(it);
-      }
-    }
+    removeFramebuffer(fbo->getID());
 }
 
 void kore::ResourceManager::removeFramebuffer(const uint64 id) {
-  auto it = _frameBuffers.find(id);
+  FrameBuffer* fbo = _frameBuffers.getByID(id);
 
-  if (it != _frameBuffers.end()) {
-    _fboDeleteEvent.raiseEvent(it->second);
-    delete (it->second);
-    _frameBuffers.erase(it);
+  if (fbo) {
+    _fboDeleteEvent.raiseEvent(fbo);
+    _frameBuffers.removeByID(id);
+    delete fbo;
   }
 }
 
 void kore::ResourceManager::removeMesh(const uint64 id) {
-  auto it = _meshes.find(id);
+  Mesh* mesh = _meshes.getByID(id);
 
-  if (it!= _meshes.end()) {
-    _meshDeleteEvent.raiseEvent(it->second);
-    delete it->second;
-    _meshes.erase(it);
+  if (mesh) {
+    _meshDeleteEvent.raiseEvent(mesh);
+    _meshes.removeByID(id);
+    delete mesh;
   }
 }
 
@@ -266,13 +316,12 @@ void kore::ResourceManager::removeMesh(const Mesh* mesh) {
 }
 
 void kore::ResourceManager::removeTexture(const uint64 id) {
-  auto it = _textures.find(id);
+  Texture* texture = _textures.getByID(id);
 
-  if (it != _textures.end()) {
-    _textureDeleteEvent.raiseEvent(it->second);
-    KORE_SAFE_DELETE(it->second);
-    _textures.erase(it);
-    return;
+  if (texture) {
+    _textureDeleteEvent.raiseEvent(texture);
+    _textures.removeByID(id);
+    delete texture;
   }
 }
 
@@ -281,13 +330,22 @@ void kore::ResourceManager::removeTexture(const Texture* texture) {
 }
 
 void kore::ResourceManager::removeShaderProgram(const uint64 id) {
-  auto it = _shaderPrograms.find(id);
-
-  if (it != _shaderPrograms.end()) {
-    _shaderProgramDeleteEvent.raiseEvent(it->second);
-    KORE_SAFE_DELETE(it->second);
-    _shaderPrograms.erase(it);
-    return;
+  ShaderProgram* program = _shaderPrograms.getByID(id);
+
+  if (program) {
+    _shaderProgramDeleteEvent.raiseEvent(program);
+    _shaderPrograms.removeByID(id);
+
+    // Later programs with the same shaders must not reuse this one.
+    for (auto it = _loadedShaderPrograms.begin();
+         it != _loadedShaderPrograms.end();) {
+      if (it->second == program) {
+        it = _loadedShaderPrograms.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    delete program;
   }
 }
 
@@ -297,131 +355,92 @@ void kore::ResourceManager::
 }
 
 
-const std::vector<kore::Mesh*> kore::ResourceManager::getMeshes(void) {
-  std::vector<kore::Mesh*> meshlist;
-  meshlist.resize(_meshes.size());
-
-  uint idx = 0;
-  for (auto it = _meshes.begin(); it != _meshes.end(); ++it) {
-    meshlist[idx++] = it->second;
-  }
-
-  return meshlist;
+const std::vector<kore::Mesh*>& kore::ResourceManager::getMeshes(void) {
+  return _meshes.getResources();
 }
 
-std::vector<kore::Texture*> kore::ResourceManager::getTextures(void){
-  std::vector<kore::Texture*> texlist;
-  texlist.resize(_textures.size());
-
-  uint idx = 0;
-  for(auto it = _textures.begin(); it != _textures.end(); it++) {
-    texlist[idx++] = it->second;
-  } 
-
-  return texlist;
+const std::vector<kore::Texture*>& kore::ResourceManager::getTextures(void){
+  return _textures.getResources();
 }
 
-std::vector<kore::FrameBuffer*>
+const std::vector<kore::FrameBuffer*>&
   kore::ResourceManager::getFramebuffers(void) {
-   std::vector<kore::FrameBuffer*> bufferlist;
-   bufferlist.resize(_frameBuffers.size());
-
-   uint idx = 0;
-   for(auto it = _frameBuffers.begin(); it != _frameBuffers.end(); it++) {
-     bufferlist[idx++] = it->second;
-  }
-
-  return bufferlist;
+  return _frameBuffers.getResources();
 }
 
-std::vector<kore::ShaderProgram*>
+const std::vector<kore::ShaderProgram*>&
   kore::ResourceManager::getShaderPrograms(void) {
-  std::vector<kore::ShaderProgram*> programlist;
-  for(auto it = _shaderPrograms.begin(); it != _shaderPrograms.end(); it++) {
-    programlist.push_back(it->second);
-  } 
-  return programlist;
+  return _shaderPrograms.getResources();
 }
 
 
 void kore::ResourceManager::addMaterial(Material* mat) {
-  if (_materials.count(mat->getID())) {
-    return;
-  }
-
-  _materials[mat->getID()] = mat;
+  _materials.insert(mat->getID(), mat);
 }
 
 kore::Material* kore::ResourceManager::getMaterial(const uint64 id) {
-  auto it = _materials.find(id);
+  return _materials.getByID(id);
+}
 
-  if (it != _materials.end()) {
-    return it->second;
-  }
+kore::Material*
+  kore::ResourceManager::getMaterial(const ResourceHandle& handle) const {
+  return _materials.get(handle);
+}
 
-  return NULL;
+kore::ResourceHandle
+  kore::ResourceManager::getMaterialHandle(const uint64 id) const {
+  return _materials.getHandle(id);
 }
 
 void kore::ResourceManager::removeMaterial(const uint64 id) {
-  auto it = _materials.find(id);
+  Material* mat = _materials.getByID(id);
 
-  if (it == _materials.end()) {
+  if (!mat) {
     return;
   }
 
-  _materialDeleteEvent.raiseEvent(it->second);
-  delete it->second;
-  _materials.erase(it);
+  _materialDeleteEvent.raiseEvent(mat);
+  _materials.removeByID(id);
+  delete mat;
 }
 
 void kore::ResourceManager::removeMaterial(const Material* mat) {
   removeMaterial(mat->getID());
 }
 
-std::vector<kore::Material*> kore::ResourceManager::getMaterials() {
-  std::vector<kore::Material*> matList;
-  matList.resize(_materials.size());
-
-  uint idx = 0;
-  for (auto it = _materials.begin(); it != _materials.end(); ++it) {
-    matList[idx++] = it->second;
-  }
-
-  return matList;
+const std::vector<kore::Material*>& kore::ResourceManager::getMaterials() {
+  return _materials.getResources();
 }
 
 kore::IndexedBuffer* kore::ResourceManager::getIndexedBuffer(const uint64 id) {
-  auto it = _indexedBuffers.find(id);
-
-  if (it != _indexedBuffers.end()) {
-    return it->second;
-  }
-
-  return NULL;
+  return _indexedBuffers.getByID(id);
 }
 
-std::vector<kore::IndexedBuffer*> kore::ResourceManager::getIndexedBuffers() {
-  std::vector<IndexedBuffer*> bufferList;
-  bufferList.resize(_indexedBuffers.size());
+kore::IndexedBuffer*
+  kore::ResourceManager::getIndexedBuffer(const ResourceHandle& handle) const {
+  return _indexedBuffers.get(handle);
+}
 
-  uint idx = 0;
-  for (auto it = _indexedBuffers.begin(); it != _indexedBuffers.end(); ++it) {
-    bufferList[idx++] = it->second;
-  }
+kore::ResourceHandle
+  kore::ResourceManager::getIndexedBufferHandle(const uint64 id) const {
+  return _indexedBuffers.getHandle(id);
+}
 
-  return bufferList;
+const std::vector<kore::IndexedBuffer*>&
+  kore::ResourceManager::getIndexedBuffers() {
+  return _indexedBuffers.getResources();
 }
 
 void kore::ResourceManager::removeIndexedBuffer(const uint64 id) {
-  auto it = _indexedBuffers.find(id);
+  IndexedBuffer* buf = _indexedBuffers.getByID(id);
 
-  if (it == _indexedBuffers.end()) {
+  if (!buf) {
     return;
   }
 
-  _indexedBufferDeleteEvent.raiseEvent(it->second);
-  delete it->second;
-  _indexedBuffers.erase(it);
+  _indexedBufferDeleteEvent.raiseEvent(buf);
+  _indexedBuffers.removeByID(id);
+  delete buf;
 }
 
 void kore::ResourceManager::removeIndexedBuffer(const IndexedBuffer* buf) {
@@ -429,11 +448,7 @@ void kore::ResourceManager::removeIndexedBuffer(const IndexedBuffer* buf) {
 }
 
 void kore::ResourceManager::addIndexedBuffer(IndexedBuffer* buf) {
-  if (!_indexedBuffers.count(buf->getID())) {
-    return;
-  }
-
-  _indexedBuffers[buf->getID()] = buf;
+  _indexedBuffers.insert(buf->getID(), buf);
 }
 
 uint kore::ResourceManager::getNumIndexedBuffers() {
@@ -442,14 +457,7 @@ uint kore::ResourceManager::getNumIndexedBuffers() {
 
 kore::IndexedBuffer*
   kore::ResourceManager::getIndexedBufferByIndex(uint index) {
-  uint idx = 0;
-  for (auto it = _indexedBuffers.begin(); it != _indexedBuffers.end(); ++it) {
-    if (idx++ == index) {
-      return it->second;
-    }
-  }
-  
-  return NULL;
+  return _indexedBuffers.at(index);
 }
 
 bool kore::ResourceManager::
@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "KoRE/Common.h"
 #include "KoRE/Mesh.h"
 #include "KoRE/Shader.h"
@@ -35,6 +36,8 @@
 #include "KoRE/Components/Material.h"
 #include "KoRE/Events.h"
 #include "KoRE/IndexedBuffer.h"
+#include "KoRE/HandleTable.h"
+#include "KoRE/GPUMemoryTracker.h"
 
 
 namespace kore {
@@ -76,8 +79,18 @@ namespace kore {
     /*! \brief Retrieve a registered Mesh */
     kore::Mesh* getMesh(const uint64 id);
 
-    /*! \brief Retrieve a list of all registered Meshes */
-    const std::vector<kore::Mesh*> getMeshes(void);
+    /*! \brief Retrieve a registered Mesh from its handle.
+    *   \return The Mesh or NULL if the handle is stale. */
+    kore::Mesh* getMesh(const ResourceHandle& handle) const;
+
+    /*! \brief Retrieve the handle of a registered Mesh */
+    ResourceHandle getMeshHandle(const uint64 id) const;
+
+    /*! \brief Retrieve a list of all registered Meshes.
+    *          The list is unordered: removing a mesh moves the last one into
+    *          its place, so positions change across removals. Refer to
+    *          meshes by handle or ID instead of by position. */
+    const std::vector<kore::Mesh*>& getMeshes(void);
     
     /*! \brief Removes a mesh from the ResourceManager and from the whole
     *          program all mesh-listeners are notified and the GPU- and HEAP-
@@ -99,8 +112,16 @@ namespace kore {
     /*! \brief Retrieve a registered texture from the ResourceManager */
     kore::Texture* getTexture(const uint64 id);
 
-    /*! \brief Retrieve all registered textures from the ResourceManager */
-    std::vector<kore::Texture*> getTextures(void);
+    /*! \brief Retrieve a registered texture from its handle.
+    *   \return The texture or NULL if the handle is stale. */
+    kore::Texture* getTexture(const ResourceHandle& handle) const;
+
+    /*! \brief Retrieve the handle of a registered texture */
+    ResourceHandle getTextureHandle(const uint64 id) const;
+
+    /*! \brief Retrieve all registered textures from the ResourceManager.
+    *          Unordered like getMeshes(). */
+    const std::vector<kore::Texture*>& getTextures(void);
 
     /*! \brief Removes a texture from the ResourceManager and from the whole
     *          program. All Texture-listeners are notified.
@@ -120,8 +141,16 @@ namespace kore {
     /*! \brief Retrieve a registered ShaderProgram from the ResourceManager. */
     kore::ShaderProgram* getShaderProgram(const uint64 id) const;
 
-    /*! \brief Retrieve all registered ShaderPrograms. */
-    std::vector<ShaderProgram*> getShaderPrograms(void);
+    /*! \brief Retrieve a registered ShaderProgram from its handle.
+    *   \return The ShaderProgram or NULL if the handle is stale. */
+    kore::ShaderProgram* getShaderProgram(const ResourceHandle& handle) const;
+
+    /*! \brief Retrieve the handle of a registered ShaderProgram. */
+    ResourceHandle getShaderProgramHandle(const uint64 id) const;
+
+    /*! \brief Retrieve all registered ShaderPrograms, unordered like
+    *          getMeshes(). */
+    const std::vector<ShaderProgram*>& getShaderPrograms(void);
 
     /*! \brief Removes a shaderProgram from the ResourceManager and from the
     *          whole program. Registered SaderProgram-listener are informed.
@@ -154,8 +183,16 @@ namespace kore {
                 added with the provided name or it has been removed already. */
     kore::FrameBuffer* getFramebuffer(const uint64 id);
 
-    /*! \brief Retrieve all registered FrameBuffers.*/
-    std::vector<FrameBuffer*> getFramebuffers(void);
+    /*! \brief Retrieve a registered FrameBuffer from its handle.
+    *   \return The FrameBuffer or NULL if the handle is stale. */
+    kore::FrameBuffer* getFramebuffer(const ResourceHandle& handle) const;
+
+    /*! \brief Retrieve the handle of a registered FrameBuffer. */
+    ResourceHandle getFramebufferHandle(const uint64 id) const;
+
+    /*! \brief Retrieve all registered FrameBuffers, unordered like
+    *          getMeshes(). */
+    const std::vector<FrameBuffer*>& getFramebuffers(void);
     
     /*! \brief Remove a registered FrameBuffer from the ResourceManager and
     *          from the whole program. FrameBuffer-listeners are informed.
@@ -192,14 +229,21 @@ namespace kore {
     /*! \brief Retrieve a Material from its id. */
     kore::Material* getMaterial(const uint64 id);
 
-    std::vector<kore::Material*> getMaterials();
+    /*! \brief Retrieve a Material from its handle or NULL if it is stale. */
+    kore::Material* getMaterial(const ResourceHandle& handle) const;
+
+    ResourceHandle getMaterialHandle(const uint64 id) const;
+
+    const std::vector<kore::Material*>& getMaterials();
     
     void removeMaterial(const uint64 id);
 
     void removeMaterial(const Material* mat);
 
     IndexedBuffer* getIndexedBuffer(const uint64 id);
-    std::vector<IndexedBuffer*> getIndexedBuffers();
+    IndexedBuffer* getIndexedBuffer(const ResourceHandle& handle) const;
+    ResourceHandle getIndexedBufferHandle(const uint64 id) const;
+    const std::vector<IndexedBuffer*>& getIndexedBuffers();
     void removeIndexedBuffer(const uint64 id);
     void removeIndexedBuffer(const IndexedBuffer* buf);
     void addIndexedBuffer(IndexedBuffer* buf);
@@ -211,27 +255,57 @@ namespace kore {
     *          properties. 
     * If a sampler with the provided properties already exists, the pointer to
     * that sampler is simply returned. Otherwise, a new sampler object is
-    * created and returned.
+    * created and returned. Each request increases the reference count of the
+    * sampler and has to be paired with a call to releaseTextureSampler(..).
     * \param properties The properties of the requested sampler.
     * \return The pointer to the sampler-object.
     */
     const TextureSampler*
       requestTextureSampler(const TexSamplerProperties& properties);
 
+    /*! \brief Decreases the reference count of a sampler obtained from
+    *          requestTextureSampler(..). The sampler is deleted as soon as
+    *          it is not referenced anymore.
+    */
+    void releaseTextureSampler(const TextureSampler* sampler);
+
+    /*! \brief Labels the GL objects of all registered resources with their
+    *          names (see GLerror::setDebugAnnotationsEnabled).
+    */
+    void applyDebugLabels(void);
+
+    /*! \brief Returns the accounting of the video memory used by meshes,
+    *          textures, FrameBuffer attachments and IndexedBuffers.
+    *          Budgets are set here as well. Allocations are tagged with the
+    *          file passed to loadScene(..) or loadResources(..).
+    */
+    inline const GPUMemoryTracker& getGPUMemoryTracker(void) const
+      {return _gpuMemory;}
+    inline GPUMemoryTracker& getGPUMemoryTracker(void) {return _gpuMemory;}
+
   private:
     ResourceManager(void);
     
 
-    std::vector<kore::TextureSampler*> _textureSamplers;
+    struct STextureSamplerEntry {
+      STextureSamplerEntry() : sampler(NULL), refCount(0) {}
+      TextureSampler* sampler;
+      uint refCount;
+    };
+
+    std::unordered_map<TexSamplerProperties, STextureSamplerEntry,
+                       TexSamplerProperties::Hasher> _textureSamplers;
+
+    GPUMemoryTracker _gpuMemory;
 
-    std::map<uint64, Shader*> _shaders;
-    std::map<uint64, Mesh*> _meshes;  // id || mesh
-    std::map<uint64, kore::Texture*> _textures;  // id || texture    
-    std::map<uint64, ShaderProgram*> _shaderPrograms;  // id || program
+    HandleTable<Shader> _shaders;
+    HandleTable<Mesh> _meshes;
+    HandleTable<kore::Texture> _textures;
+    HandleTable<ShaderProgram> _shaderPrograms;
     std::map<std::string, ShaderProgram*> _loadedShaderPrograms;  // key || program
-    std::map<uint64, kore::FrameBuffer*> _frameBuffers; // name,  || framebuffer
-    std::map<uint64, Material*> _materials;
-    std::map<uint64, IndexedBuffer*> _indexedBuffers;
+    HandleTable<kore::FrameBuffer> _frameBuffers;
+    HandleTable<Material> _materials;
+    HandleTable<IndexedBuffer> _indexedBuffers;
 
     Delegate1Param<const Shader*> _shaderDeleteEvent;
     Delegate1Param<const IndexedBuffer*> _indexedBufferDeleteEvent;
@@ -20,14 +20,21 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <cstring>
 #include "KoRE/SceneManager.h"
+#include "KoRE/Log.h"
+#include "KoRE/Profiler.h"
 
 kore::SceneManager* kore::SceneManager::getInstance(void) {
   static kore::SceneManager theInstance;
   return &theInstance;
 }
 
-kore::SceneManager::SceneManager(void) :_tagcount(0) {
+kore::SceneManager::SceneManager(void)
+  : _bvhStructureVersion(0),
+    _updateCount(0),
+    _visibilityUpdateCount(KORE_UINT_INVALID),
+    _tagcount(0) {
   addTag("DEFAULT");
   _root.setName("ROOT");
 }
@@ -36,7 +43,128 @@ kore::SceneManager::~SceneManager(void) {
 }
 
 void kore::SceneManager::update(void) {
-  _root.update();
+  KORE_PROFILE_SCOPE("SceneManager::update");
+  _transformHierarchy.update(&_root);
+  updateBVH();
+}
+
+void kore::SceneManager::updateBVH(void) {
+  if (_transformHierarchy.getStructureVersion() != _bvhStructureVersion
+      || _bvh.needsRebuild()) {
+    rebuildBVH();
+    return;
+  }
+
+  const std::vector<uint>& changed = _transformHierarchy.getChangedNodes();
+  if (changed.empty()) {
+    return;
+  }
+
+  for (uint i = 0; i < changed.size(); ++i) {
+    _bvh.refit(changed[i], _transformHierarchy.getWorldBounds(changed[i]));
+  }
+  _bvh.commit();
+  ++_updateCount;
+
+  if (_bvh.needsRebuild()) {
+    rebuildBVH();
+  }
+}
+
+void kore::SceneManager::rebuildBVH(void) {
+  const uint numNodes = _transformHierarchy.size();
+  std::vector<uint> ids(numNodes);
+  for (uint i = 0; i < numNodes; ++i) {
+    ids[i] = i;
+  }
+
+  if (numNodes > 0) {
+    _bvh.build(&_transformHierarchy.getWorldBounds()[0], &ids[0], numNodes);
+  } else {
+    _bvh.clear();
+  }
+  _bvhStructureVersion = _transformHierarchy.getStructureVersion();
+  ++_updateCount;
+}
+
+void kore::SceneManager::
+  collectQueryResult(std::vector<SceneNode*>& vSceneNodes) {
+  for (uint i = 0; i < _queryIDs.size(); ++i) {
+    vSceneNodes.push_back(_transformHierarchy.getNode(_queryIDs[i]));
+  }
+  _queryIDs.clear();
+}
+
+void kore::SceneManager::
+  getSceneNodesInFrustum(const SFrustum& frustum,
+                         std::vector<SceneNode*>& vSceneNodes) {
+  _bvh.queryFrustum(frustum, _queryIDs);
+  collectQueryResult(vSceneNodes);
+}
+
+void kore::SceneManager::
+  getSceneNodesInSphere(const glm::vec3& center, const float radius,
+                        std::vector<SceneNode*>& vSceneNodes) {
+  _bvh.querySphere(center, radius, _queryIDs);
+  collectQueryResult(vSceneNodes);
+}
+
+void kore::SceneManager::
+  getSceneNodesInAABB(const SAABB& aabb,
+                      std::vector<SceneNode*>& vSceneNodes) {
+  _bvh.queryAABB(aabb, _queryIDs);
+  collectQueryResult(vSceneNodes);
+}
+
+void kore::SceneManager::
+  getSceneNodesOnRay(const glm::vec3& origin, const glm::vec3& direction,
+                     const float maxDist,
+                     std::vector<SceneNode*>& vSceneNodes) {
+  _bvh.queryRay(origin, direction, maxDist, _queryIDs);
+  collectQueryResult(vSceneNodes);
+}
+
+const std::vector<unsigned char>&
+  kore::SceneManager::getFrustumVisibility(const SFrustum& frustum) {
+  if (_visibilityUpdateCount == _updateCount
+      && memcmp(_visibilityFrustum.planes, frustum.planes,
+                sizeof(frustum.planes)) == 0) {
+    return _visibility;
+  }
+
+  _visibility.assign(_transformHierarchy.size(), 0);
+  _bvh.queryFrustum(frustum, _queryIDs);
+  for (uint i = 0; i < _queryIDs.size(); ++i) {
+    _visibility[_queryIDs[i]] = 1;
+  }
+  _queryIDs.clear();
+
+  _visibilityFrustum = frustum;
+  _visibilityUpdateCount = _updateCount;
+  return _visibility;
+}
+
+void kore::SceneManager::setTransforms(SceneNode* const* nodes,
+                                       const STransformTRS* transforms,
+                                       const uint count) {
+  _transformHierarchy.setLocals(nodes, transforms, count);
+}
+
+void kore::SceneManager::
+  setTransforms(const std::vector<SceneNode*>& nodes,
+                const std::vector<STransformTRS>& transforms) {
+  if (nodes.size() != transforms.size()) {
+    KORE_LOG_ERROR(LOG_CATEGORY_SCENE, "SceneManager::setTransforms: "
+                   "%i nodes but %i transforms\n",
+                   static_cast<int>(nodes.size()),
+                   static_cast<int>(transforms.size()));
+    return;
+  }
+
+  if (nodes.empty()) {
+    return;
+  }
+  setTransforms(&nodes[0], &transforms[0], static_cast<uint>(nodes.size()));
 }
 
 void kore::SceneManager::addTag(const std::string& name) {
@@ -24,6 +24,8 @@
 #include <string>
 #include <vector>
 #include "KoRE/SceneNode.h"
+#include "KoRE/TransformHierarchy.h"
+#include "KoRE/Culling/BoundingVolumeHierarchy.h"
 #include "KoRE/Common.h"
 #include "KoRE/Components/Camera.h"
 #include "KoRE/Components/LightComponent.h"
@@ -55,13 +57,59 @@ namespace kore {
     kore::Camera* getCamera(const uint64 id);
     kore::LightComponent* getLight(const uint64 id);
 
+    /*! \brief Sets the local transformations of many nodes at once.
+    *   \param nodes The nodes to change.
+    *   \param transforms The new transformations, one per node.
+    *   \param count The number of nodes. */
+    void setTransforms(SceneNode* const* nodes,
+                       const STransformTRS* transforms,
+                       const uint count);
+    void setTransforms(const std::vector<SceneNode*>& nodes,
+                       const std::vector<STransformTRS>& transforms);
+
+    inline const TransformHierarchy* getTransformHierarchy() const
+      {return &_transformHierarchy;}
+
+    inline const BoundingVolumeHierarchy* getBVH() const {return &_bvh;}
+
+    /// Spatial queries on the world bounds of the nodes in the scene graph
+    void getSceneNodesInFrustum(const SFrustum& frustum,
+                                std::vector<SceneNode*>& vSceneNodes);
+    void getSceneNodesInSphere(const glm::vec3& center, const float radius,
+                               std::vector<SceneNode*>& vSceneNodes);
+    void getSceneNodesInAABB(const SAABB& aabb,
+                             std::vector<SceneNode*>& vSceneNodes);
+    void getSceneNodesOnRay(const glm::vec3& origin,
+                            const glm::vec3& direction,
+                            const float maxDist,
+                            std::vector<SceneNode*>& vSceneNodes);
+
+    /*! \brief Returns one flag per node of the transform hierarchy, which is
+    *          1 if the bounds of the node intersect the frustum. The result
+    *          is cached until the frustum or the scene changes. */
+    const std::vector<unsigned char>&
+      getFrustumVisibility(const SFrustum& frustum);
+
   private:
+    void updateBVH(void);
+    void rebuildBVH(void);
+    void collectQueryResult(std::vector<SceneNode*>& vSceneNodes);
+
     std::map<uint64, Camera*> _cameras;  // id || camera
     std::map<uint64, LightComponent*> _lights;  // id || light
 
     SceneManager(void);
     virtual ~SceneManager(void);
+    // Declared before _root, so it outlives the nodes on destruction.
+    TransformHierarchy _transformHierarchy;
     SceneNode _root;
+    BoundingVolumeHierarchy _bvh;
+    uint _bvhStructureVersion;
+    uint _updateCount;
+    std::vector<uint> _queryIDs;
+    std::vector<unsigned char> _visibility;
+    SFrustum _visibilityFrustum;
+    uint _visibilityUpdateCount;
     uint _tagcount;
     std::map<std::string, uint> _tagmap;
   };
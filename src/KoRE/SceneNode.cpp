@@ -25,6 +25,7 @@
 #include "KoRE/SceneNode.h"
 #include "KoRE/Common.h"
 #include "KoRE/SceneManager.h"
+#include "KoRE/TransformHierarchy.h"
 #include "Kore/IDManager.h"
 #include "iostream"
 
@@ -32,12 +33,19 @@ kore::SceneNode::SceneNode(void)
                        :_tag(0),
                         _parent(NULL),
                         _dirty(true),
+                        _hierarchy(NULL),
+                        _hierarchyIndex(KORE_UINT_INVALID),
                         kore::BaseResource() {
   _transform = new Transform;
   _components.push_back(_transform);
+  _nameID = StringTable::getInstance()->intern(_name);
 }
 
 kore::SceneNode::~SceneNode(void) {
+  if (_hierarchy) {
+    _hierarchy->invalidateStructure();
+  }
+
   for (uint i = 0; i < _children.size(); ++i) {
     KORE_SAFE_DELETE(_children[i]);
   }
@@ -129,19 +137,49 @@ const std::string kore::SceneNode::getName(void) const {
   return _name;
 }
 
+uint kore::SceneNode::getHierarchyIndex(void) const {
+  // The index is stale if the structure changed since the last rebuild.
+  return _hierarchy && _hierarchy->contains(this, _hierarchyIndex)
+         ? _hierarchyIndex : KORE_UINT_INVALID;
+}
+
+const kore::SAABB& kore::SceneNode::getWorldBounds(void) const {
+  static const SAABB emptyBounds;
+  const uint idx = getHierarchyIndex();
+  return idx != KORE_UINT_INVALID ? _hierarchy->getWorldBounds(idx)
+                                  : emptyBounds;
+}
+
+const kore::SAABB& kore::SceneNode::getSubtreeBounds(void) const {
+  static const SAABB emptyBounds;
+  const uint idx = getHierarchyIndex();
+  return idx != KORE_UINT_INVALID ? _hierarchy->getSubtreeBounds(idx)
+                                  : emptyBounds;
+}
+
 void kore::SceneNode::setParent(SceneNode* parent) {
   _parent = parent;
+  if (_hierarchy) {
+    _hierarchy->invalidateStructure();
+  }
 }
 
 void kore::SceneNode::addChild(SceneNode* child) {
   child->setParent(this);
   _children.push_back(child);
+  if (_hierarchy) {
+    _hierarchy->invalidateStructure();
+  }
 }
 
 void kore::SceneNode::addComponent(SceneNodeComponent* component) {
   _components.push_back(component);
   component->attachTo(this);
-  _dirty = true;
+  // The hierarchy collects the components that observe the transform.
+  if (_hierarchy) {
+    _hierarchy->invalidateStructure();
+  }
+  localChanged();
 }
 
 void kore::SceneNode::setTag(const std::string& tagname) {
@@ -150,6 +188,22 @@ void kore::SceneNode::setTag(const std::string& tagname) {
 
 void kore::SceneNode::setName(const std::string& name) {
   _name = name;
+  _nameID = StringTable::getInstance()->intern(_name);
+}
+
+void kore::SceneNode::setDirty(const bool dirty) {
+  if (dirty) {
+    localChanged();
+  } else {
+    _dirty = false;
+  }
+}
+
+void kore::SceneNode::localChanged(void) {
+  _dirty = true;
+  if (_hierarchy) {
+    _hierarchy->localChanged(this);
+  }
 }
 
 const bool kore::SceneNode::needsUpdate(void) const {
@@ -157,7 +211,12 @@ const bool kore::SceneNode::needsUpdate(void) const {
 }
 
 void kore::SceneNode::update(void) {
-  if (needsUpdate()) {
+  update(false);
+}
+
+void kore::SceneNode::update(const bool parentChanged) {
+  const bool changed = parentChanged || needsUpdate();
+  if (changed) {
     if (_parent) {
       _transform->setGlobal(_parent->getTransform()->getGlobal() *
                             _transform->getLocal());
@@ -169,25 +228,24 @@ void kore::SceneNode::update(void) {
     }
   }
   for (unsigned int i = 0; i < _children.size(); ++i) {
-    _children[i]->update();
+    _children[i]->update(changed);
   }
   _dirty = false;
 }
 
- 
-void
- kore::SceneNode::translate(const glm::vec3& dir,
+void kore::SceneNode::translate(const glm::vec3& dir,
                           const ETransfpomSpace relativeTo /*=SPACE_LOCAL*/) {
+  glm::vec3 localDir = dir;
   if (relativeTo == SPACE_WORLD) {
-    glm::vec4 v4Dir(dir, 0.0f);
-    v4Dir = glm::inverse(_transform->getGlobal()) * v4Dir;
-    _transform->setLocal(glm::translate(_transform->getLocal(),
-                                        glm::vec3(v4Dir)));
-  } else {
-    _transform->setLocal(glm::translate(_transform->getLocal(), dir));
+    localDir = glm::vec3(_transform->getGlobalInverse() *
+                         glm::vec4(dir, 0.0f));
   }
 
-  _dirty = true;
+  // Equivalent to local * translate(localDir).
+  _transform->setTranslation(_transform->getTranslation() +
+                             _transform->getRotation() *
+                             (_transform->getScale() * localDir));
+  localChanged();
 }
 
 // TODO: Implement space-changes, right now only Local space 
@@ -196,47 +254,43 @@ void kore::SceneNode::setTransform( glm::mat4& trans
                                   )
 {
   _transform->setLocal(trans);
-  _dirty = true;
+  localChanged();
 }
 
-
+void kore::SceneNode::setTransform(const STransformTRS& trs) {
+  _transform->setLocal(trs);
+  localChanged();
+}
 
 void kore::SceneNode::
   setTranslation(const glm::vec3& position
                  //,const ETransfpomSpace relativeTo /*= SPACE_LOCAL*/
                  ) {
-   glm::mat4 local = _transform->getLocal();
-  /*if (relativeTo == SPACE_WORLD) {
-    glm::vec3 localPos = glm::vec3(glm::inverse(_transform->getGlobal()) *
-                                   glm::vec4(position, 1.0f));
-    local[3] = glm::vec4(localPos, 1.0f);
-  } else {*/
-    local[3] = glm::vec4(position, 1.0f);
-  //}
-  _transform->setLocal(local);
-  _dirty = true;
+  _transform->setTranslation(position);
+  localChanged();
 }
 
 void kore::SceneNode::rotate(const GLfloat& angle, const glm::vec3& axis,
                           const ETransfpomSpace relativeTo /*=SPACE_LOCAL*/) {
-   if (relativeTo == SPACE_WORLD) {
-    glm::vec4 v4Axis(axis, 0.0f);
-    v4Axis = glm::inverse(_transform->getGlobal()) * v4Axis;
-    _transform->setLocal(glm::rotate(_transform->getLocal(),
-                                      angle,
-                                      glm::vec3(v4Axis)));
-   } else {
-     _transform->setLocal(glm::rotate(_transform->getLocal(), angle, axis));
-   }
+  glm::vec3 localAxis = axis;
+  if (relativeTo == SPACE_WORLD) {
+    localAxis = glm::vec3(_transform->getGlobalInverse() *
+                          glm::vec4(axis, 0.0f));
+  }
 
-  _dirty = true;
+  // Equivalent to local * rotate(angle, localAxis) for uniform scales:
+  // the rotation is applied in the node's own frame, before its current
+  // rotation and after its scale.
+  _transform->setRotation(glm::normalize(_transform->getRotation() *
+                          glm::angleAxis(angle, glm::normalize(localAxis))));
+  localChanged();
 }
 
 // TODO(dlazarek): Implement space-changes
 void kore::SceneNode::scale(const glm::vec3& dim,
                             const ETransfpomSpace relativeTo /*=SPACE_LOCAL*/) {
-  _transform->setLocal(glm::scale(_transform->getLocal(), dim));
-  _dirty = true;
+  _transform->setScale(_transform->getScale() * dim);
+  localChanged();
 }
 
 void kore::SceneNode::setOrientation(const glm::vec3& v3Side,
@@ -246,7 +300,7 @@ void kore::SceneNode::setOrientation(const glm::vec3& v3Side,
   glm::mat4 newMat;
   if (relativeTo == SPACE_WORLD) {
     glm::mat4 matGlobalI =
-      glm::inverse(_transform->getGlobal());
+      _transform->getGlobalInverse();
 
     glm::vec3 localSide =
       glm::normalize(glm::vec3(matGlobalI * glm::vec4(v3Side, 0.0f)));
@@ -267,7 +321,7 @@ void kore::SceneNode::setOrientation(const glm::vec3& v3Side,
     newMat[2] = glm::vec4(v3Forward, newMat[2][3]);
   }
   _transform->setLocal(newMat);
-  _dirty = true;
+  localChanged();
 }
 
 void kore::SceneNode::getSceneNodesByTag(const uint tag,
@@ -26,6 +26,8 @@
 #include "KoRE/Components/SceneNodeComponent.h"
 #include "KoRE/Components/Transform.h"
 #include "KoRE/BaseResource.h"
+#include "KoRE/BoundingVolume.h"
+#include "KoRE/StringTable.h"
 
 namespace kore {
   enum ETransfpomSpace {
@@ -33,8 +35,11 @@ namespace kore {
     SPACE_WORLD
   };
 
+  class TransformHierarchy;
+
   class SceneNode : public BaseResource {
     friend class SceneLoader;
+    friend class TransformHierarchy;
   public:
     SceneNode(void);
     virtual ~SceneNode(void);
@@ -49,6 +54,21 @@ namespace kore {
     SceneNodeComponent* getComponent(EComponentType type);
     const uint getTag(void) const;
     const std::string getName(void) const;
+    /// The interned name, e.g. for profiler scopes.
+    inline StringID getNameID(void) const {return _nameID;}
+
+    /*! \brief Returns the world-space box of the meshes of this node.
+    *          Empty for nodes without a hierarchy index. */
+    const SAABB& getWorldBounds(void) const;
+
+    /*! \brief Returns the world-space box of all meshes in this subtree. */
+    const SAABB& getSubtreeBounds(void) const;
+
+    /*! \brief Returns the position of the node in the transform hierarchy
+    *          of the scene or KORE_UINT_INVALID for detached nodes.
+    *          After nodes were added or removed, all nodes are treated as
+    *          detached until the next SceneManager::update(). */
+    uint getHierarchyIndex(void) const;
     void getSceneNodesByTag(const uint tag,
                             std::vector<SceneNode*>& vNodes);
     void getSceneNodesByName(const std::string& name,
@@ -60,9 +80,13 @@ namespace kore {
     void addComponent(SceneNodeComponent* component);
     void setTag(const std::string& tagname);
     void setName(const std::string& name);
-    void inline setDirty(const bool dirty) {_dirty = dirty;}
+    void setDirty(const bool dirty);
 
     const bool needsUpdate(void) const;
+
+    /*! \brief Recursively updates the transforms of this subtree.
+    *          Nodes in the scene graph are updated by the SceneManager in
+    *          one batch, this is only needed for detached subtrees. */
     void update(void);
 
     void translate(const glm::vec3& dir,
@@ -72,6 +96,10 @@ namespace kore {
                         //,const ETransfpomSpace relativeTo = SPACE_LOCAL
                         );
 
+    /*! \brief Rotates the node around an axis through its origin. The
+    *          rotation is appended to the local rotation, like rotating the
+    *          local matrix did. With a non-uniform scale the scale axes
+    *          now rotate with the node instead of shearing it. */
     void rotate(const GLfloat& angle, const glm::vec3& axis, 
                 const ETransfpomSpace relativeTo = SPACE_LOCAL);
 
@@ -85,14 +113,21 @@ namespace kore {
     void setTransform(glm::mat4& trans 
       //,const ETransfpomSpace relativeTo /*=SPACE_LOCAL*/
                       );
+    void setTransform(const STransformTRS& trs);
   private:
+    void localChanged(void);
+    void update(const bool parentChanged);
+
     uint _tag;
     std::string _name;
+    StringID _nameID;
     SceneNode* _parent;
     std::vector<SceneNode*> _children;
     std::vector<SceneNodeComponent*> _components;
     bool _dirty;  // if node has to be updated;
     Transform* _transform;
+    TransformHierarchy* _hierarchy;  // hierarchy this node is stored in
+    uint _hierarchyIndex;  // position in the hierarchy-arrays
   };
 };
 #endif  // CORE_INCLUDE_CORE_SCENENODE_H_
@@ -24,6 +24,7 @@
 #include "KoRE/Common.h"
 #include "KoRE/Shader.h"
 #include "KoRE/ResourceManager.h"
+#include "KoRE/GLerror.h"
 
 
 
@@ -61,7 +62,8 @@ void kore::Shader::loadShaderCode(const std::string& file, GLenum shadertype, st
   std::vector<std::string> vLines;
 
   if(!readTextFileLines(file, vLines)) {
-    Log::getInstance()->write("[ERROR] Could not read shader file %s\n", file.c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                   "Could not read shader file %s\n", file.c_str());
   }
 
   std::vector<std::string>::iterator iterIncludeLine = vLines.end();
@@ -106,7 +108,9 @@ void kore::Shader::loadShaderCode(const std::string& file, GLenum shadertype, st
 
       std::vector<std::string> vInsertLines;
       if (!readTextFileLines(szSubStr, vInsertLines)) {
-        Log::getInstance()->write("[ERROR] Could not read #include-shader file %s\n", szSubStr.c_str());
+        KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                       "Could not read #include-shader file %s\n",
+                       szSubStr.c_str());
       }
 
       if(vInsertLines.size() > 0) {
@@ -121,19 +125,41 @@ void kore::Shader::loadShaderCode(const std::string& file, GLenum shadertype, st
 
   } while(bFound);
 
+  compile(shaderCode, shadertype, file);
+  _name = defines + file.substr(file.find_last_of("/")+1);
+  applyDebugLabel();
+  kore::ResourceManager::getInstance()->addShader(this);
+}
+
+void kore::Shader::loadShaderSource(const std::string& source,
+                                    GLenum shadertype,
+                                    const std::string& name) {
+  compile(source, shadertype, name);
+  _name = name;
+  applyDebugLabel();
+  kore::ResourceManager::getInstance()->addShader(this);
+}
 
+void kore::Shader::compile(const std::string& code, GLenum shadertype,
+                           const std::string& name) {
   _handle = glCreateShader(shadertype);
   _shadertype = shadertype;
-  const char* szShaderSource = shaderCode.c_str();
+  _code = code;
+  const char* szShaderSource = code.c_str();
   glShaderSource(_handle, 1, &szShaderSource, 0);
   glCompileShader(_handle);
 
-  bool bSuccess = checkShaderCompileStatus(_handle, file);
+  bool bSuccess = checkShaderCompileStatus(_handle, name);
   if (!bSuccess) {
     glDeleteShader(_handle);
   }
-  _name = defines + file.substr(file.find_last_of("/")+1);
-  kore::ResourceManager::getInstance()->addShader(this);
+}
+
+void kore::Shader::applyDebugLabel(void) const {
+  // A shader that failed to compile has been deleted already.
+  if (GLerror::areDebugAnnotationsEnabled() && glIsShader(_handle)) {
+    GLerror::setObjectLabel(GL_SHADER, _handle, _name);
+  }
 }
 
 bool kore::Shader::checkShaderCompileStatus(const GLuint shaderHandle,
@@ -146,19 +172,19 @@ bool kore::Shader::checkShaderCompileStatus(const GLuint shaderHandle,
   if (infologLen > 1) {
     GLchar * infoLog = new GLchar[infologLen];
     if (infoLog == NULL) {
-      kore::Log::getInstance()->write(
-        "[ERROR] Could not allocate ShaderInfoLog buffer from '%s'\n",
-        name.c_str());
+      KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                     "Could not allocate ShaderInfoLog buffer from '%s'\n",
+                     name.c_str());
     }
     int charsWritten = 0;
     glGetShaderInfoLog(shaderHandle, infologLen, &charsWritten, infoLog);
     std::string shaderlog = infoLog;
-    kore::Log::getInstance()->write(
-      "[DEBUG] '%s' shader Log %s\n", name.c_str(), shaderlog.c_str());
+    KORE_LOG_DEBUG(LOG_CATEGORY_SHADER,
+                   "'%s' shader Log %s\n", name.c_str(), shaderlog.c_str());
     KORE_SAFE_DELETE_ARR(infoLog);
   } else {
-    /*kore::Log::getInstance()->write(
-      "[DEBUG] Shader '%s' compiled\n", name.c_str());*/
+    /*KORE_LOG_DEBUG(LOG_CATEGORY_SHADER, 
+      "Shader '%s' compiled\n", name.c_str());*/
   }
   return success == GL_TRUE;
 }
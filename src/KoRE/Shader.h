@@ -29,14 +29,26 @@ namespace kore {
     ~Shader(void);
 
     void loadShaderCode(const std::string& file, GLenum shadertype, std::string defines = "");
+
+    /*! \brief Compiles a shader from source code in memory, e.g. for
+    *          shaders that are part of KoRE itself.
+    *   \param name The name of the shader, used in logs and labels. */
+    void loadShaderSource(const std::string& source, GLenum shadertype,
+                          const std::string& name);
     inline const std::string& getName(void){return _name;}
     inline GLenum getHandle(void){return _handle;}
     inline const std::string& getCode(void){return _code;}
     inline GLenum getType(void){return _shadertype;}
 
+    /*! \brief Labels the GL shader with its name
+    *          (see GLerror::setDebugAnnotationsEnabled). */
+    void applyDebugLabel(void) const;
+
   private:
     static bool checkShaderCompileStatus(const GLuint shaderHandle,
                                          const std::string& name);
+    void compile(const std::string& code, GLenum shadertype,
+                 const std::string& name);
     bool readTextFileLines(const std::string& szFileName,
                            std::vector<std::string>& rvLines);
 
@@ -18,13 +18,15 @@
 */
 
 #include "KoRE/ShaderData.h"
+#include "KoRE/Components/SceneNodeComponent.h"
 
 kore::ShaderData::ShaderData(void)
   : type(GL_NONE),
   size(1),
   name("UNDEFINED"),
   data(NULL),
-  component(NULL) {
+  component(NULL),
+  deferred(false) {
 }
 
 kore::ShaderData::ShaderData(const GLenum _type, const GLuint _size,
@@ -34,5 +36,12 @@ kore::ShaderData::ShaderData(const GLenum _type, const GLuint _size,
   size(_size),
   name(_name),
   data(_data),
-  component(_comp) {
+  component(_comp),
+  deferred(false) {
+}
+
+void kore::ShaderData::resolveDeferred(void) const {
+  if (component) {
+    component->resolveShaderData(this);
+  }
 }
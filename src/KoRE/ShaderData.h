@@ -32,11 +32,19 @@ namespace kore {
     ShaderData(void);
     virtual ~ShaderData(void) {};
 
+    /*! \brief Makes sure the value data points to is up to date.
+    *          Has to be called before reading deferred data. */
+    inline void resolve(void) const {if (deferred) resolveDeferred();}
+
     GLenum type;      // e.g. GL_FLOAT_VEC3
     GLuint size;      // number of components in units of type (always 1 for non-array uniforms)
     std::string name;
     void* data;
     SceneNodeComponent* component;
+    bool deferred;    // data is computed on demand by the component
+
+  private:
+    void resolveDeferred(void) const;
   };
 }
 
@@ -49,6 +49,7 @@ namespace kore {
        GLuint texUnit;          // texUnit to bind a texture to.
        GLuint imgUnit;          // imgUnit to bind an image to.
        GLuint atomicCounterBindingPoint;       // bindingpoint for atomic counters
+       GLuint uniformBlockBinding;  // bindingpoint for uniform blocks
     };
 
     GLuint programHandle;    // GLhandle of the shader program
@@ -18,16 +18,19 @@
 */
 
 #include <vector>
+#include <set>
 #include <string>
 #include <sstream>
 
 #include "KoRE/ShaderProgram.h"
 #include "KoRE/Log.h"
+#include "KoRE/GLerror.h"
 #include "KoRE/Operations/Operation.h"
 #include "KoRE/ResourceManager.h"
 #include "Kore/RenderManager.h"
 #include "KoRE/IndexedBuffer.h"
 #include "KoRE/IDManager.h"
+#include "KoRE/UniformBuffer.h"
 
 const unsigned int BUFSIZE = 100;  // Buffer length for shader-element names
 
@@ -39,17 +42,28 @@ kore::ShaderProgram::ShaderProgram()
   _fragment_prog(NULL),
   _tess_ctrl(NULL),
   _tess_eval(NULL),
+  _compute_prog(NULL),
+  _computeWorkGroupSize(0, 0, 0),
   _uniformCheckInProcess(false),
   kore::BaseResource() {
 }
 
+std::unordered_map<GLuint, uint> kore::ShaderProgram::_programRefCounts;
+
 kore::ShaderProgram::~ShaderProgram(void) {
   destroyProgram();
 }
 
 void kore::ShaderProgram::destroyProgram() {
   if(_programHandle != KORE_GLUINT_HANDLE_INVALID) {
-    glDeleteProgram(_programHandle);
+    auto it = _programRefCounts.find(_programHandle);
+    if (it == _programRefCounts.end() || --it->second == 0) {
+      if (it != _programRefCounts.end()) {
+        _programRefCounts.erase(it);
+      }
+      UniformBuffer::removeProgram(_programHandle);
+      glDeleteProgram(_programHandle);
+    }
     _programHandle = KORE_GLUINT_HANDLE_INVALID;
   }
 
@@ -57,6 +71,19 @@ void kore::ShaderProgram::destroyProgram() {
   _uniforms.clear();
   _attributes.clear();
   _imgAccessParams.clear();
+  _uniformBlocks.clear();
+  _uniformBlockLayouts.clear();
+  _attributeLookup.clear();
+  _uniformLookup.clear();
+  releaseSamplers();
+}
+
+void kore::ShaderProgram::releaseSamplers() {
+  ResourceManager* resMgr = ResourceManager::getInstance();
+  for (uint i = 0; i < _vSamplers.size(); ++i) {
+    resMgr->releaseTextureSampler(_vSamplers[i]);
+  }
+  _vSamplers.clear();
 }
 
 void kore::ShaderProgram::removeShaders() {
@@ -65,6 +92,7 @@ void kore::ShaderProgram::removeShaders() {
   _fragment_prog = NULL;
   _tess_ctrl = NULL;
   _tess_eval = NULL;
+  _compute_prog = NULL;
 }
 
 
@@ -80,6 +108,26 @@ void kore::ShaderProgram::loadShader(const std::string& file,
     shader = kore::ResourceManager::getInstance()->getShader(sid);
   }
 
+  setShader(shader, shadertype);
+}
+
+void kore::ShaderProgram::loadShaderSource(const std::string& source,
+                                           GLenum shadertype,
+                                           const std::string& name) {
+  kore::Shader* shader = NULL;
+  uint64 sid = kore::IDManager::getInstance()->getID(name);
+  if(sid == 0) {  // Shader not found in cache.
+    shader = new kore::Shader();
+    shader->loadShaderSource(source, shadertype, name);
+    kore::IDManager::getInstance()->registerURL(shader->getID(), name);
+  } else {
+    shader = kore::ResourceManager::getInstance()->getShader(sid);
+  }
+
+  setShader(shader, shadertype);
+}
+
+void kore::ShaderProgram::setShader(Shader* shader, GLenum shadertype) {
   switch (shadertype) {
   case GL_VERTEX_SHADER:
     _vertex_prog = shader;
@@ -96,6 +144,9 @@ void kore::ShaderProgram::loadShader(const std::string& file,
   case GL_TESS_EVALUATION_SHADER:
     _tess_eval = shader;
     break;
+  case GL_COMPUTE_SHADER:
+    _compute_prog = shader;
+    break;
   }
 }
 
@@ -116,6 +167,9 @@ kore::Shader* kore::ShaderProgram::getShader(GLenum shadertype) {
   case GL_TESS_EVALUATION_SHADER:
     return _tess_eval;
     break;
+  case GL_COMPUTE_SHADER:
+    return _compute_prog;
+    break;
   default:
     return NULL;
   }
@@ -144,14 +198,41 @@ bool kore::ShaderProgram::init() {
     shaderKey += _tess_eval->getName();
   }
 
+  if (_compute_prog) {
+    if (_vertex_prog || _fragment_prog || _geometry_prog
+        || _tess_ctrl || _tess_eval) {
+      KORE_LOG_ERROR(LOG_CATEGORY_SHADER, "ShaderProgram %s: a compute shader "
+                     "can't be combined with other stages\n",
+                     _name.c_str());
+      return false;
+    }
+    shaderKey += _compute_prog->getName();
+  }
+
   ResourceManager* resMgr = ResourceManager::getInstance();
   if (resMgr->isShaderProgramLoaded(shaderKey)) {
     ShaderProgram* sProg = resMgr->getLoadedShaderProgram(shaderKey);
+    if (_programHandle != KORE_GLUINT_HANDLE_INVALID) {
+      destroyProgram();
+    }
     this->_programHandle = sProg->_programHandle;
+    ++_programRefCounts[_programHandle];
     this->_outputs = sProg->_outputs;
     this->_uniforms = sProg->_uniforms;
     this->_attributes = sProg->_attributes;
-    this->_vSamplers = sProg->_vSamplers;
+    this->_uniformBlocks = sProg->_uniformBlocks;
+    this->_uniformBlockLayouts = sProg->_uniformBlockLayouts;
+    this->_computeWorkGroupSize = sProg->_computeWorkGroupSize;
+    for (uint i = 0; i < _uniformBlocks.size(); ++i) {
+      _uniformBlocks[i].additionalData = &_uniformBlockLayouts[i];
+    }
+    releaseSamplers();
+    for (uint i = 0; i < sProg->_vSamplers.size(); ++i) {
+      const TextureSampler* sampler = sProg->_vSamplers[i];
+      _vSamplers.push_back(sampler ?
+        resMgr->requestTextureSampler(sampler->getProperties()) : NULL);
+    }
+    buildInputLookup();
   }
 
   else {
@@ -160,6 +241,8 @@ bool kore::ShaderProgram::init() {
     }
 
     _programHandle = glCreateProgram();
+    _programRefCounts[_programHandle] = 1;
+    applyDebugLabel();
   
     if (_vertex_prog) {
       glAttachShader(_programHandle, _vertex_prog->getHandle());
@@ -181,6 +264,10 @@ bool kore::ShaderProgram::init() {
       glAttachShader(_programHandle, _tess_eval->getHandle());
     }
 
+    if (_compute_prog) {
+      glAttachShader(_programHandle, _compute_prog->getHandle());
+    }
+
     glLinkProgram(_programHandle);
     
     bool success = checkProgramLinkStatus(_programHandle, _name);
@@ -191,24 +278,36 @@ bool kore::ShaderProgram::init() {
 
     constructShaderInputInfo(GL_ACTIVE_ATTRIBUTES, _attributes);
     //for (uint i = 0; i < _attributes.size(); i++) {
-    //    kore::Log::getInstance()->write("\tAttribute '%s' at location %i\n",
-    //        _attributes[i].name.c_str(),
-    //        _attributes[i].location);
+    //    KORE_LOG_DEBUG(LOG_CATEGORY_SHADER,
+    //                   "\tAttribute '%s' at location %i\n",
+    //                   _attributes[i].name.c_str(),
+    //                   _attributes[i].location);
     //}
     constructShaderInputInfo(GL_ACTIVE_UNIFORMS, _uniforms);
     //for (uint j = 0; j < _uniforms.size(); j++) {
-    //    kore::Log::getInstance()->write("\tUniform '%s' at location %i\n",
-    //        _uniforms[j].name.c_str(),
-    //        _uniforms[j].location);
+    //    KORE_LOG_DEBUG(LOG_CATEGORY_SHADER,
+    //                   "\tUniform '%s' at location %i\n",
+    //                   _uniforms[j].name.c_str(),
+    //                   _uniforms[j].location);
     //}
+    constructUniformBlockInfo();
+    buildInputLookup();
+
+    if (_compute_prog) {
+      GLint workGroupSize[3];
+      glGetProgramiv(_programHandle, GL_COMPUTE_WORK_GROUP_SIZE,
+                     workGroupSize);
+      _computeWorkGroupSize = glm::uvec3(workGroupSize[0], workGroupSize[1],
+                                         workGroupSize[2]);
+    }
 
     /*
     /* OpenGL 4.3 or arb_program_interface_query needed
     /*
     constructShaderOutputInfo(_outputs);
     for (uint j = 0; j < _outputs.size(); j++) {
-        kore::Log::getInstance()->write("\tOutput '%s'\n",
-            _outputs[j].name.c_str());
+        KORE_LOG_DEBUG(LOG_CATEGORY_SHADER, "\tOutput '%s'\n",
+                       _outputs[j].name.c_str());
     }
     */
 
@@ -248,6 +347,37 @@ const std::vector<kore::ShaderOutput>& kore::ShaderProgram
     return _outputs;
 }
 
+const std::vector<kore::ShaderInput>& kore::ShaderProgram
+  ::getUniformBlocks() const {
+    return _uniformBlocks;
+}
+
+void kore::ShaderProgram::
+  setUniformBlockBinding(const std::string& blockName,
+                         const GLuint binding) {
+  if (_programHandle != KORE_GLUINT_HANDLE_INVALID) {
+    KORE_LOG_WARNING(LOG_CATEGORY_SHADER, "ShaderProgram %s: the binding of "
+                     "uniform block '%s' is used from the next "
+                     "init() on\n", _name.c_str(),
+                     blockName.c_str());
+  }
+  _declaredBlockBindings[blockName] = binding;
+}
+
+const kore::ShaderInput* kore::ShaderProgram
+  ::getUniformBlock(const std::string& name) const {
+    for (uint i = 0; i < _uniformBlocks.size(); ++i) {
+      if (_uniformBlocks[i].name == name) {
+        return &_uniformBlocks[i];
+      }
+    }
+
+    KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                   "Uniform block '%s' not found in shader '%s'\n",
+                   name.c_str(), _name.c_str());
+    return NULL;
+}
+
 void kore::ShaderProgram::constructShaderInputInfo(const GLenum activeType,
                                 std::vector<kore::ShaderInput>& rInputVector) {
   GLint iNumActiveElements = 0;
@@ -293,6 +423,16 @@ void kore::ShaderProgram::constructShaderInputInfo(const GLenum activeType,
         iElementLoc = glGetAttribLocation(_programHandle, szNameBuf);
     }
     if (activeType == GL_ACTIVE_UNIFORMS){
+        // Members of uniform blocks are sourced from buffers and can't be
+        // bound as individual uniforms.
+        GLuint uniformIndex = i;
+        GLint blockIndex = -1;
+        glGetActiveUniformsiv(_programHandle, 1, &uniformIndex,
+                              GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+        if (blockIndex != -1) {
+          continue;
+        }
+
         glGetActiveUniform(_programHandle, i, BUFSIZE, &iActualNameLength,
             &iElementSize, &eElementType, szNameBuf);
         iElementLoc = glGetUniformLocation(_programHandle, szNameBuf);
@@ -399,6 +539,122 @@ void kore::ShaderProgram::constructShaderInputInfo(const GLenum activeType,
   }
 }
 
+void kore::ShaderProgram::constructUniformBlockInfo() {
+  _uniformBlocks.clear();
+  _uniformBlockLayouts.clear();
+
+  GLint iNumBlocks = 0;
+  glGetProgramiv(_programHandle, GL_ACTIVE_UNIFORM_BLOCKS, &iNumBlocks);
+
+  // GL reports binding 0 for blocks without a binding qualifier, so only
+  // non-zero and declared bindings (see setUniformBlockBinding) are kept.
+  // All other blocks get the lowest bindings that those don't use.
+  std::vector<GLint> vBindings(iNumBlocks, 0);
+  std::vector<bool> vExplicitBinding(iNumBlocks, false);
+  std::set<GLint> usedBindings;
+  for (GLint iBlock = 0; iBlock < iNumBlocks; ++iBlock) {
+    GLchar szNameBuf[BUFSIZE];
+    glGetActiveUniformBlockName(_programHandle, iBlock, BUFSIZE, NULL,
+                                szNameBuf);
+    glGetActiveUniformBlockiv(_programHandle, iBlock,
+                              GL_UNIFORM_BLOCK_BINDING, &vBindings[iBlock]);
+    auto itDeclared = _declaredBlockBindings.find(szNameBuf);
+    const bool declared = itDeclared != _declaredBlockBindings.end();
+    if (declared) {
+      vBindings[iBlock] = itDeclared->second;
+      glUniformBlockBinding(_programHandle, iBlock, vBindings[iBlock]);
+    }
+    if (vBindings[iBlock] != 0 || declared) {
+      vExplicitBinding[iBlock] = true;
+      usedBindings.insert(vBindings[iBlock]);
+    }
+  }
+
+  GLint iNextBinding = 0;
+  for (GLint iBlock = 0; iBlock < iNumBlocks; ++iBlock) {
+    GLchar szNameBuf[BUFSIZE];
+    GLsizei iActualNameLength = 0;
+    glGetActiveUniformBlockName(_programHandle, iBlock, BUFSIZE,
+                                &iActualNameLength, szNameBuf);
+
+    GLint iDataSize = 0;
+    GLint iBinding = vBindings[iBlock];
+    GLint iNumMembers = 0;
+    glGetActiveUniformBlockiv(_programHandle, iBlock,
+                              GL_UNIFORM_BLOCK_DATA_SIZE, &iDataSize);
+    glGetActiveUniformBlockiv(_programHandle, iBlock,
+                              GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &iNumMembers);
+
+    if (!vExplicitBinding[iBlock]) {
+      while (usedBindings.count(iNextBinding) > 0) {
+        ++iNextBinding;
+      }
+      iBinding = iNextBinding++;
+      glUniformBlockBinding(_programHandle, iBlock, iBinding);
+    }
+
+    UniformBlockLayout layout(BLOCKLAYOUT_REFLECTED);
+    layout.setName(std::string(szNameBuf));
+    layout.setDataSize(iDataSize);
+
+    if (iNumMembers > 0) {
+      std::vector<GLint> vIndices(iNumMembers);
+      glGetActiveUniformBlockiv(_programHandle, iBlock,
+                                GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES,
+                                &vIndices[0]);
+
+      std::vector<GLuint> vUIndices(vIndices.begin(), vIndices.end());
+      std::vector<GLint> vTypes(iNumMembers), vSizes(iNumMembers),
+        vOffsets(iNumMembers), vArrayStrides(iNumMembers),
+        vMatrixStrides(iNumMembers);
+
+      glGetActiveUniformsiv(_programHandle, iNumMembers, &vUIndices[0],
+                            GL_UNIFORM_TYPE, &vTypes[0]);
+      glGetActiveUniformsiv(_programHandle, iNumMembers, &vUIndices[0],
+                            GL_UNIFORM_SIZE, &vSizes[0]);
+      glGetActiveUniformsiv(_programHandle, iNumMembers, &vUIndices[0],
+                            GL_UNIFORM_OFFSET, &vOffsets[0]);
+      glGetActiveUniformsiv(_programHandle, iNumMembers, &vUIndices[0],
+                            GL_UNIFORM_ARRAY_STRIDE, &vArrayStrides[0]);
+      glGetActiveUniformsiv(_programHandle, iNumMembers, &vUIndices[0],
+                            GL_UNIFORM_MATRIX_STRIDE, &vMatrixStrides[0]);
+
+      for (GLint iMember = 0; iMember < iNumMembers; ++iMember) {
+        GLchar szMemberName[BUFSIZE];
+        glGetActiveUniformName(_programHandle, vUIndices[iMember], BUFSIZE,
+                               NULL, szMemberName);
+
+        SBlockMember member;
+        member.name = UniformBlockLayout::getBaseName(szMemberName);
+        member.type = vTypes[iMember];
+        member.arraySize = vSizes[iMember];
+        member.offset = vOffsets[iMember];
+        member.arrayStride = vArrayStrides[iMember];
+        member.matrixStride = vMatrixStrides[iMember];
+        layout.addMember(member);
+      }
+    }
+
+    ShaderInput element;
+    element.name = std::string(szNameBuf);
+    element.type = GL_UNIFORM_BLOCK;
+    element.input_type = GL_ACTIVE_UNIFORM_BLOCKS;
+    element.size = 1;
+    element.location = iBlock;
+    element.uniformBlockBinding = iBinding;
+    element.programHandle = _programHandle;
+    element.shader = this;
+
+    _uniformBlocks.push_back(element);
+    _uniformBlockLayouts.push_back(layout);
+  }
+
+  // Only take pointers once the layout-vector doesn't grow anymore.
+  for (uint i = 0; i < _uniformBlocks.size(); ++i) {
+    _uniformBlocks[i].additionalData = &_uniformBlockLayouts[i];
+  }
+}
+
 void kore::ShaderProgram::constructShaderOutputInfo(std::vector<ShaderOutput>& 
                                              rOutputVector) {
     GLint iNumActiveElements = 0;
@@ -448,54 +704,86 @@ bool kore::ShaderProgram::checkProgramLinkStatus(const GLuint programHandle,
   if (infologLen > 1) {
     GLchar * infoLog = new GLchar[infologLen];
     if (infoLog == NULL) {
-      kore::Log::getInstance()->write(
-        "[ERROR] Could not allocate ShaderInfoLog buffer from '%s'\n",
-        name.c_str());
+      KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                     "Could not allocate ShaderInfoLog buffer from '%s'\n",
+                     name.c_str());
     }
     int charsWritten = 0;
     glGetProgramInfoLog(programHandle, infologLen, &charsWritten, infoLog);
     std::string shaderlog = infoLog;
-    kore::Log::getInstance()->write(
-      "[DEBUG] '%s' program Log %s\n", name.c_str(), shaderlog.c_str());
+    KORE_LOG_DEBUG(LOG_CATEGORY_SHADER,
+                   "'%s' program Log %s\n", name.c_str(), shaderlog.c_str());
     KORE_SAFE_DELETE_ARR(infoLog);
   } else {
-    /*kore::Log::getInstance()->write(
-      "[DEBUG] Program '%s' linked\n", name.c_str());*/
+    /*KORE_LOG_DEBUG(LOG_CATEGORY_SHADER, 
+      "Program '%s' linked\n", name.c_str());*/
   }
 
   return success == GL_TRUE;
 }
 
+void kore::ShaderProgram::buildInputLookup() {
+  StringTable* strTable = StringTable::getInstance();
+
+  _attributeLookup.clear();
+  for (uint i = 0; i < _attributes.size(); ++i) {
+    _attributeLookup[strTable->intern(_attributes[i].name)] = i;
+  }
+
+  _uniformLookup.clear();
+  for (uint i = 0; i < _uniforms.size(); ++i) {
+    _uniformLookup[strTable->intern(_uniforms[i].name)] = i;
+  }
+}
+
 const kore::ShaderInput*
 kore::ShaderProgram::getAttribute(const std::string& name) const {
-  for (uint i = 0; i < _attributes.size(); ++i) {
-    if (_attributes[i].name == name) {
-      return &_attributes[i];
-    }
+  return getAttribute(StringTable::getInstance()->find(name), name);
+}
+
+const kore::ShaderInput*
+kore::ShaderProgram::getAttribute(const StringID nameID) const {
+  return getAttribute(nameID, StringTable::getInstance()->getString(nameID));
+}
+
+const kore::ShaderInput*
+kore::ShaderProgram::getAttribute(const StringID nameID,
+                                  const std::string& name) const {
+  auto it = _attributeLookup.find(nameID);
+  if (it != _attributeLookup.end()) {
+    return &_attributes[it->second];
   }
 
-  Log::getInstance()->write(
-      "[ERROR] Attribute '%s' not found in shader '%s'\n",
-      name.c_str(), _name.c_str());
+  KORE_LOG_ERROR(LOG_CATEGORY_SHADER,
+                 "Attribute '%s' not found in shader '%s'\n",
+                 name.c_str(), _name.c_str());
   return NULL;
 }
 
 const kore::ShaderInput*
 kore::ShaderProgram::getUniform(const std::string& name) const {
-  for (uint i = 0; i < _uniforms.size(); ++i) {
-    if (_uniforms[i].name == name) {
-      const kore::ShaderInput* foundInput = &_uniforms[i];
-      
-      if (_uniformCheckInProcess) {
-        _tagList.push_back(i);
-      }
+  return getUniform(StringTable::getInstance()->find(name), name);
+}
+
+const kore::ShaderInput*
+kore::ShaderProgram::getUniform(const StringID nameID) const {
+  return getUniform(nameID, StringTable::getInstance()->getString(nameID));
+}
 
-      return foundInput;
+const kore::ShaderInput*
+kore::ShaderProgram::getUniform(const StringID nameID,
+                                const std::string& name) const {
+  auto it = _uniformLookup.find(nameID);
+  if (it != _uniformLookup.end()) {
+    if (_uniformCheckInProcess) {
+      _tagList.push_back(it->second);
     }
+
+    return &_uniforms[it->second];
   }
 
-  Log::getInstance()->write("[ERROR] Uniform '%s' not found in shader '%s'\n",
-    name.c_str(), _name.c_str());
+  KORE_LOG_ERROR(LOG_CATEGORY_SHADER, "Uniform '%s' not found in shader '%s'\n",
+                 name.c_str(), _name.c_str());
   return NULL;
 }
 
@@ -509,8 +797,10 @@ void kore::ShaderProgram::setSamplerProperties(const uint idx,
         return;
   }
 
-  _vSamplers[idx] = ResourceManager::getInstance()->
-                                    requestTextureSampler(properties);
+  ResourceManager* resMgr = ResourceManager::getInstance();
+  const TextureSampler* oldSampler = _vSamplers[idx];
+  _vSamplers[idx] = resMgr->requestTextureSampler(properties);
+  resMgr->releaseTextureSampler(oldSampler);
 }
 
 void kore::ShaderProgram::setSamplerProperties(const std::string& uniformName,
@@ -560,13 +850,17 @@ void kore::ShaderProgram::finishUniformBindingCheck() {
     }
 
     if (!isTagged) {
-      Log::getInstance()->write("[WARNING] Shader %s: The active uniform %s " 
-                                "was not bound to the shader!\n",
-                                this->_name.c_str(),
-                                _uniforms[iUniform].name.c_str());
+      KORE_LOG_WARNING(LOG_CATEGORY_SHADER, "Shader %s: The active uniform %s "
+                       "was not bound to the shader!\n",
+                       this->_name.c_str(),
+                       _uniforms[iUniform].name.c_str());
     }
   }
 
   _uniformCheckInProcess = false;
   _tagList.clear();
 }
+
+void kore::ShaderProgram::applyDebugLabel(void) const {
+  GLerror::setObjectLabel(GL_PROGRAM, _programHandle, _name);
+}
@@ -22,12 +22,15 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include "KoRE/ShaderInput.h"
 #include "KoRE/ShaderOutput.h"
 #include "KoRE/Common.h"
 #include "KoRE/TextureSampler.h"
 #include "KoRE/BaseResource.h"
 #include "KoRE/Shader.h"
+#include "KoRE/StringTable.h"
+#include "KoRE/UniformBlockLayout.h"
 
 namespace kore {
   class Operation;
@@ -37,6 +40,9 @@ namespace kore {
     virtual ~ShaderProgram(void);
     /// load a single shader from file
     void loadShader(const std::string& file, GLenum shadertype, std::string defines = "");
+    /// compile a single shader from source code in memory
+    void loadShaderSource(const std::string& source, GLenum shadertype,
+                          const std::string& name);
     /// Returns the attached shader of given type, else NULL
     Shader* getShader(GLenum shadertype);
     /// compile and link shader program
@@ -47,10 +53,28 @@ namespace kore {
     inline const std::string& getName(void){return _name;};
     const ShaderInput* getAttribute(const std::string& name) const;
     const ShaderInput* getUniform(const std::string& name) const;
+    /// Lookup by interned name. Prefer these when binding many nodes.
+    const ShaderInput* getAttribute(const StringID nameID) const;
+    const ShaderInput* getUniform(const StringID nameID) const;
     const std::vector<ShaderInput>& getAttributes() const;
     const std::vector<ShaderInput>& getUniforms() const;
     const std::vector<ShaderOutput>& getOutputs() const;
 
+    /*! \brief Retrieve the active uniform blocks of this program. The
+    *          additionalData-field of each ShaderInput points to the
+    *          reflected UniformBlockLayout of the block. */
+    const std::vector<ShaderInput>& getUniformBlocks() const;
+    const ShaderInput* getUniformBlock(const std::string& name) const;
+
+    /*! \brief Declares a fixed binding point for a uniform block. Blocks
+    *          without a declared or shader-side (non-zero) binding are
+    *          assigned free binding points on init(). GL reports binding 0
+    *          for blocks without a binding qualifier, so a shader-side
+    *          "binding = 0" is only kept if it is declared here as well.
+    *          Has to be called before init(); it is kept over relinks. */
+    void setUniformBlockBinding(const std::string& blockName,
+                                const GLuint binding);
+
     /*! \brief Get the currently selected imageAccess-parameter for the image
     *          uniform at the provided imageUnit.
     *   \param imgUnit The imageUnit which the image will be bound to.
@@ -91,10 +115,22 @@ namespace kore {
     void setSamplerProperties(const std::string& uniformName,
                               const TexSamplerProperties& properties);
 
+    /*! \brief Returns true if the program consists of a compute shader. */
+    inline bool isCompute() const {return _compute_prog != NULL;}
+
+    /*! \brief Returns the local work group size of a compute program. */
+    inline const glm::uvec3& getComputeWorkGroupSize() const
+      {return _computeWorkGroupSize;}
+
     /*! \brief Set a new name for the ShaderProgram
      * \param name The new name
      */
-    inline void setName(const std::string& name){_name = name;}
+    inline void setName(const std::string& name)
+      {_name = name; applyDebugLabel();}
+
+    /*! \brief Labels the GL program with its name
+    *          (see GLerror::setDebugAnnotationsEnabled). */
+    void applyDebugLabel(void) const;
 
     void removeShaders();
 
@@ -103,10 +139,17 @@ namespace kore {
 
 
   private:
+    void setShader(Shader* shader, GLenum shadertype);
     static bool checkProgramLinkStatus(const GLuint programHandle,
                                        const std::string& name);
 
     void destroyProgram();
+    void releaseSamplers();
+    void buildInputLookup();
+    const ShaderInput* getAttribute(const StringID nameID,
+                                    const std::string& name) const;
+    const ShaderInput* getUniform(const StringID nameID,
+                                  const std::string& name) const;
 
     void getAttributeInfo();
     void getUniformInfo();
@@ -115,14 +158,22 @@ namespace kore {
 
     void constructShaderOutputInfo(std::vector<ShaderOutput>& rOutputVector);
 
+    void constructUniformBlockInfo();
+
     std::string _name;
     std::vector<ShaderInput> _attributes;
     std::vector<ShaderInput> _uniforms;
     std::vector<ShaderOutput> _outputs;
+    std::vector<ShaderInput> _uniformBlocks;
+    std::vector<UniformBlockLayout> _uniformBlockLayouts;
+    std::unordered_map<std::string, GLuint> _declaredBlockBindings;
     std::vector<GLuint> _imgAccessParams;
 
     std::vector<const TextureSampler*> _vSamplers;
 
+    std::unordered_map<StringID, uint> _attributeLookup;  // name || index
+    std::unordered_map<StringID, uint> _uniformLookup;  // name || index
+
     mutable std::vector<uint> _tagList;
     bool _uniformCheckInProcess;
 
@@ -131,8 +182,14 @@ namespace kore {
     Shader* _fragment_prog;
     Shader* _tess_ctrl;
     Shader* _tess_eval;
+    Shader* _compute_prog;
+    glm::uvec3 _computeWorkGroupSize;
 
     GLuint _programHandle;
+
+    // Programs with the same shaders share one GL program (see init()). It
+    // is only deleted when the last of them is destroyed.
+    static std::unordered_map<GLuint, uint> _programRefCounts;
   };
 };
 #endif  // SRC_KORE_SHADERPROGRAM_H_
@@ -0,0 +1,183 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/StreamingBuffer.h"
+#include "KoRE/RenderManager.h"
+#include "KoRE/GLerror.h"
+#include "KoRE/Log.h"
+
+kore::StreamingBuffer::StreamingBuffer(void)
+  : _target(GL_UNIFORM_BUFFER),
+    _handle(KORE_GLUINT_HANDLE_INVALID),
+    _frameSize(0),
+    _numFrames(0),
+    _frameIndex(0),
+    _writeOffset(0),
+    _alignment(1),
+    _persistent(false),
+    _overflowReported(false),
+    _mapping(NULL) {
+}
+
+kore::StreamingBuffer::~StreamingBuffer(void) {
+  destroy();
+}
+
+bool kore::StreamingBuffer::create(const GLenum target,
+                                   const GLsizeiptr frameSize,
+                                   const uint numFrames) {
+  destroy();
+
+  _target = target;
+  _numFrames = numFrames > 0 ? numFrames : 1;
+
+  if (target == GL_SHADER_STORAGE_BUFFER) {
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &_alignment);
+  } else {
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &_alignment);
+  }
+  if (_alignment < 1) {
+    _alignment = 1;
+  }
+
+  // Every region has to start at an aligned offset.
+  _frameSize = ((frameSize + _alignment - 1) / _alignment) * _alignment;
+  const GLsizeiptr totalSize = _frameSize * _numFrames;
+
+  GLerror::gl_ErrorCheckStart();
+  glGenBuffers(1, &_handle);
+  RenderManager::getInstance()->bindBuffer(_target, _handle);
+
+#ifdef GL_ARB_buffer_storage
+  if (GLEW_ARB_buffer_storage) {
+    const GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(_target, totalSize, NULL, flags);
+    _mapping = static_cast<GLubyte*>(
+      glMapBufferRange(_target, 0, totalSize, flags));
+    _persistent = _mapping != NULL;
+  }
+#endif
+
+  if (!_persistent) {
+    glBufferData(_target, totalSize, NULL, GL_STREAM_DRAW);
+    _shadowCopy.resize(totalSize);
+    _mapping = &_shadowCopy[0];
+  }
+
+  if (!GLerror::gl_ErrorCheckFinish("StreamingBuffer::create")) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RENDER, "StreamingBuffer creation failed\n");
+    destroy();
+    return false;
+  }
+
+  _fences.resize(_numFrames, 0);
+  _frameIndex = 0;
+  _writeOffset = 0;
+  return true;
+}
+
+void kore::StreamingBuffer::destroy(void) {
+  for (uint i = 0; i < _fences.size(); ++i) {
+    if (_fences[i]) {
+      glDeleteSync(_fences[i]);
+    }
+  }
+  _fences.clear();
+
+  if (_handle != KORE_GLUINT_HANDLE_INVALID) {
+    if (_persistent) {
+      RenderManager::getInstance()->bindBuffer(_target, _handle);
+      glUnmapBuffer(_target);
+    }
+    glDeleteBuffers(1, &_handle);
+    _handle = KORE_GLUINT_HANDLE_INVALID;
+  }
+
+  _shadowCopy.clear();
+  _mapping = NULL;
+  _persistent = false;
+  _overflowReported = false;
+}
+
+void kore::StreamingBuffer::beginFrame(void) {
+  if (!isCreated()) {
+    return;
+  }
+
+  _frameIndex = (_frameIndex + 1) % _numFrames;
+  _writeOffset = 0;
+
+  GLsync& fence = _fences[_frameIndex];
+  if (fence) {
+    // Wait until the GPU finished the frame that last used this region.
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+      result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                1000000);  // 1ms
+    }
+    glDeleteSync(fence);
+    fence = 0;
+  }
+}
+
+void kore::StreamingBuffer::endFrame(void) {
+  if (!isCreated()) {
+    return;
+  }
+
+  if (_fences[_frameIndex]) {
+    glDeleteSync(_fences[_frameIndex]);
+  }
+  _fences[_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLubyte* kore::StreamingBuffer::allocate(const GLsizeiptr size,
+                                         GLintptr& outOffset) {
+  if (!isCreated()) {
+    return NULL;
+  }
+
+  const GLintptr alignedOffset =
+    ((_writeOffset + _alignment - 1) / _alignment) * _alignment;
+
+  if (alignedOffset + size > _frameSize) {
+    if (!_overflowReported) {
+      KORE_LOG_WARNING(LOG_CATEGORY_RENDER, "StreamingBuffer: frame-region of "
+                       "%i bytes is full\n",
+                       static_cast<int>(_frameSize));
+      _overflowReported = true;
+    }
+    return NULL;
+  }
+
+  _writeOffset = alignedOffset + size;
+  outOffset = _frameIndex * _frameSize + alignedOffset;
+  return _mapping + outOffset;
+}
+
+void kore::StreamingBuffer::commit(const GLintptr offset,
+                                   const GLsizeiptr size) {
+  if (_persistent || !isCreated()) {
+    return;
+  }
+
+  RenderManager::getInstance()->bindBuffer(_target, _handle);
+  glBufferSubData(_target, offset, size, &_shadowCopy[offset]);
+}
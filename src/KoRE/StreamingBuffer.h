@@ -0,0 +1,92 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_STREAMINGBUFFER_H_
+#define KORE_SRC_KORE_STREAMINGBUFFER_H_
+
+#include <vector>
+#include "KoRE/Common.h"
+
+namespace kore {
+  /*! \brief A ring-buffer for data that is rewritten every frame
+  *          (e.g. per-draw transform blocks).
+  *   The buffer is split into one region per frame in flight. Each frame
+  *   writes into its own region and fences it at the end, so the CPU never
+  *   overwrites data the GPU is still reading. If ARB_buffer_storage is
+  *   available, the buffer stays persistently mapped and data is written
+  *   directly into GPU-visible memory. Otherwise, writes go to a CPU copy
+  *   and are uploaded with commit().
+  */
+  class StreamingBuffer {
+  public:
+    StreamingBuffer(void);
+    ~StreamingBuffer(void);
+
+    /*! \brief Creates the buffer.
+    *   \param target The buffer target (GL_UNIFORM_BUFFER or
+    *                 GL_SHADER_STORAGE_BUFFER).
+    *   \param frameSize The number of bytes available per frame.
+    *   \param numFrames The number of frames in flight (regions).
+    *   \return True, if the creation was successful. */
+    bool create(const GLenum target,
+                const GLsizeiptr frameSize,
+                const uint numFrames = 3);
+
+    void destroy(void);
+
+    /*! \brief Switches to the next region. Waits for the GPU if it still
+    *          reads from that region. */
+    void beginFrame(void);
+
+    /*! \brief Fences all commands that read from the current region. */
+    void endFrame(void);
+
+    /*! \brief Reserves memory in the current region. The offset is aligned
+    *          to the offset-alignment of the target.
+    *   \param size The number of bytes to reserve.
+    *   \param outOffset The offset of the reservation in the buffer.
+    *   \return A pointer to write the data into or NULL if the region is
+    *           full. */
+    GLubyte* allocate(const GLsizeiptr size, GLintptr& outOffset);
+
+    /*! \brief Makes written data visible to the GPU. Does nothing for
+    *          persistently mapped buffers. */
+    void commit(const GLintptr offset, const GLsizeiptr size);
+
+    inline GLuint getHandle() const {return _handle;}
+    inline GLenum getTarget() const {return _target;}
+    inline bool isCreated() const {return _handle != KORE_GLUINT_HANDLE_INVALID;}
+    inline bool isPersistent() const {return _persistent;}
+
+  private:
+    GLenum _target;
+    GLuint _handle;
+    GLsizeiptr _frameSize;
+    uint _numFrames;
+    uint _frameIndex;
+    GLintptr _writeOffset;  // Write-head within the current region
+    GLint _alignment;
+    bool _persistent;
+    bool _overflowReported;
+    GLubyte* _mapping;
+    std::vector<GLubyte> _shadowCopy;
+    std::vector<GLsync> _fences;
+  };
+}
+#endif  // KORE_SRC_KORE_STREAMINGBUFFER_H_
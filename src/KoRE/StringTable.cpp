@@ -0,0 +1,59 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KoRE/StringTable.h"
+
+kore::StringTable* kore::StringTable::getInstance(void) {
+  static kore::StringTable theInstance;
+  return &theInstance;
+}
+
+kore::StringTable::StringTable(void)
+  : _invalidString("") {
+}
+
+kore::StringTable::~StringTable(void) {
+}
+
+kore::StringID kore::StringTable::intern(const std::string& str) {
+  auto it = _ids.find(str);
+  if (it != _ids.end()) {
+    return it->second;
+  }
+
+  _strings.push_back(str);
+  StringID id = static_cast<StringID>(_strings.size());
+  _ids[str] = id;
+  return id;
+}
+
+kore::StringID kore::StringTable::find(const std::string& str) const {
+  auto it = _ids.find(str);
+  if (it != _ids.end()) {
+    return it->second;
+  }
+  return KORE_STRINGID_INVALID;
+}
+
+const std::string& kore::StringTable::getString(const StringID id) const {
+  if (id == KORE_STRINGID_INVALID || id > _strings.size()) {
+    return _invalidString;
+  }
+  return _strings[id - 1];
+}
@@ -0,0 +1,63 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_STRINGTABLE_H_
+#define KORE_SRC_KORE_STRINGTABLE_H_
+
+#include <deque>
+#include <unordered_map>
+#include "KoRE/Common.h"
+
+#define KORE_STRINGID_INVALID 0
+
+namespace kore {
+  /// 32-bit identifier of an interned string
+  typedef uint StringID;
+
+  /*! \brief Global string interner. Every distinct string is stored once
+  *          and identified by a StringID, so names can be compared and
+  *          hashed as integers.
+  */
+  class StringTable {
+  public:
+    static StringTable* getInstance(void);
+    ~StringTable(void);
+
+    /*! \brief Returns the id of the string. The string is added to the
+    *          table if it has not been interned yet. */
+    StringID intern(const std::string& str);
+
+    /*! \brief Returns the id of an already interned string without adding it.
+    *   \return The id or KORE_STRINGID_INVALID if the string is unknown. */
+    StringID find(const std::string& str) const;
+
+    /*! \brief Returns the string for an id or an empty string if the id is
+    *          invalid. The returned reference stays valid for the lifetime
+    *          of the program. */
+    const std::string& getString(const StringID id) const;
+
+  private:
+    StringTable(void);
+
+    std::deque<std::string> _strings;  // id - 1 || string
+    std::unordered_map<std::string, StringID> _ids;
+    std::string _invalidString;
+  };
+}
+#endif  // KORE_SRC_KORE_STRINGTABLE_H_
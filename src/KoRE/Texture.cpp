@@ -22,6 +22,7 @@
 #include "KoRE/GLerror.h"
 #include "KoRE/IDManager.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/ResourceManager.h"
 
 kore::Texture::Texture()
                     : _handle(KORE_GLUINT_HANDLE_INVALID),
@@ -40,6 +41,7 @@ void kore::Texture::destroy() {
   }
 
   glDeleteTextures(1, &_handle);
+  ResourceManager::getInstance()->getGPUMemoryTracker().release(getID());
   _handle = KORE_GLUINT_HANDLE_INVALID;
   _resourcepath = "";
   _properties = STextureProperties();
@@ -69,9 +71,19 @@ bool kore::Texture::init(const STextureProperties& properties,
     texTarget = GL_TEXTURE_3D;
 
   } else {
-    Log::getInstance()
-      ->write("[ERROR] '%s' : Invalid texture dimensions provided.\n",
-              name.c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   "'%s' : Invalid texture dimensions provided.\n",
+                   name.c_str());
+    return false;
+  }
+
+  GPUMemoryTracker& gpuMemory =
+    ResourceManager::getInstance()->getGPUMemoryTracker();
+  if (!gpuMemory.allocate(getID(), GPUMEM_TEXTURE, name,
+      GPUMemoryTracker::getTextureByteSize(properties, false))) {
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   "'%s' : Texture exceeds the GPU memory budget.\n",
+                   name.c_str());
     return false;
   }
 
@@ -158,8 +170,9 @@ bool kore::Texture::init(const STextureProperties& properties,
 
   bool bSuccess = GLerror::gl_ErrorCheckFinish("Texture::init()");
   if (!bSuccess) {
-    Log::getInstance()->write("[ERROR]:'%s' Texture could not be initialized!",
-                              name.c_str());
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                   ":'%s' Texture could not be initialized!",
+                   name.c_str());
     destroy();
     return false;
   }
@@ -167,12 +180,26 @@ bool kore::Texture::init(const STextureProperties& properties,
   _resourcepath = name;
   _properties = properties;
   _semantics = semantics;
+  applyDebugLabel();
 
   return true;
 }
 
+void kore::Texture::applyDebugLabel(void) const {
+  GLerror::setObjectLabel(GL_TEXTURE, _handle, _resourcepath);
+}
+
 void kore::Texture::genMipmapHierarchy() {
   if (_handle != KORE_GLUINT_HANDLE_INVALID) {
+    GPUMemoryTracker& gpuMemory =
+      ResourceManager::getInstance()->getGPUMemoryTracker();
+    if (!gpuMemory.allocate(getID(), GPUMEM_TEXTURE, _resourcepath,
+        GPUMemoryTracker::getTextureByteSize(_properties, true))) {
+      KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE,
+                     "'%s' : Mipmaps exceed the GPU memory budget.\n",
+                     _resourcepath.c_str());
+      return;
+    }
     RenderManager::getInstance()->bindTexture(_properties.targetType, _handle);
     glGenerateMipmap(_properties.targetType);
   }
@@ -112,6 +112,10 @@ namespace kore {
     void genMipmapHierarchy();
     void destroy();
 
+    /*! \brief Labels the GL texture with its name
+    *          (see GLerror::setDebugAnnotationsEnabled). */
+    void applyDebugLabel(void) const;
+
   private:
     GLuint _handle;
     std:: string _resourcepath;
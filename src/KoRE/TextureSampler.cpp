@@ -25,10 +25,51 @@ bool kore::TextureSampler::create(const TexSamplerProperties& properties) {
   glSamplerParameteri(_handle, GL_TEXTURE_WRAP_R, properties.wrapping.r);
   glSamplerParameteri(_handle, GL_TEXTURE_MAG_FILTER, properties.magfilter);
   glSamplerParameteri(_handle, GL_TEXTURE_MIN_FILTER, properties.minfilter);
-  //glSamplerParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY_EXT, 16.0f);
+  glSamplerParameterf(_handle, GL_TEXTURE_LOD_BIAS, properties.lodBias);
+  glSamplerParameteri(_handle, GL_TEXTURE_COMPARE_MODE, properties.compareMode);
+  glSamplerParameteri(_handle, GL_TEXTURE_COMPARE_FUNC, properties.compareFunc);
+  glSamplerParameterfv(_handle, GL_TEXTURE_BORDER_COLOR,
+                       glm::value_ptr(properties.borderColor));
+
+  if (properties.maxAnisotropy > 1.0f) {
+    if (GLEW_EXT_texture_filter_anisotropic) {
+      glSamplerParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                          properties.maxAnisotropy);
+    } else {
+      KORE_LOG_WARNING(LOG_CATEGORY_RESOURCE, "Anisotropic filtering is not "
+                       "supported\n");
+    }
+  }
+
+  _properties = properties;
   return GLerror::gl_ErrorCheckFinish("GenSampler");
 }
 
+size_t kore::TexSamplerProperties::hash() const {
+  // FNV-1a over the raw property values.
+  const GLuint values[] = {
+    type, wrapping.s, wrapping.t, wrapping.r, magfilter, minfilter,
+    compareMode, compareFunc
+  };
+  // Adding 0.0f maps -0.0f to 0.0f so equal properties hash equally.
+  const GLfloat fvalues[] = {
+    maxAnisotropy + 0.0f, lodBias + 0.0f,
+    borderColor.r + 0.0f, borderColor.g + 0.0f,
+    borderColor.b + 0.0f, borderColor.a + 0.0f
+  };
+
+  size_t h = 2166136261U;
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+  for (uint i = 0; i < sizeof(values); ++i) {
+    h = (h ^ bytes[i]) * 16777619U;
+  }
+  bytes = reinterpret_cast<const unsigned char*>(fvalues);
+  for (uint i = 0; i < sizeof(fvalues); ++i) {
+    h = (h ^ bytes[i]) * 16777619U;
+  }
+  return h;
+}
+
 GLuint kore::TextureSampler::getSamplerTypeFromTexType(const GLuint texType) {
   // TODO(dlazarek) include additional texture info to reslove ambiguities (commented sections)
   switch (texType) {
@@ -95,8 +136,8 @@ GLuint kore::TextureSampler::getSamplerTypeFromTexType(const GLuint texType) {
     return GL_UNSIGNED_INT_SAMPLER_BUFFER;
     return GL_UNSIGNED_INT_SAMPLER_2D_RECT; */
   default:
-    Log::getInstance()->write("[ERROR] No sampler-type for this texture"
-                              "type defined");
+    KORE_LOG_ERROR(LOG_CATEGORY_RESOURCE, "No sampler-type for this texture"
+                   "type defined");
     return KORE_GLUINT_HANDLE_INVALID;
     break;
   }
@@ -27,16 +27,36 @@ namespace kore {
       type(GL_SAMPLER_2D),
       wrapping(glm::uvec3(GL_REPEAT)),
       magfilter(GL_LINEAR),
-      minfilter(GL_LINEAR) { //GL_LINEAR_MIPMAP_LINEAR
+      minfilter(GL_LINEAR), //GL_LINEAR_MIPMAP_LINEAR
+      maxAnisotropy(1.0f),
+      lodBias(0.0f),
+      compareMode(GL_NONE),
+      compareFunc(GL_LEQUAL),
+      borderColor(0.0f, 0.0f, 0.0f, 0.0f) {
     }
 
     bool operator== (const TexSamplerProperties& other) const {
       return    type == other.type
               && wrapping == other.wrapping
               && magfilter == other.magfilter
-              && minfilter == other.minfilter;
+              && minfilter == other.minfilter
+              && maxAnisotropy == other.maxAnisotropy
+              && lodBias == other.lodBias
+              && compareMode == other.compareMode
+              && compareFunc == other.compareFunc
+              && borderColor == other.borderColor;
     }
 
+    /*! \brief Computes a hash-value over all properties. */
+    size_t hash() const;
+
+    /*! \brief Hash-functor for the use in unordered containers. */
+    struct Hasher {
+      size_t operator()(const TexSamplerProperties& props) const {
+        return props.hash();
+      }
+    };
+
     /// The sampler-type (e.g. GL_SAMPLER_2D)
     GLuint type;
 
@@ -48,6 +68,22 @@ namespace kore {
 
     /// The OpenGL minification filter (e.g. GL_LINEAR)
     GLuint minfilter;
+
+    /// The maximum degree of anisotropy. Values > 1 need
+    /// EXT_texture_filter_anisotropic.
+    GLfloat maxAnisotropy;
+
+    /// The bias added to the texture level-of-detail
+    GLfloat lodBias;
+
+    /// The compare mode for depth-textures (e.g. GL_COMPARE_REF_TO_TEXTURE)
+    GLuint compareMode;
+
+    /// The compare function used if the compare mode is active (e.g. GL_LESS)
+    GLuint compareFunc;
+
+    /// The color used for GL_CLAMP_TO_BORDER wrapping
+    glm::vec4 borderColor;
   };
 
   class TextureSampler {
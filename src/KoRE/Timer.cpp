@@ -1,20 +1,25 @@
 #include "KoRE/Timer.h"
 
 kore::Timer::Timer(void) {
+  start();
 }
 
 kore::Timer::~Timer(void) {
 }
 
 void kore::Timer::start(void) {
-  _start = clock();
+  _start = Clock::now();
   _last = _start;
 }
 
 double kore::Timer::timeSinceLastCall(void) {
-  // time prototype
-  _current = clock();
-  _diff = _current - _last;
-  _last = _current;
-  return static_cast<double>(_diff *0.001);  // in milliseconds
+  const Clock::time_point current = Clock::now();
+  const std::chrono::duration<double> diff = current - _last;
+  _last = current;
+  return diff.count();  // in seconds
+}
+
+double kore::Timer::timeSinceStart(void) const {
+  const std::chrono::duration<double> diff = Clock::now() - _start;
+  return diff.count();
 }
@@ -20,22 +20,29 @@
 #ifndef CORE_INCLUDE_CORE_TIMER_H_
 #define CORE_INCLUDE_CORE_TIMER_H_
 
-#include <ctime>
+#include <chrono>
 
 namespace kore {
+  /*! \brief Measures wall time with a monotonic clock. */
   class Timer {
   public:
+    typedef std::chrono::steady_clock Clock;
+
     Timer(void);
     virtual ~Timer(void);
 
     void start(void);
+
+    /*! \brief Returns the wall time in seconds since the last call
+    *          (or since start()). */
     double timeSinceLastCall(void);
 
+    /*! \brief Returns the wall time in seconds since start(). */
+    double timeSinceStart(void) const;
+
   private:
-    clock_t _start;
-    clock_t _current;
-    clock_t _diff;
-    clock_t _last;
+    Clock::time_point _start;
+    Clock::time_point _last;
   };
 }
 #endif  // CORE_INCLUDE_CORE_TIMER_H_
@@ -0,0 +1,324 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KORE_TRANSFORM_SSE
+#endif
+#include "KoRE/TransformHierarchy.h"
+#include "KoRE/SceneNode.h"
+#include "KoRE/Components/Transform.h"
+#include "KoRE/Components/MeshComponent.h"
+
+namespace {
+  // result = a * b for column-major matrices. result may not alias a or b.
+  inline void multiplyMat4(const glm::mat4& a, const glm::mat4& b,
+                           glm::mat4& result) {
+#ifdef KORE_TRANSFORM_SSE
+    const float* pa = &a[0][0];
+    const float* pb = &b[0][0];
+    float* pr = &result[0][0];
+    const __m128 a0 = _mm_loadu_ps(pa);
+    const __m128 a1 = _mm_loadu_ps(pa + 4);
+    const __m128 a2 = _mm_loadu_ps(pa + 8);
+    const __m128 a3 = _mm_loadu_ps(pa + 12);
+    for (int col = 0; col < 4; ++col) {
+      const float* bc = pb + col * 4;
+      __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+      r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+      r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+      r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+      _mm_storeu_ps(pr + col * 4, r);
+    }
+#else
+    result = a * b;
+#endif
+  }
+
+  // Returns the object-space box of all meshes of a node.
+  kore::SAABB getMeshBounds(const kore::SceneNode* node) {
+    kore::SAABB bounds;
+    const std::vector<kore::SceneNodeComponent*>& components =
+      node->getComponents();
+    for (uint i = 0; i < components.size(); ++i) {
+      if (components[i]->getType() == kore::COMPONENT_MESH) {
+        const kore::Mesh* mesh =
+          static_cast<kore::MeshComponent*>(components[i])->getMesh();
+        if (mesh) {
+          bounds.extend(mesh->getAABB());
+        }
+      }
+    }
+    return bounds;
+  }
+}
+
+kore::TransformHierarchy::TransformHierarchy(void)
+  : _structureDirty(true),
+    _structureVersion(0) {
+}
+
+kore::TransformHierarchy::~TransformHierarchy(void) {
+}
+
+void kore::TransformHierarchy::clear(void) {
+  // If the structure is dirty, nodes in the arrays may already be deleted.
+  if (!_structureDirty) {
+    for (uint i = 0; i < _nodes.size(); ++i) {
+      _nodes[i]->_hierarchy = NULL;
+      _nodes[i]->_hierarchyIndex = KORE_UINT_INVALID;
+    }
+  }
+  _nodes.clear();
+  _transforms.clear();
+  _parents.clear();
+  _subtreeEnd.clear();
+  _local.clear();
+  _global.clear();
+  _localBounds.clear();
+  _worldBounds.clear();
+  _subtreeBounds.clear();
+  _dirty.clear();
+  _dirtyRoots.clear();
+  _changedNodes.clear();
+  _observers.clear();
+  _structureDirty = true;
+}
+
+void kore::TransformHierarchy::rebuild(SceneNode* root) {
+  _nodes.clear();
+  _parents.clear();
+
+  // Iterative depth-first traversal. Children are pushed in reverse order,
+  // so they end up in the arrays in the order of the children-list and
+  // every subtree occupies a contiguous range.
+  std::vector<std::pair<SceneNode*, uint> > stack;
+  stack.push_back(std::make_pair(root, KORE_UINT_INVALID));
+  while (!stack.empty()) {
+    SceneNode* node = stack.back().first;
+    const uint parentIdx = stack.back().second;
+    stack.pop_back();
+
+    const uint idx = static_cast<uint>(_nodes.size());
+    node->_hierarchy = this;
+    node->_hierarchyIndex = idx;
+    _nodes.push_back(node);
+    _parents.push_back(parentIdx);
+
+    for (uint i = static_cast<uint>(node->_children.size()); i > 0; --i) {
+      stack.push_back(std::make_pair(node->_children[i - 1], idx));
+    }
+  }
+
+  const uint numNodes = static_cast<uint>(_nodes.size());
+  _subtreeEnd.resize(numNodes);
+  for (uint i = 0; i < numNodes; ++i) {
+    _subtreeEnd[i] = i + 1;
+  }
+  for (uint i = numNodes; i > 1; --i) {
+    const uint parent = _parents[i - 1];
+    if (_subtreeEnd[parent] < _subtreeEnd[i - 1]) {
+      _subtreeEnd[parent] = _subtreeEnd[i - 1];
+    }
+  }
+
+  // Nodes are visited in order, so the observers end up sorted by node.
+  _observers.clear();
+  for (uint i = 0; i < numNodes; ++i) {
+    const std::vector<SceneNodeComponent*>& components =
+      _nodes[i]->_components;
+    for (uint iComp = 0; iComp < components.size(); ++iComp) {
+      if (components[iComp]->observesTransform()) {
+        SObserver observer;
+        observer.node = i;
+        observer.component = components[iComp];
+        _observers.push_back(observer);
+      }
+    }
+  }
+
+  _transforms.resize(numNodes);
+  _local.resize(numNodes);
+  _global.resize(numNodes);
+  _localBounds.resize(numNodes);
+  _worldBounds.assign(numNodes, SAABB());
+  _subtreeBounds.assign(numNodes, SAABB());
+  for (uint i = 0; i < numNodes; ++i) {
+    _transforms[i] = _nodes[i]->_transform;
+    _local[i] = _transforms[i]->getLocal();
+    _localBounds[i] = getMeshBounds(_nodes[i]);
+  }
+
+  // The whole tree has to be recomputed.
+  _dirty.assign(numNodes, 0);
+  _dirtyRoots.clear();
+  if (numNodes > 0) {
+    _dirty[0] = 1;
+    _dirtyRoots.push_back(0);
+  }
+  _structureDirty = false;
+  ++_structureVersion;
+}
+
+void kore::TransformHierarchy::localChanged(const SceneNode* node) {
+  const uint idx = node->_hierarchyIndex;
+  if (!contains(node, idx)) {
+    // The node is not (yet) part of the arrays. The next rebuild picks up
+    // its local matrix.
+    return;
+  }
+  // The local matrix is fetched in update(), so it is composed only once
+  // even if the node is changed several times per frame.
+  if (!_dirty[idx]) {
+    _dirty[idx] = 1;
+    _dirtyRoots.push_back(idx);
+  }
+}
+
+void kore::TransformHierarchy::setLocals(SceneNode* const* nodes,
+                                          const STransformTRS* transforms,
+                                          const uint count) {
+  _dirtyRoots.reserve(_dirtyRoots.size() + count);
+  for (uint i = 0; i < count; ++i) {
+    SceneNode* node = nodes[i];
+    node->_transform->setLocal(transforms[i]);
+    node->_dirty = true;
+
+    const uint idx = node->_hierarchyIndex;
+    if (contains(node, idx) && !_dirty[idx]) {
+      _dirty[idx] = 1;
+      _dirtyRoots.push_back(idx);
+    }
+  }
+}
+
+void kore::TransformHierarchy::update(SceneNode* root) {
+  _changedNodes.clear();
+  if (_structureDirty) {
+    rebuild(root);
+  }
+
+  if (_dirtyRoots.empty()) {
+    return;
+  }
+
+  // Changing the mesh of a node marks it as changed as well.
+  for (uint i = 0; i < _dirtyRoots.size(); ++i) {
+    const uint idx = _dirtyRoots[i];
+    _local[idx] = _transforms[idx]->getLocal();
+    _localBounds[idx] = getMeshBounds(_nodes[idx]);
+  }
+
+  // Sorted, a root inside the range of a previous root is already covered
+  // by that range.
+  std::sort(_dirtyRoots.begin(), _dirtyRoots.end());
+  uint coveredEnd = 0;
+  for (uint i = 0; i < _dirtyRoots.size(); ++i) {
+    const uint dirtyRoot = _dirtyRoots[i];
+    _dirty[dirtyRoot] = 0;
+    if (dirtyRoot < coveredEnd) {
+      continue;
+    }
+    coveredEnd = _subtreeEnd[dirtyRoot];
+    updateRange(dirtyRoot, coveredEnd);
+
+    // The subtree bounds of all ancestors have changed as well. _dirty is
+    // reused to visit every ancestor only once.
+    uint ancestor = _parents[dirtyRoot];
+    while (ancestor != KORE_UINT_INVALID && !_dirty[ancestor]) {
+      _dirty[ancestor] = 1;
+      _boundsAncestors.push_back(ancestor);
+      ancestor = _parents[ancestor];
+    }
+  }
+  _dirtyRoots.clear();
+
+  // Deeper ancestors have higher indices and are merged first.
+  std::sort(_boundsAncestors.begin(), _boundsAncestors.end());
+  for (uint i = static_cast<uint>(_boundsAncestors.size()); i > 0; --i) {
+    const uint ancestor = _boundsAncestors[i - 1];
+    _dirty[ancestor] = 0;
+    SAABB& bounds = _subtreeBounds[ancestor];
+    bounds = _worldBounds[ancestor];
+    // Jump from child to child over their subtree ranges.
+    for (uint child = ancestor + 1; child < _subtreeEnd[ancestor];
+         child = _subtreeEnd[child]) {
+      bounds.extend(_subtreeBounds[child]);
+    }
+  }
+  _boundsAncestors.clear();
+}
+
+const kore::SAABB&
+  kore::TransformHierarchy::getWorldBounds(const uint index) const {
+  static const SAABB emptyBounds;
+  return index < _worldBounds.size() ? _worldBounds[index] : emptyBounds;
+}
+
+const kore::SAABB&
+  kore::TransformHierarchy::getSubtreeBounds(const uint index) const {
+  static const SAABB emptyBounds;
+  return index < _subtreeBounds.size() ? _subtreeBounds[index] : emptyBounds;
+}
+
+void kore::TransformHierarchy::updateRange(const uint begin, const uint end) {
+  // Parents precede their children, so the global matrix of the parent is
+  // always up to date when a child is reached. The parent of the first node
+  // lies outside of the range and is unchanged.
+  for (uint i = begin; i < end; ++i) {
+    const uint parent = _parents[i];
+    if (parent == KORE_UINT_INVALID) {
+      _global[i] = _local[i];
+    } else {
+      multiplyMat4(_global[parent], _local[i], _global[i]);
+    }
+  }
+
+  for (uint i = begin; i < end; ++i) {
+    _worldBounds[i] = _localBounds[i].transform(_global[i]);
+    _subtreeBounds[i] = _worldBounds[i];
+    _changedNodes.push_back(i);
+  }
+
+  // Write the results back to the Transforms of the changed nodes.
+  for (uint i = begin; i < end; ++i) {
+    _transforms[i]->setGlobal(_global[i]);
+    _nodes[i]->_dirty = false;
+  }
+
+  // Children follow their parents, so walking backwards merges every
+  // subtree before it is merged into its parent.
+  for (uint i = end - 1; i > begin; --i) {
+    _subtreeBounds[_parents[i]].extend(_subtreeBounds[i]);
+  }
+
+  // The observers in the range are contiguous, as they are sorted by node.
+  std::vector<SObserver>::const_iterator it =
+    std::lower_bound(_observers.begin(), _observers.end(), begin,
+                     [](const SObserver& observer, const uint node) {
+                       return observer.node < node;
+                     });
+  for (; it != _observers.end() && it->node < end; ++it) {
+    it->component->transformChanged(_transforms[it->node]);
+  }
+}
@@ -0,0 +1,141 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_TRANSFORMHIERARCHY_H_
+#define KORE_SRC_KORE_TRANSFORMHIERARCHY_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "KoRE/Common.h"
+#include "KoRE/BoundingVolume.h"
+
+namespace kore {
+  class SceneNode;
+  class SceneNodeComponent;
+  class Transform;
+  struct STransformTRS;
+
+  /*! \brief Flattened storage of the local and global matrices of a scene
+  *          graph.
+  *   All nodes below a root are stored in depth-first order, so every parent
+  *   precedes its children. Global matrices can then be computed in a single
+  *   linear pass over contiguous arrays instead of recursing through the
+  *   child pointers. The matrices are written back to the Transform
+  *   components of changed nodes after the pass, through pointers cached
+  *   at the rebuild, as shader data refers to the matrices of the
+  *   components.
+  *   Because of the depth-first order, every subtree occupies a contiguous
+  *   range of the arrays. Changed nodes are collected in a list of dirty
+  *   roots and only their ranges are processed, so static frames cost
+  *   nothing.
+  *   World-space bounding boxes of the meshes of each node and of each
+  *   subtree are updated together with the matrices. Components that
+  *   observe their transform (cameras, lights) are notified once per dirty
+  *   range afterwards.
+  *   The arrays are rebuilt lazily whenever the structure of the graph
+  *   changes.
+  */
+  class TransformHierarchy {
+  public:
+    TransformHierarchy(void);
+    ~TransformHierarchy(void);
+
+    /*! \brief Recomputes the global matrices of all changed nodes below root.
+    *          Rebuilds the arrays first if the structure has changed. */
+    void update(SceneNode* root);
+
+    /*! \brief Marks the subtree of a node as changed. The local matrix of
+    *          the node is fetched on the next update. */
+    void localChanged(const SceneNode* node);
+
+    /*! \brief Sets the local transformations of many nodes and marks them
+    *          as changed in a single pass. */
+    void setLocals(SceneNode* const* nodes,
+                   const STransformTRS* transforms,
+                   const uint count);
+
+    /*! \brief Forces a rebuild of the arrays on the next update. Has to be
+    *          called if nodes are added or removed. */
+    inline void invalidateStructure() {_structureDirty = true;}
+
+    /*! \brief Detaches all nodes from the hierarchy. */
+    void clear(void);
+
+    inline uint size(void) const {return static_cast<uint>(_nodes.size());}
+    inline bool needsUpdate(void) const
+      {return _structureDirty || !_dirtyRoots.empty();}
+    inline const std::vector<glm::mat4>& getGlobals() const {return _global;}
+    inline const std::vector<glm::mat4>& getLocals() const {return _local;}
+
+    inline SceneNode* getNode(const uint index) const {return _nodes[index];}
+
+    /*! \brief Returns true if node is stored at index. False while the
+    *          structure has changed since the last update, because the
+    *          indices of all nodes may be stale then. */
+    inline bool contains(const SceneNode* node, const uint index) const {
+      return !_structureDirty && index < _nodes.size()
+             && _nodes[index] == node;
+    }
+
+    /*! \brief Incremented every time the arrays are rebuilt. Indices from
+    *          an older version are invalid. */
+    inline uint getStructureVersion() const {return _structureVersion;}
+
+    /*! \brief Returns the indices of all nodes whose global matrix changed
+    *          during the last update. */
+    inline const std::vector<uint>& getChangedNodes() const
+      {return _changedNodes;}
+
+    /*! \brief Returns the world-space box of the meshes of a node. */
+    const SAABB& getWorldBounds(const uint index) const;
+    inline const std::vector<SAABB>& getWorldBounds() const
+      {return _worldBounds;}
+
+    /*! \brief Returns the world-space box of all meshes in a subtree. */
+    const SAABB& getSubtreeBounds(const uint index) const;
+
+  private:
+    /// A component to notify when the global matrix of its node changed.
+    struct SObserver {
+      uint node;
+      SceneNodeComponent* component;
+    };
+
+    void rebuild(SceneNode* root);
+    void updateRange(const uint begin, const uint end);
+
+    bool _structureDirty;
+    uint _structureVersion;
+    std::vector<SceneNode*> _nodes;
+    std::vector<Transform*> _transforms;
+    std::vector<uint> _parents;  // index of parent or KORE_UINT_INVALID
+    std::vector<uint> _subtreeEnd;  // one past the last node of the subtree
+    std::vector<glm::mat4> _local;
+    std::vector<glm::mat4> _global;
+    std::vector<SAABB> _localBounds;  // bounds of the meshes of a node
+    std::vector<SAABB> _worldBounds;
+    std::vector<SAABB> _subtreeBounds;
+    std::vector<unsigned char> _dirty;  // node is in _dirtyRoots
+    std::vector<uint> _dirtyRoots;
+    std::vector<uint> _boundsAncestors;
+    std::vector<uint> _changedNodes;
+    std::vector<SObserver> _observers;  // sorted by node index
+  };
+};
+#endif  // KORE_SRC_KORE_TRANSFORMHIERARCHY_H_
@@ -0,0 +1,147 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+#include "KoRE/UniformBlockLayout.h"
+#include "KoRE/DataTypes.h"
+
+namespace {
+  inline GLuint roundUp(const GLuint value, const GLuint alignment) {
+    return ((value + alignment - 1) / alignment) * alignment;
+  }
+}
+
+kore::UniformBlockLayout::UniformBlockLayout(const EBlockLayout layout)
+  : _layout(layout),
+    _name(""),
+    _dataSize(0),
+    _endOffset(0) {
+}
+
+kore::UniformBlockLayout::~UniformBlockLayout(void) {
+}
+
+void kore::UniformBlockLayout::addMember(const std::string& name,
+                                         const GLenum type,
+                                         const GLuint arraySize) {
+  SDatatypeInfo info;
+  if (!DatatypeUtil::getDatatypeInfo(type, info)) {
+    KORE_LOG_ERROR(LOG_CATEGORY_SHADER, "UniformBlockLayout: unsupported type "
+                   "of member '%s'\n", name.c_str());
+    return;
+  }
+
+  // Base alignment of a single column: scalars align to N, vec2 to 2N,
+  // vec3 and vec4 to 4N.
+  const GLuint N = info.scalarSize;
+  GLuint columnAlign = N * (info.rows == 1 ? 1 : (info.rows == 2 ? 2 : 4));
+  GLuint columnSize = N * info.rows;
+
+  SBlockMember member;
+  member.name = name;
+  member.type = type;
+  member.arraySize = arraySize;
+  member.matrixStride = 0;
+
+  GLuint align = columnAlign;
+  GLuint elementSize = columnSize;
+
+  if (info.columns > 1) {
+    // Matrices are stored like arrays of column vectors.
+    if (_layout == BLOCKLAYOUT_STD140) {
+      columnAlign = roundUp(columnAlign, 4 * N);
+    }
+    member.matrixStride = roundUp(columnSize, columnAlign);
+    align = columnAlign;
+    elementSize = member.matrixStride * info.columns;
+  }
+
+  if (arraySize > 1 && _layout == BLOCKLAYOUT_STD140) {
+    // std140 rounds the alignment of array-elements up to a vec4.
+    align = roundUp(align, 16);
+  }
+
+  member.arrayStride = arraySize > 1 ? roundUp(elementSize, align) : 0;
+  member.offset = roundUp(_endOffset, align);
+
+  _endOffset = member.offset
+             + (arraySize > 1 ? member.arrayStride * arraySize : elementSize);
+  // The block itself is padded to a multiple of a vec4.
+  _dataSize = roundUp(_endOffset, 16);
+  _members.push_back(member);
+}
+
+void kore::UniformBlockLayout::addMember(const SBlockMember& member) {
+  _members.push_back(member);
+}
+
+const kore::SBlockMember*
+  kore::UniformBlockLayout::getMember(const std::string& name) const {
+  const std::string baseName = getBaseName(name);
+  for (uint i = 0; i < _members.size(); ++i) {
+    if (getBaseName(_members[i].name) == baseName) {
+      return &_members[i];
+    }
+  }
+  return NULL;
+}
+
+void kore::UniformBlockLayout::writeMember(const SBlockMember& member,
+                                           const void* value,
+                                           const GLuint arraySize,
+                                           GLubyte* blockData) const {
+  SDatatypeInfo info;
+  if (!value || !DatatypeUtil::getDatatypeInfo(member.type, info)) {
+    return;
+  }
+
+  const GLuint columnSize = info.scalarSize * info.rows;
+  const GLuint numElements = glm::min(arraySize, member.arraySize);
+  const GLubyte* src = static_cast<const GLubyte*>(value);
+
+  for (GLuint e = 0; e < numElements; ++e) {
+    GLubyte* dst = blockData + member.offset + e * member.arrayStride;
+    if (info.columns == 1) {
+      memcpy(dst, src, columnSize);
+      src += columnSize;
+      continue;
+    }
+
+    for (GLuint c = 0; c < info.columns; ++c) {
+      memcpy(dst + c * member.matrixStride, src, columnSize);
+      src += columnSize;
+    }
+  }
+}
+
+std::string kore::UniformBlockLayout::getBaseName(const std::string& name) {
+  std::string baseName = name;
+
+  std::size_t posDot = baseName.find_last_of(".");
+  if (posDot != std::string::npos) {
+    baseName = baseName.substr(posDot + 1);
+  }
+
+  std::size_t posBracket = baseName.find_first_of("[");
+  if (posBracket != std::string::npos) {
+    baseName = baseName.substr(0, posBracket);
+  }
+
+  return baseName;
+}
@@ -0,0 +1,95 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_UNIFORMBLOCKLAYOUT_H_
+#define KORE_SRC_KORE_UNIFORMBLOCKLAYOUT_H_
+
+#include <string>
+#include <vector>
+#include "KoRE/Common.h"
+
+namespace kore {
+  enum EBlockLayout {
+    BLOCKLAYOUT_REFLECTED,  // Offsets were queried from a linked program
+    BLOCKLAYOUT_STD140,
+    BLOCKLAYOUT_STD430
+  };
+
+  struct SBlockMember {
+    std::string name;     // e.g. "diffuseColor"
+    GLenum type;          // e.g. GL_FLOAT_VEC3
+    GLuint arraySize;     // 1 for non-array members
+    GLuint offset;        // Byte-offset from the start of the block
+    GLuint arrayStride;   // Bytes between two array elements
+    GLuint matrixStride;  // Bytes between two matrix columns
+  };
+
+  /*! \brief Describes the memory layout of a uniform (or storage) block.
+  *   A layout is either reflected from a linked ShaderProgram or generated
+  *   on the CPU from a list of members following the std140/std430 rules.
+  */
+  class UniformBlockLayout {
+  public:
+    explicit UniformBlockLayout(const EBlockLayout layout = BLOCKLAYOUT_STD140);
+    ~UniformBlockLayout(void);
+
+    /*! \brief Appends a member and computes its offset and strides according
+    *          to the std140/std430 rules of this layout. */
+    void addMember(const std::string& name,
+                   const GLenum type,
+                   const GLuint arraySize = 1);
+
+    /*! \brief Appends a member with already known offset and strides
+    *          (e.g. from program reflection). */
+    void addMember(const SBlockMember& member);
+
+    /*! \brief Retrieve a member by its name. Array-suffixes ("[0]") and
+    *          instance-name prefixes ("Block.") are ignored.
+    *   \return The member or NULL if there is no such member. */
+    const SBlockMember* getMember(const std::string& name) const;
+
+    /*! \brief Copies a tightly packed client-side value (as stored in a
+    *          ShaderData) into the block-memory at the member's location,
+    *          applying the array- and matrix-strides. */
+    void writeMember(const SBlockMember& member,
+                     const void* value,
+                     const GLuint arraySize,
+                     GLubyte* blockData) const;
+
+    inline const std::vector<SBlockMember>& getMembers() const
+                                                        {return _members;}
+    inline GLuint getDataSize() const {return _dataSize;}
+    inline void setDataSize(const GLuint size) {_dataSize = size;}
+    inline EBlockLayout getLayout() const {return _layout;}
+    inline const std::string& getName() const {return _name;}
+    inline void setName(const std::string& name) {_name = name;}
+
+    /*! \brief Strips instance-name prefixes and array-suffixes from a
+    *          member-name as returned by glGetActiveUniformName. */
+    static std::string getBaseName(const std::string& name);
+
+  private:
+    EBlockLayout _layout;
+    std::string _name;
+    GLuint _dataSize;
+    GLuint _endOffset;  // End of the last generated member
+    std::vector<SBlockMember> _members;
+  };
+}
+#endif  // KORE_SRC_KORE_UNIFORMBLOCKLAYOUT_H_
@@ -0,0 +1,210 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cctype>
+#include "KoRE/UniformBuffer.h"
+#include "KoRE/RenderManager.h"
+
+std::unordered_set<kore::UniformBuffer*> kore::UniformBuffer::_instances;
+
+kore::UniformBuffer::UniformBuffer(const std::vector<ShaderData>* values)
+  : _values(values) {
+}
+
+kore::UniformBuffer::~UniformBuffer(void) {
+  for (uint i = 0; i < _buffers.size(); ++i) {
+    if (_buffers[i].handle != KORE_GLUINT_HANDLE_INVALID) {
+      glDeleteBuffers(1, &_buffers[i].handle);
+    }
+  }
+  _instances.erase(this);
+}
+
+void kore::UniformBuffer::removeProgram(const GLuint programHandle) {
+  // removeBuffers() may unregister the instance, so iterate over a copy.
+  const std::vector<UniformBuffer*> instances(_instances.begin(),
+                                              _instances.end());
+  for (uint i = 0; i < instances.size(); ++i) {
+    instances[i]->removeBuffers(programHandle);
+  }
+}
+
+void kore::UniformBuffer::removeBuffers(const GLuint programHandle) {
+  for (uint i = 0; i < _buffers.size(); ) {
+    if (_buffers[i].programHandle == programHandle) {
+      if (_buffers[i].handle != KORE_GLUINT_HANDLE_INVALID) {
+        glDeleteBuffers(1, &_buffers[i].handle);
+      }
+      _buffers.erase(_buffers.begin() + i);
+    } else {
+      ++i;
+    }
+  }
+
+  if (_buffers.empty()) {
+    _instances.erase(this);
+  }
+}
+
+void kore::UniformBuffer::setValues(const std::vector<ShaderData>* values) {
+  _values = values;
+  for (uint i = 0; i < _buffers.size(); ++i) {
+    _buffers[i].sources.clear();
+  }
+  invalidate();
+}
+
+void kore::UniformBuffer::invalidate(void) {
+  for (uint i = 0; i < _buffers.size(); ++i) {
+    _buffers[i].dirty = true;
+  }
+}
+
+GLuint kore::UniformBuffer::update(const ShaderInput* block) {
+  if (!block || !block->additionalData) {
+    return KORE_GLUINT_HANDLE_INVALID;
+  }
+
+  SLayoutBuffer& buffer = getLayoutBuffer(block);
+  if (buffer.handle == KORE_GLUINT_HANDLE_INVALID) {
+    glGenBuffers(1, &buffer.handle);
+    buffer.dirty = true;
+  }
+
+  if (buffer.dirty) {
+    upload(buffer);
+  }
+  return buffer.handle;
+}
+
+void kore::UniformBuffer::write(const ShaderInput* block, GLubyte* dst) {
+  if (block && block->additionalData) {
+    write(getLayoutBuffer(block), dst);
+  }
+}
+
+kore::UniformBuffer::SLayoutBuffer&
+  kore::UniformBuffer::getLayoutBuffer(const ShaderInput* block) {
+  for (uint i = 0; i < _buffers.size(); ++i) {
+    if (_buffers[i].programHandle == block->programHandle
+        && _buffers[i].blockName == block->name) {
+      return _buffers[i];
+    }
+  }
+
+  if (_buffers.empty()) {
+    _instances.insert(this);
+  }
+
+  SLayoutBuffer buffer;
+  buffer.programHandle = block->programHandle;
+  buffer.blockName = block->name;
+  buffer.layout =
+    static_cast<const UniformBlockLayout*>(block->additionalData);
+  buffer.handle = KORE_GLUINT_HANDLE_INVALID;
+  buffer.size = 0;
+  buffer.dirty = true;
+  buffer.numValues = 0;
+  _buffers.push_back(buffer);
+  return _buffers.back();
+}
+
+void kore::UniformBuffer::matchSources(SLayoutBuffer& buffer) {
+  const std::vector<SBlockMember>& members = buffer.layout->getMembers();
+  buffer.sources.resize(members.size());
+  buffer.numValues = _values ? _values->size() : 0;
+
+  for (uint m = 0; m < members.size(); ++m) {
+    SMemberSource& source = buffer.sources[m];
+    source.valueIndex = KORE_UINT_INVALID;
+    source.data = NULL;
+
+    const std::string memberName =
+      normalizeName(UniformBlockLayout::getBaseName(members[m].name));
+
+    for (uint v = 0; v < buffer.numValues; ++v) {
+      const ShaderData& value = (*_values)[v];
+      if (value.type == members[m].type
+          && normalizeName(value.name) == memberName) {
+        source.valueIndex = v;
+        source.data = value.data;
+        break;
+      }
+    }
+  }
+}
+
+void kore::UniformBuffer::write(SLayoutBuffer& buffer, GLubyte* dst) {
+  if (!_values) {
+    return;
+  }
+
+  // Re-match members and values only if the value-list changed.
+  bool matched = buffer.sources.size() == buffer.layout->getMembers().size()
+                 && buffer.numValues == _values->size();
+  for (uint m = 0; matched && m < buffer.sources.size(); ++m) {
+    const SMemberSource& source = buffer.sources[m];
+    matched = source.valueIndex == KORE_UINT_INVALID
+              || (*_values)[source.valueIndex].data == source.data;
+  }
+  if (!matched) {
+    matchSources(buffer);
+  }
+
+  const std::vector<SBlockMember>& members = buffer.layout->getMembers();
+  for (uint m = 0; m < members.size(); ++m) {
+    const SMemberSource& source = buffer.sources[m];
+    if (source.valueIndex != KORE_UINT_INVALID) {
+      const ShaderData& value = (*_values)[source.valueIndex];
+      value.resolve();
+      buffer.layout->writeMember(members[m], value.data, value.size, dst);
+    }
+  }
+}
+
+void kore::UniformBuffer::upload(SLayoutBuffer& buffer) {
+  const UniformBlockLayout* layout = buffer.layout;
+
+  _staging.assign(layout->getDataSize(), 0);
+  if (!_staging.empty()) {
+    write(buffer, &_staging[0]);
+  }
+
+  RenderManager::getInstance()->bindBuffer(GL_UNIFORM_BUFFER, buffer.handle);
+  if (buffer.size != layout->getDataSize()) {
+    buffer.size = layout->getDataSize();
+    glBufferData(GL_UNIFORM_BUFFER, buffer.size,
+                 _staging.empty() ? NULL : &_staging[0], GL_DYNAMIC_DRAW);
+  } else if (buffer.size > 0) {
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, buffer.size, &_staging[0]);
+  }
+
+  buffer.dirty = false;
+}
+
+std::string kore::UniformBuffer::normalizeName(const std::string& name) {
+  std::string normalized;
+  normalized.reserve(name.size());
+  for (uint i = 0; i < name.size(); ++i) {
+    if (name[i] != ' ' && name[i] != '_') {
+      normalized.push_back(static_cast<char>(tolower(name[i])));
+    }
+  }
+  return normalized;
+}
@@ -0,0 +1,98 @@
+/*
+  Copyright (c) 2012 The KoRE Project
+
+  This file is part of KoRE.
+
+  KoRE is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  KoRE is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with KoRE.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KORE_SRC_KORE_UNIFORMBUFFER_H_
+#define KORE_SRC_KORE_UNIFORMBUFFER_H_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "KoRE/Common.h"
+#include "KoRE/ShaderData.h"
+#include "KoRE/ShaderInput.h"
+#include "KoRE/UniformBlockLayout.h"
+
+namespace kore {
+  /*! \brief Mirrors a list of ShaderData-values into uniform buffer objects.
+  *   For every uniform block the values are requested for, one buffer is
+  *   kept, identified by the program and the name of the block. The buffers
+  *   are only rebuilt after invalidate() was called and are dropped when
+  *   their program is destroyed.
+  *   Block-members are matched to ShaderData-names case-insensitively,
+  *   ignoring spaces and underscores (e.g. "Diffuse Color" -> diffuseColor).
+  */
+  class UniformBuffer {
+  public:
+    explicit UniformBuffer(const std::vector<ShaderData>* values = NULL);
+    ~UniformBuffer(void);
+
+    /*! \brief Sets the list of values to mirror. */
+    void setValues(const std::vector<ShaderData>* values);
+
+    /*! \brief Marks the buffer-contents of all layouts as outdated. */
+    void invalidate(void);
+
+    /*! \brief Returns the handle of the buffer holding the values in the
+    *          layout of the provided uniform block. The buffer is created or
+    *          re-uploaded if it is outdated. */
+    GLuint update(const ShaderInput* block);
+
+    /*! \brief Writes the values in the layout of the provided uniform block
+    *          to dst, which has to hold at least the data size of the
+    *          block. Members without a matching value are left untouched. */
+    void write(const ShaderInput* block, GLubyte* dst);
+
+    /*! \brief Drops the buffers of all UniformBuffers for the blocks of a
+    *          program. Called when the program is destroyed or relinked. */
+    static void removeProgram(const GLuint programHandle);
+
+  private:
+    // The value a block-member is sourced from.
+    struct SMemberSource {
+      uint valueIndex;   // KORE_UINT_INVALID if no value matches
+      const void* data;  // To detect changes in the value-list
+    };
+
+    struct SLayoutBuffer {
+      GLuint programHandle;
+      std::string blockName;
+      const UniformBlockLayout* layout;  // Owned by the program
+      GLuint handle;
+      GLuint size;
+      bool dirty;
+      uint numValues;  // Size of the value-list when sources were matched
+      std::vector<SMemberSource> sources;
+    };
+
+    const std::vector<ShaderData>* _values;
+    std::vector<SLayoutBuffer> _buffers;
+    std::vector<GLubyte> _staging;
+
+    // All UniformBuffers holding buffers, see removeProgram().
+    static std::unordered_set<UniformBuffer*> _instances;
+
+    SLayoutBuffer& getLayoutBuffer(const ShaderInput* block);
+    void removeBuffers(const GLuint programHandle);
+    void matchSources(SLayoutBuffer& buffer);
+    void write(SLayoutBuffer& buffer, GLubyte* dst);
+    void upload(SLayoutBuffer& buffer);
+    static std::string normalizeName(const std::string& name);
+  };
+}
+#endif  // KORE_SRC_KORE_UNIFORMBUFFER_H_
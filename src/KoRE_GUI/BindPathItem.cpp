@@ -30,6 +30,7 @@
 #include "KoRE/Operations/BindOperations/BindUniform.h"
 #include "KoRE/Operations/BindOperations/BindTexture.h"
 #include "KoRE/Operations/BindOperations/BindImageTexture.h"
+#include "KoRE/Operations/BindOperations/BindUniformBlock.h"
 #include "KoRE/Operations/RenderMesh.h"
 
 koregui::BindPathItem::BindPathItem(ShaderDataItem* start,
@@ -154,6 +155,25 @@ bool koregui::BindPathItem::initBinding(void) {
     }
     return true;
   }
+
+  // uniform block binding
+  if (target->input_type == GL_ACTIVE_UNIFORM_BLOCKS) {
+    // Transforms change often and are streamed, other blocks (e.g. materials)
+    // keep a buffer that is only rebuilt when a value changes.
+    const kore::ShaderData* data = _start->getData();
+    const bool streamed = data->component
+      && data->component->getType() == kore::COMPONENT_TRANSFORM;
+    _bindOP = new kore::BindUniformBlock(data, _end->getInput(), streamed);
+    if(nodePass) {
+      nodePass->addOperation(_bindOP);
+    } else {
+      kore::ShaderProgramPass* progpass =
+        static_cast<kore::ShaderProgramPass*>(_end->getShaderPass()
+                                                  ->getProgramPass());
+      progpass->addStartupOperation(_bindOP);
+    }
+    return true;
+  }
   return false;
 }
 
@@ -37,6 +37,7 @@
 #include "KoRE/SceneManager.h"
 #include "KoRE/ResourceManager.h"
 #include "KoRE/RenderManager.h"
+#include "KoRE/GLerror.h"
 
 GLWidget::GLWidget(QWidget *parent) : QGLWidget(parent) {
 
@@ -81,6 +82,11 @@ void GLWidget::initializeGL() {
         reinterpret_cast<const char*>
         (glGetString(GL_SHADING_LANGUAGE_VERSION)));
 
+#if KORE_GL_ERROR_CHECKS
+    kore::GLerror::installDebugCallback();
+    kore::GLerror::setDebugAnnotationsEnabled(true);
+#endif
+
     // enable culling and depthtest
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
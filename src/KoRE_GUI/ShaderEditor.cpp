@@ -84,6 +84,7 @@ void koregui::ShaderEditor::addShader(void) {
   typeselect->addItem("GEOMETRY", QVariant(GL_GEOMETRY_SHADER));
   typeselect->addItem("TESS_CONTROL", QVariant(GL_TESS_CONTROL_SHADER));
   typeselect->addItem("TESS_EVALUATION", QVariant(GL_TESS_EVALUATION_SHADER));
+  typeselect->addItem("COMPUTE", QVariant(GL_COMPUTE_SHADER));
   ui.shaderTable->setCellWidget(row, 0, typeselect);
 
   QHBoxLayout* hlay = new QHBoxLayout;
@@ -136,6 +137,8 @@ void koregui::ShaderEditor::refresh(void) {
   if (shader) addShaderInfo(shader);
   shader = _currentprogram->getShader(GL_TESS_EVALUATION_SHADER);
   if (shader) addShaderInfo(shader);
+  shader = _currentprogram->getShader(GL_COMPUTE_SHADER);
+  if (shader) addShaderInfo(shader);
 }
 
 void koregui::ShaderEditor::setShaderProgram(const QString& name) {
@@ -160,6 +163,7 @@ void koregui::ShaderEditor::addShaderInfo(kore::Shader* shader) {
   typesel->addItem("GEOMETRY", QVariant(GL_GEOMETRY_SHADER));
   typesel->addItem("TESS_CONTROL", QVariant(GL_TESS_CONTROL_SHADER));
   typesel->addItem("TESS_EVALUATION", QVariant(GL_TESS_EVALUATION_SHADER));
+  typesel->addItem("COMPUTE", QVariant(GL_COMPUTE_SHADER));
   typesel-> setCurrentIndex(typesel->findData(QVariant(shader->getType())));
   ui.shaderTable->setCellWidget(row, 0, typesel);
 
@@ -105,6 +105,14 @@ void koregui::ShaderPassItem::refresh(void) {
       _uniforms.push_back(inpitem);
       inpitem->setPos(-4, tmpheight + 30 * j);
     }
+    // uniform blocks are listed and bound like uniforms
+    sinput = _shader->getUniformBlocks();
+    for (uint k = 0; k < sinput.size(); k++) {
+      const kore::ShaderInput* tmp = _shader->getUniformBlock(sinput[k].name);
+      ShaderInputItem* inpitem =  new ShaderInputItem(tmp, this, this);
+      inpitem->setPos(-4, tmpheight + 30 * _uniforms.size());
+      _uniforms.push_back(inpitem);
+    }
   }
 
   _shaderheight = 40; // place for shader name